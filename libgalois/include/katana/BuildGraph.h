@@ -26,7 +26,7 @@ using NullMaps = std::pair<
     std::unordered_map<int, std::shared_ptr<arrow::Array>>,
     std::unordered_map<int, std::shared_ptr<arrow::Array>>>;
 
-enum SourceType { kGraphml, kKatana };
+enum SourceType { kGraphml, kKatana, kCsv };
 enum SourceDatabase { kNone, kNeo4j, kMongodb, kMysql };
 enum ImportDataType {
   kString,
@@ -228,6 +228,17 @@ private:
   GraphComponent BuildFinalEdges(bool verbose);
 };
 
+/// SortEdgesIntoCSR puts edges, given as parallel \param sources and
+/// \param destinations vectors, in CSR order. \param out_indices holds the
+/// end offset of the edges of each node. The edges of a node keep their
+/// input order. Afterwards, (*edge_mapping)[e] is the input index of CSR
+/// edge e.
+KATANA_EXPORT void SortEdgesIntoCSR(
+    const std::vector<uint64_t>& out_indices,
+    const std::vector<uint32_t>& sources,
+    const std::vector<uint32_t>& destinations,
+    std::vector<uint32_t>* out_dests, std::vector<size_t>* edge_mapping);
+
 KATANA_EXPORT Result<void> WritePropertyGraph(
     const GraphComponents& graph_comps, const std::string& dir);
 KATANA_EXPORT Result<void> WritePropertyGraph(
@@ -46,6 +46,15 @@ class KATANA_EXPORT DynamicBitset {
   katana::PODResizeableArray<katana::CopyableAtomic<uint64_t>> bitvec_{};
   size_t num_bits_{0};
 
+  // Bulk operations access the words as plain integers so that they can be
+  // vectorized
+  static_assert(
+      sizeof(katana::CopyableAtomic<uint64_t>) == sizeof(uint64_t) &&
+      alignof(katana::CopyableAtomic<uint64_t>) == alignof(uint64_t));
+
+  // Clears the bits of the last word past size() that bitwise_not sets
+  void ClearPadding();
+
 public:
   static constexpr uint32_t kNumBitsInUint64 = sizeof(uint64_t) * CHAR_BIT;
 
@@ -90,6 +99,8 @@ public:
     bitvec_.resize((n + kNumBitsInUint64 - 1) / kNumBitsInUint64);
     if (bitvec_.size() > old_size) {
       std::fill(bitvec_.begin() + old_size, bitvec_.end(), 0);
+    } else {
+      ClearPadding();
     }
   }
 
@@ -262,6 +273,40 @@ public:
     return (old_val & bit_offset);
   }
 
+  /**
+   * Set a bit in the bitset without an atomic read-modify-write. Only use
+   * this if no other thread writes a bit of the same 64-bit word at the same
+   * time, e.g., if each thread owns a contiguous block of bits aligned to 64.
+   *
+   * @param index Bit to set
+   * @returns the old value
+   */
+  bool set_nonatomic(size_t index) {
+    size_t bit_index = index / kNumBitsInUint64;
+    uint64_t bit_offset = uint64_t{1} << (index % kNumBitsInUint64);
+    uint64_t old_val = bitvec_[bit_index].load(std::memory_order_relaxed);
+    bitvec_[bit_index].store(old_val | bit_offset, std::memory_order_relaxed);
+    return (old_val & bit_offset);
+  }
+
+  /**
+   * Reset a bit in the bitset without an atomic read-modify-write; see
+   * set_nonatomic.
+   *
+   * @param index Bit to reset
+   * @returns the old value
+   */
+  bool reset_nonatomic(size_t index) {
+    size_t bit_index = index / kNumBitsInUint64;
+    uint64_t bit_offset = uint64_t{1} << (index % kNumBitsInUint64);
+    uint64_t old_val = bitvec_[bit_index].load(std::memory_order_relaxed);
+    bitvec_[bit_index].store(old_val & ~bit_offset, std::memory_order_relaxed);
+    return (old_val & bit_offset);
+  }
+
+  // The bulk operations below run in parallel and use AVX2 or AVX-512 if the
+  // processor supports them. Do NOT call them in a parallel region.
+
   // assumes bit_vector is not updated (set) in parallel
   void bitwise_or(const DynamicBitset& other);
 
@@ -302,6 +347,14 @@ public:
    */
   void bitwise_xor(const DynamicBitset& other1, const DynamicBitset& other2);
 
+  /**
+   * Does an IN-PLACE bitwise and of this bitset and the complement of
+   * another bitset, i.e., removes the bits set in other
+   *
+   * @param other Bitset whose set bits to unset in this bitset
+   */
+  void bitwise_andnot(const DynamicBitset& other);
+
   /**
    * Count how many bits are set in the bitset
    *
@@ -309,6 +362,24 @@ public:
    */
   size_t count() const;
 
+  /**
+   * Count how many bits are set in both this bitset and another bitset
+   * without materializing their intersection
+   *
+   * @param other Bitset to intersect with
+   * @returns number of bits set in both bitsets
+   */
+  size_t and_count(const DynamicBitset& other) const;
+
+  /**
+   * Does an IN-PLACE bitwise or of this bitset and another bitset and then
+   * resets the other bitset in the same pass, e.g., to merge the next
+   * frontier into the visited set
+   *
+   * @param other Bitset to or with this bitset and then reset
+   */
+  void or_and_clear(DynamicBitset* other);
+
   /**
    * Returns a vector containing the set bits in this bitset in order
    * from left to right.
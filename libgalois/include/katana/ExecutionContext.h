@@ -0,0 +1,110 @@
+#ifndef KATANA_LIBGALOIS_KATANA_EXECUTIONCONTEXT_H_
+#define KATANA_LIBGALOIS_KATANA_EXECUTIONCONTEXT_H_
+
+#include <memory>
+
+#include "katana/Barrier.h"
+#include "katana/Result.h"
+#include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// An ExecutionContext is a group of threads of the thread pool that runs
+/// parallel loops independently of other contexts. Jobs that run at the
+/// same time, e.g., analytics started by different service threads, can each
+/// use their own context instead of queueing for the whole pool or
+/// oversubscribing the machine.
+///
+/// A thread uses a context by creating a Scope. Until the scope ends, loops
+/// started by the thread (do_all, for_each, on_each, ...) run on the threads
+/// of the context and the calling thread stands in for thread 0 of the
+/// context. Inside those loops, ThreadPool::getTID(), getActiveThreads(),
+/// the topology queries of the thread pool and PerThreadStorage all refer to
+/// the threads of the context, numbered from 0. One thread at a time can be
+/// in the scope of a context; others wait for it.
+///
+/// Contexts reserve threads of the single thread pool of the process, so
+/// per-thread storage made outside of a context remains valid inside it.
+/// Loops started outside of any context use the whole pool and wait until
+/// no thread is in the scope of a context. Thread 0 of the pool and threads
+/// dedicated with ThreadPool::runDedicated are never part of a context.
+///
+///   auto ctx = ExecutionContext::MakeForNumaNode(1).value();
+///   {
+///     ExecutionContext::Scope scope(*ctx);
+///     katana::do_all(katana::iterate(graph), ...);
+///   }
+class KATANA_EXPORT ExecutionContext {
+public:
+  /// Make reserves num_threads threads of the pool that are not in another
+  /// context. Threads on distinct cores and on the same socket are
+  /// preferred.
+  static Result<std::unique_ptr<ExecutionContext>> Make(unsigned num_threads);
+
+  /// MakeForNumaNode reserves the threads of the pool on NUMA node
+  /// numa_node. None of them may be in another context.
+  static Result<std::unique_ptr<ExecutionContext>> MakeForNumaNode(
+      unsigned numa_node);
+
+  /// Current returns the context of the calling thread, or null if the
+  /// thread is not in the scope of a context or in a loop started by such a
+  /// thread.
+  static ExecutionContext* Current();
+
+  ~ExecutionContext();
+
+  ExecutionContext(const ExecutionContext&) = delete;
+  ExecutionContext& operator=(const ExecutionContext&) = delete;
+  ExecutionContext(ExecutionContext&&) = delete;
+  ExecutionContext& operator=(ExecutionContext&&) = delete;
+
+  /// Scope binds the calling thread to a context for its lifetime
+  class KATANA_EXPORT Scope {
+  public:
+    explicit Scope(ExecutionContext& ctx);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    Scope(Scope&&) = delete;
+    Scope& operator=(Scope&&) = delete;
+
+  private:
+    char* pts_base_;
+    char* pss_base_;
+  };
+
+  unsigned num_threads() const { return partition_->threads.size(); }
+
+  /// Thread ids of the pool that belong to this context
+  const std::vector<unsigned>& pool_threads() const {
+    return partition_->threads;
+  }
+
+  /// The number of threads loops in this context use; see setActiveThreads
+  unsigned active_threads() const { return active_threads_; }
+  unsigned SetActiveThreads(unsigned num);
+
+  /// Like katana::GetBarrier and katana::GetTerminationDetection but for the
+  /// threads of this context. Only valid in the scope of this context.
+  Barrier& GetBarrier(unsigned active_threads);
+  TerminationDetection& GetTerminationDetection(unsigned active_threads);
+
+private:
+  explicit ExecutionContext(std::unique_ptr<ThreadPool::Partition> partition);
+
+  static Result<std::unique_ptr<ExecutionContext>> MakeFromThreads(
+      std::vector<unsigned> threads);
+
+  std::unique_ptr<ThreadPool::Partition> partition_;
+  std::unique_ptr<Barrier> barrier_;
+  unsigned barrier_threads_{0};
+  std::unique_ptr<TerminationDetection> term_;
+  unsigned active_threads_;
+};
+
+}  // namespace katana
+
+#endif
@@ -20,15 +20,23 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORDOALL_H_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <type_traits>
+
 #include "katana/Barrier.h"
 #include "katana/CompilerSpecific.h"
 #include "katana/Executor_OnEach.h"
+#include "katana/LoopProfiler.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/PaddedLock.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
@@ -367,6 +375,7 @@ private:
   PerThreadTimer<MORE_STATS> execTime;
   PerThreadTimer<MORE_STATS> stealTime;
   PerThreadTimer<MORE_STATS> termTime;
+  LoopProfiler profiler;
 
 public:
   DoAllStealingExec(const R& _range, F _func, const ArgsTuple& argsTuple)
@@ -374,12 +383,13 @@ public:
         func(_func),
         loopname(katana::internal::getLoopName(argsTuple)),
         chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
-        term(GetTerminationDetection(activeThreads)),
+        term(GetTerminationDetection(getActiveThreads())),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
         stealTime(loopname, "Steal"),
-        termTime(loopname, "Term") {
+        termTime(loopname, "Term"),
+        profiler(getProfiledLoopName(argsTuple)) {
     KATANA_LOG_DEBUG_ASSERT(chunk_size > 0);
   }
 
@@ -412,6 +422,7 @@ public:
   void operator()(void) {
     ThreadContext& ctx = *workers.getLocal();
     totalTime.start();
+    profiler.BeginThread();
 
     while (true) {
       bool workHappened = false;
@@ -427,7 +438,9 @@ public:
       KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
 
       stealTime.start();
+      profiler.BeginPhase();
       bool stole = trySteal(ctx);
+      profiler.EndPhase(LoopProfiler::kSteal);
       stealTime.stop();
 
       if (stole) {
@@ -437,9 +450,11 @@ public:
         KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
         if (USE_TERM) {
           termTime.start();
+          profiler.BeginPhase();
           term.SignalWorked(workHappened);
 
           bool quit = !term.Working();
+          profiler.EndPhase(LoopProfiler::kWait);
           termTime.stop();
 
           if (quit) {
@@ -451,6 +466,7 @@ public:
       }
     }
 
+    profiler.EndThread();
     totalTime.stop();
     KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
 
@@ -460,18 +476,268 @@ public:
   }
 };
 
+/// DoAllDequeExec is the stealing executor for ranges with random access
+/// iterators. Each thread owns a deque of iteration indices: the owner claims
+/// chunks from the front without locking while thieves take half of what is
+/// left from the back. Owner and thieves arbitrate with the THE protocol of
+/// Cilk, so the victim's lock is only taken by thieves and by an owner that
+/// contends with a thief for the last iterations.
+///
+/// Idle threads look for victims on their NUMA node first, then on their
+/// socket and only then anywhere. Owners adapt their chunk size so that a
+/// chunk takes about kTargetChunkNanos, but never claim fewer iterations than
+/// the chunk_size of the loop.
+template <typename R, typename F, typename ArgsTuple>
+class DoAllDequeExec {
+  typedef typename R::local_iterator Iter;
+  typedef typename std::iterator_traits<Iter>::difference_type Diff_ty;
+
+  constexpr static const bool NEED_STATS =
+      katana::internal::NeedStats<ArgsTuple>::value;
+  constexpr static const bool MORE_STATS =
+      NEED_STATS && has_trait<more_stats_tag, ArgsTuple>();
+
+  constexpr static const int64_t kTargetChunkNanos = 20000;
+  constexpr static const Diff_ty kMaxChunkSize = Diff_ty{1} << 20;
+
+  enum StealLevel { kNumaNode, kSocket, kAny };
+
+  struct WorkDeque {
+    alignas(KATANA_CACHE_LINE_SIZE) std::atomic<Diff_ty> beg{0};
+    std::atomic<Diff_ty> end{0};
+    Iter base{};
+    unsigned numa_node{0};
+    unsigned socket{0};
+    size_t num_iter{0};
+    SimpleLock lock;
+
+    bool hasWorkWeak() const {
+      return beg.load(std::memory_order_relaxed) <
+             end.load(std::memory_order_relaxed);
+    }
+
+    /// Claim up to n iterations from the front. Only called by the owner.
+    bool take(Diff_ty n, Diff_ty* take_beg, Diff_ty* take_end) {
+      Diff_ty b = beg.load(std::memory_order_relaxed);
+      Diff_ty nb = b + n;
+      beg.store(nb, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      Diff_ty e = end.load(std::memory_order_relaxed);
+      if (nb <= e) {
+        *take_beg = b;
+        *take_end = nb;
+        return true;
+      }
+
+      // A thief may be taking the same iterations; let the lock decide
+      std::lock_guard<SimpleLock> lg(lock);
+      e = end.load(std::memory_order_relaxed);
+      if (b >= e) {
+        beg.store(b, std::memory_order_relaxed);
+        return false;
+      }
+      nb = std::min(nb, e);
+      beg.store(nb, std::memory_order_relaxed);
+      *take_beg = b;
+      *take_end = nb;
+      return true;
+    }
+
+    /// Take half of the remaining iterations from the back. Called by
+    /// thieves.
+    bool steal(Iter* steal_base, Diff_ty* steal_beg, Diff_ty* steal_end) {
+      if (!lock.try_lock()) {
+        return false;
+      }
+      bool succ = false;
+      Diff_ty e = end.load(std::memory_order_relaxed);
+      Diff_ty size = e - beg.load(std::memory_order_relaxed);
+      if (size > 0) {
+        Diff_ty ne = e - (size + 1) / 2;
+        end.store(ne, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (beg.load(std::memory_order_relaxed) > ne) {
+          // The owner claimed into the stolen part; give it back
+          end.store(e, std::memory_order_relaxed);
+        } else {
+          *steal_base = base;
+          *steal_beg = ne;
+          *steal_end = e;
+          succ = true;
+        }
+      }
+      lock.unlock();
+      return succ;
+    }
+
+    /// Replace the (empty) deque with [b, e) of iter. Only called by the
+    /// owner.
+    void reset(Iter iter, Diff_ty b, Diff_ty e) {
+      std::lock_guard<SimpleLock> lg(lock);
+      base = iter;
+      beg.store(b, std::memory_order_relaxed);
+      end.store(e, std::memory_order_relaxed);
+    }
+  };
+
+  bool isVictim(
+      const WorkDeque& poor, const WorkDeque& rich, StealLevel level) const {
+    switch (level) {
+    case kNumaNode:
+      return rich.numa_node == poor.numa_node;
+    case kSocket:
+      return rich.socket == poor.socket;
+    default:
+      return true;
+    }
+  }
+
+  /// Steal into poor, which is empty. Returns true if work was stolen or seen
+  /// (but not stolen) somewhere.
+  KATANA_ATTRIBUTE_NOINLINE bool trySteal(unsigned id, WorkDeque& poor) {
+    const unsigned maxT = katana::getActiveThreads();
+    bool sawWork = false;
+
+    for (StealLevel level : {kNumaNode, kSocket, kAny}) {
+      // go around the machine starting from the next thread
+      for (unsigned i = 1; i < maxT; ++i) {
+        WorkDeque& rich = *workers.getRemote((id + i) % maxT);
+        if (!isVictim(poor, rich, level) || !rich.hasWorkWeak()) {
+          continue;
+        }
+        sawWork = true;
+        Iter steal_base;
+        Diff_ty steal_beg;
+        Diff_ty steal_end;
+        if (rich.steal(&steal_base, &steal_beg, &steal_end)) {
+          poor.reset(steal_base, steal_beg, steal_end);
+          return true;
+        }
+      }
+      if (sawWork) {
+        return true;
+      }
+      asmPause();
+    }
+
+    return false;
+  }
+
+  R range;
+  F func;
+  const char* loopname;
+  Diff_ty chunk_size;
+  PerThreadStorage<WorkDeque> workers;
+
+  // for stats
+  PerThreadTimer<MORE_STATS> totalTime;
+  PerThreadTimer<MORE_STATS> initTime;
+  PerThreadTimer<MORE_STATS> execTime;
+  PerThreadTimer<MORE_STATS> stealTime;
+  LoopProfiler profiler;
+
+public:
+  DoAllDequeExec(const R& _range, F _func, const ArgsTuple& argsTuple)
+      : range(_range),
+        func(_func),
+        loopname(katana::internal::getLoopName(argsTuple)),
+        chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
+        totalTime(loopname, "Total"),
+        initTime(loopname, "Init"),
+        execTime(loopname, "Execute"),
+        stealTime(loopname, "Steal"),
+        profiler(getProfiledLoopName(argsTuple)) {
+    KATANA_LOG_DEBUG_ASSERT(chunk_size > 0);
+  }
+
+  // parallel call
+  void initThread(void) {
+    initTime.start();
+
+    unsigned id = ThreadPool::getTID();
+    WorkDeque& ctx = *workers.getLocal(id);
+    ctx.numa_node = ThreadPool::getNumaNode();
+    ctx.socket = ThreadPool::getSocket();
+    ctx.num_iter = 0;
+    Iter beg = range.local_begin();
+    ctx.reset(beg, 0, std::distance(beg, range.local_end()));
+
+    initTime.stop();
+  }
+
+  void operator()(void) {
+    unsigned id = ThreadPool::getTID();
+    WorkDeque& ctx = *workers.getLocal(id);
+    Diff_ty chunk = chunk_size;
+    totalTime.start();
+    profiler.BeginThread();
+
+    do {
+      execTime.start();
+      Diff_ty beg;
+      Diff_ty end;
+      while (ctx.take(chunk, &beg, &end)) {
+        auto start = std::chrono::steady_clock::now();
+        Iter it = ctx.base;
+        std::advance(it, beg);
+        for (Diff_ty i = beg; i != end; ++i, ++it) {
+          func(*it);
+        }
+        if (NEED_STATS) {
+          ctx.num_iter += end - beg;
+        }
+        int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+        if (nanos < kTargetChunkNanos / 2 && end - beg == chunk &&
+            chunk < kMaxChunkSize) {
+          chunk *= 2;
+        } else if (nanos > kTargetChunkNanos * 2 && chunk > chunk_size) {
+          chunk = std::max(chunk / 2, chunk_size);
+        }
+      }
+      execTime.stop();
+
+      stealTime.start();
+      profiler.BeginPhase();
+      bool stole = trySteal(id, ctx);
+      profiler.EndPhase(LoopProfiler::kSteal);
+      stealTime.stop();
+      if (!stole) {
+        break;
+      }
+    } while (true);
+
+    profiler.EndThread();
+    totalTime.stop();
+
+    if (NEED_STATS) {
+      katana::ReportStatSum(loopname, "Iterations", ctx.num_iter);
+    }
+  }
+};
+
+template <typename Iter>
+constexpr bool kIsRandomAccess = std::is_base_of_v<
+    std::random_access_iterator_tag,
+    typename std::iterator_traits<Iter>::iterator_category>;
+
 template <bool _STEAL>
 struct ChooseDoAllImpl {
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F&& func, const ArgsT& argsTuple) {
-    internal::DoAllStealingExec<
-        R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
-        exec(range, std::forward<F>(func), argsTuple);
+    using FuncRef = OperatorReferenceType<decltype(std::forward<F>(func))>;
+    using Exec = std::conditional_t<
+        kIsRandomAccess<typename R::local_iterator>,
+        internal::DoAllDequeExec<R, FuncRef, ArgsT>,
+        internal::DoAllStealingExec<R, FuncRef, ArgsT>>;
+
+    Exec exec(range, std::forward<F>(func), argsTuple);
 
-    Barrier& barrier = GetBarrier(activeThreads);
+    Barrier& barrier = GetBarrier(getActiveThreads());
 
     GetThreadPool().run(
-        activeThreads, [&exec]() { exec.initThread(); },
+        getActiveThreads(), [&exec]() { exec.initThread(); },
         [&barrier]() { barrier.Wait(); }, std::ref(exec));
   }
 };
@@ -480,6 +746,7 @@ template <>
 struct ChooseDoAllImpl<false> {
   template <typename R, typename F, typename ArgsT>
   static void call(const R& range, F func, const ArgsT& argsTuple) {
+    LoopProfiler profiler(getProfiledLoopName(argsTuple));
     on_each_gen(
         [&](const unsigned int, const unsigned int) {
           static constexpr bool NEED_STATS =
@@ -494,6 +761,7 @@ struct ChooseDoAllImpl<false> {
           PerThreadTimer<MORE_STATS> execTime(loopname, "Work");
 
           totalTime.start();
+          profiler.BeginThread();
           initTime.start();
 
           auto begin = range.local_begin();
@@ -513,6 +781,7 @@ struct ChooseDoAllImpl<false> {
           }
           execTime.stop();
 
+          profiler.EndThread();
           totalTime.stop();
 
           if (NEED_STATS) {
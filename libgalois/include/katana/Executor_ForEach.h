@@ -28,6 +28,7 @@
 #include "katana/Barrier.h"
 #include "katana/Chunk.h"
 #include "katana/Context.h"
+#include "katana/LoopProfiler.h"
 #include "katana/LoopStatistics.h"
 #include "katana/Mem.h"
 #include "katana/OperatorReferenceTypes.h"
@@ -193,6 +194,7 @@ protected:
 
   PerThreadTimer<MORE_STATS> initTime;
   PerThreadTimer<MORE_STATS> execTime;
+  internal::LoopProfiler profiler;
 
   inline void commitIteration(ThreadLocalData& tld) {
     if (needsPush) {
@@ -314,6 +316,9 @@ protected:
     while (true) {
       do {
         bool didWork = false;
+        // Looking for work in other threads' queues happens in pop(), so a
+        // round without work counts as waiting
+        profiler.BeginPhase();
 
         // Run some iterations
         if (couldAbort || needsBreak) {
@@ -333,6 +338,8 @@ protected:
         // Update node color and prop token
         term.SignalWorked(didWork);
         asmPause();  // Let token propagate
+        profiler.EndPhase(didWork ? internal::LoopProfiler::kBusy
+                                : internal::LoopProfiler::kWait);
       } while (term.Working() && (!needsBreak || !broke));
 
       if (checkEmpty(wl, tld, 0)) {
@@ -346,7 +353,9 @@ protected:
       }
 
       term.InitializeThread();
+      profiler.BeginPhase();
       barrier.Wait();
+      profiler.EndPhase(internal::LoopProfiler::kWait);
     }
 
     if (couldAbort)
@@ -358,14 +367,15 @@ protected:
 
   template <typename... WArgsTy>
   ForEachExecutor(T2, FunctionTy f, const ArgsTy& args, WArgsTy... wargs)
-      : term(GetTerminationDetection(activeThreads)),
-        barrier(GetBarrier(activeThreads)),
+      : term(GetTerminationDetection(getActiveThreads())),
+        barrier(GetBarrier(getActiveThreads())),
         wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f),
         loopname(katana::internal::getLoopName(args)),
         broke(false),
         initTime(loopname, "Init"),
-        execTime(loopname, "Execute") {}
+        execTime(loopname, "Execute"),
+        profiler(internal::getProfiledLoopName(args)) {}
 
   template <typename WArgsTy, size_t... Is>
   ForEachExecutor(
@@ -401,7 +411,8 @@ public:
 
   void operator()() {
     bool isLeader = ThreadPool::isLeader();
-    bool couldAbort = needsAborts && activeThreads > 1;
+    bool couldAbort = needsAborts && getActiveThreads() > 1;
+    profiler.BeginThread();
     if (couldAbort && isLeader)
       go<true, true>();
     else if (couldAbort && !isLeader)
@@ -410,6 +421,7 @@ public:
       go<false, true>();
     else
       go<false, false>();
+    profiler.EndThread();
   }
 };
 
@@ -451,12 +463,12 @@ for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
 
-  auto& barrier = GetBarrier(activeThreads);
+  auto& barrier = GetBarrier(getActiveThreads());
   FuncRefType fn_ref = fn;
   WorkTy W(fn_ref, args);
   W.init(range);
   GetThreadPool().run(
-      activeThreads, [&W, &range]() { W.initThread(range); },
+      getActiveThreads(), [&W, &range]() { W.initThread(range); },
       [&barrier] { barrier.Wait(); }, std::ref(W));
 }
 
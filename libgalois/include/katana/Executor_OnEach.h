@@ -20,6 +20,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORONEACH_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORONEACH_H_
 
+#include "katana/LoopProfiler.h"
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/ThreadPool.h"
 #include "katana/ThreadTimer.h"
@@ -48,6 +49,7 @@ on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
   CondStatTimer<NEEDS_STATS> timer(loopname);
 
   PerThreadTimer<MORE_STATS> execTime(loopname, "Execute");
+  LoopProfiler profiler(getProfiledLoopName(argsTuple));
 
   const auto numT = getActiveThreads();
 
@@ -55,9 +57,11 @@ on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
 
   auto runFun = [&] {
     execTime.start();
+    profiler.BeginThread();
 
     fn_ref(ThreadPool::getTID(), numT);
 
+    profiler.EndThread();
     execTime.stop();
   };
 
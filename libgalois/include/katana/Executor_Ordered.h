@@ -20,20 +20,336 @@
 #ifndef KATANA_LIBGALOIS_KATANA_EXECUTORORDERED_H_
 #define KATANA_LIBGALOIS_KATANA_EXECUTORORDERED_H_
 
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "katana/Context.h"
+#include "katana/Executor_Deterministic.h"
+#include "katana/LoopsDecl.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Range.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/Threads.h"
+#include "katana/Traits.h"
+#include "katana/UserContextAccess.h"
 #include "katana/config.h"
 
 namespace katana {
 
-// TODO(ddn): Pull in and integrate in executors from exp
+namespace internal {
+
+/// Conflict detection for one task of an ordered loop. The tasks of a round
+/// acquire their neighborhoods in parallel. A task that finds a lock held by
+/// an earlier task in the round is not ready; a task that finds a lock held by
+/// a later task steals it and marks the later task not ready. Thus, the
+/// earliest task of a round is always ready.
+template <typename T>
+class OrderedContext : public FirstPassBase {
+public:
+  T item;
+  /// Rank of the task in its round; lower ranks come first
+  size_t id;
+
+  /// Whether the task will run this round
+  bool isSource;
+
+private:
+  bool notReady;
+
+public:
+  OrderedContext(const T& _item, size_t _id)
+      : FirstPassBase(true),
+        item(_item),
+        id(_id),
+        isSource(false),
+        notReady(false) {}
+
+  bool isReady() const { return !notReady; }
+
+  void alwaysAcquire(Lockable* lockable, katana::MethodFlag) override {
+    if (this->tryLock(lockable))
+      this->addToNhood(lockable);
+
+    OrderedContext* other;
+    do {
+      other = static_cast<OrderedContext*>(this->getOwner(lockable));
+      if (other == this)
+        return;
+      if (other && other->id < this->id) {
+        notReady = true;
+        return;
+      }
+    } while (!this->stealByCAS(lockable, other));
+
+    if (other) {
+      // Only need atomic write
+      other->notReady = true;
+    }
+  }
+};
+
+/// Stability test for stable-source algorithms: a ready task can always run.
+template <typename T>
+struct AlwaysStable {
+  bool operator()(const T&) const { return true; }
+};
+
+/// Windowed, speculative executor for ordered loops.
+///
+/// Each round takes the earliest pending tasks (the window), runs their
+/// neighborhood functions in parallel to detect conflicts, and then runs the
+/// operator in parallel on the tasks that are sources: tasks that do not
+/// conflict with an earlier task of the round and that pass the stability
+/// test. The stability test is evaluated for the whole window before any
+/// operator of the round runs. The earliest task of a round is always a source
+/// because new tasks may not be ordered before the task that created them, so
+/// every round makes progress. Other tasks, and any new work, are returned to
+/// the pending set. The window grows while most tasks commit and shrinks when
+/// they conflict.
+///
+/// The pending set is one binary heap per thread. Threads push aborted tasks,
+/// tasks that did not run and new work to their own heap while the round runs,
+/// and the calling thread merges the heaps when it fills the next window,
+/// which costs O(log n) per task in the window. OrderedList is not used
+/// because inserting a new priority into its flat_map moves every later
+/// entry, and Obim only orders by an integer indexer, which the comparator
+/// interface of for_each_ordered does not provide.
+template <
+    typename T, typename Cmp, typename NhFunc, typename OpFunc,
+    typename StableTest>
+class OrderedExecutor {
+  using Context = OrderedContext<T>;
+
+  /// Reverses cmp so that the std heap functions build a min-heap
+  struct HeapCmp {
+    const Cmp& cmp;
+    bool operator()(const T& a, const T& b) const { return cmp(b, a); }
+  };
+
+  static constexpr size_t kMinWindowPerThread = 4;
+  static constexpr size_t kInitialWindowPerThread = 64;
+  static constexpr float kTargetCommitRatio = 0.95;
+
+  const Cmp& cmp_;
+  const NhFunc& nh_func_;
+  const OpFunc& op_func_;
+  const StableTest& stability_test_;
+  const char* loopname_;
+
+  /// Pending tasks, as a heap per thread ordered by HeapCmp
+  PerThreadStorage<std::vector<T>> pending_;
+  std::deque<Context> window_;
+  PerThreadStorage<UserContextAccess<T>> user_contexts_;
+  bool did_break_{false};
+
+  void PushPending(const T& item) {
+    std::vector<T>& heap = *pending_.getLocal();
+    heap.push_back(item);
+    std::push_heap(heap.begin(), heap.end(), HeapCmp{cmp_});
+  }
+
+  bool HasPending() {
+    for (unsigned i = 0; i < pending_.size(); ++i) {
+      if (!pending_.getRemote(i)->empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Move the earliest window_size pending tasks into the window in order,
+  /// merging the per-thread heaps
+  void FillWindow(size_t window_size) {
+    window_.clear();
+    // Threads with pending tasks, as a heap ordered by their earliest task
+    auto later_head = [this](unsigned a, unsigned b) {
+      return cmp_(
+          pending_.getRemote(b)->front(), pending_.getRemote(a)->front());
+    };
+    std::vector<unsigned> heads;
+    for (unsigned i = 0; i < pending_.size(); ++i) {
+      if (!pending_.getRemote(i)->empty()) {
+        heads.push_back(i);
+      }
+    }
+    std::make_heap(heads.begin(), heads.end(), later_head);
+
+    for (size_t i = 0; i < window_size && !heads.empty(); ++i) {
+      std::pop_heap(heads.begin(), heads.end(), later_head);
+      unsigned head = heads.back();
+      std::vector<T>& heap = *pending_.getRemote(head);
+      std::pop_heap(heap.begin(), heap.end(), HeapCmp{cmp_});
+      window_.emplace_back(heap.back(), i);
+      heap.pop_back();
+      if (heap.empty()) {
+        heads.pop_back();
+      } else {
+        std::push_heap(heads.begin(), heads.end(), later_head);
+      }
+    }
+  }
+
+  void AcquireNeighborhood(Context* ctx) {
+    ctx->startIteration();
+    ctx->setFirstPass();
+    setThreadContext(ctx);
+    nh_func_(ctx->item);
+    setThreadContext(nullptr);
+  }
+
+  /// Run the operator on a source. Returns false if the operator aborted, in
+  /// which case the task should be retried.
+  bool Execute(Context* ctx) {
+    UserContextAccess<T>& facing = *user_contexts_.getLocal();
+    ctx->resetFirstPass();
+    facing.resetFirstPass();
+    setThreadContext(ctx);
+
+    int result = 0;
+#ifdef KATANA_USE_LONGJMP_ABORT
+    if ((result = setjmp(execFrame)) == 0) {
+#elif defined(KATANA_USE_EXCEPTION_ABORT)
+    try {
+#endif
+      op_func_(ctx->item, facing.data());
+#ifdef KATANA_USE_LONGJMP_ABORT
+    } else {
+      clearConflictLock();
+    }
+#elif defined(KATANA_USE_EXCEPTION_ABORT)
+    } catch (const ConflictFlag& flag) {
+      clearConflictLock();
+      result = flag;
+    }
+#endif
+    setThreadContext(nullptr);
+
+    switch (result) {
+    case 0:
+      break;
+    case CONFLICT:
+      facing.resetPushBuffer();
+      facing.resetAlloc();
+      return false;
+    default:
+      KATANA_LOG_FATAL("unknown conflict flag");
+      break;
+    }
+
+    for (auto& item : facing.getPushBuffer()) {
+      PushPending(item);
+    }
+    facing.resetPushBuffer();
+    facing.resetAlloc();
+    return true;
+  }
+
+public:
+  OrderedExecutor(
+      const Cmp& cmp, const NhFunc& nh_func, const OpFunc& op_func,
+      const StableTest& stability_test, const char* loopname)
+      : cmp_(cmp),
+        nh_func_(nh_func),
+        op_func_(op_func),
+        stability_test_(stability_test),
+        loopname_(loopname ? loopname : "for_each_ordered") {
+    for (unsigned i = 0; i < getActiveThreads(); ++i) {
+      user_contexts_.getRemote(i)->setBreakFlag(&did_break_);
+    }
+  }
+
+  template <typename Iter>
+  void Run(Iter beg, Iter end) {
+    katana::do_all(
+        katana::iterate(beg, end),
+        [&](const T& item) { pending_.getLocal()->push_back(item); },
+        katana::no_stats());
+    katana::do_all(
+        katana::iterate(0U, pending_.size()),
+        [&](unsigned i) {
+          std::vector<T>& heap = *pending_.getRemote(i);
+          std::make_heap(heap.begin(), heap.end(), HeapCmp{cmp_});
+        },
+        katana::no_stats());
+
+    const size_t min_window = kMinWindowPerThread * getActiveThreads();
+    size_t window_size = kInitialWindowPerThread * getActiveThreads();
+
+    size_t rounds = 0;
+    size_t iterations = 0;
+    size_t conflicts = 0;
+
+    while (HasPending() && !did_break_) {
+      ++rounds;
+      FillWindow(window_size);
+      const size_t num_tasks = window_.size();
+
+      katana::do_all(
+          katana::iterate(size_t{0}, num_tasks),
+          [&](size_t i) { AcquireNeighborhood(&window_[i]); }, katana::steal(),
+          katana::no_stats());
+
+      katana::do_all(
+          katana::iterate(size_t{0}, num_tasks),
+          [&](size_t i) {
+            Context& ctx = window_[i];
+            ctx.isSource =
+                ctx.isReady() && (i == 0 || stability_test_(ctx.item));
+          },
+          katana::no_stats());
+
+      GAccumulator<size_t> committed;
+      katana::do_all(
+          katana::iterate(size_t{0}, num_tasks),
+          [&](size_t i) {
+            Context& ctx = window_[i];
+            if (ctx.isSource && Execute(&ctx)) {
+              committed += 1;
+            } else {
+              PushPending(ctx.item);
+            }
+            // Locks are only looked at while acquiring neighborhoods, so
+            // they can be released as soon as each task is done
+            ctx.commitIteration();
+          },
+          katana::steal(), katana::no_stats());
+
+      size_t num_committed = committed.reduce();
+      iterations += num_committed;
+      conflicts += num_tasks - num_committed;
+
+      float commit_ratio = num_committed / static_cast<float>(num_tasks);
+      if (commit_ratio >= kTargetCommitRatio) {
+        window_size *= 2;
+      } else {
+        window_size = std::max(
+            min_window, static_cast<size_t>(
+                            window_size * commit_ratio / kTargetCommitRatio));
+      }
+    }
+
+    window_.clear();
+
+    ReportStatSingle(loopname_, "Iterations", iterations);
+    ReportStatSingle(loopname_, "Conflicts", conflicts);
+    ReportStatSingle(loopname_, "Rounds", rounds);
+  }
+};
+
+}  // namespace internal
 
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
 void
 for_each_ordered_impl(
-    [[maybe_unused]] Iter beg, [[maybe_unused]] Iter end,
-    [[maybe_unused]] const Cmp& cmp, [[maybe_unused]] const NhFunc& nhFunc,
-    [[maybe_unused]] const OpFunc& opFunc,
-    [[maybe_unused]] const char* loopname) {
-  KATANA_DIE("not yet implemented");
+    Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc,
+    const OpFunc& opFunc, const char* loopname) {
+  using T = typename std::iterator_traits<Iter>::value_type;
+  internal::AlwaysStable<T> stabilityTest;
+  internal::OrderedExecutor<T, Cmp, NhFunc, OpFunc, internal::AlwaysStable<T>>
+      executor(cmp, nhFunc, opFunc, stabilityTest, loopname);
+  executor.Run(beg, end);
 }
 
 template <
@@ -41,12 +357,13 @@ template <
     typename StableTest>
 void
 for_each_ordered_impl(
-    [[maybe_unused]] Iter beg, [[maybe_unused]] Iter end,
-    [[maybe_unused]] const Cmp& cmp, [[maybe_unused]] const NhFunc& nhFunc,
-    [[maybe_unused]] const OpFunc& opFunc,
-    [[maybe_unused]] const StableTest& stabilityTest,
-    [[maybe_unused]] const char* loopname) {
-  KATANA_DIE("not yet implemented");
+    Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc,
+    const OpFunc& opFunc, const StableTest& stabilityTest,
+    const char* loopname) {
+  using T = typename std::iterator_traits<Iter>::value_type;
+  internal::OrderedExecutor<T, Cmp, NhFunc, OpFunc, StableTest> executor(
+      cmp, nhFunc, opFunc, stabilityTest, loopname);
+  executor.Run(beg, end);
 }
 
 }  // end namespace katana
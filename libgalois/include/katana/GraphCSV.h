@@ -0,0 +1,52 @@
+#ifndef KATANA_LIBGALOIS_KATANA_GRAPHCSV_H_
+#define KATANA_LIBGALOIS_KATANA_GRAPHCSV_H_
+
+#include <string>
+
+#include "katana/BuildGraph.h"
+
+namespace katana {
+
+struct KATANA_EXPORT CSVImportOptions {
+  /// Separator of the fields of a line
+  char delimiter{','};
+  /// Separator of the labels in a :LABEL field
+  char array_delimiter{';'};
+  /// Number of byte ranges each file is split into for parsing; 0 picks a
+  /// few per thread
+  size_t num_chunks{0};
+};
+
+/// ConvertCSV converts a node file and an edge file in the CSV format of
+/// neo4j-admin import into katana form.
+///
+/// The first line of each file is a header of "name:type" fields. The node
+/// file has one ":ID" field and optionally a ":LABEL" field; the edge file
+/// has ":START_ID" and ":END_ID" fields and optionally a ":TYPE" field.
+/// Other fields are properties of type int, long, float, double, boolean or
+/// string (the default); other types are read as strings. Empty fields are
+/// null. Fields may be quoted, with quotes escaped by doubling, but must not
+/// contain line breaks. Edges to node ids that are not in the node file
+/// create nodes without properties.
+///
+/// Files are mapped into memory and split into byte ranges at line breaks.
+/// The ranges are parsed in parallel into per-range arrow builders, string
+/// node ids are resolved with a map built in parallel by shard, and edges
+/// are put in CSR order with a parallel counting sort that keeps the edges
+/// of each node in file order.
+///
+/// The topology has 32-bit node ids, so graphs with more than 2^32 - 1
+/// nodes, counting the ones created for edges, are rejected with
+/// ErrorCode::NotImplemented.
+///
+/// \param nodes_filename Path to the node file
+/// \param edges_filename Path to the edge file
+/// \returns A collection of Arrow tables of node properties/labels, edge
+///     properties/types, and CSR topology
+KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertCSV(
+    const std::string& nodes_filename, const std::string& edges_filename,
+    const CSVImportOptions& opts = CSVImportOptions());
+
+}  // end namespace katana
+
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "katana/LC_CSR_CSC_Graph.h"
+#include "katana/Threads.h"
 
 namespace katana {
 
@@ -588,7 +589,7 @@ private:
 
     // ordered map
     std::map<EdgeTy, uint32_t> sortedMap;
-    for (uint32_t i = 0; i < katana::activeThreads; ++i) {
+    for (uint32_t i = 0; i < katana::getActiveThreads(); ++i) {
       auto& edgeLabelsSet = *edgeLabels.getRemote(i);
       for (auto edgeLabel : edgeLabelsSet) {
         sortedMap[edgeLabel] = 1;
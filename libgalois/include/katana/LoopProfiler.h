@@ -0,0 +1,130 @@
+#ifndef KATANA_LIBGALOIS_KATANA_LOOPPROFILER_H_
+#define KATANA_LIBGALOIS_KATANA_LOOPPROFILER_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "katana/Traits.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Turns profiling of named loops on or off. Profiling is off unless the
+/// environment variable KATANA_PROFILE_LOOPS is set to a true value.
+///
+/// When profiling is on, every do_all, for_each and on_each with a loopname
+/// reports the following statistics of each thread to the StatManager under
+/// the loop name:
+///
+///   BusyTime, StealTime, IdleTime: microseconds a thread spent running
+///     iterations, looking for work in other threads' queues, and waiting
+///     for the other threads (for termination, at barriers, or for the loop
+///     to end after running out of work)
+///   Cycles, Instructions, LLCMisses, DTLBMisses, RemoteMemoryAccesses:
+///     hardware events counted with Linux perf_event_open, without PAPI.
+///     Events the machine or the permissions of the process
+///     (/proc/sys/kernel/perf_event_paranoid) do not allow are omitted.
+///
+/// Set PRINT_PER_THREAD_STATS to print the values of each thread in addition
+/// to their sum.
+KATANA_EXPORT void SetLoopProfiling(bool enabled);
+KATANA_EXPORT bool IsLoopProfilingEnabled();
+
+namespace internal {
+
+/// Hardware events counted for loops; see SetLoopProfiling
+constexpr size_t kNumHWCounters = 5;
+
+struct HWCounterValues {
+  std::array<uint64_t, kNumHWCounters> values{};
+  /// Bit i is set if values[i] was counted
+  uint32_t valid{0};
+};
+
+/// Reads the hardware counters of the calling thread, opening them on first
+/// use. Returns false if no counter could be opened.
+KATANA_EXPORT bool ReadHWCounters(HWCounterValues* out);
+
+/// Name of hardware counter i as reported in statistics
+KATANA_EXPORT const char* HWCounterName(size_t i);
+
+/// The name to profile a loop with arguments args under, or null if the loop
+/// has no loopname and should not be profiled
+template <typename ArgsTy>
+const char*
+getProfiledLoopName(const ArgsTy& args) {
+  if constexpr (has_trait<loopname_tag, ArgsTy>()) {
+    return getLoopName(args);
+  } else {
+    return nullptr;
+  }
+}
+
+/// LoopProfiler collects the profile of one loop. The executor constructs it
+/// before running the loop, and each thread of the loop calls BeginThread()
+/// and EndThread() around its share of the loop and BeginPhase() and
+/// EndPhase() around time it spends looking for or waiting for work. The
+/// destructor reports the statistics, so it must run outside of the loop on
+/// the thread that started it. While the StatManager records a timeline, the
+/// time each thread spent in the loop is added to it as well.
+///
+/// All calls do nothing unless a loop name is given and profiling or the
+/// timeline is on.
+class KATANA_EXPORT LoopProfiler {
+public:
+  enum Phase { kBusy, kSteal, kWait };
+
+private:
+  struct ThreadProfile;
+  struct State;
+
+  std::unique_ptr<State> state_;
+
+  void DoBeginThread();
+  void DoEndThread();
+  void DoBeginPhase();
+  void DoEndPhase(Phase phase);
+
+public:
+  explicit LoopProfiler(const char* loopname);
+  ~LoopProfiler();
+
+  LoopProfiler(const LoopProfiler&) = delete;
+  LoopProfiler& operator=(const LoopProfiler&) = delete;
+  LoopProfiler(LoopProfiler&&) = delete;
+  LoopProfiler& operator=(LoopProfiler&&) = delete;
+
+  bool enabled() const { return state_ != nullptr; }
+
+  void BeginThread() {
+    if (state_) {
+      DoBeginThread();
+    }
+  }
+  void EndThread() {
+    if (state_) {
+      DoEndThread();
+    }
+  }
+
+  /// Marks the start of a stretch of time of the calling thread
+  void BeginPhase() {
+    if (state_) {
+      DoBeginPhase();
+    }
+  }
+  /// Accounts the time since BeginPhase() to phase; busy time is whatever is
+  /// not accounted to another phase
+  void EndPhase(Phase phase) {
+    if (state_) {
+      DoEndPhase(phase);
+    }
+  }
+};
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
@@ -94,9 +94,17 @@ on_each(FunctionTy&& fn, Args&&... args) {
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item
  * is a value from the iteration range and T is the type of item. Comparison
  * function should conform to <code>bool r = cmp(item1, item2)</code> where r is
- * true if item1 is less than or equal to item2. Neighborhood function should
- * conform to <code>nhFunc(item)</code> and should visit every element in the
- * neighborhood of active element item.
+ * true if item1 must be processed before item2; it must be a strict weak
+ * ordering. Neighborhood function should conform to <code>nhFunc(item)</code>
+ * and should acquire every element in the neighborhood of active element
+ * item. Items pushed by the operator may not be ordered before the item that
+ * pushed them. In a stable source algorithm, an item that conflicts with no
+ * earlier item can always be processed, i.e., processing other items never
+ * creates new items that come before it and conflict with it.
+ *
+ * Items run in parallel in rounds. Threads queue pending items on their own,
+ * but one thread merges the queues to pick the items of each round, so
+ * operators that do very little work per item will not scale.
  *
  * @param b begining of range of initial items
  * @param e end of range of initial items
@@ -119,11 +127,14 @@ for_each_ordered(
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item
  * is a value from the iteration range and T is the type of item. Comparison
  * function should conform to <code>bool r = cmp(item1, item2)</code> where r is
- * true if item1 is less than or equal to item2. Neighborhood function should
- * conform to <code>nhFunc(item)</code> and should visit every element in the
- * neighborhood of active element item. The stability test should conform to
+ * true if item1 must be processed before item2; it must be a strict weak
+ * ordering. Neighborhood function should conform to <code>nhFunc(item)</code>
+ * and should acquire every element in the neighborhood of active element
+ * item. Items pushed by the operator may not be ordered before the item that
+ * pushed them. The stability test should conform to
  * <code>bool r = stabilityTest(item)</code> where r is true if item is a stable
- * source.
+ * source, i.e., no item still to be created can come before it and conflict
+ * with it. The stability test is not called concurrently with the operator.
  *
  * @param b begining of range of initial items
  * @param e end of range of initial items
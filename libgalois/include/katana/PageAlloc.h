@@ -29,7 +29,8 @@ namespace katana {
 // size of pages
 KATANA_EXPORT size_t allocSize();
 
-// allocate contiguous pages, optionally faulting them in
+// allocate contiguous zeroed pages, optionally faulting them in. Single pages
+// come from arenas local to the NUMA node of the calling thread.
 KATANA_EXPORT void* allocPages(unsigned num, bool preFault);
 
 // free page range
@@ -205,6 +205,18 @@ struct partition_helper {
       }
       Lock.unlock();
     }
+    /// Partition what the threads left out of place once they are all done.
+    /// Taken low blocks end where first and last meet, and taken high blocks
+    /// begin there. Completed low blocks only hold elements that satisfy pred
+    /// and completed high blocks only elements that do not. Completed blocks
+    /// can still lie between a partial block and the meeting point (e.g., a
+    /// thread completed its low and high blocks together and recorded
+    /// nothing), so the range spans the partial blocks and the meeting point.
+    RandomAccessIterator finish() {
+      rfirst = std::min(rfirst, first);
+      rlast = std::max(rlast, last);
+      return std::partition(rfirst, rlast, pred);
+    }
   };
 
   partition_helper(partition_helper_state* s) : state(s) {}
@@ -236,11 +248,7 @@ partition(
   typedef partition_helper<RandomAccessIterator, Predicate> P;
   typename P::partition_helper_state s(first, last, pred);
   on_each(P(&s));
-  if (s.rfirst == first && s.rlast == last) {  // perfect !
-    // abort();
-    return s.first;
-  }
-  return std::partition(s.rfirst, s.rlast, pred);
+  return s.finish();
 }
 
 struct pair_dist {
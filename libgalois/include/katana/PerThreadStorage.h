@@ -70,11 +70,22 @@ public:
 
   unsigned allocOffset(unsigned size);
   void deallocOffset(unsigned offset, unsigned size);
-  void* getRemote(unsigned thread, unsigned offset);
+  //! thread is a thread id of the partition of the calling thread, if any
+  void* getRemote(unsigned thread, unsigned offset) {
+    return getPoolRemote(ThreadPool::getPoolTID(thread), offset);
+  }
+  //! like getRemote but thread is a thread id of the whole pool
+  void* getPoolRemote(unsigned thread, unsigned offset);
   void* getLocal(unsigned offset, char* base) { return &base[offset]; }
   // faster when (1) you already know the id and (2) shared access to heads is
   // not to expensive; otherwise use getLocal(unsigned,char*)
-  void* getLocal(unsigned offset, unsigned id) { return &heads[id][offset]; }
+  void* getLocal(unsigned offset, unsigned id) {
+    return &heads[ThreadPool::getPoolTID(id)][offset];
+  }
+  //! return the storage of thread of the whole pool
+  char* getPoolBase(unsigned thread) {
+    return static_cast<char*>(getPoolRemote(thread, 0));
+  }
 };
 
 extern thread_local char* ptsBase;
@@ -95,8 +106,8 @@ class PerThreadStorage {
       return;
     }
 
-    for (unsigned n = 0; n < GetThreadPool().getMaxThreads(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(n, offset))->~T();
+    for (unsigned n = 0; n < GetThreadPool().getMaxPoolThreads(); ++n) {
+      reinterpret_cast<T*>(b->getPoolRemote(n, offset))->~T();
     }
     b->deallocOffset(offset, sizeof(T));
     offset = ~0U;
@@ -141,8 +152,8 @@ public:
     auto& tp = GetThreadPool();
 
     offset = b->allocOffset(sizeof(T));
-    for (unsigned n = 0; n < tp.getMaxThreads(); ++n) {
-      new (b->getRemote(n, offset)) T(std::forward<Args>(args)...);
+    for (unsigned n = 0; n < tp.getMaxPoolThreads(); ++n) {
+      new (b->getPoolRemote(n, offset)) T(std::forward<Args>(args)...);
     }
   }
 
@@ -212,8 +223,9 @@ class PerSocketStorage {
 
   void destruct() {
     auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(tp.getLeaderForSocket(n), offset))
+    for (unsigned n = 0; n < tp.getMaxPoolSockets(); ++n) {
+      reinterpret_cast<T*>(
+          b->getPoolRemote(tp.getPoolLeaderForSocket(n), offset))
           ->~T();
     }
     b->deallocOffset(offset, sizeof(T));
@@ -228,8 +240,8 @@ public:
 
     offset = b->allocOffset(sizeof(T));
     auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      new (b->getRemote(tp.getLeaderForSocket(n), offset))
+    for (unsigned n = 0; n < tp.getMaxPoolSockets(); ++n) {
+      new (b->getPoolRemote(tp.getPoolLeaderForSocket(n), offset))
           T(std::forward<Args>(args)...);
     }
   }
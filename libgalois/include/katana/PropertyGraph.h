@@ -1,7 +1,12 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 
+#include <algorithm>
 #include <bitset>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -20,9 +25,20 @@ namespace katana {
 
 /// A graph topology represents the adjacency information for a graph in CSR
 /// format.
-struct KATANA_EXPORT GraphTopology {
-  using Node = uint32_t;
+///
+/// A topology may optionally carry an in-edge (CSC) index over the same edges
+/// (see PropertyGraph::ConstructInEdges). In-edges have their own ids; use
+/// in_edge_to_out_edge to find the out-edge id of an in-edge in order to look
+/// up edge properties.
+///
+/// NodeT is the type of node ids: GraphTopology has 32-bit ids, which halve
+/// the size of the destination arrays, and is used whenever the number of
+/// nodes allows; WideGraphTopology has 64-bit ids.
+template <typename NodeT>
+struct KATANA_EXPORT BasicGraphTopology {
+  using Node = NodeT;
   using Edge = uint64_t;
+  using NodeArray = typename arrow::CTypeTraits<NodeT>::ArrayType;
   using node_iterator = boost::counting_iterator<Node>;
   using edge_iterator = boost::counting_iterator<Edge>;
   using nodes_range = StandardRange<node_iterator>;
@@ -30,13 +46,20 @@ struct KATANA_EXPORT GraphTopology {
   using iterator = node_iterator;
 
   std::shared_ptr<arrow::UInt64Array> out_indices;
-  std::shared_ptr<arrow::UInt32Array> out_dests;
+  std::shared_ptr<NodeArray> out_dests;
+
+  /// in_indices[n] is one past the last in-edge of node n
+  std::shared_ptr<arrow::UInt64Array> in_indices;
+  /// in_sources[e] is the source of in-edge e
+  std::shared_ptr<NodeArray> in_sources;
+  /// in_to_out_edges[e] is the out-edge id of in-edge e
+  std::shared_ptr<arrow::UInt64Array> in_to_out_edges;
 
   uint64_t num_nodes() const { return out_indices ? out_indices->length() : 0; }
 
   uint64_t num_edges() const { return out_dests ? out_dests->length() : 0; }
 
-  bool Equals(const GraphTopology& other) const {
+  bool Equals(const BasicGraphTopology& other) const {
     return out_indices->Equals(*other.out_indices) &&
            out_dests->Equals(*other.out_dests);
   }
@@ -74,6 +97,31 @@ struct KATANA_EXPORT GraphTopology {
     return MakeStandardRange<node_iterator>(begin, end);
   }
 
+  // In-edge accessors; only valid if has_in_edges()
+
+  bool has_in_edges() const { return in_indices != nullptr; }
+
+  /// Gets the in-edge range of some node.
+  ///
+  /// \param node node to get the in-edge range of
+  /// \returns iterable in-edge range for node.
+  edges_range in_edges(Node node) const {
+    KATANA_LOG_DEBUG_ASSERT(has_in_edges());
+    auto edge_start = node > 0 ? in_indices->Value(node - 1) : 0;
+    auto edge_end = in_indices->Value(node);
+    return MakeStandardRange<edge_iterator>(edge_start, edge_end);
+  }
+
+  Node in_edge_source(Edge in_eid) const {
+    KATANA_LOG_ASSERT(in_eid < static_cast<Edge>(in_sources->length()));
+    return in_sources->Value(in_eid);
+  }
+
+  Edge in_edge_to_out_edge(Edge in_eid) const {
+    KATANA_LOG_ASSERT(in_eid < static_cast<Edge>(in_to_out_edges->length()));
+    return in_to_out_edges->Value(in_eid);
+  }
+
   // Standard container concepts
 
   node_iterator begin() const { return node_iterator(0); }
@@ -85,6 +133,9 @@ struct KATANA_EXPORT GraphTopology {
   bool empty() const { return num_nodes() == 0; }
 };
 
+using GraphTopology = BasicGraphTopology<uint32_t>;
+using WideGraphTopology = BasicGraphTopology<uint64_t>;
+
 /// A property graph is a graph that has properties associated with its nodes
 /// and edges. A property has a name and value. Its value may be a primitive
 /// type, a list of values or a composition of properties.
@@ -125,6 +176,130 @@ public:
   using Node = GraphTopology::Node;
   using Edge = GraphTopology::Edge;
 
+  /// TypeIndexRange is a range over part of a type index: an array of node or
+  /// edge ids that is grouped by TypeSetID in increasing TypeSetID order. It
+  /// yields the ids whose TypeSetID is in a given set, skipping the groups of
+  /// other TypeSetIDs with a binary search.
+  ///
+  /// The index may store ids as Offsets from a base id, which keeps it
+  /// smaller than the ids themselves. Without an index, the range yields the
+  /// ids of its positions, which must then already be grouped by TypeSetID.
+  template <typename Id, typename Offset = Id>
+  class TypeIndexRange {
+  public:
+    class iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = Id;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const Id*;
+      using reference = Id;
+
+      iterator() = default;
+
+      reference operator*() const { return IdAt(pos_); }
+
+      iterator& operator++() {
+        ++pos_;
+        SkipUnwanted();
+        return *this;
+      }
+
+      iterator operator++(int) {
+        iterator tmp = *this;
+        ++*this;
+        return tmp;
+      }
+
+      bool operator==(const iterator& other) const {
+        return pos_ == other.pos_;
+      }
+      bool operator!=(const iterator& other) const {
+        return pos_ != other.pos_;
+      }
+
+    private:
+      friend class TypeIndexRange;
+
+      iterator(
+          const Offset* index, Id base, uint64_t pos, uint64_t end,
+          const TypeSetID* type_set_ids, const SetOfTypeSetIDs* wanted)
+          : index_(index),
+            base_(base),
+            pos_(pos),
+            end_(end),
+            type_set_ids_(type_set_ids),
+            wanted_(wanted) {
+        SkipUnwanted();
+      }
+
+      Id IdAt(uint64_t pos) const {
+        return index_ ? base_ + index_[pos] : static_cast<Id>(pos);
+      }
+
+      void SkipUnwanted() {
+        if (wanted_ == nullptr) {
+          return;
+        }
+        while (pos_ != end_ && !wanted_->test(type_set_ids_[IdAt(pos_)])) {
+          // Skip to the first position with a greater TypeSetID
+          TypeSetID type_set_id = type_set_ids_[IdAt(pos_)];
+          uint64_t lo = pos_ + 1;
+          uint64_t hi = end_;
+          while (lo < hi) {
+            uint64_t mid = lo + (hi - lo) / 2;
+            if (type_set_ids_[IdAt(mid)] <= type_set_id) {
+              lo = mid + 1;
+            } else {
+              hi = mid;
+            }
+          }
+          pos_ = lo;
+        }
+      }
+
+      const Offset* index_{nullptr};
+      Id base_{0};
+      uint64_t pos_{0};
+      uint64_t end_{0};
+      const TypeSetID* type_set_ids_{nullptr};
+      const SetOfTypeSetIDs* wanted_{nullptr};
+    };
+
+    TypeIndexRange() = default;
+
+    /// \param index the type index, whose entries at positions [begin, end)
+    ///   are offsets from base; nullptr yields the positions themselves
+    /// \param wanted the TypeSetIDs to yield; nullptr yields every id in
+    ///   the range
+    TypeIndexRange(
+        const Offset* index, Id base, uint64_t begin, uint64_t end,
+        const TypeSetID* type_set_ids, const SetOfTypeSetIDs* wanted)
+        : index_(index),
+          base_(base),
+          begin_(begin),
+          end_(end),
+          type_set_ids_(type_set_ids),
+          wanted_(wanted) {}
+
+    iterator begin() const {
+      return iterator(index_, base_, begin_, end_, type_set_ids_, wanted_);
+    }
+    iterator end() const {
+      return iterator(index_, base_, end_, end_, nullptr, nullptr);
+    }
+
+    bool empty() const { return begin() == end(); }
+
+  private:
+    const Offset* index_{nullptr};
+    Id base_{0};
+    uint64_t begin_{0};
+    uint64_t end_{0};
+    const TypeSetID* type_set_ids_{nullptr};
+    const SetOfTypeSetIDs* wanted_{nullptr};
+  };
+
 private:
   PropertyGraph(std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg);
 
@@ -136,12 +311,20 @@ private:
   Result<void> WriteGraph(
       const std::string& uri, const std::string& command_line);
 
-  tsuba::RDG rdg_;
+  // mutable so that unloaded properties can be fetched by const accessors,
+  // which hold load_mutex_ while they look at or load properties
+  mutable tsuba::RDG rdg_;
+  // A unique_ptr to keep PropertyGraph movable
+  std::unique_ptr<std::mutex> load_mutex_{std::make_unique<std::mutex>()};
   std::unique_ptr<tsuba::RDGFile> file_;
 
   // The topology is either backed by rdg_ or shared with the
   // caller of SetTopology.
   GraphTopology topology_;
+  /// Used instead of topology_ for graphs with more than 2^32 - 1 nodes
+  WideGraphTopology wide_topology_;
+
+  bool compress_topology_{false};
 
   /// A map from the node TypeSetID to
   /// the set of the node type names it contains
@@ -162,6 +345,32 @@ private:
   /// The edge TypeSetID for each edge in the graph
   katana::LargeArray<TypeSetID> edge_type_set_id_;
 
+  /// The type index of nodes: all nodes grouped by TypeSetID, in increasing
+  /// order within each group
+  katana::LargeArray<Node> nodes_by_type_set_id_;
+  /// Group i of nodes_by_type_set_id_ is
+  /// [node_type_set_id_offsets_[i], node_type_set_id_offsets_[i + 1])
+  std::vector<uint64_t> node_type_set_id_offsets_;
+  /// The type index of out-edges: the out-edge range of each node holds the
+  /// offsets of its out-edges from its first out-edge, grouped by TypeSetID
+  /// and in increasing order within each group. It is left empty when the
+  /// out-edges of every node are already grouped, such as when all edges
+  /// have one TypeSetID.
+  katana::LargeArray<uint32_t> out_edges_by_type_set_id_;
+  /// Whether OutEdgesOfType and OutEdgesOfTypeSetID can be answered: false
+  /// before the type indexes are built, and if a node has too many out-edges
+  /// for 32-bit offsets
+  bool has_out_edge_type_index_{false};
+
+  /// Build the type indexes from the TypeSetIDs in parallel. Type indexes
+  /// hold 32-bit node ids, so graphs with wide node ids are not supported.
+  Result<void> BuildTypeIndexes();
+  void ClearTypeIndexes();
+
+  /// Load the unloaded properties that ConstructTypeSetIDs treats as types,
+  /// leaving other properties in storage
+  Result<void> EnsureTypePropertiesLoaded() const;
+
   // Keep partition_metadata, master_nodes, mirror_nodes out of the public interface,
   // while allowing Distribution to read/write it for RDG
   friend class Distribution;
@@ -207,8 +416,7 @@ public:
     std::shared_ptr<arrow::Schema> (PropertyGraph::*schema_fn)() const;
     std::shared_ptr<arrow::ChunkedArray> (PropertyGraph::*property_fn)(
         int i) const;
-    const std::shared_ptr<arrow::Table>& (
-        PropertyGraph::*properties_fn)() const;
+    std::shared_ptr<arrow::Table> (PropertyGraph::*properties_fn)() const;
     Result<void> (PropertyGraph::*add_properties_fn)(
         const std::shared_ptr<arrow::Table>& props);
     Result<void> (PropertyGraph::*upsert_properties_fn)(
@@ -222,7 +430,7 @@ public:
       return (g->*property_fn)(i);
     }
 
-    const std::shared_ptr<arrow::Table>& properties() const {
+    std::shared_ptr<arrow::Table> properties() const {
       return (g->*properties_fn)();
     }
 
@@ -260,8 +468,9 @@ public:
       const std::string& rdg_name,
       const tsuba::RDGLoadOptions& opts = tsuba::RDGLoadOptions());
 
-  /// \return A copy of this with the same set of properties. The copy shares no
-  ///       state with this.
+  /// \return A copy of this with the same set of properties, including
+  ///       unloaded ones, which are loaded first. The copy shares no state
+  ///       with this.
   Result<std::unique_ptr<PropertyGraph>> Copy() const;
 
   /// \param node_properties The node properties to copy.
@@ -274,7 +483,8 @@ public:
 
   /// Construct node & edge TypeSetIDs from node & edge properties
   /// Also constructs metadata to convert between types and TypeSetIDs
-  /// Assumes all boolean or uint8 properties are types
+  /// Assumes all boolean or uint8 properties are types. Unloaded properties
+  /// are loaded first so that none of the types are missed.
   /// TODO(roshan) move this to be a part of Make()
   Result<void> ConstructTypeSetIDs();
 
@@ -333,6 +543,31 @@ public:
   /// Like \ref Write(const std::string&, const std::string&) but can only update
   /// parts of the original read location of the graph.
   Result<void> Commit(const std::string& command_line);
+
+  /// If \param compress is true, Write and Commit store the topology in the
+  /// compressed format (see tsuba/CSRTopology.h), rewriting a stored
+  /// uncompressed topology. Compressed topologies are decoded when a graph is
+  /// loaded, so compression saves storage and I/O but not memory. The default
+  /// is false; a topology already stored compressed is kept as is.
+  void set_compress_topology(bool compress) { compress_topology_ = compress; }
+
+  /// Statistics of the topology and types of this graph: degree histograms,
+  /// maximum degrees, sortedness, self loops, duplicate edges and the number
+  /// of nodes and edges of each type.
+  ///
+  /// Statistics are computed when the graph is written and are available
+  /// right after it is loaded. They are nullopt if the graph was stored
+  /// before statistics were recorded or if its topology has been replaced
+  /// since. edges_sorted is not updated by sorting edges in place, so it may
+  /// be false for sorted edges but never true for unsorted ones.
+  const std::optional<tsuba::GraphStatistics>& statistics() const {
+    return rdg_.statistics();
+  }
+
+  /// Compute the statistics of the current topology and types in parallel,
+  /// replacing any loaded ones
+  void ComputeStatistics();
+
   /// Tell the RDG where it's data is coming from
   Result<void> InformPath(const std::string& input_path);
 
@@ -360,19 +595,47 @@ public:
   }
 
   /// \returns true if a node type with @param name exists
-  /// NB: no node may have this type
-  /// TODO(roshan) build an index for the number of nodes with the type
+  /// NB: no node may have this type; see NumNodesOfType
   bool HasNodeType(const std::string& name) const {
     return node_type_name_to_type_set_ids_.count(name) == 1;
   }
 
   /// \returns true if an edge type with @param name exists
   /// NB: no edge may have this type
-  /// TODO(roshan) build an index for the number of edges with the type
   bool HasEdgeType(const std::string& name) const {
     return edge_type_name_to_type_set_ids_.count(name) == 1;
   }
 
+  //
+  // Type indexes. They are built by ConstructTypeSetIDs and are empty before
+  // it is called, and always for graphs with wide node ids; out-edge ranges
+  // are also empty if a node has 2^32 or more out-edges. Iterating over
+  // the ids of a type takes time proportional to their number rather than to
+  // the number of nodes or out-edges.
+  //
+
+  /// \returns the nodes whose TypeSetID is @param type_set_id in increasing
+  /// order
+  TypeIndexRange<Node> NodesOfTypeSetID(TypeSetID type_set_id) const;
+
+  /// \returns the nodes that have the type @param name. Nodes are grouped
+  /// by TypeSetID and are in increasing order within each group.
+  TypeIndexRange<Node> NodesOfType(const std::string& name) const;
+
+  /// \returns the number of nodes that have the type @param name
+  uint64_t NumNodesOfType(const std::string& name) const;
+
+  /// \returns the out-edges of @param node whose TypeSetID is
+  /// @param type_set_id in increasing order
+  TypeIndexRange<Edge, uint32_t> OutEdgesOfTypeSetID(
+      Node node, TypeSetID type_set_id) const;
+
+  /// \returns the out-edges of @param node that have the type @param name.
+  /// Edges are grouped by TypeSetID and are in increasing order within each
+  /// group.
+  TypeIndexRange<Edge, uint32_t> OutEdgesOfType(
+      Node node, const std::string& name) const;
+
   /// \returns the set of node TypeSetIDs that contain
   /// the node type with @param name
   /// (assumes that the node type exists)
@@ -425,6 +688,22 @@ public:
     return edge_type_set_id_[edge];
   }
 
+  /// \returns the node TypeSetIDs indexed by node, or nullptr if the node
+  /// types have not been constructed. Changing the topology or the types
+  /// invalidates the pointer.
+  const TypeSetID* node_type_set_ids() const {
+    return node_type_set_id_.size() == num_nodes() ? node_type_set_id_.data()
+                                                   : nullptr;
+  }
+
+  /// \returns the edge TypeSetIDs indexed by edge, or nullptr if the edge
+  /// types have not been constructed. Changing the topology or the types
+  /// invalidates the pointer.
+  const TypeSetID* edge_type_set_ids() const {
+    return edge_type_set_id_.size() == num_edges() ? edge_type_set_id_.data()
+                                                   : nullptr;
+  }
+
   // Return type dictated by arrow
   int32_t GetNodePropertyNum() const {
     return node_properties()->num_columns();
@@ -435,49 +714,106 @@ public:
 
   // num_rows() == num_nodes() (all local nodes)
   std::shared_ptr<arrow::ChunkedArray> GetNodeProperty(int i) const {
-    if (i >= rdg_.node_properties()->num_columns()) {
+    std::shared_ptr<arrow::Table> props = node_properties();
+    if (i < 0 || i >= props->num_columns()) {
       return nullptr;
     }
-    return node_properties()->column(i);
+    return props->column(i);
   }
 
   // num_rows() == num_edges() (all local edges)
   std::shared_ptr<arrow::ChunkedArray> GetEdgeProperty(int i) const {
-    if (i >= edge_properties()->num_columns()) {
+    std::shared_ptr<arrow::Table> props = edge_properties();
+    if (i < 0 || i >= props->num_columns()) {
       return nullptr;
     }
-    return edge_properties()->column(i);
+    return props->column(i);
   }
 
-  /// \returns true if a node property/type with @param name exists
+  /// \returns true if a node property/type with @param name exists, whether
+  /// or not it is loaded
   bool HasNodeProperty(const std::string& name) const {
-    return node_properties()->schema()->GetFieldIndex(name) != -1;
+    std::lock_guard<std::mutex> lock(*load_mutex_);
+    return rdg_.node_properties()->schema()->GetFieldIndex(name) != -1 ||
+           rdg_.HasUnloadedNodeProperty(name);
   }
 
-  /// \returns true if an edge property/type with @param name exists
+  /// \returns true if an edge property/type with @param name exists, whether
+  /// or not it is loaded
   bool HasEdgeProperty(const std::string& name) const {
-    return edge_properties()->schema()->GetFieldIndex(name) != -1;
+    std::lock_guard<std::mutex> lock(*load_mutex_);
+    return rdg_.edge_properties()->schema()->GetFieldIndex(name) != -1 ||
+           rdg_.HasUnloadedEdgeProperty(name);
   }
 
-  /// Get a node property by name.
+  /// Get a node property by name. If the graph was made with
+  /// RDGLoadOptions::lazy_load_properties and the property is not loaded yet,
+  /// it is loaded from storage first. Concurrent calls, also with the other
+  /// const property accessors, are safe, but not calls concurrent with
+  /// changes to the properties.
+  ///
+  /// \param name The name of the property to get.
+  /// \return The property data, PropertyNotFound if there is no such
+  ///     property, or the error from loading it.
+  Result<std::shared_ptr<arrow::ChunkedArray>> LoadNodeProperty(
+      const std::string& name) const;
+  Result<std::shared_ptr<arrow::ChunkedArray>> LoadEdgeProperty(
+      const std::string& name) const;
+
+  /// Get a node property by name like LoadNodeProperty.
   ///
   /// \param name The name of the property to get.
-  /// \return The property data or NULL if the property is not found.
+  /// \return The property data or NULL if the property is not found or
+  ///     could not be loaded; use LoadNodeProperty to tell these apart.
   std::shared_ptr<arrow::ChunkedArray> GetNodeProperty(
-      const std::string& name) const {
-    return node_properties()->GetColumnByName(name);
-  }
+      const std::string& name) const;
+  /// \returns the names of the loaded node properties
   std::vector<std::string> GetNodePropertyNames() const {
     return node_properties()->ColumnNames();
   }
+  /// \returns the names of node properties in storage that are not loaded
+  std::vector<std::string> GetUnloadedNodePropertyNames() const {
+    std::lock_guard<std::mutex> lock(*load_mutex_);
+    return rdg_.unloaded_node_property_names();
+  }
 
   std::shared_ptr<arrow::ChunkedArray> GetEdgeProperty(
-      const std::string& name) const {
-    return edge_properties()->GetColumnByName(name);
-  }
+      const std::string& name) const;
   std::vector<std::string> GetEdgePropertyNames() const {
     return edge_properties()->ColumnNames();
   }
+  std::vector<std::string> GetUnloadedEdgePropertyNames() const {
+    std::lock_guard<std::mutex> lock(*load_mutex_);
+    return rdg_.unloaded_edge_property_names();
+  }
+
+  /// Load node property @param name from storage if it is not loaded yet.
+  /// Loading a property appends it to node_properties(), so references to
+  /// node_properties() taken before may not see it. Like LoadNodeProperty,
+  /// this may run concurrently with other loads.
+  Result<void> EnsureNodePropertyLoaded(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(*load_mutex_);
+    return rdg_.EnsureNodePropertyLoaded(name);
+  }
+  Result<void> EnsureEdgePropertyLoaded(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(*load_mutex_);
+    return rdg_.EnsureEdgePropertyLoaded(name);
+  }
+  /// Load all unloaded node and edge properties
+  Result<void> EnsureAllPropertiesLoaded() const {
+    std::lock_guard<std::mutex> lock(*load_mutex_);
+    return rdg_.EnsureAllPropertiesLoaded();
+  }
+
+  /// Release the memory of node property @param name; it can be loaded
+  /// again later. Only properties that are unchanged since they were last
+  /// stored can be unloaded.
+  Result<void> UnloadNodeProperty(const std::string& name) {
+    return rdg_.UnloadNodeProperty(name);
+  }
+  Result<void> UnloadEdgeProperty(const std::string& name) {
+    return rdg_.UnloadEdgeProperty(name);
+  }
 
   /// Get a node property by name and cast it to a type.
   ///
@@ -487,10 +823,11 @@ public:
   template <typename T>
   Result<std::shared_ptr<typename arrow::CTypeTraits<T>::ArrayType>>
   GetNodePropertyTyped(const std::string& name) {
-    auto chunked_array = GetNodeProperty(name);
-    if (!chunked_array) {
-      return ErrorCode::PropertyNotFound;
+    auto load_result = LoadNodeProperty(name);
+    if (!load_result) {
+      return load_result.error();
     }
+    const auto& chunked_array = load_result.value();
 
     auto array =
         std::dynamic_pointer_cast<typename arrow::CTypeTraits<T>::ArrayType>(
@@ -509,10 +846,11 @@ public:
   template <typename T>
   Result<std::shared_ptr<typename arrow::CTypeTraits<T>::ArrayType>>
   GetEdgePropertyTyped(const std::string& name) {
-    auto chunked_array = GetEdgeProperty(name);
-    if (!chunked_array) {
-      return ErrorCode::PropertyNotFound;
+    auto load_result = LoadEdgeProperty(name);
+    if (!load_result) {
+      return load_result.error();
     }
+    const auto& chunked_array = load_result.value();
 
     auto array =
         std::dynamic_pointer_cast<typename arrow::CTypeTraits<T>::ArrayType>(
@@ -542,8 +880,32 @@ public:
     return rdg_.MarkEdgePropertiesPersistent(persist_edge_props);
   }
 
+  /// The topology of this graph if it has 32-bit node ids, otherwise an
+  /// empty topology (see has_wide_node_ids)
   const GraphTopology& topology() const { return topology_; }
 
+  /// True if this graph has more nodes than 32-bit node ids can address. Its
+  /// topology is then wide_topology() and topology() is empty, as are the
+  /// node and edge accessors of this class that are defined in terms of
+  /// topology(); use VisitTopology for code that handles both.
+  bool has_wide_node_ids() const {
+    return wide_topology_.out_indices != nullptr;
+  }
+
+  /// The topology of this graph if has_wide_node_ids(), otherwise an empty
+  /// topology
+  const WideGraphTopology& wide_topology() const { return wide_topology_; }
+
+  /// Call \param fn with the topology of this graph, either a GraphTopology
+  /// or a WideGraphTopology
+  template <typename F>
+  decltype(auto) VisitTopology(F&& fn) const {
+    if (has_wide_node_ids()) {
+      return std::forward<F>(fn)(wide_topology_);
+    }
+    return std::forward<F>(fn)(topology_);
+  }
+
   /// Add Node properties that do not exist in the current graph
   Result<void> AddNodeProperties(const std::shared_ptr<arrow::Table>& props);
   /// Add Edge properties that do not exist in the current graph
@@ -587,31 +949,90 @@ public:
 
   Result<void> SetTopology(const GraphTopology& topology);
 
-  /// Return the node property table for local nodes
-  const std::shared_ptr<arrow::Table>& node_properties() const {
+  /// Set a topology with 64-bit node ids. A topology with fewer than 2^32
+  /// nodes is narrowed to 32-bit ids.
+  ///
+  /// In-edges, node relabeling and type indexes are not supported for graphs
+  /// with wide node ids.
+  Result<void> SetTopology(const WideGraphTopology& topology);
+
+  /// Construct the in-edge index of the topology if it does not have one.
+  ///
+  /// If the RDG this graph was loaded from has a stored in-edge index, it is
+  /// loaded; otherwise the index is built from the out-edges in parallel.
+  /// In-edges of each node are ordered by source. A built index is stored
+  /// alongside the topology by the next Write or Commit.
+  Result<void> ConstructInEdges();
+
+  /// Discard the in-edge index, in memory and in storage. Functions that
+  /// modify the topology in place call this.
+  Result<void> DropInEdges();
+
+  /// Reorder the edge TypeSetIDs after the out-edges of each node were
+  /// reordered in place, so that new edge e keeps the TypeSetID of old edge
+  /// old_edge[e], and rebuild the type indexes. Functions that reorder edges
+  /// in place call this.
+  Result<void> ReorderEdgeTypeSetIDs(const uint64_t* old_edge);
+
+  /// Renumber the nodes so that node n becomes node old_to_new[n].
+  ///
+  /// Node properties, edge properties, type set ids and local to user/global
+  /// id maps are permuted along with the topology, so every node and edge
+  /// keeps its data. Edges keep their relative order within each node but
+  /// get new ids. Unloaded properties are loaded first. The graph is only
+  /// modified once everything has been permuted, and a failure leaves it
+  /// as it was.
+  ///
+  /// \param old_to_new a permutation of [0, num_nodes())
+  /// \returns InvalidArgument if old_to_new is not a permutation or if this
+  ///   is a partition of a distributed graph
+  Result<void> RelabelNodes(
+      const std::shared_ptr<arrow::UInt64Array>& old_to_new);
+
+  /// Return the node property table for local nodes. Loading a property
+  /// replaces the table, so this returns a reference-counted copy of the
+  /// pointer that stays valid across concurrent loads.
+  std::shared_ptr<arrow::Table> node_properties() const {
+    std::lock_guard<std::mutex> lock(*load_mutex_);
     return rdg_.node_properties();
   }
   /// Return the edge property table for local edges
-  const std::shared_ptr<arrow::Table>& edge_properties() const {
+  std::shared_ptr<arrow::Table> edge_properties() const {
+    std::lock_guard<std::mutex> lock(*load_mutex_);
     return rdg_.edge_properties();
   }
 
   // Standard container concepts
 
-  node_iterator begin() const { return topology().begin(); }
+  // Node iterators hold 32-bit node ids, so they cannot cover graphs with
+  // wide node ids; use VisitTopology for those.
 
-  node_iterator end() const { return topology().end(); }
+  node_iterator begin() const {
+    KATANA_LOG_ASSERT(!has_wide_node_ids());
+    return topology().begin();
+  }
+
+  node_iterator end() const {
+    KATANA_LOG_ASSERT(!has_wide_node_ids());
+    return topology().end();
+  }
 
   /// Return the number of local nodes
-  size_t size() const { return topology().size(); }
+  size_t size() const { return num_nodes(); }
 
-  bool empty() const { return topology().empty(); }
+  bool empty() const { return num_nodes() == 0; }
 
   /// Return the number of local nodes
   ///  num_nodes in repartitioner is of type LocalNodeID
-  uint64_t num_nodes() const { return topology().num_nodes(); }
+  uint64_t num_nodes() const {
+    return has_wide_node_ids() ? wide_topology_.num_nodes()
+                               : topology().num_nodes();
+  }
   /// Return the number of local edges
-  uint64_t num_edges() const { return topology().num_edges(); }
+  uint64_t num_edges() const {
+    return has_wide_node_ids() ? wide_topology_.num_edges()
+                               : topology().num_edges();
+  }
 
   /// Gets the edge range of some node.
   ///
@@ -636,22 +1057,67 @@ public:
 ///
 /// Returns the permutation vector (mapping from old
 /// indices to the new indices) which results due to the sorting.
+///
+/// Edge properties are not moved: the properties of new edge e stay at row
+/// permutation[e] (see SortAllEdgesByDestWithProperties). Edge TypeSetIDs
+/// are moved with the edges and the type indexes are rebuilt.
 KATANA_EXPORT Result<std::shared_ptr<arrow::UInt64Array>> SortAllEdgesByDest(
     PropertyGraph* pg);
 
+/// SortAllEdgesByDestWithProperties sorts edges like SortAllEdgesByDest and
+/// permutes the edge properties with them, so that every edge keeps its
+/// properties. Unloaded edge properties are loaded first.
+///
+/// Returns the permutation vector of SortAllEdgesByDest.
+KATANA_EXPORT Result<std::shared_ptr<arrow::UInt64Array>>
+SortAllEdgesByDestWithProperties(PropertyGraph* pg);
+
 /// FindEdgeSortedByDest finds the "node_to_find" id in the
 /// sorted edgelist of the "node" using binary search.
 ///
 /// This returns the matched edge index if 'node_to_find' is present
 /// in the edgelist of 'node' else edge end if 'node_to_find' is not found.
-KATANA_EXPORT GraphTopology::Edge FindEdgeSortedByDest(
+/// Graphs with wide node ids are not supported (ErrorCode::NotImplemented).
+KATANA_EXPORT Result<GraphTopology::Edge> FindEdgeSortedByDest(
     const PropertyGraph* graph, GraphTopology::Node node,
     GraphTopology::Node node_to_find);
 
 /// Relabel all nodes in the graph by sorting in the descending
-/// order by node degree.
+/// order by node degree; nodes of equal degree keep their relative order,
+/// so the smaller id comes first (see NodeOrdering::kDegree).
+///
+/// All properties are loaded and permuted with the nodes (see
+/// PropertyGraph::RelabelNodes), which costs time and memory in proportion
+/// to their size.
 KATANA_EXPORT Result<void> SortNodesByDegree(PropertyGraph* pg);
 
+/// Orders of nodes that tend to improve the locality of graph traversals
+enum class NodeOrdering {
+  /// Descending out-degree; ties keep their original order
+  kDegree,
+  /// Reverse Cuthill-McKee: breadth-first from a low degree node of each
+  /// unvisited component, visiting neighbors in ascending degree order,
+  /// then reversed. Nodes that are close in the graph get close ids.
+  kReverseCuthillMcKee,
+  /// Nodes with more than the average out-degree first, then the others;
+  /// each group keeps its original order
+  kHubCluster,
+};
+
+/// ComputeNodeOrdering computes a relabeling of the nodes of \p pg.
+///
+/// \returns the mapping from old to new node ids, which can be passed to
+///   PropertyGraph::RelabelNodes
+KATANA_EXPORT Result<std::shared_ptr<arrow::UInt64Array>> ComputeNodeOrdering(
+    const PropertyGraph* pg, NodeOrdering ordering);
+
+/// RelabelNodes relabels the nodes of \p pg in the given order, permuting
+/// properties with the nodes.
+///
+/// \returns the mapping from old to new node ids
+KATANA_EXPORT Result<std::shared_ptr<arrow::UInt64Array>> RelabelNodes(
+    PropertyGraph* pg, NodeOrdering ordering);
+
 /// Creates in-memory symmetric (or undirected) graph.
 ///
 /// This function creates an symmetric or undirected version of the
@@ -660,12 +1126,21 @@ KATANA_EXPORT Result<void> SortNodesByDegree(PropertyGraph* pg);
 /// For each edge (a, b) in the graph, this function will
 /// add an additional edge (b, a) except when a == b, in which
 /// case, no additional edge is added.
-/// The generated symmetric graph may have duplicate edges.
+///
+/// The edges of each node are sorted by destination, so the result is the
+/// same from run to run. The generated symmetric graph may have duplicate
+/// edges unless remove_duplicates is true, in which case only one edge from
+/// a node to each destination is kept, preferring original edges over
+/// reverse ones.
 /// \param pg The original property graph
+/// \param edge_property_names Edge properties to copy; a reverse edge gets
+///   the property values of the edge it reverses
+/// \param remove_duplicates Keep at most one edge between a pair of nodes
 /// \return The new symmetric property graph by adding reverse edges
-// TODO(gill): Add edge properties for the new reversed edges.
 KATANA_EXPORT Result<std::unique_ptr<katana::PropertyGraph>>
-CreateSymmetricGraph(PropertyGraph* pg);
+CreateSymmetricGraph(
+    PropertyGraph* pg, const std::vector<std::string>& edge_property_names = {},
+    bool remove_duplicates = false);
 
 /// Creates in-memory transpose graph.
 ///
@@ -674,12 +1149,15 @@ CreateSymmetricGraph(PropertyGraph* pg);
 ///
 /// For each edge (a, b) in the graph, this function will
 /// add edge (b, a) without retaining the original edge (a, b) unlike
-/// CreateSymmetricGraph.
+/// CreateSymmetricGraph. The edges of each node are sorted by destination.
 /// \param pg The original property graph
+/// \param edge_property_names Edge properties to copy to the reversed edges
+/// \param remove_duplicates Keep at most one edge between a pair of nodes
 /// \return The new transposed property graph by reversing the edges
-// TODO(gill): Add tranposed edge properties as well.
 KATANA_EXPORT Result<std::unique_ptr<katana::PropertyGraph>>
-CreateTransposeGraph(PropertyGraph* pg);
+CreateTransposeGraph(
+    PropertyGraph* pg, const std::vector<std::string>& edge_property_names = {},
+    bool remove_duplicates = false);
 
 }  // namespace katana
 
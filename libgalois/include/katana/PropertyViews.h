@@ -35,7 +35,7 @@ MakePropertyViews(
 
 /// MakeNodePropertyViews asserts a typed view on top of runtime properties.
 /// This version selects a specific set of properties to include in the typed
-/// view.
+/// view. Selected properties that are not loaded yet are loaded first.
 ///
 /// It returns an error if there are fewer properties than elements of the
 /// view or if the underlying arrow::ChunkedArray has more than one
@@ -44,6 +44,11 @@ template <typename PropTuple>
 static Result<katana::PropertyViewTuple<PropTuple>>
 MakeNodePropertyViews(
     const PropertyGraph* pg, const std::vector<std::string>& properties) {
+  for (const std::string& name : properties) {
+    if (auto res = pg->EnsureNodePropertyLoaded(name); !res) {
+      return res.error();
+    }
+  }
   return MakePropertyViews<PropTuple>(pg->node_properties().get(), properties);
 }
 
@@ -67,6 +72,11 @@ template <typename PropTuple>
 static Result<katana::PropertyViewTuple<PropTuple>>
 MakeEdgePropertyViews(
     const PropertyGraph* pg, const std::vector<std::string>& properties) {
+  for (const std::string& name : properties) {
+    if (auto res = pg->EnsureEdgePropertyLoaded(name); !res) {
+      return res.error();
+    }
+  }
   return MakePropertyViews<PropTuple>(pg->edge_properties().get(), properties);
 }
 
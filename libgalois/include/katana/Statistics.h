@@ -20,6 +20,7 @@
 #ifndef KATANA_LIBGALOIS_KATANA_STATISTICS_H_
 #define KATANA_LIBGALOIS_KATANA_STATISTICS_H_
 
+#include <chrono>
 #include <limits>
 #include <string>
 #include <type_traits>
@@ -286,6 +287,19 @@ using ScalarStatManager = BasicStatMap<ScalarStat<T>>;
 
 }  // end namespace internal
 
+/// Formats of the statistics printed by StatManager::Print
+enum class StatFormat {
+  /// One line per statistic with fields separated by commas
+  kText,
+  /// A JSON object with the values of each statistic from each thread.
+  /// Regions are nested under the region of the timer or loop that was
+  /// running when they first started.
+  kJSON,
+  /// Chrome trace events, which chrome://tracing and Perfetto show as a
+  /// timeline of every StatTimer and of each thread of every named loop
+  kChromeTrace,
+};
+
 class KATANA_EXPORT StatManager {
   class Impl;
 
@@ -348,6 +362,21 @@ public:
 
   void SetStatFile(const std::string& outfile);
 
+  /// SetStatFormat selects the format Print uses. The default is given by the
+  /// environment variable KATANA_STAT_FORMAT (text, json or chrome) and is
+  /// text otherwise. Start and stop times of timers and loops are only
+  /// recorded while the format is not text.
+  void SetStatFormat(StatFormat format);
+
+  bool IsRecordingTimeline() const;
+
+  /// AddTimelineEvent records that the calling thread spent the time from
+  /// begin to end in a region
+  void AddTimelineEvent(
+      const char* region, const char* category,
+      std::chrono::steady_clock::time_point begin,
+      std::chrono::steady_clock::time_point end);
+
   void AddInt(
       const std::string& region, const std::string& category, int64_t val,
       const StatTotal::Type& type);
@@ -367,6 +396,15 @@ namespace internal {
 KATANA_EXPORT void setSysStatManager(StatManager* sm);
 KATANA_EXPORT StatManager* sysStatManager();
 
+/// Whether timers and loops should report their start and stop times with
+/// ReportTimelineEvent
+KATANA_EXPORT bool IsRecordingTimeline();
+
+KATANA_EXPORT void ReportTimelineEvent(
+    const char* region, const char* category,
+    std::chrono::steady_clock::time_point begin,
+    std::chrono::steady_clock::time_point end);
+
 }  // end namespace internal
 
 template <typename T>
@@ -443,6 +481,9 @@ KATANA_EXPORT void PrintStats();
 
 KATANA_EXPORT void SetStatFile(const std::string& f);
 
+/// Selects the format of PrintStats; see StatManager::SetStatFormat
+KATANA_EXPORT void SetStatFormat(StatFormat format);
+
 }  // end namespace katana
 
 #endif
@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_TERMINATIONDETECTION_H_
 
 #include <atomic>
+#include <memory>
 
 #include "katana/CacheLineStorage.h"
 #include "katana/PerThreadStorage.h"
@@ -70,6 +71,7 @@ KATANA_EXPORT TerminationDetection& GetTerminationDetection(
 class KATANA_EXPORT TerminationDetection {
   // So that GetTerminationDetection can call init.
   friend TerminationDetection& GetTerminationDetection(unsigned);
+  friend class ExecutionContext;
 
   CacheLineStorage<std::atomic<int>> global_term_;
 
@@ -110,6 +112,10 @@ public:
 
 namespace internal {
 void SetTerminationDetection(TerminationDetection* term);
+
+/// Creates an instance of the default termination detection, e.g., for the
+/// threads of an ExecutionContext
+std::unique_ptr<TerminationDetection> CreateLocalTerminationDetection();
 }  // end namespace internal
 
 }  // end namespace katana
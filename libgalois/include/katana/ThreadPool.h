@@ -25,6 +25,9 @@
 #include <condition_variable>
 #include <cstdlib>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <vector>
 
@@ -54,6 +57,24 @@ namespace katana {
 class KATANA_EXPORT ThreadPool {
   friend class SharedMem;
 
+public:
+  //! A subset of the threads of the pool that runs work independently of
+  //! the other threads. Inside a partition, thread ids and topology refer to
+  //! the threads of the partition, numbered from 0.
+  struct Partition {
+    //! pool thread id of each thread of the partition
+    std::vector<unsigned> threads;
+    //! topology of each thread as seen from inside the partition
+    std::vector<ThreadTopoInfo> topo;
+    MachineTopoInfo mi;
+    //! object that uses the partition, e.g., an ExecutionContext
+    void* owner{nullptr};
+    //! held by the thread that stands in for thread 0 of the partition
+    std::mutex entry;
+    bool running{false};
+    std::function<void(void)> work;
+  };
+
 protected:
   struct shutdown_ty {};  //! type for shutting down thread
   struct fastmode_ty {
@@ -71,6 +92,10 @@ protected:
     std::atomic<int> done;
     std::atomic<int> fastRelease;
     ThreadTopoInfo topo;
+    //! partition of the current work; null for the whole pool
+    Partition* partition{nullptr};
+    //! topology of the thread before it entered a partition
+    ThreadTopoInfo savedTopo;
 
     void wakeup(bool fastmode) {
       if (fastmode) {
@@ -100,13 +125,19 @@ protected:
 
   thread_local static per_signal my_box;
 
-  MachineTopoInfo mi;
+  //! the whole pool viewed as a partition of all of its threads
+  Partition whole;
   std::vector<per_signal*> signals;
   std::vector<std::thread> threads;
   unsigned reserved;
   unsigned masterFastmode;
-  bool running;
-  std::function<void(void)> work;
+  //! shared by threads in a partition; work on the whole pool is exclusive
+  std::shared_mutex partitionLock;
+  //! guards leased and the number of partitions
+  std::mutex leaseLock;
+  //! pool threads that belong to a partition
+  std::vector<bool> leased;
+  unsigned numPartitions;
 
   //! destroy all threads
   void destroyCommon();
@@ -124,7 +155,12 @@ protected:
   void decascade();
 
   //! execute work on num threads
-  void runInternal(unsigned num);
+  void runInternal(unsigned num, std::function<void(void)> work);
+
+  //! the partition the calling thread works in
+  const Partition& view() const {
+    return my_box.partition ? *my_box.partition : whole;
+  }
 
   ThreadPool();
 
@@ -155,11 +191,10 @@ public:
     // paying for an indirection in work allows small-object optimization in
     // std::function to kick in and avoid a heap allocation
     ExecuteTuple lwork(std::forward<Args>(args)...);
-    work = std::ref(lwork);
     // work =
     // std::function<void(void)>(ExecuteTuple(std::forward<Args>(args)...));
     KATANA_LOG_DEBUG_ASSERT(num <= getMaxThreads());
-    runInternal(num);
+    runInternal(num, std::ref(lwork));
   }
 
   //! run function in a dedicated thread until the threadpool exits
@@ -170,16 +205,55 @@ public:
   // experimental: leave busy wait
   void beKind();
 
-  bool isRunning() const { return running; }
+  bool isRunning() const { return view().running; }
+
+  //! Make a partition of the given pool threads. Returns null if one of them
+  //! is thread 0, is dedicated or is already in a partition.
+  std::unique_ptr<Partition> makePartition(std::vector<unsigned> threads);
+  //! Return the threads of a partition to the pool
+  void releasePartition(std::unique_ptr<Partition> p);
+  //! Whether a pool thread can be put in a partition
+  bool isAvailable(unsigned poolTid);
+
+  //! Make the calling thread stand in for thread 0 of p until
+  //! leavePartition. Work started by the thread in between runs on the
+  //! threads of p; work on the whole pool waits until no thread is in a
+  //! partition.
+  void enterPartition(Partition* p);
+  void leavePartition();
+
+  //! return the partition of the calling thread, if any
+  static Partition* getPartition() { return my_box.partition; }
+  //! return the pool thread id of thread tid of the calling thread's
+  //! partition
+  static unsigned getPoolTID(unsigned tid) {
+    return my_box.partition ? my_box.partition->threads[tid] : tid;
+  }
 
   //! return the number of non-reserved threads in the pool
-  unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
+  unsigned getMaxUsableThreads() const {
+    if (my_box.partition) {
+      return my_box.partition->mi.maxThreads;
+    }
+    return whole.mi.maxThreads - reserved;
+  }
   //! return the number of threads supported by the thread pool on the current
   //! machine
-  unsigned getMaxThreads() const { return mi.maxThreads; }
-  unsigned getMaxCores() const { return mi.maxCores; }
-  unsigned getMaxSockets() const { return mi.maxSockets; }
-  unsigned getMaxNumaNodes() const { return mi.maxNumaNodes; }
+  unsigned getMaxThreads() const { return view().mi.maxThreads; }
+  unsigned getMaxCores() const { return view().mi.maxCores; }
+  unsigned getMaxSockets() const { return view().mi.maxSockets; }
+  unsigned getMaxNumaNodes() const { return view().mi.maxNumaNodes; }
+
+  //! like getMaxThreads() and getMaxSockets() but for the whole pool, even
+  //! inside a partition; per-thread storage is kept for all pool threads
+  unsigned getMaxPoolThreads() const { return whole.mi.maxThreads; }
+  unsigned getMaxPoolSockets() const { return whole.mi.maxSockets; }
+  unsigned getPoolLeaderForSocket(unsigned pid) const {
+    for (unsigned i = 0; i < whole.mi.maxThreads; ++i)
+      if (whole.topo[i].socket == pid && whole.topo[i].socketLeader == i)
+        return i;
+    abort();
+  }
 
   unsigned getLeaderForSocket(unsigned pid) const {
     for (unsigned i = 0; i < getMaxThreads(); ++i)
@@ -189,17 +263,17 @@ public:
   }
 
   bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
+    return view().topo[tid].socketLeader == tid;
   }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
+  unsigned getSocket(unsigned tid) const { return view().topo[tid].socket; }
   unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+    return view().topo[tid].socketLeader;
   }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
+    return view().topo[tid].cumulativeMaxSocket;
   }
   unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+    return view().topo[tid].numaNode;
   }
 
   static unsigned getTID() { return my_box.topo.tid; }
@@ -64,6 +64,9 @@ class KATANA_EXPORT StatTimer : public TimeAccumulator {
   gstl::Str name_;
   gstl::Str region_;
   bool valid_;
+  // Whether start() recorded begin_ for the timeline
+  bool timeline_;
+  std::chrono::steady_clock::time_point begin_;
 
 public:
   StatTimer(const char* name, const char* region);
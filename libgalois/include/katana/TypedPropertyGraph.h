@@ -7,6 +7,7 @@
 #include <boost/iterator/counting_iterator.hpp>
 
 #include "katana/Details.h"
+#include "katana/ErrorCode.h"
 #include "katana/NoDerefIterator.h"
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -203,9 +204,10 @@ KATANA_EXPORT typename GraphTy::edge_iterator
 FindEdgeSortedByDest(
     const GraphTy& graph, typename GraphTy::Node node,
     typename GraphTy::Node node_to_find) {
+  // Typed graphs never have wide node ids (see TypedPropertyGraph::Make)
   auto edge_matched = katana::FindEdgeSortedByDest(
       &graph.GetPropertyGraph(), node, node_to_find);
-  return typename GraphTy::edge_iterator(edge_matched);
+  return typename GraphTy::edge_iterator(edge_matched.value());
 }
 
 template <typename NodeProps, typename EdgeProps>
@@ -213,6 +215,12 @@ Result<TypedPropertyGraph<NodeProps, EdgeProps>>
 TypedPropertyGraph<NodeProps, EdgeProps>::Make(
     PropertyGraph* pg, const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties) {
+  if (pg->has_wide_node_ids()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "typed views of graphs with wide node ids are not supported");
+  }
+
   auto node_view_result =
       internal::MakeNodePropertyViews<NodeProps>(pg, node_properties);
   if (!node_view_result) {
@@ -20,13 +20,18 @@
 #ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <random>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/Galois.h"
 #include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -48,6 +53,81 @@ using DegreeWeight = katana::PODProperty<EdgeWeightType>;
 template <typename EdgeWeightType>
 using EdgeWeight = katana::PODProperty<EdgeWeightType>;
 
+/**
+ * Sums edge weights by cluster id. Clusters are kept in dense arrays in the
+ * order they are first added, and an open-addressing hash table maps cluster
+ * ids to their position. Clear only resets the table slots that were used, so
+ * a single instance per thread can be reused for every node or cluster
+ * without allocating or touching memory proportional to the table size.
+ */
+template <typename EdgeTy>
+class ClusterWeightAccumulator {
+public:
+  /// Remove all clusters and make room for at least \p expected clusters
+  void Clear(size_t expected) {
+    for (uint64_t slot : used_slots_) {
+      slots_[slot] = kEmpty;
+    }
+    used_slots_.clear();
+    clusters_.clear();
+    weights_.clear();
+
+    // Keep the load factor at most one half
+    uint64_t capacity = kMinCapacity;
+    uint32_t shift = 64 - kMinCapacityLog2;
+    while (capacity < 2 * expected) {
+      capacity <<= 1;
+      --shift;
+    }
+    if (capacity > slots_.size()) {
+      slots_.assign(capacity, kEmpty);
+      shift_ = shift;
+    }
+  }
+
+  /// Add \p weight to the total weight of \p cluster
+  void Add(uint64_t cluster, EdgeTy weight) {
+    uint64_t mask = slots_.size() - 1;
+    // Fibonacci hashing: the high bits of the product are well mixed
+    uint64_t slot = (cluster * UINT64_C(0x9E3779B97F4A7C15)) >> shift_;
+    while (true) {
+      uint32_t index = slots_[slot];
+      if (index == kEmpty) {
+        slots_[slot] = clusters_.size();
+        used_slots_.push_back(slot);
+        clusters_.push_back(cluster);
+        weights_.push_back(weight);
+        return;
+      }
+      if (clusters_[index] == cluster) {
+        weights_[index] += weight;
+        return;
+      }
+      slot = (slot + 1) & mask;
+    }
+  }
+
+  /// Number of unique clusters added since the last Clear
+  size_t size() const { return clusters_.size(); }
+
+  /// The i-th unique cluster in the order clusters were first added
+  uint64_t cluster(size_t i) const { return clusters_[i]; }
+
+  /// Total weight of the i-th unique cluster
+  EdgeTy weight(size_t i) const { return weights_[i]; }
+
+private:
+  constexpr static uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+  constexpr static uint32_t kMinCapacityLog2 = 4;
+  constexpr static uint64_t kMinCapacity = UINT64_C(1) << kMinCapacityLog2;
+
+  std::vector<uint32_t> slots_;
+  std::vector<uint64_t> used_slots_;
+  std::vector<uint64_t> clusters_;
+  std::vector<EdgeTy> weights_;
+  uint32_t shift_{64};
+};
+
 template <typename _Graph, typename _EdgeType, typename _CommunityType>
 struct ClusteringImplementationBase {
   using Graph = _Graph;
@@ -60,28 +140,26 @@ struct ClusteringImplementationBase {
 
   using CommunityArray = katana::LargeArray<CommunityType>;
 
+  using NeighborClusters = ClusterWeightAccumulator<EdgeTy>;
+
   /**
    * Algorithm to find the best cluster for the node
    * to move to among its neighbors in the graph and moves.
    *
-   * It updates the mapping of neighboring nodes clusters
-   * in cluster_local_map, total unique cluster edge weights
-   * in counter as well as total weight of self edges in self_loop_wt.
+   * It records the total edge weight from n to each neighboring
+   * cluster in neighbors, with n's current cluster first, as well
+   * as total weight of self edges in self_loop_wt.
    */
   template <typename EdgeWeightType>
   void FindNeighboringClusters(
-      const Graph& graph, GNode& n,
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, EdgeTy& self_loop_wt) {
-    uint64_t num_unique_clusters = 0;
+      const Graph& graph, GNode& n, NeighborClusters* neighbors,
+      EdgeTy& self_loop_wt) {
+    neighbors->Clear(
+        std::distance(graph.edge_begin(n), graph.edge_end(n)) + 1);
 
     // Add the node's current cluster to be considered
-    // for movement as well
-    cluster_local_map[graph.template GetData<CurrentCommunityId>(n)] =
-        0;                 // Add n's current cluster
-    counter.push_back(0);  // Initialize the counter to zero (no edges incident
-                           // yet)
-    num_unique_clusters++;
+    // for movement as well, with no edges incident yet
+    neighbors->Add(graph.template GetData<CurrentCommunityId>(n), 0);
 
     // Assuming we have grabbed lock on all the neighbors
     for (auto ii = graph.edge_begin(n); ii != graph.edge_end(n); ++ii) {
@@ -91,17 +169,7 @@ struct ClusteringImplementationBase {
       if (*dst == n) {
         self_loop_wt += edge_wt;  // Self loop weights is recorded
       }
-      auto stored_already =
-          cluster_local_map.find(graph.template GetData<CurrentCommunityId>(
-              dst));  // Check if it already exists
-      if (stored_already != cluster_local_map.end()) {
-        counter[stored_already->second] += edge_wt;
-      } else {
-        cluster_local_map[graph.template GetData<CurrentCommunityId>(dst)] =
-            num_unique_clusters;
-        counter.push_back(edge_wt);
-        num_unique_clusters++;
-      }
+      neighbors->Add(graph.template GetData<CurrentCommunityId>(dst), edge_wt);
     }  // End edge loop
     return;
   }
@@ -207,44 +275,40 @@ struct ClusteringImplementationBase {
    * without swapping the cluster assignment.
    */
   uint64_t MaxModularityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, uint64_t self_loop_wt,
+      const NeighborClusters& neighbors, uint64_t self_loop_wt,
       CommunityArray& c_info, EdgeTy degree_wt, uint64_t sc, double constant) {
     uint64_t max_index = sc;  // Assign the intial value as self community
     double cur_gain = 0;
     double max_gain = 0;
-    double eix = counter[0] - self_loop_wt;
+    double eix = neighbors.weight(0) - self_loop_wt;
     double ax = c_info[sc].degree_wt - degree_wt;
     double eiy = 0;
     double ay = 0;
 
-    auto stored_already = cluster_local_map.begin();
-    do {
-      if (sc != stored_already->first) {
-        ay = c_info[stored_already->first].degree_wt;  // Degree wt of cluster y
-
-        if (ay < (ax + degree_wt)) {
-          stored_already++;
-          continue;
-        } else if (ay == (ax + degree_wt) && stored_already->first > sc) {
-          stored_already++;
-          continue;
-        }
+    // Ties are broken by cluster id so the order of neighbors does not matter
+    for (size_t i = 0; i < neighbors.size(); ++i) {
+      uint64_t cluster = neighbors.cluster(i);
+      if (sc == cluster) {
+        continue;
+      }
+      ay = c_info[cluster].degree_wt;  // Degree wt of cluster y
+
+      if (ay < (ax + degree_wt)) {
+        continue;
+      } else if (ay == (ax + degree_wt) && cluster > sc) {
+        continue;
+      }
 
-        eiy = counter[stored_already
-                          ->second];  // Total edges incident on cluster y
-        cur_gain = 2 * constant * (eiy - eix) +
-                   2 * degree_wt * ((ax - ay) * constant * constant);
+      eiy = neighbors.weight(i);  // Total edges incident on cluster y
+      cur_gain = 2 * constant * (eiy - eix) +
+                 2 * degree_wt * ((ax - ay) * constant * constant);
 
-        if ((cur_gain > max_gain) ||
-            ((cur_gain == max_gain) && (cur_gain != 0) &&
-             (stored_already->first < max_index))) {
-          max_gain = cur_gain;
-          max_index = stored_already->first;
-        }
+      if ((cur_gain > max_gain) || ((cur_gain == max_gain) && (cur_gain != 0) &&
+                                    (cluster < max_index))) {
+        max_gain = cur_gain;
+        max_index = cluster;
       }
-      stored_already++;  // Explore next cluster
-    } while (stored_already != cluster_local_map.end());
+    }
 
     if ((c_info[max_index].size == 1 && c_info[sc].size == 1 &&
          max_index > sc)) {
@@ -538,68 +602,125 @@ struct ClusteringImplementationBase {
     uint64_t num_nodes_next = num_unique_clusters;
     uint64_t num_edges_next = 0;  // Unknown right now
 
-    std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-    // Comment: Serial separation is better than do_all due to contention
-    for (GNode n = 0; n < graph.num_nodes(); ++n) {
-      auto n_data_curr_comm_id = graph.template GetData<CurrentCommunityId>(n);
-      if (n_data_curr_comm_id != UNASSIGNED)
-        cluster_bags[n_data_curr_comm_id].push_back(n);
-    }
+    // Counting sort of the nodes by cluster: the nodes of cluster c are
+    // cluster_nodes[cluster_offsets[c], cluster_offsets[c + 1])
+    katana::LargeArray<std::atomic<uint64_t>> cluster_cursor;
+    cluster_cursor.allocateBlocked(num_unique_clusters);
+    katana::LargeArray<uint64_t> cluster_offsets;
+    cluster_offsets.allocateBlocked(num_unique_clusters + 1);
+    katana::LargeArray<GNode> cluster_nodes;
+    cluster_nodes.allocateBlocked(graph.num_nodes());
+
+    katana::do_all(
+        katana::iterate((uint64_t)0, num_unique_clusters),
+        [&](uint64_t c) { cluster_cursor[c] = 0; });
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto n_data_curr_comm_id =
+              graph.template GetData<CurrentCommunityId>(n);
+          if (n_data_curr_comm_id != UNASSIGNED) {
+            katana::atomicAdd(
+                cluster_cursor[n_data_curr_comm_id], (uint64_t)1);
+          }
+        },
+        katana::loopname("BuildGraph: Count cluster nodes"));
 
-    std::vector<std::vector<uint32_t>> edges_id(num_unique_clusters);
-    std::vector<std::vector<EdgeTy>> edges_data(num_unique_clusters);
+    cluster_offsets[0] = 0;
+    katana::do_all(
+        katana::iterate((uint64_t)0, num_unique_clusters),
+        [&](uint64_t c) { cluster_offsets[c + 1] = cluster_cursor[c]; });
+    katana::ParallelSTL::partial_sum(
+        cluster_offsets.begin(), cluster_offsets.end(),
+        cluster_offsets.begin());
+    katana::do_all(
+        katana::iterate((uint64_t)0, num_unique_clusters),
+        [&](uint64_t c) { cluster_cursor[c] = cluster_offsets[c]; });
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto n_data_curr_comm_id =
+              graph.template GetData<CurrentCommunityId>(n);
+          if (n_data_curr_comm_id != UNASSIGNED) {
+            cluster_nodes[cluster_cursor[n_data_curr_comm_id]++] = n;
+          }
+        },
+        katana::loopname("BuildGraph: Place cluster nodes"));
+
+    // Restore node order within each cluster so that the coarsened graph is
+    // the same from run to run. While there, bound the number of edges of
+    // each coarsened node by the degrees of its nodes.
+    katana::LargeArray<uint64_t> edge_bounds;
+    edge_bounds.allocateBlocked(num_unique_clusters + 1);
+    edge_bounds[0] = 0;
+    katana::do_all(
+        katana::iterate((uint64_t)0, num_unique_clusters),
+        [&](uint64_t c) {
+          auto begin = cluster_nodes.begin() + cluster_offsets[c];
+          auto end = cluster_nodes.begin() + cluster_offsets[c + 1];
+          std::sort(begin, end);
+          uint64_t degree = 0;
+          for (auto it = begin; it != end; ++it) {
+            degree += std::distance(graph.edge_begin(*it), graph.edge_end(*it));
+          }
+          edge_bounds[c + 1] = degree;
+        },
+        katana::steal(), katana::loopname("BuildGraph: Sort cluster nodes"));
+    katana::ParallelSTL::partial_sum(
+        edge_bounds.begin(), edge_bounds.end(), edge_bounds.begin());
+
+    // Edges of coarsened node c are written starting at edge_bounds[c] and
+    // compacted once the number of unique neighboring clusters is known
+    katana::LargeArray<uint32_t> edges_id;
+    edges_id.allocateBlocked(edge_bounds[num_unique_clusters]);
+    katana::LargeArray<EdgeTy> edges_data;
+    edges_data.allocateBlocked(edge_bounds[num_unique_clusters]);
+    katana::LargeArray<uint64_t> prefix_edges_count;
+    prefix_edges_count.allocateBlocked(num_unique_clusters + 1);
+    prefix_edges_count[0] = 0;
+
+    katana::PerThreadStorage<NeighborClusters> per_thread_neighbors;
 
     /* First pass to find the number of edges */
     katana::do_all(
         katana::iterate((uint64_t)0, num_unique_clusters),
         [&](uint64_t c) {
-          std::map<uint64_t, uint64_t> cluster_local_map;
-          uint64_t num_unique_clusters = 0;
-          for (auto cb_ii = cluster_bags[c].begin();
-               cb_ii != cluster_bags[c].end(); ++cb_ii) {
+          NeighborClusters& neighbors = *per_thread_neighbors.getLocal();
+          neighbors.Clear(std::min<uint64_t>(
+              edge_bounds[c + 1] - edge_bounds[c], num_unique_clusters));
+          for (uint64_t i = cluster_offsets[c]; i < cluster_offsets[c + 1];
+               ++i) {
+            GNode node = cluster_nodes[i];
             KATANA_LOG_DEBUG_ASSERT(
-                graph.template GetData<CurrentCommunityId>(*cb_ii) ==
+                graph.template GetData<CurrentCommunityId>(node) ==
                 c);  // All nodes in this bag must have same cluster id
 
-            for (auto ii = graph.edge_begin(*cb_ii);
-                 ii != graph.edge_end(*cb_ii); ++ii) {
+            for (auto ii = graph.edge_begin(node); ii != graph.edge_end(node);
+                 ++ii) {
               auto dst = graph.GetEdgeDest(ii);
               auto dst_data_curr_comm_id =
                   graph.template GetData<CurrentCommunityId>(dst);
               KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
-              auto stored_already = cluster_local_map.find(
-                  dst_data_curr_comm_id);  // Check if it already exists
-              if (stored_already != cluster_local_map.end()) {
-                edges_data[c][stored_already->second] +=
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii);
-              } else {
-                cluster_local_map[dst_data_curr_comm_id] = num_unique_clusters;
-                edges_id[c].push_back(dst_data_curr_comm_id);
-                edges_data[c].push_back(
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii));
-                num_unique_clusters++;
-              }
+              neighbors.Add(
+                  dst_data_curr_comm_id,
+                  graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(ii));
             }  // End edge loop
           }
+
+          uint64_t start = edge_bounds[c];
+          for (size_t k = 0; k < neighbors.size(); ++k) {
+            edges_id[start + k] = neighbors.cluster(k);
+            edges_data[start + k] = neighbors.weight(k);
+          }
+          prefix_edges_count[c + 1] = neighbors.size();
         },
         katana::steal(), katana::loopname("BuildGraph: Find edges"));
 
-    /* Serial loop to reduce all the edge counts */
-    std::vector<uint64_t> prefix_edges_count(num_unique_clusters);
-    katana::GAccumulator<uint64_t> num_edges_acc;
-    katana::do_all(
-        katana::iterate((uint64_t)0, num_nodes_next), [&](uint64_t c) {
-          prefix_edges_count[c] = edges_id[c].size();
-          num_edges_acc += prefix_edges_count[c];
-        });
-
-    num_edges_next = num_edges_acc.reduce();
-    for (uint64_t c = 1; c < num_nodes_next; ++c) {
-      prefix_edges_count[c] += prefix_edges_count[c - 1];
-    }
-
-    KATANA_LOG_DEBUG_ASSERT(
-        prefix_edges_count[num_unique_clusters - 1] == num_edges_next);
+    katana::ParallelSTL::partial_sum(
+        prefix_edges_count.begin(), prefix_edges_count.end(),
+        prefix_edges_count.begin());
+    num_edges_next = prefix_edges_count[num_unique_clusters];
     katana::StatTimer TimerConstructFrom("Timer_Construct_From");
     TimerConstructFrom.start();
 
@@ -676,15 +797,15 @@ struct ClusteringImplementationBase {
     Graph graph_curr = graph_result.value();
     katana::do_all(
         katana::iterate((uint64_t)0, num_nodes_next), [&](uint64_t n) {
-          out_indices_view[n] = prefix_edges_count[n];
+          out_indices_view[n] = prefix_edges_count[n + 1];
           uint64_t number_of_edges =
-              (n == 0) ? prefix_edges_count[0]
-                       : (prefix_edges_count[n] - prefix_edges_count[n - 1]);
-          uint64_t start_index = (n == 0) ? 0 : prefix_edges_count[n - 1];
-          for (uint32_t k = 0; k < number_of_edges; ++k) {
-            out_dests_view[start_index + k] = edges_id[n][k];
+              prefix_edges_count[n + 1] - prefix_edges_count[n];
+          uint64_t start_index = prefix_edges_count[n];
+          uint64_t bound_index = edge_bounds[n];
+          for (uint64_t k = 0; k < number_of_edges; ++k) {
+            out_dests_view[start_index + k] = edges_id[bound_index + k];
             graph_curr.template GetEdgeData<EdgeWeight<EdgeWeightType>>(
-                start_index + k) = edges_data[n][k];
+                start_index + k) = edges_data[bound_index + k];
           }
         });
 
@@ -28,7 +28,8 @@ public:
 };
 
 //! Used to determine if a graph has power-law degree distribution or not
-//! by sampling some of the vertices in the graph randomly
+//! by sampling some of the vertices in the graph randomly, or from its
+//! stored degree histogram if it has statistics
 //! This code has been copied from GAP benchmark suite
 //! (https://github.com/sbeamer/gapbs/blob/master/src/tc.cc WorthRelabelling())
 KATANA_EXPORT bool IsApproximateDegreeDistributionPowerLaw(
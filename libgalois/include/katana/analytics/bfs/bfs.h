@@ -16,40 +16,73 @@ public:
     kAsynchronousTile = 0,
     kAsynchronous,
     kSynchronousTile,
-    kSynchronous
+    kSynchronous,
+    kDirectionOptimizing
   };
 
   static const int kDefaultEdgeTileSize = 256;
+  static constexpr uint32_t kDefaultAlpha = 15;
+  static constexpr uint32_t kDefaultBeta = 18;
 
 private:
   Algorithm algorithm_;
   ptrdiff_t edge_tile_size_;
+  uint32_t alpha_;
+  uint32_t beta_;
 
   BfsPlan(
-      Architecture architecture, Algorithm algorithm, ptrdiff_t edge_tile_size)
+      Architecture architecture, Algorithm algorithm, ptrdiff_t edge_tile_size,
+      uint32_t alpha, uint32_t beta)
       : Plan(architecture),
         algorithm_(algorithm),
-        edge_tile_size_(edge_tile_size) {}
+        edge_tile_size_(edge_tile_size),
+        alpha_(alpha),
+        beta_(beta) {}
 
 public:
-  BfsPlan() : BfsPlan{kCPU, kSynchronousTile, kDefaultEdgeTileSize} {}
+  BfsPlan()
+      : BfsPlan{
+            kCPU, kSynchronousTile, kDefaultEdgeTileSize, kDefaultAlpha,
+            kDefaultBeta} {}
 
   Algorithm algorithm() const { return algorithm_; }
   ptrdiff_t edge_tile_size() const { return edge_tile_size_; }
+  /// Switch to bottom-up steps once the frontier's out-edges exceed
+  /// 1/alpha of the edges that have not been explored yet.
+  uint32_t alpha() const { return alpha_; }
+  /// Switch back to top-down steps once the frontier shrinks below 1/beta of
+  /// the nodes.
+  uint32_t beta() const { return beta_; }
 
   static BfsPlan AsynchronousTile(
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
-    return {kCPU, kAsynchronousTile, edge_tile_size};
+    return {kCPU, kAsynchronousTile, edge_tile_size, 0, 0};
   }
 
-  static BfsPlan Asynchronous() { return {kCPU, kAsynchronous, 0}; }
+  static BfsPlan Asynchronous() { return {kCPU, kAsynchronous, 0, 0, 0}; }
 
   static BfsPlan SynchronousTile(
       ptrdiff_t edge_tile_size = kDefaultEdgeTileSize) {
-    return {kCPU, kSynchronousTile, edge_tile_size};
+    return {kCPU, kSynchronousTile, edge_tile_size, 0, 0};
   }
 
-  static BfsPlan Synchronous() { return {kCPU, kSynchronous, 0}; }
+  static BfsPlan Synchronous() { return {kCPU, kSynchronous, 0, 0, 0}; }
+
+  /// Bulk-synchronous BFS that switches between top-down (push) and bottom-up
+  /// (pull) steps depending on the size of the frontier.
+  ///
+  /// Bottom-up steps scan the in-edges of unvisited nodes. The graph's in-edge
+  /// index (PropertyGraph::ConstructInEdges) is loaded or built the first time
+  /// a bottom-up step is taken.
+  ///
+  /// Beamer, Scott, Krste Asanovic, and David Patterson. "Direction-optimizing
+  /// breadth-first search." SC'12: Proceedings of the International Conference
+  /// on High Performance Computing, Networking, Storage and Analysis. IEEE,
+  /// 2012.
+  static BfsPlan DirectionOptimizing(
+      uint32_t alpha = kDefaultAlpha, uint32_t beta = kDefaultBeta) {
+    return {kCPU, kDirectionOptimizing, 0, alpha, beta};
+  }
 };
 
 /// Compute BFS level of nodes in the graph pg starting from start_node. The
@@ -61,6 +94,23 @@ KATANA_EXPORT Result<void> Bfs(
     PropertyGraph* pg, size_t start_node,
     const std::string& output_property_name, BfsPlan algo = {});
 
+/// Compute BFS levels of nodes in the graph pg from each node in start_nodes.
+/// The levels from start_nodes[i] are stored in a property named by
+/// output_property_names[i]. The properties are created by this function and
+/// may not exist before the call. If the call fails, none of them are left in
+/// the graph.
+///
+/// Sources are traversed in batches of 64, with one bit per source in a word
+/// per node, so each batch shares a single pass over the edges of each level.
+///
+/// Then, Manuel, et al. "The more the merrier: Efficient multi-source graph
+/// traversal." Proceedings of the VLDB Endowment 8.4 (2014): 449-460.
+///
+/// Start nodes are 64-bit so that graphs with wide node ids are supported.
+KATANA_EXPORT Result<void> BfsMultiSource(
+    PropertyGraph* pg, const std::vector<uint64_t>& start_nodes,
+    const std::vector<std::string>& output_property_names);
+
 /// Do a quick validation of the results of a BFS computation where the results
 /// are stored in property_name. This function does not do an exhaustive check.
 /// The results are approximate and may have false-negatives.
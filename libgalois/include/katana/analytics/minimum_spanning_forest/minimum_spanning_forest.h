@@ -0,0 +1,98 @@
+#ifndef KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+#define KATANA_LIBGALOIS_KATANA_ANALYTICS_MINIMUMSPANNINGFOREST_MINIMUMSPANNINGFOREST_H_
+
+#include <iostream>
+
+#include "katana/analytics/Plan.h"
+#include "katana/analytics/Utils.h"
+
+namespace katana::analytics {
+
+/// A computational plan to for minimum spanning forest, specifying the
+/// algorithm and any parameters associated with it.
+class MinimumSpanningForestPlan : public Plan {
+public:
+  /// Algorithm selectors for minimum spanning forest
+  enum Algorithm { kBoruvka, kFilterKruskal };
+
+  static const uint64_t kDefaultKruskalThreshold = 1 << 16;
+
+  // Don't allow people to directly construct these, so as to have only one
+  // consistent way to configure.
+private:
+  Algorithm algorithm_;
+  uint64_t kruskal_threshold_;
+
+  MinimumSpanningForestPlan(
+      Architecture architecture, Algorithm algorithm,
+      uint64_t kruskal_threshold)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        kruskal_threshold_(kruskal_threshold) {}
+
+public:
+  MinimumSpanningForestPlan() : MinimumSpanningForestPlan{kCPU, kBoruvka, 0} {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// The number of edges below which filter-Kruskal stops partitioning and
+  /// runs sequential Kruskal.
+  uint64_t kruskal_threshold() const { return kruskal_threshold_; }
+
+  /// Parallel Boruvka: in each round every component picks its lightest
+  /// outgoing edge and the picked edges are merged into the forest, which at
+  /// least halves the number of components.
+  static MinimumSpanningForestPlan Boruvka() { return {kCPU, kBoruvka, 0}; }
+
+  /// Filter-Kruskal: partition the edges around a pivot weight, solve the
+  /// lighter part recursively, then drop heavier edges that already connect
+  /// a single component before recursing on them. Partitioning, filtering and
+  /// sorting are parallel; merging is sequential.
+  static MinimumSpanningForestPlan FilterKruskal(
+      uint64_t kruskal_threshold = kDefaultKruskalThreshold) {
+    return {kCPU, kFilterKruskal, kruskal_threshold};
+  }
+};
+
+/// Compute a minimum spanning forest of pg. The pg must be symmetric, with the
+/// same weight on both directions of an edge. The edge weights are taken from
+/// the property named edge_weight_property_name (which may be a 32- or 64-bit
+/// sign or unsigned int, or a float or double), and the forest is stored in
+/// the property named output_property_name (as uint8_t): 1 for edges in the
+/// forest and 0 otherwise. Of the two directions of a forest edge, only one is
+/// marked.
+/// Ties between equal weights are broken by the node ids of the endpoints, so
+/// all plans compute the same forest up to parallel edges of equal weight.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name,
+    MinimumSpanningForestPlan plan = {});
+
+/// Check that the edges marked in output_property_name form a spanning forest
+/// of pg and that its weights are those of a minimum spanning forest computed
+/// by sequential Kruskal.
+KATANA_EXPORT Result<void> MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name);
+
+struct KATANA_EXPORT MinimumSpanningForestStatistics {
+  /// The number of edges in the forest.
+  uint64_t n_forest_edges;
+  /// The number of trees in the forest, including isolated nodes.
+  uint64_t n_trees;
+  /// The sum of the weights of the forest edges.
+  double total_weight;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<MinimumSpanningForestStatistics> Compute(
+      PropertyGraph* pg, const std::string& edge_weight_property_name,
+      const std::string& output_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
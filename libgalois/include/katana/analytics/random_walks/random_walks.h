@@ -123,7 +123,7 @@ public:
       uint32_t number_of_edge_types = kDefaultNumberOfEdgeTypes) {
     return {
         kCPU,
-        kNode2Vec,
+        kEdge2Vec,
         walk_length,
         number_of_walks,
         backward_probability,
@@ -137,8 +137,36 @@ public:
 /// parameters can be specified, but have reasonable defaults. Not all
 /// parameters are used by the algorithms. The generated random-walks generated
 /// are returned as a vector of vectors.
+///
+/// If edge_weight_property_name is not empty, neighbors are sampled with
+/// probability proportional to the (non-negative, numeric) weight of the edge
+/// to them; this applies to both Node2Vec and Edge2Vec. The alias tables
+/// persisted by RandomWalksBuildAliasTable are used if present; otherwise they
+/// are built for this call.
+///
+/// The walks are generated from a private copy of the adjacency; pg and its
+/// edge order are not changed. The plan's walk_length must be at least 1.
 KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
-    PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
+    PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan(),
+    const std::string& edge_weight_property_name = "");
+
+/// Compute the random-walks for pg like RandomWalks, but return them as one
+/// arrow table with a row per walk. The "walk" column is a
+/// FixedSizeList<UInt32> of walk_length + 1 nodes and the "length" column is
+/// the number of those nodes that belong to the walk; walks that stop early
+/// are padded with zeros.
+KATANA_EXPORT Result<std::shared_ptr<arrow::Table>> RandomWalksTable(
+    PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan(),
+    const std::string& edge_weight_property_name = "");
+
+/// Precompute the alias tables for weighted random walks over
+/// edge_weight_property_name and add them to pg as the edge properties
+/// edge_weight_property_name + "_alias_prob" and
+/// edge_weight_property_name + "_alias_index", so they are stored with the
+/// graph. The tables refer to edges by their offset in the edge range of their
+/// source, so they must be rebuilt if the edges of pg are reordered.
+KATANA_EXPORT Result<void> RandomWalksBuildAliasTable(
+    PropertyGraph* pg, const std::string& edge_weight_property_name);
 
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
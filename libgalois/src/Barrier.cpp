@@ -19,6 +19,7 @@
 
 #include "katana/Barrier.h"
 
+#include "katana/ExecutionContext.h"
 #include "katana/Logging.h"
 #include "katana/ThreadPool.h"
 
@@ -43,6 +44,9 @@ katana::internal::SetBarrier(katana::Barrier* barrier) {
 
 katana::Barrier&
 katana::GetBarrier(unsigned active_threads) {
+  if (ExecutionContext* ctx = ExecutionContext::Current()) {
+    return ctx->GetBarrier(active_threads);
+  }
   KATANA_LOG_VASSERT(kBarrier, "Barrier not initialized");
   active_threads =
       std::min(active_threads, GetThreadPool().getMaxUsableThreads());
@@ -703,23 +703,6 @@ AddLabelInternal(
   }
 }
 
-/***********************************/
-/* Functions for handling topology */
-/***********************************/
-
-// Used to build the out_dests component of the CSR representation
-uint64_t
-SetEdgeId(
-    TopologyState* topology_builder, std::vector<uint64_t>* offsets,
-    size_t index) {
-  uint32_t src = topology_builder->sources[index];
-  uint64_t base = src ? topology_builder->out_indices[src - 1] : 0;
-  uint64_t i = base + offsets->at(src)++;
-
-  topology_builder->out_dests[i] = topology_builder->destinations[index];
-  return i;
-}
-
 /******************************************************************************/
 /* Functions for ensuring all arrow arrays are of the right length in the end */
 /******************************************************************************/
@@ -1669,17 +1652,10 @@ katana::PropertyGraphBuilder::BuildFinalEdges(bool verbose) {
       topology_builder_.out_indices.begin());
 
   std::vector<size_t> edge_mapping;
-  edge_mapping.resize(edges_, std::numeric_limits<uint64_t>::max());
-
-  std::vector<uint64_t> offsets;
-  offsets.resize(nodes_, 0);
-
-  // get edge indices
-  for (size_t i = 0; i < topology_builder_.sources.size(); i++) {
-    uint64_t edgeId = SetEdgeId(&topology_builder_, &offsets, i);
-    // edge_mapping[i] = edgeId;
-    edge_mapping[edgeId] = i;
-  }
+  katana::SortEdgesIntoCSR(
+      topology_builder_.out_indices, topology_builder_.sources,
+      topology_builder_.destinations, &topology_builder_.out_dests,
+      &edge_mapping);
 
   auto initial_edges = BuildChunks(&edge_properties_.chunks);
   auto initial_types = BuildChunks(&edge_types_.chunks);
@@ -1792,6 +1768,53 @@ katana::PropertyGraphBuilder::Finish(bool verbose) {
   return katana::GraphComponents{nodes_tables, edges_tables, topology};
 }
 
+void
+katana::SortEdgesIntoCSR(
+    const std::vector<uint64_t>& out_indices,
+    const std::vector<uint32_t>& sources,
+    const std::vector<uint32_t>& destinations,
+    std::vector<uint32_t>* out_dests, std::vector<size_t>* edge_mapping) {
+  uint64_t num_nodes = out_indices.size();
+  uint64_t num_edges = sources.size();
+  KATANA_LOG_DEBUG_ASSERT(destinations.size() == num_edges);
+  KATANA_LOG_DEBUG_ASSERT(num_nodes == 0 || out_indices.back() == num_edges);
+
+  out_dests->resize(num_edges);
+  edge_mapping->resize(num_edges);
+
+  std::vector<uint64_t> offsets(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { offsets[n] = n > 0 ? out_indices[n - 1] : 0; },
+      katana::no_stats());
+
+  // Scatter edges to their source's range
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t i) {
+        auto e = __sync_fetch_and_add(&offsets[sources[i]], 1);
+        (*edge_mapping)[e] = i;
+      },
+      katana::no_stats());
+
+  // Restore input order within each range so the result does not depend on
+  // thread timing
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n > 0 ? out_indices[n - 1] : 0;
+        std::sort(
+            edge_mapping->begin() + begin,
+            edge_mapping->begin() + out_indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { (*out_dests)[e] = destinations[(*edge_mapping)[e]]; },
+      katana::no_stats());
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::GraphComponents::ToPropertyGraph() const {
   auto graph = std::make_unique<katana::PropertyGraph>();
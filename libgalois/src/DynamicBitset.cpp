@@ -23,33 +23,253 @@
 
 #include "katana/DynamicBitset.h"
 
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define KATANA_BITSET_X86 1
+#endif
+
 #include "katana/Galois.h"
 
 KATANA_EXPORT katana::DynamicBitset katana::EmptyBitset;
 
+namespace {
+
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define KATANA_BITSET_SANITIZED 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) ||    \
+    __has_feature(memory_sanitizer)
+#define KATANA_BITSET_SANITIZED 1
+#endif
+#endif
+
+// Compile the loop for AVX-512, AVX2 and the baseline architecture and pick
+// one when the library is loaded. The loader runs the selection before
+// sanitizer runtimes are initialized, so sanitized builds use the baseline.
+// Compilers without target_clones (e.g., Clang before 14) also use the
+// baseline.
+#if defined(KATANA_BITSET_X86) && !defined(KATANA_BITSET_SANITIZED) &&         \
+    defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define KATANA_BITSET_CLONES                                                   \
+  __attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+#endif
+#ifndef KATANA_BITSET_CLONES
+#define KATANA_BITSET_CLONES
+#endif
+
+/// Number of words that fit in a cache line; threads write disjoint lines
+constexpr size_t kWordsPerLine =
+    katana::KATANA_CACHE_LINE_SIZE / sizeof(uint64_t);
+
+/// Bulk operations on fewer words than this run on the calling thread
+constexpr size_t kSerialWords = size_t{1} << 12;
+
+/// Fused operations go through blocks of this many words so that the words
+/// of the first step are still in cache for the second
+constexpr size_t kChunkWords = size_t{1} << 10;
+
+uint64_t*
+Words(katana::DynamicBitset* bitset) {
+  return reinterpret_cast<uint64_t*>(bitset->get_vec().data());
+}
+
+const uint64_t*
+Words(const katana::DynamicBitset& bitset) {
+  return reinterpret_cast<const uint64_t*>(bitset.get_vec().data());
+}
+
+enum class BitOp { kAnd, kOr, kXor, kAndNot, kNot };
+
+/// dst[i] = a[i] op b[i]; dst may be a
+KATANA_BITSET_CLONES void
+ApplyWords(
+    BitOp op, uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+  switch (op) {
+  case BitOp::kAnd:
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = a[i] & b[i];
+    }
+    break;
+  case BitOp::kOr:
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = a[i] | b[i];
+    }
+    break;
+  case BitOp::kXor:
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = a[i] ^ b[i];
+    }
+    break;
+  case BitOp::kAndNot:
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = a[i] & ~b[i];
+    }
+    break;
+  case BitOp::kNot:
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = ~a[i];
+    }
+    break;
+  }
+}
+
+size_t
+PopcountScalar(const uint64_t* words, size_t n) {
+  size_t count = 0;
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t w = words[i];
+#ifdef __GNUC__
+    count += __builtin_popcountll(w);
+#else
+    w = w - ((w >> 1) & 0x5555555555555555UL);
+    w = (w & 0x3333333333333333UL) + ((w >> 2) & 0x3333333333333333UL);
+    count +=
+        (((w + (w >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
+#endif
+  }
+  return count;
+}
+
+#ifdef KATANA_BITSET_X86
+/// Counts the bits of each nibble with a table lookup and sums the bytes of
+/// each word (W. Mula's algorithm)
+__attribute__((target("avx2"))) size_t
+PopcountAVX2(const uint64_t* words, size_t n) {
+  const __m256i lookup = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1,
+      2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i acc = _mm256_setzero_si256();
+
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+    __m256i lo = _mm256_and_si256(v, low_mask);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    __m256i bytes = _mm256_add_epi8(
+        _mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    acc = _mm256_add_epi64(
+        acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+  }
+
+  size_t count = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+                 _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+  return count + PopcountScalar(words + i, n - i);
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq"))) size_t
+PopcountAVX512(const uint64_t* words, size_t n) {
+  __m512i acc = _mm512_setzero_si512();
+
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc = _mm512_add_epi64(
+        acc, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+  }
+  if (i < n) {
+    __mmask8 mask = (1U << (n - i)) - 1;
+    acc = _mm512_add_epi64(
+        acc, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(mask, words + i)));
+  }
+  // Not _mm512_reduce_add_epi64, which makes GCC 12 warn about an
+  // uninitialized value inside the intrinsic
+  alignas(64) uint64_t lanes[8];
+  _mm512_store_si512(lanes, acc);
+  size_t count = 0;
+  for (uint64_t lane : lanes) {
+    count += lane;
+  }
+  return count;
+}
+#endif
+
+using PopcountFn = size_t (*)(const uint64_t*, size_t);
+
+PopcountFn
+ChoosePopcount() {
+#ifdef KATANA_BITSET_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512vpopcntdq")) {
+    return PopcountAVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return PopcountAVX2;
+  }
+#endif
+  return PopcountScalar;
+}
+
+size_t
+PopcountWords(const uint64_t* words, size_t n) {
+  static const PopcountFn popcount = ChoosePopcount();
+  return popcount(words, n);
+}
+
+/// Calls fn(begin, end) on blocks of whole cache lines of words in parallel
+template <typename F>
+void
+ForEachBlock(size_t num_words, const F& fn) {
+  if (num_words < kSerialWords || katana::getActiveThreads() == 1) {
+    fn(size_t{0}, num_words);
+    return;
+  }
+
+  size_t num_lines = (num_words + kWordsPerLine - 1) / kWordsPerLine;
+  katana::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [begin, end] =
+        katana::block_range(size_t{0}, num_lines, tid, nthreads);
+    begin *= kWordsPerLine;
+    end = std::min(end * kWordsPerLine, num_words);
+    if (begin < end) {
+      fn(begin, end);
+    }
+  });
+}
+
+void
+Apply(
+    BitOp op, katana::DynamicBitset* dst, const katana::DynamicBitset& a,
+    const katana::DynamicBitset& b) {
+  uint64_t* d = Words(dst);
+  const uint64_t* wa = Words(a);
+  const uint64_t* wb = Words(b);
+  ForEachBlock(dst->get_vec().size(), [&](size_t begin, size_t end) {
+    ApplyWords(op, d + begin, wa + begin, wb + begin, end - begin);
+  });
+}
+
+}  // namespace
+
+void
+katana::DynamicBitset::ClearPadding() {
+  size_t used = num_bits_ % kNumBitsInUint64;
+  if (used != 0) {
+    bitvec_[bitvec_.size() - 1] &= (uint64_t{1} << used) - 1;
+  }
+}
+
 void
 katana::DynamicBitset::bitwise_or(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] |= other_bitvec[i]; }, katana::no_stats());
+  Apply(BitOp::kOr, this, *this, other);
 }
 
 void
 katana::DynamicBitset::bitwise_not() {
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = ~bitvec_[i]; }, katana::no_stats());
+  Apply(BitOp::kNot, this, *this, *this);
+  ClearPadding();
 }
 
 void
 katana::DynamicBitset::bitwise_and(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] &= other_bitvec[i]; }, katana::no_stats());
+  Apply(BitOp::kAnd, this, *this, other);
 }
 
 void
@@ -57,22 +277,13 @@ katana::DynamicBitset::bitwise_and(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
   KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
-
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] & other_bitvec2[i]; },
-      katana::no_stats());
+  Apply(BitOp::kAnd, this, other1, other2);
 }
 
 void
 katana::DynamicBitset::bitwise_xor(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] ^= other_bitvec[i]; }, katana::no_stats());
+  Apply(BitOp::kXor, this, *this, other);
 }
 
 void
@@ -80,34 +291,58 @@ katana::DynamicBitset::bitwise_xor(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
   KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
+  Apply(BitOp::kXor, this, other1, other2);
+}
 
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] ^ other_bitvec2[i]; },
-      katana::no_stats());
+void
+katana::DynamicBitset::bitwise_andnot(const DynamicBitset& other) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
+  Apply(BitOp::kAndNot, this, *this, other);
 }
 
 size_t
 katana::DynamicBitset::count() const {
   katana::GAccumulator<size_t> ret;
-  katana::do_all(
-      katana::iterate(bitvec_.begin(), bitvec_.end()),
-      [&](uint64_t n) {
-#ifdef __GNUC__
-        ret += __builtin_popcountll(n);
-#else
-        n = n - ((n >> 1) & 0x5555555555555555UL);
-        n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-        ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-               56;
-#endif
-      },
-      katana::no_stats());
+  const uint64_t* words = Words(*this);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    ret += PopcountWords(words + begin, end - begin);
+  });
+  return ret.reduce();
+}
+
+size_t
+katana::DynamicBitset::and_count(const DynamicBitset& other) const {
+  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
+  katana::GAccumulator<size_t> ret;
+  const uint64_t* a = Words(*this);
+  const uint64_t* b = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    uint64_t chunk[kChunkWords];
+    size_t count = 0;
+    for (size_t i = begin; i < end; i += kChunkWords) {
+      size_t len = std::min(kChunkWords, end - i);
+      ApplyWords(BitOp::kAnd, chunk, a + i, b + i, len);
+      count += PopcountWords(chunk, len);
+    }
+    ret += count;
+  });
   return ret.reduce();
 }
 
+void
+katana::DynamicBitset::or_and_clear(DynamicBitset* other) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other->size());
+  uint64_t* a = Words(this);
+  uint64_t* b = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i += kChunkWords) {
+      size_t len = std::min(kChunkWords, end - i);
+      ApplyWords(BitOp::kOr, a + i, a + i, b + i, len);
+      std::memset(b + i, 0, len * sizeof(uint64_t));
+    }
+  });
+}
+
 namespace {
 template <typename Integer>
 void
@@ -116,20 +351,14 @@ ComputeOffsets(
   // TODO uint32_t is somewhat dangerous; change in the future
   uint32_t activeThreads = katana::getActiveThreads();
   std::vector<Integer> tPrefixBitCounts(activeThreads);
+  const uint64_t* words = Words(bitset);
+  size_t num_words = bitset.get_vec().size();
 
   // count how many bits are set on each thread
   katana::on_each([&](unsigned tid, unsigned nthreads) {
     auto [start, end] =
-        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
-
-    Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
-    }
-
-    tPrefixBitCounts[tid] = count;
+        katana::block_range(size_t{0}, num_words, tid, nthreads);
+    tPrefixBitCounts[tid] = PopcountWords(words + start, end - start);
   });
 
   // calculate prefix sum of bits per thread
@@ -145,18 +374,23 @@ ComputeOffsets(
   if (bitsetCount > 0) {
     size_t cur_size = offsets->size();
     offsets->resize(cur_size + bitsetCount);
+    Integer* out = offsets->data() + cur_size;
     katana::on_each([&](unsigned tid, unsigned nthreads) {
       auto [start, end] =
-          katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
-      Integer index = cur_size;
+          katana::block_range(size_t{0}, num_words, tid, nthreads);
+      Integer index = 0;
       if (tid != 0) {
         index += tPrefixBitCounts[tid - 1];
       }
 
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets->at(index) = i;
+      // visit only the set bits of each word, lowest first
+      for (size_t i = start; i < end; ++i) {
+        uint64_t word = words[i];
+        Integer base = i * katana::DynamicBitset::kNumBitsInUint64;
+        while (word != 0) {
+          out[index] = base + __builtin_ctzll(word);
           ++index;
+          word &= word - 1;
         }
       }
     });
@@ -0,0 +1,156 @@
+#include "katana/ExecutionContext.h"
+
+#include <algorithm>
+
+#include "katana/ErrorCode.h"
+#include "katana/HWTopo.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+
+katana::ExecutionContext::ExecutionContext(
+    std::unique_ptr<ThreadPool::Partition> partition)
+    : partition_(std::move(partition)),
+      active_threads_(partition_->threads.size()) {
+  partition_->owner = this;
+}
+
+katana::ExecutionContext::~ExecutionContext() {
+  {
+    // The barrier and termination detection use per-thread storage of the
+    // context, so destroy them in its scope
+    Scope scope(*this);
+    barrier_.reset();
+    term_.reset();
+  }
+  GetThreadPool().releasePartition(std::move(partition_));
+}
+
+katana::Result<std::unique_ptr<katana::ExecutionContext>>
+katana::ExecutionContext::MakeFromThreads(std::vector<unsigned> threads) {
+  auto partition = GetThreadPool().makePartition(std::move(threads));
+  if (!partition) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "threads are not available for a context");
+  }
+
+  std::unique_ptr<ExecutionContext> ctx(
+      new ExecutionContext(std::move(partition)));
+  {
+    // The barrier reads the topology of the context when it is made
+    Scope scope(*ctx);
+    ctx->barrier_threads_ = ctx->num_threads();
+    ctx->barrier_ = CreateTopoBarrier(ctx->barrier_threads_);
+    ctx->term_ = internal::CreateLocalTerminationDetection();
+  }
+  return std::unique_ptr<ExecutionContext>(std::move(ctx));
+}
+
+katana::Result<std::unique_ptr<katana::ExecutionContext>>
+katana::ExecutionContext::Make(unsigned num_threads) {
+  if (num_threads == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "context must have at least one thread");
+  }
+
+  // Pool thread ids order distinct cores first and, among those, threads of
+  // the same socket together, so the lowest free ids are the closest.
+  auto& tp = GetThreadPool();
+  std::vector<unsigned> threads;
+  for (unsigned t = 0;
+       t < tp.getMaxPoolThreads() && threads.size() < num_threads; ++t) {
+    if (tp.isAvailable(t)) {
+      threads.emplace_back(t);
+    }
+  }
+  if (threads.size() < num_threads) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "only {} of {} requested threads are available", threads.size(),
+        num_threads);
+  }
+  return MakeFromThreads(std::move(threads));
+}
+
+katana::Result<std::unique_ptr<katana::ExecutionContext>>
+katana::ExecutionContext::MakeForNumaNode(unsigned numa_node) {
+  auto& tp = GetThreadPool();
+  HWTopoInfo topo = getHWTopo();
+
+  std::vector<unsigned> threads;
+  for (unsigned t = 0; t < tp.getMaxPoolThreads(); ++t) {
+    if (topo.threadTopoInfo[t].numaNode != numa_node) {
+      continue;
+    }
+    // thread 0 of the pool belongs to the caller of the whole pool
+    if (t == 0) {
+      continue;
+    }
+    if (!tp.isAvailable(t)) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "thread {} of numa node {} is not available", t, numa_node);
+    }
+    threads.emplace_back(t);
+  }
+  if (threads.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::NotFound, "no threads on numa node {}", numa_node);
+  }
+  return MakeFromThreads(std::move(threads));
+}
+
+katana::ExecutionContext*
+katana::ExecutionContext::Current() {
+  ThreadPool::Partition* p = ThreadPool::getPartition();
+  if (!p) {
+    return nullptr;
+  }
+  return static_cast<ExecutionContext*>(p->owner);
+}
+
+unsigned
+katana::ExecutionContext::SetActiveThreads(unsigned num) {
+  num = std::min(num, num_threads());
+  num = std::max(num, 1U);
+  active_threads_ = num;
+  return num;
+}
+
+katana::Barrier&
+katana::ExecutionContext::GetBarrier(unsigned active_threads) {
+  KATANA_LOG_DEBUG_ASSERT(Current() == this);
+  active_threads = std::min(active_threads, num_threads());
+  active_threads = std::max(active_threads, 1U);
+
+  if (active_threads != barrier_threads_) {
+    barrier_threads_ = active_threads;
+    barrier_->Reinit(barrier_threads_);
+  }
+  return *barrier_;
+}
+
+katana::TerminationDetection&
+katana::ExecutionContext::GetTerminationDetection(unsigned active_threads) {
+  KATANA_LOG_DEBUG_ASSERT(Current() == this);
+  term_->Init(active_threads);
+  return *term_;
+}
+
+katana::ExecutionContext::Scope::Scope(ExecutionContext& ctx) {
+  ThreadPool::Partition* p = ctx.partition_.get();
+  GetThreadPool().enterPartition(p);
+
+  // The calling thread stands in for thread 0 of the context, whose pool
+  // thread is idle meanwhile, so it takes over its per-thread storage.
+  pts_base_ = ptsBase;
+  pss_base_ = pssBase;
+  ptsBase = getPTSBackend().getPoolBase(p->threads[0]);
+  pssBase = getPPSBackend().getPoolBase(p->threads[0]);
+}
+
+katana::ExecutionContext::Scope::~Scope() {
+  ptsBase = pts_base_;
+  pssBase = pss_base_;
+  GetThreadPool().leavePartition();
+}
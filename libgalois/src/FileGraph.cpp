@@ -31,7 +31,9 @@
 
 #include "katana/Logging.h"
 #include "katana/PageAlloc.h"
+#include "katana/Threads.h"
 #include "katana/gIO.h"
+#include "tsuba/CSRTopology.h"
 #include "tsuba/file.h"
 
 #ifdef __linux__
@@ -158,6 +160,11 @@ FileGraph::fromMem(
   uint64_t* fptr = (uint64_t*)m;
   graphVersion = convert_le64toh(*fptr++);
 
+  if (graphVersion == tsuba::kCompressedCSRTopologyVersion) {
+    KATANA_DIE(
+        "compressed topology files (version ", graphVersion,
+        ") can only be read as part of a property graph");
+  }
   if (graphVersion != 1 && graphVersion != 2) {
     KATANA_DIE("unknown file version ", graphVersion);
   }
@@ -455,7 +462,7 @@ FileGraph::partFromFile(
 
   // do interleaved numa allocation with current number of threads
   if (numaMap) {
-    unsigned int numThreads = katana::activeThreads;
+    unsigned int numThreads = katana::getActiveThreads();
     const size_t hugePageSize = 2 * 1024 * 1024;  // 2MB
 
     void* ptr;
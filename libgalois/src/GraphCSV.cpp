@@ -0,0 +1,913 @@
+#include "katana/GraphCSV.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <boost/algorithm/string.hpp>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Threads.h"
+
+namespace {
+
+/// Number of byte ranges per thread when CSVImportOptions::num_chunks is 0.
+/// More than one evens out ranges that take longer to parse.
+constexpr size_t kChunksPerThread = 4;
+/// Number of independently built parts of the node id map
+constexpr size_t kNumShards = 256;
+
+/// A read-only mapping of a whole file
+class MappedFile {
+public:
+  static katana::Result<std::unique_ptr<MappedFile>> Make(
+      const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return KATANA_ERROR(katana::ResultErrno(), "opening {}", filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      auto ec = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(ec, "reading size of {}", filename);
+    }
+    size_t size = st.st_size;
+    void* data = nullptr;
+    if (size > 0) {
+      data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        auto ec = katana::ResultErrno();
+        close(fd);
+        return KATANA_ERROR(ec, "mapping {}", filename);
+      }
+    }
+    close(fd);
+    return std::unique_ptr<MappedFile>(new MappedFile(filename, data, size));
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    if (size_ > 0) {
+      munmap(data_, size_);
+    }
+  }
+
+  std::string_view contents() const {
+    return std::string_view(static_cast<const char*>(data_), size_);
+  }
+  const std::string& filename() const { return filename_; }
+
+private:
+  MappedFile(std::string filename, void* data, size_t size)
+      : filename_(std::move(filename)), data_(data), size_(size) {}
+
+  std::string filename_;
+  void* data_;
+  size_t size_;
+};
+
+/***************************/
+/* Functions for splitting */
+/***************************/
+
+/// SplitLines splits \param text into at most \param num_chunks ranges of
+/// about the same size that each end at a line break
+std::vector<std::string_view>
+SplitLines(std::string_view text, size_t num_chunks) {
+  std::vector<std::string_view> chunks;
+  size_t begin = 0;
+  for (size_t i = 1; i <= num_chunks && begin < text.size(); ++i) {
+    size_t end = text.size();
+    if (i < num_chunks) {
+      end = text.find('\n', std::max(begin, text.size() / num_chunks * i));
+      end = end == std::string_view::npos ? text.size() : end + 1;
+    }
+    chunks.emplace_back(text.substr(begin, end - begin));
+    begin = end;
+  }
+  return chunks;
+}
+
+/// NextLine removes the first line from \param text and returns it without
+/// its line break
+std::string_view
+NextLine(std::string_view* text) {
+  size_t end = text->find('\n');
+  std::string_view line = text->substr(0, end);
+  text->remove_prefix(end == std::string_view::npos ? text->size() : end + 1);
+  if (!line.empty() && line.back() == '\r') {
+    line.remove_suffix(1);
+  }
+  return line;
+}
+
+struct Field {
+  std::string_view text;
+  /// True if the field was empty and unquoted
+  bool null;
+  /// True if text does not point into the line because quotes were
+  /// unescaped
+  bool unescaped;
+};
+
+/// LineTokenizer splits lines into fields. It keeps the unescaped text of
+/// quoted fields, which is valid until the next call to Tokenize.
+class LineTokenizer {
+public:
+  explicit LineTokenizer(char delimiter) : delimiter_(delimiter) {}
+
+  katana::Result<void> Tokenize(std::string_view line) {
+    fields_.clear();
+    size_t num_unescaped = 0;
+    size_t pos = 0;
+    while (true) {
+      if (pos < line.size() && line[pos] == '"') {
+        size_t begin = ++pos;
+        bool escaped = false;
+        while (true) {
+          pos = line.find('"', pos);
+          if (pos == std::string_view::npos) {
+            return KATANA_ERROR(
+                katana::ErrorCode::InvalidArgument, "unterminated quote");
+          }
+          if (pos + 1 < line.size() && line[pos + 1] == '"') {
+            escaped = true;
+            pos += 2;
+            continue;
+          }
+          break;
+        }
+        std::string_view text = line.substr(begin, pos - begin);
+        ++pos;
+        if (pos < line.size() && line[pos] != delimiter_) {
+          return KATANA_ERROR(
+              katana::ErrorCode::InvalidArgument,
+              "unexpected character after quoted field");
+        }
+        if (escaped) {
+          if (num_unescaped == unescaped_.size()) {
+            unescaped_.emplace_back();
+          }
+          std::string& buf = unescaped_[num_unescaped++];
+          buf.clear();
+          for (size_t i = 0; i < text.size(); ++i) {
+            buf.push_back(text[i]);
+            if (text[i] == '"') {
+              ++i;
+            }
+          }
+          text = buf;
+        }
+        fields_.emplace_back(Field{text, false, escaped});
+      } else {
+        size_t end = std::min(line.find(delimiter_, pos), line.size());
+        fields_.emplace_back(
+            Field{line.substr(pos, end - pos), end == pos, false});
+        pos = end;
+      }
+      if (pos >= line.size()) {
+        break;
+      }
+      ++pos;
+    }
+    return katana::ResultSuccess();
+  }
+
+  const std::vector<Field>& fields() const { return fields_; }
+
+private:
+  char delimiter_;
+  std::vector<Field> fields_;
+  // A deque so that growing it does not move the strings fields_ point to
+  std::deque<std::string> unescaped_;
+};
+
+/*************************/
+/* Functions for headers */
+/*************************/
+
+enum class FieldKind { kId, kLabel, kStartId, kEndId, kType, kIgnore, kValue };
+
+struct FieldSpec {
+  FieldKind kind;
+  /// Index of the property the field is stored in, or -1
+  int property;
+};
+
+struct Header {
+  std::vector<FieldSpec> fields;
+  katana::ArrowFields properties;
+};
+
+std::shared_ptr<arrow::DataType>
+PropertyType(std::string type) {
+  boost::algorithm::to_lower(type);
+  if (type == "int" || type == "long" || type == "short" || type == "byte") {
+    return arrow::int64();
+  }
+  if (type == "float" || type == "double") {
+    return arrow::float64();
+  }
+  if (type == "boolean") {
+    return arrow::boolean();
+  }
+  return arrow::utf8();
+}
+
+katana::Result<Header>
+ParseHeader(std::string_view line, char delimiter, bool for_nodes) {
+  LineTokenizer tokenizer(delimiter);
+  if (auto res = tokenizer.Tokenize(line); !res) {
+    return res.error().WithContext("header");
+  }
+
+  Header header;
+  std::set<std::string> names;
+  std::map<FieldKind, size_t> counts;
+  for (const auto& field : tokenizer.fields()) {
+    std::string_view text = field.text;
+    size_t colon = text.rfind(':');
+    std::string name(text.substr(0, colon));
+    std::string type;
+    if (colon != std::string_view::npos) {
+      type = std::string(text.substr(colon + 1));
+      // ID fields may name an id space, e.g., ":ID(Person)", which is not
+      // needed with a single node file
+      type = type.substr(0, type.find('('));
+      boost::algorithm::to_upper(type);
+    }
+
+    FieldSpec spec{FieldKind::kValue, -1};
+    if (type == "ID") {
+      spec.kind = FieldKind::kId;
+    } else if (type == "LABEL") {
+      spec.kind = FieldKind::kLabel;
+    } else if (type == "START_ID") {
+      spec.kind = FieldKind::kStartId;
+    } else if (type == "END_ID") {
+      spec.kind = FieldKind::kEndId;
+    } else if (type == "TYPE") {
+      spec.kind = FieldKind::kType;
+    } else if (type == "IGNORE") {
+      spec.kind = FieldKind::kIgnore;
+    }
+    counts[spec.kind]++;
+
+    bool for_edges_only = spec.kind == FieldKind::kStartId ||
+                          spec.kind == FieldKind::kEndId ||
+                          spec.kind == FieldKind::kType;
+    bool for_nodes_only =
+        spec.kind == FieldKind::kId || spec.kind == FieldKind::kLabel;
+    if ((for_nodes && for_edges_only) || (!for_nodes && for_nodes_only)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "header field {} is not allowed in a {} file", text,
+          for_nodes ? "node" : "edge");
+    }
+
+    // Like neo4j, keep named node ids as properties
+    bool is_property = spec.kind == FieldKind::kValue ||
+                       (spec.kind == FieldKind::kId && !name.empty());
+    if (is_property) {
+      if (name.empty()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "header field {} has no name", text);
+      }
+      if (!names.emplace(name).second) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "header field {} is repeated", name);
+      }
+      spec.property = header.properties.size();
+      header.properties.emplace_back(arrow::field(
+          name, spec.kind == FieldKind::kId ? arrow::utf8()
+                                            : PropertyType(type)));
+    }
+    header.fields.emplace_back(spec);
+  }
+
+  if (for_nodes && counts[FieldKind::kId] != 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "node header needs exactly one :ID field");
+  }
+  if (!for_nodes &&
+      (counts[FieldKind::kStartId] != 1 || counts[FieldKind::kEndId] != 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge header needs exactly one :START_ID and one :END_ID field");
+  }
+  if (counts[FieldKind::kLabel] > 1 || counts[FieldKind::kType] > 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "header has more than one :LABEL or :TYPE field");
+  }
+  return header;
+}
+
+/*************************/
+/* Functions for parsing */
+/*************************/
+
+/// The rows parsed from one byte range of a file
+struct ChunkState {
+  /// Node ids of a node file or edge sources of an edge file
+  std::vector<std::string_view> ids;
+  /// Edge destinations of an edge file
+  std::vector<std::string_view> dest_ids;
+  /// Ids that had to be unescaped and are not in the file
+  std::deque<std::string> owned_ids;
+  katana::ArrayBuilders builders;
+  katana::ArrowArrays arrays;
+  /// Rows (relative to this chunk) of each node label or edge type
+  std::map<std::string, std::vector<uint64_t>> label_rows;
+  uint64_t num_rows{0};
+  std::optional<katana::CopyableErrorInfo> error;
+};
+
+std::string_view
+KeepId(const Field& field, ChunkState* chunk) {
+  if (!field.unescaped) {
+    return field.text;
+  }
+  return chunk->owned_ids.emplace_back(field.text);
+}
+
+katana::Result<void>
+AppendValue(
+    arrow::ArrayBuilder* builder, std::string_view text, std::string* buf) {
+  arrow::Status st;
+  switch (builder->type()->id()) {
+  case arrow::Type::INT64: {
+    int64_t value;
+    auto [end, ec] =
+        std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "invalid integer {}", text);
+    }
+    st = static_cast<arrow::Int64Builder*>(builder)->Append(value);
+    break;
+  }
+  case arrow::Type::DOUBLE: {
+    buf->assign(text);
+    char* end = nullptr;
+    double value = std::strtod(buf->c_str(), &end);
+    if (buf->empty() || end != buf->c_str() + buf->size()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "invalid number {}", text);
+    }
+    st = static_cast<arrow::DoubleBuilder*>(builder)->Append(value);
+    break;
+  }
+  case arrow::Type::BOOL: {
+    bool value = boost::algorithm::iequals(text, "true");
+    if (!value && !boost::algorithm::iequals(text, "false")) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "invalid boolean {}", text);
+    }
+    st = static_cast<arrow::BooleanBuilder*>(builder)->Append(value);
+    break;
+  }
+  default:
+    st = static_cast<arrow::StringBuilder*>(builder)->Append(
+        text.data(), text.size());
+    break;
+  }
+  if (!st.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(st), "appending value: {}", st);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+ParseRow(
+    const std::vector<Field>& fields, const Header& header,
+    const katana::CSVImportOptions& opts, ChunkState* chunk,
+    std::string* buf) {
+  if (fields.size() != header.fields.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "expected {} fields but found {}",
+        header.fields.size(), fields.size());
+  }
+
+  for (size_t i = 0; i < fields.size(); ++i) {
+    const Field& field = fields[i];
+    const FieldSpec& spec = header.fields[i];
+    switch (spec.kind) {
+    case FieldKind::kId:
+    case FieldKind::kStartId:
+    case FieldKind::kEndId: {
+      if (field.null) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument, "empty id in field {}", i);
+      }
+      auto* ids =
+          spec.kind == FieldKind::kEndId ? &chunk->dest_ids : &chunk->ids;
+      ids->emplace_back(KeepId(field, chunk));
+      break;
+    }
+    case FieldKind::kLabel: {
+      std::string_view labels = field.text;
+      while (!labels.empty()) {
+        size_t end = std::min(labels.find(opts.array_delimiter), labels.size());
+        if (end > 0) {
+          chunk->label_rows[std::string(labels.substr(0, end))].emplace_back(
+              chunk->num_rows);
+        }
+        labels.remove_prefix(std::min(end + 1, labels.size()));
+      }
+      break;
+    }
+    case FieldKind::kType:
+      if (!field.null) {
+        chunk->label_rows[std::string(field.text)].emplace_back(
+            chunk->num_rows);
+      }
+      break;
+    default:
+      break;
+    }
+
+    if (spec.property < 0) {
+      continue;
+    }
+    arrow::ArrayBuilder* builder = chunk->builders[spec.property].get();
+    if (field.null) {
+      if (auto st = builder->AppendNull(); !st.ok()) {
+        return KATANA_ERROR(
+            katana::ArrowToKatana(st), "appending value: {}", st);
+      }
+    } else if (auto res = AppendValue(builder, field.text, buf); !res) {
+      return res.error().WithContext(
+          "field {}", header.properties[spec.property]->name());
+    }
+  }
+  chunk->num_rows++;
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+ParseChunk(
+    std::string_view text, const char* file_begin, const Header& header,
+    const katana::CSVImportOptions& opts, ChunkState* chunk) {
+  for (const auto& field : header.properties) {
+    std::unique_ptr<arrow::ArrayBuilder> builder;
+    auto st = arrow::MakeBuilder(
+        arrow::default_memory_pool(), field->type(), &builder);
+    if (!st.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(st), "making builder: {}", st);
+    }
+    chunk->builders.emplace_back(std::move(builder));
+  }
+
+  LineTokenizer tokenizer(opts.delimiter);
+  std::string buf;
+  while (!text.empty()) {
+    std::string_view line = NextLine(&text);
+    if (line.empty()) {
+      continue;
+    }
+    auto res = tokenizer.Tokenize(line);
+    if (res) {
+      res = ParseRow(tokenizer.fields(), header, opts, chunk, &buf);
+    }
+    if (!res) {
+      return res.error().WithContext(
+          "line at byte {}", line.data() - file_begin);
+    }
+  }
+
+  for (const auto& builder : chunk->builders) {
+    std::shared_ptr<arrow::Array> array;
+    if (auto st = builder->Finish(&array); !st.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(st), "building array: {}", st);
+    }
+    chunk->arrays.emplace_back(std::move(array));
+  }
+  chunk->builders.clear();
+  return katana::ResultSuccess();
+}
+
+struct ParsedFile {
+  Header header;
+  std::vector<ChunkState> chunks;
+  /// Index of the first row of each chunk
+  std::vector<uint64_t> offsets;
+  uint64_t num_rows{0};
+};
+
+katana::Result<ParsedFile>
+ParseFile(
+    const MappedFile& file, const katana::CSVImportOptions& opts,
+    size_t num_chunks, bool for_nodes) {
+  std::string_view text = file.contents();
+  auto header_res = ParseHeader(NextLine(&text), opts.delimiter, for_nodes);
+  if (!header_res) {
+    return header_res.error().WithContext("{}", file.filename());
+  }
+
+  ParsedFile parsed;
+  parsed.header = std::move(header_res.value());
+  std::vector<std::string_view> ranges = SplitLines(text, num_chunks);
+  parsed.chunks.resize(ranges.size());
+
+  katana::do_all(
+      katana::iterate(size_t{0}, ranges.size()),
+      [&](size_t i) {
+        ChunkState* chunk = &parsed.chunks[i];
+        auto res = ParseChunk(
+            ranges[i], file.contents().data(), parsed.header, opts, chunk);
+        if (!res) {
+          chunk->error = res.error();
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  for (const auto& chunk : parsed.chunks) {
+    if (chunk.error) {
+      return chunk.error->ToErrorInfo().WithContext("{}", file.filename());
+    }
+    parsed.offsets.emplace_back(parsed.num_rows);
+    parsed.num_rows += chunk.num_rows;
+  }
+  return parsed;
+}
+
+/**************************/
+/* Functions for node ids */
+/**************************/
+
+using NodeMapShard = std::unordered_map<std::string_view, uint32_t>;
+
+/// CheckNumNodes rejects graphs with more nodes than 32-bit node ids can
+/// number, the only ones the importer builds; like PropertyGraph, it allows
+/// up to std::numeric_limits<uint32_t>::max() nodes
+katana::Result<void>
+CheckNumNodes(uint64_t num_nodes) {
+  if (num_nodes > std::numeric_limits<uint32_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "found at least {} nodes but the CSV importer only builds graphs "
+        "with 32-bit node ids, which have at most {} nodes",
+        num_nodes, std::numeric_limits<uint32_t>::max());
+  }
+  return katana::ResultSuccess();
+}
+
+size_t
+ShardOf(std::string_view id) {
+  return std::hash<std::string_view>{}(id) % kNumShards;
+}
+
+/// BuildNodeMap maps the ids of a node file to node indexes. The ids of each
+/// chunk are partitioned by shard in parallel and then each shard is built
+/// in parallel, so no locks are needed.
+katana::Result<std::vector<NodeMapShard>>
+BuildNodeMap(const ParsedFile& nodes) {
+  using Entries = std::vector<std::pair<std::string_view, uint32_t>>;
+  std::vector<std::vector<Entries>> partitioned(nodes.chunks.size());
+
+  katana::do_all(
+      katana::iterate(size_t{0}, nodes.chunks.size()),
+      [&](size_t c) {
+        const ChunkState& chunk = nodes.chunks[c];
+        partitioned[c].resize(kNumShards);
+        for (size_t i = 0; i < chunk.ids.size(); ++i) {
+          std::string_view id = chunk.ids[i];
+          partitioned[c][ShardOf(id)].emplace_back(id, nodes.offsets[c] + i);
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<NodeMapShard> shards(kNumShards);
+  std::vector<std::optional<std::string_view>> repeated(kNumShards);
+  katana::do_all(
+      katana::iterate(size_t{0}, kNumShards),
+      [&](size_t s) {
+        for (const auto& chunk_entries : partitioned) {
+          for (const auto& [id, index] : chunk_entries[s]) {
+            if (!shards[s].emplace(id, index).second && !repeated[s]) {
+              repeated[s] = id;
+            }
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  for (const auto& id : repeated) {
+    if (id) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "node id {} is repeated", *id);
+    }
+  }
+  return shards;
+}
+
+/// ResolveEdges fills in the node index of the endpoints of each edge.
+/// Endpoints that are not in \param shards become new nodes, numbered in
+/// order of first appearance starting at \param num_nodes. Returns the new
+/// number of nodes.
+katana::Result<uint64_t>
+ResolveEdges(
+    const ParsedFile& edges, const std::vector<NodeMapShard>& shards,
+    uint64_t num_nodes, std::vector<uint32_t>* sources,
+    std::vector<uint32_t>* destinations) {
+  sources->resize(edges.num_rows);
+  destinations->resize(edges.num_rows);
+
+  // Missing endpoints as 2 * edge + (1 if destination)
+  std::vector<std::vector<uint64_t>> missing(edges.chunks.size());
+
+  katana::do_all(
+      katana::iterate(size_t{0}, edges.chunks.size()),
+      [&](size_t c) {
+        const ChunkState& chunk = edges.chunks[c];
+        for (size_t i = 0; i < chunk.num_rows; ++i) {
+          uint64_t e = edges.offsets[c] + i;
+          for (uint64_t is_dest : {0, 1}) {
+            std::string_view id = is_dest ? chunk.dest_ids[i] : chunk.ids[i];
+            const NodeMapShard& shard = shards[ShardOf(id)];
+            auto it = shard.find(id);
+            if (it == shard.end()) {
+              missing[c].emplace_back(2 * e + is_dest);
+            } else {
+              (is_dest ? *destinations : *sources)[e] = it->second;
+            }
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::unordered_map<std::string_view, uint32_t> created;
+  for (size_t c = 0; c < edges.chunks.size(); ++c) {
+    const ChunkState& chunk = edges.chunks[c];
+    for (uint64_t code : missing[c]) {
+      uint64_t e = code / 2;
+      bool is_dest = code % 2;
+      uint64_t i = e - edges.offsets[c];
+      std::string_view id = is_dest ? chunk.dest_ids[i] : chunk.ids[i];
+      auto [it, inserted] = created.emplace(id, 0);
+      if (inserted) {
+        if (auto res = CheckNumNodes(num_nodes + 1); !res) {
+          return res.error();
+        }
+        it->second = num_nodes++;
+      }
+      (is_dest ? *destinations : *sources)[e] = it->second;
+    }
+  }
+  return num_nodes;
+}
+
+/************************/
+/* Functions for tables */
+/************************/
+
+/// BuildPropertyTable makes a table of the properties parsed from \param
+/// file, followed by \param num_null_rows rows of nulls
+katana::Result<std::shared_ptr<arrow::Table>>
+BuildPropertyTable(const ParsedFile& file, uint64_t num_null_rows) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (size_t p = 0; p < file.header.properties.size(); ++p) {
+    auto type = file.header.properties[p]->type();
+    katana::ArrowArrays arrays;
+    for (const auto& chunk : file.chunks) {
+      if (chunk.num_rows > 0) {
+        arrays.emplace_back(chunk.arrays[p]);
+      }
+    }
+    if (num_null_rows > 0) {
+      auto nulls_res = arrow::MakeArrayOfNull(type, num_null_rows);
+      if (!nulls_res.ok()) {
+        return KATANA_ERROR(
+            katana::ArrowToKatana(nulls_res.status()), "making nulls: {}",
+            nulls_res.status());
+      }
+      arrays.emplace_back(nulls_res.ValueOrDie());
+    }
+    columns.emplace_back(std::make_shared<arrow::ChunkedArray>(arrays, type));
+  }
+  return arrow::Table::Make(
+      arrow::schema(file.header.properties), columns,
+      file.num_rows + num_null_rows);
+}
+
+/// BuildLabelTable makes a table with a boolean column per node label or edge
+/// type of \param file, \param num_rows long
+katana::Result<std::shared_ptr<arrow::Table>>
+BuildLabelTable(const ParsedFile& file, uint64_t num_rows) {
+  std::set<std::string> label_set;
+  for (const auto& chunk : file.chunks) {
+    for (const auto& [label, rows] : chunk.label_rows) {
+      label_set.emplace(label);
+    }
+  }
+  std::vector<std::string> labels(label_set.begin(), label_set.end());
+
+  katana::ArrowFields fields;
+  for (const auto& label : labels) {
+    fields.emplace_back(arrow::field(label, arrow::boolean()));
+  }
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns(labels.size());
+  std::vector<arrow::Status> statuses(labels.size());
+
+  katana::do_all(
+      katana::iterate(size_t{0}, labels.size()),
+      [&](size_t l) {
+        std::vector<uint8_t> flags(num_rows, 0);
+        for (size_t c = 0; c < file.chunks.size(); ++c) {
+          const auto& label_rows = file.chunks[c].label_rows;
+          auto it = label_rows.find(labels[l]);
+          if (it == label_rows.end()) {
+            continue;
+          }
+          for (uint64_t row : it->second) {
+            flags[file.offsets[c] + row] = 1;
+          }
+        }
+        arrow::BooleanBuilder builder;
+        std::shared_ptr<arrow::Array> array;
+        statuses[l] = builder.AppendValues(flags.data(), flags.size());
+        if (statuses[l].ok()) {
+          statuses[l] = builder.Finish(&array);
+        }
+        columns[l] = std::make_shared<arrow::ChunkedArray>(
+            katana::ArrowArrays{array}, arrow::boolean());
+      },
+      katana::steal(), katana::no_stats());
+
+  for (const auto& st : statuses) {
+    if (!st.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(st), "building labels: {}", st);
+    }
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, num_rows);
+}
+
+/// PermuteRows returns a table whose row i is row \param indices[i] of \param
+/// table
+katana::Result<std::shared_ptr<arrow::Table>>
+PermuteRows(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::shared_ptr<arrow::Array>& indices) {
+  if (table->num_columns() == 0) {
+    return table;
+  }
+  auto take_result = arrow::compute::Take(table, indices);
+  if (!take_result.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(take_result.status()), "permuting rows: {}",
+        take_result.status());
+  }
+  return take_result.ValueOrDie().table();
+}
+
+}  // namespace
+
+katana::Result<katana::GraphComponents>
+katana::ConvertCSV(
+    const std::string& nodes_filename, const std::string& edges_filename,
+    const CSVImportOptions& opts) {
+  auto nodes_file_res = MappedFile::Make(nodes_filename);
+  if (!nodes_file_res) {
+    return nodes_file_res.error();
+  }
+  auto edges_file_res = MappedFile::Make(edges_filename);
+  if (!edges_file_res) {
+    return edges_file_res.error();
+  }
+
+  size_t num_chunks = opts.num_chunks;
+  if (num_chunks == 0) {
+    num_chunks = kChunksPerThread * katana::getActiveThreads();
+  }
+
+  auto nodes_res = ParseFile(*nodes_file_res.value(), opts, num_chunks, true);
+  if (!nodes_res) {
+    return nodes_res.error();
+  }
+  ParsedFile nodes = std::move(nodes_res.value());
+  auto edges_res = ParseFile(*edges_file_res.value(), opts, num_chunks, false);
+  if (!edges_res) {
+    return edges_res.error();
+  }
+  ParsedFile edges = std::move(edges_res.value());
+
+  if (auto res = CheckNumNodes(nodes.num_rows); !res) {
+    return res.error().WithContext("{}", nodes_filename);
+  }
+
+  auto shards_res = BuildNodeMap(nodes);
+  if (!shards_res) {
+    return shards_res.error().WithContext("{}", nodes_filename);
+  }
+  std::vector<uint32_t> sources;
+  std::vector<uint32_t> destinations;
+  auto num_nodes_res = ResolveEdges(
+      edges, shards_res.value(), nodes.num_rows, &sources, &destinations);
+  if (!num_nodes_res) {
+    return num_nodes_res.error().WithContext("{}", edges_filename);
+  }
+  uint64_t num_nodes = num_nodes_res.value();
+  uint64_t num_edges = edges.num_rows;
+
+  // Counting sort of edges by source
+  std::vector<uint64_t> out_indices(num_nodes, 0);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { __sync_fetch_and_add(&out_indices[sources[e]], 1); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+
+  std::vector<uint32_t> out_dests;
+  std::vector<size_t> edge_mapping;
+  SortEdgesIntoCSR(
+      out_indices, sources, destinations, &out_dests, &edge_mapping);
+
+  auto topology = std::make_shared<katana::GraphTopology>();
+  arrow::UInt64Builder indices_builder;
+  arrow::UInt32Builder dests_builder;
+  arrow::UInt64Builder mapping_builder;
+  std::shared_ptr<arrow::Array> mapping;
+  arrow::Status st = indices_builder.AppendValues(out_indices);
+  if (st.ok()) {
+    st = indices_builder.Finish(&topology->out_indices);
+  }
+  if (st.ok()) {
+    st = dests_builder.AppendValues(out_dests);
+  }
+  if (st.ok()) {
+    st = dests_builder.Finish(&topology->out_dests);
+  }
+  if (st.ok()) {
+    st = mapping_builder.AppendValues(edge_mapping.data(), edge_mapping.size());
+  }
+  if (st.ok()) {
+    st = mapping_builder.Finish(&mapping);
+  }
+  if (!st.ok()) {
+    return KATANA_ERROR(ArrowToKatana(st), "building topology: {}", st);
+  }
+
+  auto node_properties_res =
+      BuildPropertyTable(nodes, num_nodes - nodes.num_rows);
+  if (!node_properties_res) {
+    return node_properties_res.error();
+  }
+  auto node_labels_res = BuildLabelTable(nodes, num_nodes);
+  if (!node_labels_res) {
+    return node_labels_res.error();
+  }
+  auto edge_properties_res = BuildPropertyTable(edges, 0);
+  if (!edge_properties_res) {
+    return edge_properties_res.error();
+  }
+  auto edge_types_res = BuildLabelTable(edges, num_edges);
+  if (!edge_types_res) {
+    return edge_types_res.error();
+  }
+
+  // Put edge rows in CSR order
+  auto edge_properties = PermuteRows(edge_properties_res.value(), mapping);
+  if (!edge_properties) {
+    return edge_properties.error();
+  }
+  auto edge_types = PermuteRows(edge_types_res.value(), mapping);
+  if (!edge_types) {
+    return edge_types.error();
+  }
+
+  return katana::GraphComponents{
+      GraphComponent{node_properties_res.value(), node_labels_res.value()},
+      GraphComponent{edge_properties.value(), edge_types.value()}, topology};
+}
@@ -0,0 +1,287 @@
+#include "katana/LoopProfiler.h"
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "katana/Env.h"
+#include "katana/Executor_OnEach.h"
+#include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Statistics.h"
+
+namespace {
+
+struct EventSpec {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t
+CacheEvent(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+const EventSpec kEvents[katana::internal::kNumHWCounters] = {
+    {"Cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"Instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"LLCMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"DTLBMisses", PERF_TYPE_HW_CACHE,
+     CacheEvent(
+         PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+         PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    // Reads that miss the memory of the local NUMA node
+    {"RemoteMemoryAccesses", PERF_TYPE_HW_CACHE,
+     CacheEvent(
+         PERF_COUNT_HW_CACHE_NODE, PERF_COUNT_HW_CACHE_OP_READ,
+         PERF_COUNT_HW_CACHE_RESULT_MISS)},
+};
+
+/// The counters of a thread are opened as one group on first use, so that
+/// they are scheduled together and read with one system call, and stay open
+/// until the thread exits.
+class ThreadCounters {
+  bool opened_{false};
+  int leader_{-1};
+  std::vector<int> fds_;
+  /// position of each event in the group, or -1 if it is not counted
+  std::array<int, katana::internal::kNumHWCounters> slot_;
+
+  void Open() {
+    opened_ = true;
+    slot_.fill(-1);
+    for (size_t i = 0; i < katana::internal::kNumHWCounters; ++i) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = kEvents[i].type;
+      attr.config = kEvents[i].config;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+      int fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0);
+      if (fd < 0) {
+        continue;
+      }
+      if (leader_ < 0) {
+        leader_ = fd;
+      }
+      slot_[i] = fds_.size();
+      fds_.emplace_back(fd);
+    }
+    if (leader_ < 0) {
+      KATANA_WARN_ONCE(
+          "hardware counters are not available for loop profiling; check "
+          "/proc/sys/kernel/perf_event_paranoid");
+    }
+  }
+
+public:
+  ThreadCounters() = default;
+  ThreadCounters(const ThreadCounters&) = delete;
+  ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+  ~ThreadCounters() {
+    for (int fd : fds_) {
+      close(fd);
+    }
+  }
+
+  bool Read(katana::internal::HWCounterValues* out) {
+    if (!opened_) {
+      Open();
+    }
+    out->valid = 0;
+    if (leader_ < 0) {
+      return false;
+    }
+
+    // nr, time_enabled, time_running, values[nr]
+    uint64_t buf[3 + katana::internal::kNumHWCounters];
+    ssize_t len = read(leader_, buf, sizeof(buf));
+    if (len < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buf[2] == 0) {
+      return false;
+    }
+    // scale for the time the group was multiplexed out
+    double scale = static_cast<double>(buf[1]) / buf[2];
+    for (size_t i = 0; i < katana::internal::kNumHWCounters; ++i) {
+      if (slot_[i] < 0 || static_cast<uint64_t>(slot_[i]) >= buf[0]) {
+        continue;
+      }
+      out->values[i] = buf[3 + slot_[i]] * scale;
+      out->valid |= 1U << i;
+    }
+    return true;
+  }
+};
+
+thread_local ThreadCounters kThreadCounters;
+
+std::atomic<int> kProfiling{-1};
+
+uint64_t
+ToMicros(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+}  // namespace
+
+void
+katana::SetLoopProfiling(bool enabled) {
+  kProfiling = enabled;
+}
+
+bool
+katana::IsLoopProfilingEnabled() {
+  int p = kProfiling.load(std::memory_order_relaxed);
+  if (p < 0) {
+    bool enabled = false;
+    GetEnv("KATANA_PROFILE_LOOPS", &enabled);
+    p = enabled;
+    kProfiling = p;
+  }
+  return p;
+}
+
+bool
+katana::internal::ReadHWCounters(HWCounterValues* out) {
+  return kThreadCounters.Read(out);
+}
+
+const char*
+katana::internal::HWCounterName(size_t i) {
+  return kEvents[i].name;
+}
+
+struct katana::internal::LoopProfiler::ThreadProfile {
+  bool active{false};
+  std::chrono::steady_clock::time_point begin;
+  std::chrono::steady_clock::time_point end;
+  std::chrono::steady_clock::time_point phase_begin;
+  std::chrono::steady_clock::duration steal{0};
+  std::chrono::steady_clock::duration wait{0};
+  HWCounterValues counters_begin;
+  HWCounterValues counters_end;
+};
+
+struct katana::internal::LoopProfiler::State {
+  const char* loopname;
+  bool profiling;
+  bool timeline;
+  PerThreadStorage<ThreadProfile> threads;
+};
+
+katana::internal::LoopProfiler::LoopProfiler(const char* loopname) {
+  if (!loopname) {
+    return;
+  }
+  bool profiling = IsLoopProfilingEnabled();
+  bool timeline = IsRecordingTimeline();
+  if (profiling || timeline) {
+    state_ = std::make_unique<State>();
+    state_->loopname = loopname;
+    state_->profiling = profiling;
+    state_->timeline = timeline;
+  }
+}
+
+katana::internal::LoopProfiler::~LoopProfiler() {
+  if (!state_ || !state_->profiling) {
+    return;
+  }
+
+  // A thread is also idle from the start of the loop, when the first thread
+  // began, until it began, and from when it ended until the last thread ended
+  auto& threads = state_->threads;
+  std::chrono::steady_clock::time_point first_begin;
+  std::chrono::steady_clock::time_point last_end;
+  bool any = false;
+  for (unsigned t = 0; t < threads.size(); ++t) {
+    const ThreadProfile& p = *threads.getRemote(t);
+    if (!p.active) {
+      continue;
+    }
+    first_begin = any ? std::min(first_begin, p.begin) : p.begin;
+    last_end = any ? std::max(last_end, p.end) : p.end;
+    any = true;
+  }
+  if (!any) {
+    return;
+  }
+
+  const char* loopname = state_->loopname;
+  on_each_gen(
+      [&](unsigned, unsigned) {
+        const ThreadProfile& p = *threads.getLocal();
+        if (!p.active) {
+          return;
+        }
+        auto total = p.end - p.begin;
+        auto outside = (last_end - first_begin) - total;
+        auto busy = std::max(total - p.steal - p.wait, total.zero());
+        ReportStatSum(loopname, "BusyTime", ToMicros(busy));
+        ReportStatSum(loopname, "StealTime", ToMicros(p.steal));
+        ReportStatSum(loopname, "IdleTime", ToMicros(p.wait + outside));
+
+        uint32_t valid = p.counters_begin.valid & p.counters_end.valid;
+        for (size_t i = 0; i < kNumHWCounters; ++i) {
+          // scaled values of multiplexed counters may go backwards
+          if ((valid & (1U << i)) &&
+              p.counters_end.values[i] >= p.counters_begin.values[i]) {
+            ReportStatSum(
+                loopname, HWCounterName(i),
+                p.counters_end.values[i] - p.counters_begin.values[i]);
+          }
+        }
+      },
+      std::make_tuple());
+}
+
+void
+katana::internal::LoopProfiler::DoBeginThread() {
+  ThreadProfile& p = *state_->threads.getLocal();
+  p.active = true;
+  if (state_->profiling) {
+    ReadHWCounters(&p.counters_begin);
+  }
+  p.begin = std::chrono::steady_clock::now();
+}
+
+void
+katana::internal::LoopProfiler::DoEndThread() {
+  ThreadProfile& p = *state_->threads.getLocal();
+  p.end = std::chrono::steady_clock::now();
+  if (state_->profiling) {
+    ReadHWCounters(&p.counters_end);
+  }
+  if (state_->timeline) {
+    ReportTimelineEvent(state_->loopname, "Loop", p.begin, p.end);
+  }
+}
+
+void
+katana::internal::LoopProfiler::DoBeginPhase() {
+  state_->threads.getLocal()->phase_begin = std::chrono::steady_clock::now();
+}
+
+void
+katana::internal::LoopProfiler::DoEndPhase(Phase phase) {
+  ThreadProfile& p = *state_->threads.getLocal();
+  auto d = std::chrono::steady_clock::now() - p.phase_begin;
+  switch (phase) {
+  case kSteal:
+    p.steal += d;
+    break;
+  case kWait:
+    p.wait += d;
+    break;
+  default:
+    break;
+  }
+}
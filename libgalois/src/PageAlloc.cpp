@@ -19,24 +19,31 @@
 
 #include "katana/PageAlloc.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <vector>
 
+#include "katana/Env.h"
+#include "katana/HWTopo.h"
 #include "katana/Logging.h"
 #include "katana/SimpleLock.h"
+#include "katana/ThreadPool.h"
 
 #ifdef __linux__
 #include <linux/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
 #include <sys/mman.h>
 
 // figure this out dynamically
 const size_t hugePageSize = 2 * 1024 * 1024;
-// protect mmap, munmap since linux has issues
-static katana::SimpleLock allocLock;
 
 static void*
 trymmap(size_t size, int flag) {
-  std::lock_guard<katana::SimpleLock> lg(allocLock);
   const int _PROT = PROT_READ | PROT_WRITE;
   void* ptr = mmap(0, size, _PROT, flag, -1, 0);
   if (ptr == MAP_FAILED) {
@@ -69,6 +76,424 @@ static const int _MAP_HUGE = MAP_HUGETLB | _MAP;
 static const int _MAP_HUGE_POP = _MAP_POP;
 static const int _MAP_HUGE = _MAP;
 #endif
+#ifdef MAP_NORESERVE
+static const int _MAP_RESERVE = MAP_NORESERVE | _MAP;
+#else
+static const int _MAP_RESERVE = _MAP;
+#endif
+
+namespace {
+
+// Single pages come from per-NUMA-node arenas. An arena carves pages out of
+// regions, which are mapped when the arena runs out of pages and bound to the
+// arena's NUMA node. A region whose pages are all freed is unmapped, unless
+// it is the one the arena is currently filling.
+//
+// Regions are regionSize bytes of 2 MB pages or, if KATANA_USE_1GB_PAGES
+// allows and the system has any, gigaRegionSize bytes backed by one 1 GB
+// page. Either way they are aligned to regionSize.
+const size_t regionSize = 32 * hugePageSize;
+const size_t gigaRegionSize = 1024 * 1024 * 1024;
+// Bounds the number of regions mapped at once; past that, single pages are
+// mapped directly like multi-page allocations
+const size_t maxRegions = 4096;
+
+struct FreePage {
+  FreePage* next;
+};
+
+// Regions live in a fixed table of slots. A slot is in use while inUse is
+// set. The other fields belong to the arena that owns the slot and are
+// protected by its lock.
+struct Region {
+  std::atomic<bool> inUse{false};
+  char* base{nullptr};
+  size_t size{0};
+  unsigned arena{0};
+  // Bytes handed out by bumping
+  size_t used{0};
+  // Pages handed out and not freed yet
+  size_t live{0};
+  // Freed pages, which are handed out again before bumping
+  FreePage* freeList{nullptr};
+  // Links in the list of regions of the arena that have freed pages
+  Region* prevFree{nullptr};
+  Region* nextFree{nullptr};
+};
+
+struct Arena {
+  unsigned osNumaNode{0};
+  katana::SimpleLock lock;
+  // The region pages are bumped from
+  Region* current{nullptr};
+  // The regions of this arena whose freeList is not empty
+  Region* withFree{nullptr};
+};
+
+Region regionTable[maxRegions];
+
+// Every regionSize chunk of the address space belongs to at most one region.
+// chunkMap maps chunks to their region in two levels, so freePages finds the
+// region of a page in constant time and without a lock. Leaves are made on
+// demand and never freed.
+const unsigned chunkShift = 26;
+static_assert(size_t{1} << chunkShift == regionSize);
+const unsigned addressBits = 48;
+const unsigned chunkLeafBits = 11;
+const size_t numChunks = size_t{1} << (addressBits - chunkShift);
+const size_t chunkLeafSize = size_t{1} << chunkLeafBits;
+
+std::atomic<std::atomic<Region*>*> chunkMap[numChunks / chunkLeafSize];
+
+// The chunkMap entry of the chunk holding ptr. Returns nullptr if ptr is
+// outside the mapped address range or, unless create is true, if the leaf of
+// the chunk has not been made.
+std::atomic<Region*>*
+chunkEntry(const void* ptr, bool create) {
+  uintptr_t chunk = reinterpret_cast<uintptr_t>(ptr) >> chunkShift;
+  if (chunk >= numChunks) {
+    return nullptr;
+  }
+  std::atomic<std::atomic<Region*>*>& leafPtr =
+      chunkMap[chunk >> chunkLeafBits];
+  std::atomic<Region*>* leaf = leafPtr.load(std::memory_order_acquire);
+  if (!leaf) {
+    if (!create) {
+      return nullptr;
+    }
+    auto* fresh = new std::atomic<Region*>[chunkLeafSize]();
+    if (leafPtr.compare_exchange_strong(
+            leaf, fresh, std::memory_order_acq_rel)) {
+      leaf = fresh;
+    } else {
+      delete[] fresh;
+    }
+  }
+  return &leaf[chunk & (chunkLeafSize - 1)];
+}
+
+class Arenas {
+  std::unique_ptr<Arena[]> arenas_;
+  unsigned num_{0};
+
+public:
+  Arenas() {
+    katana::HWTopoInfo topo = katana::getHWTopo();
+    num_ = std::max(topo.machineTopoInfo.maxNumaNodes, 1U);
+    arenas_ = std::make_unique<Arena[]>(num_);
+    for (const katana::ThreadTopoInfo& t : topo.threadTopoInfo) {
+      if (t.numaNode < num_) {
+        arenas_[t.numaNode].osNumaNode = t.osNumaNode;
+      }
+    }
+  }
+
+  unsigned size() const { return num_; }
+
+  Arena& operator[](unsigned i) { return arenas_[i]; }
+};
+
+Arenas&
+getArenas() {
+  // Never destroyed so that pages can be freed during static destruction
+  static Arenas* arenas = new Arenas;
+  return *arenas;
+}
+
+bool
+use1GBPages() {
+  static bool use = [] {
+    bool r = true;
+    katana::GetEnv("KATANA_USE_1GB_PAGES", &r);
+    return r;
+  }();
+  return use;
+}
+
+// Prefer, but do not require, memory from the given node
+void
+bindToNode(
+    [[maybe_unused]] void* ptr, [[maybe_unused]] size_t size,
+    [[maybe_unused]] unsigned osNumaNode) {
+#if defined(__linux__) && defined(SYS_mbind)
+  const int mpolPreferred = 1;
+  const unsigned long bitsPerWord = 8 * sizeof(unsigned long);
+  unsigned long mask[16] = {};
+  if (osNumaNode >= bitsPerWord * 16) {
+    return;
+  }
+  mask[osNumaNode / bitsPerWord] = 1UL << (osNumaNode % bitsPerWord);
+  if (syscall(
+          SYS_mbind, ptr, size, mpolPreferred, mask, bitsPerWord * 16 + 1,
+          0) != 0) {
+    KATANA_DEBUG_WARN_ONCE("mbind failed: {}", errno);
+  }
+#endif
+}
+
+// Map regionSize bytes aligned to regionSize with flags. An aligned address
+// is found by reserving twice the size. Mappings other than _MAP_RESERVE
+// give the reservation back and ask for the aligned address as a hint;
+// MAP_FIXED would not be safe, since a failed fixed mapping may drop the
+// reservation and another thread may map the range before it is unmapped.
+char*
+mapAligned(int flags) {
+  char* raw = static_cast<char*>(trymmap(2 * regionSize, _MAP_RESERVE));
+  if (!raw) {
+    return nullptr;
+  }
+  uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+  char* base = reinterpret_cast<char*>(
+      (addr + regionSize - 1) & ~static_cast<uintptr_t>(regionSize - 1));
+  if (flags != _MAP_RESERVE) {
+    munmap(raw, 2 * regionSize);
+    void* ptr = mmap(base, regionSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (ptr == MAP_FAILED) {
+      return nullptr;
+    }
+    if (ptr != base) {
+      munmap(ptr, regionSize);
+      return nullptr;
+    }
+    return base;
+  }
+  if (base != raw) {
+    munmap(raw, base - raw);
+  }
+  size_t tail = regionSize - (base - raw);
+  if (tail) {
+    munmap(base + regionSize, tail);
+  }
+  return base;
+}
+
+// Map a region for an arena and set size to its size
+char*
+mapRegion(size_t* size) {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_1GB)
+  // Stop trying once the system has run out of 1 GB pages
+  static std::atomic<bool> have1GBPages{true};
+  if (use1GBPages() && have1GBPages.load(std::memory_order_relaxed)) {
+    // hugetlb mappings are aligned to their page size
+    if (void* ptr = trymmap(gigaRegionSize, _MAP_HUGE | MAP_HUGE_1GB)) {
+      *size = gigaRegionSize;
+      return static_cast<char*>(ptr);
+    }
+    have1GBPages.store(false, std::memory_order_relaxed);
+  }
+#endif
+  *size = regionSize;
+  if (char* base = mapAligned(_MAP_HUGE)) {
+    return base;
+  }
+
+  // Fall back to regular pages that transparent huge pages can back
+  KATANA_DEBUG_WARN_ONCE(
+      "huge page alloc failed, falling back to regular pages");
+  char* base = mapAligned(_MAP_RESERVE);
+  if (!base) {
+    return nullptr;
+  }
+#ifdef MADV_HUGEPAGE
+  madvise(base, regionSize, MADV_HUGEPAGE);
+#endif
+  return base;
+}
+
+// Point the chunks of region at value
+void
+setChunks(Region* region, Region* value) {
+  for (size_t offset = 0; offset < region->size; offset += regionSize) {
+    chunkEntry(region->base + offset, false)
+        ->store(value, std::memory_order_release);
+  }
+}
+
+// Claim a free slot of regionTable for a mapping of size bytes at base and
+// enter it in chunkMap. Returns nullptr if all slots are in use.
+Region*
+claimRegion(char* base, size_t size, unsigned arenaID) {
+  for (size_t offset = 0; offset < size; offset += regionSize) {
+    if (!chunkEntry(base + offset, true)) {
+      return nullptr;
+    }
+  }
+  for (size_t i = 0; i < maxRegions; ++i) {
+    Region& region = regionTable[i];
+    if (region.inUse.load(std::memory_order_relaxed) ||
+        region.inUse.exchange(true, std::memory_order_acquire)) {
+      continue;
+    }
+    // The other fields are only read through pages of this region, which
+    // are handed out under the arena lock
+    region.base = base;
+    region.size = size;
+    region.arena = arenaID;
+    region.used = 0;
+    region.live = 0;
+    region.freeList = nullptr;
+    region.prevFree = nullptr;
+    region.nextFree = nullptr;
+    setChunks(&region, &region);
+    return &region;
+  }
+  return nullptr;
+}
+
+// Unmap region and free its slot. The region is no longer reachable from
+// its arena, so this does not need the arena lock.
+void
+releaseRegion(Region* region) {
+  setChunks(region, nullptr);
+  if (munmap(region->base, region->size) != 0) {
+    KATANA_LOG_FATAL("munmap failed: {}", errno);
+  }
+  region->inUse.store(false, std::memory_order_release);
+}
+
+// Add region to the regions of arena with freed pages. The caller holds the
+// arena lock.
+void
+linkFree(Arena& arena, Region* region) {
+  region->prevFree = nullptr;
+  region->nextFree = arena.withFree;
+  if (arena.withFree) {
+    arena.withFree->prevFree = region;
+  }
+  arena.withFree = region;
+}
+
+// Remove region from the regions of arena with freed pages. The caller holds
+// the arena lock.
+void
+unlinkFree(Arena& arena, Region* region) {
+  if (region->prevFree) {
+    region->prevFree->nextFree = region->nextFree;
+  } else {
+    arena.withFree = region->nextFree;
+  }
+  if (region->nextFree) {
+    region->nextFree->prevFree = region->prevFree;
+  }
+  region->prevFree = nullptr;
+  region->nextFree = nullptr;
+}
+
+// Hand out the next unused page of the current region of arena, or return
+// nullptr if it has none. The caller holds the arena lock.
+char*
+bumpPage(Arena& arena) {
+  Region* region = arena.current;
+  if (!region || region->used == region->size) {
+    return nullptr;
+  }
+  char* page = region->base + region->used;
+  region->used += hugePageSize;
+  ++region->live;
+  return page;
+}
+
+// Allocate a single page from the arena of the calling thread's NUMA node.
+// Returns nullptr if the arena cannot grow.
+//
+// The arena lock only covers list and counter updates: zeroing reused pages
+// and mapping regions happen outside of it.
+void*
+arenaAlloc() {
+  Arenas& arenas = getArenas();
+  unsigned arenaID = katana::ThreadPool::getNumaNode() % arenas.size();
+  Arena& arena = arenas[arenaID];
+
+  FreePage* reused = nullptr;
+  {
+    std::lock_guard<katana::SimpleLock> lg(arena.lock);
+    if (Region* region = arena.withFree) {
+      reused = region->freeList;
+      region->freeList = reused->next;
+      if (!region->freeList) {
+        unlinkFree(arena, region);
+      }
+      ++region->live;
+    } else if (char* page = bumpPage(arena)) {
+      return page;
+    }
+  }
+  if (reused) {
+    // Keep the guarantee of fresh mappings that pages start zeroed
+    std::memset(reused, 0, hugePageSize);
+    return reused;
+  }
+
+  size_t size = 0;
+  char* base = mapRegion(&size);
+  if (!base) {
+    return nullptr;
+  }
+  if (arenas.size() > 1) {
+    bindToNode(base, size, arena.osNumaNode);
+  }
+  Region* region = claimRegion(base, size, arenaID);
+  if (!region) {
+    munmap(base, size);
+    return nullptr;
+  }
+
+  // Another thread may have grown the arena in the meantime; then the new
+  // region is not needed
+  Region* unused = region;
+  char* page = nullptr;
+  {
+    std::lock_guard<katana::SimpleLock> lg(arena.lock);
+    page = bumpPage(arena);
+    if (!page) {
+      unused = arena.current;
+      arena.current = region;
+      page = bumpPage(arena);
+      // The old current region is released once it has no live pages
+      if (unused && unused->live == 0) {
+        if (unused->freeList) {
+          unlinkFree(arena, unused);
+        }
+      } else {
+        unused = nullptr;
+      }
+    }
+  }
+  if (unused) {
+    releaseRegion(unused);
+  }
+  return page;
+}
+
+// Find the region that ptr was allocated from, if any
+Region*
+findRegion(void* ptr) {
+  std::atomic<Region*>* entry = chunkEntry(ptr, false);
+  return entry ? entry->load(std::memory_order_acquire) : nullptr;
+}
+
+// Return a page of region to its arena, unmapping the region once all its
+// pages are free
+void
+arenaFree(Region* region, void* ptr) {
+  Arena& arena = getArenas()[region->arena];
+  auto* page = static_cast<FreePage*>(ptr);
+  {
+    std::lock_guard<katana::SimpleLock> lg(arena.lock);
+    if (!region->freeList) {
+      linkFree(arena, region);
+    }
+    page->next = region->freeList;
+    region->freeList = page;
+    if (--region->live != 0 || region == arena.current) {
+      return;
+    }
+    unlinkFree(arena, region);
+  }
+  releaseRegion(region);
+}
+
+}  // namespace
 
 size_t
 katana::allocSize() {
@@ -81,7 +506,15 @@ katana::allocPages(unsigned num, bool preFault) {
     return nullptr;
   }
 
-  void* ptr = trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+  void* ptr = nullptr;
+  if (num == 1) {
+    ptr = arenaAlloc();
+  }
+  bool handMap = doHandMap || ptr;
+
+  if (!ptr) {
+    ptr = trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+  }
   if (!ptr) {
     KATANA_DEBUG_WARN_ONCE(
         "huge page alloc failed, falling back to regular pages");
@@ -92,7 +525,7 @@ katana::allocPages(unsigned num, bool preFault) {
     KATANA_LOG_FATAL("failed to allocate: {}", errno);
   }
 
-  if (preFault && doHandMap) {
+  if (preFault && handMap) {
     for (size_t x = 0; x < num * hugePageSize; x += 4096) {
       static_cast<char*>(ptr)[x] = 0;
     }
@@ -103,7 +536,12 @@ katana::allocPages(unsigned num, bool preFault) {
 
 void
 katana::freePages(void* ptr, unsigned num) {
-  std::lock_guard<SimpleLock> lg(allocLock);
+  if (num == 1) {
+    if (Region* region = findRegion(ptr)) {
+      arenaFree(region, ptr);
+      return;
+    }
+  }
   if (munmap(ptr, num * hugePageSize) != 0) {
     KATANA_LOG_FATAL("munmap failed: {}", errno);
   }
@@ -151,7 +151,7 @@ katana::PerBackend::deallocOffset(const unsigned offset, const unsigned sz) {
 }
 
 void*
-katana::PerBackend::getRemote(unsigned thread, unsigned offset) {
+katana::PerBackend::getPoolRemote(unsigned thread, unsigned offset) {
   char* rbase = heads[thread].load(std::memory_order_relaxed);
   KATANA_LOG_DEBUG_ASSERT(rbase);
   return &rbase[offset];
@@ -2,13 +2,24 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <numeric>
+
 #include "katana/ArrowInterchange.h"
 #include "katana/Logging.h"
 #include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/Platform.h"
 #include "katana/Properties.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
+#include "katana/Threads.h"
+#include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/RDG.h"
@@ -16,13 +27,18 @@
 
 namespace {
 
-constexpr uint64_t
-GetGraphSize(uint64_t num_nodes, uint64_t num_edges) {
-  /// version, sizeof_edge_data, num_nodes, num_edges
-  constexpr int mandatory_fields = 4;
-
-  return (mandatory_fields + num_nodes) * sizeof(uint64_t) +
-         (num_edges * sizeof(uint32_t));
+/// AllocateValues allocates an arrow buffer that can hold \param count values
+/// of type T
+template <typename T>
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateValues(uint64_t count) {
+  auto res = arrow::AllocateBuffer(count * sizeof(T));
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(res.status()), "allocating {} values: {}", count,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
 }
 
 /// MapTopology takes a file buffer of a topology file and extracts the
@@ -39,23 +55,21 @@ GetGraphSize(uint64_t num_nodes, uint64_t num_edges) {
 ///   uint32_t padding if num_edges is odd
 ///   void*[num_edges] edge_data: edge data
 ///
+/// Version 2 files are the same except that out_dests are uint64_t.
+///
 /// Since property graphs store their edge data separately, we will
 /// ignore the size_of_edge_data (data[1]).
-katana::Result<katana::GraphTopology>
+template <typename Topology>
+katana::Result<Topology>
 MapTopology(const tsuba::FileView& file_view) {
+  using Node = typename Topology::Node;
   const auto* data = file_view.ptr<uint64_t>();
-  if (file_view.size() < 4) {
-    return katana::ErrorCode::InvalidArgument;
-  }
-
-  if (data[0] != 1) {
-    return katana::ErrorCode::InvalidArgument;
-  }
 
   uint64_t num_nodes = data[2];
   uint64_t num_edges = data[3];
 
-  uint64_t expected_size = GetGraphSize(num_nodes, num_edges);
+  uint64_t expected_size = (4 + num_nodes) * sizeof(uint64_t) +
+                           num_edges * sizeof(Node);
 
   if (file_view.size() < expected_size) {
     return KATANA_ERROR(
@@ -65,37 +79,179 @@ MapTopology(const tsuba::FileView& file_view) {
 
   uint64_t* out_indices = const_cast<uint64_t*>(&data[4]);
 
-  auto* out_dests = reinterpret_cast<uint32_t*>(out_indices + num_nodes);
+  auto* out_dests = reinterpret_cast<Node*>(out_indices + num_nodes);
 
   auto indices_buffer = std::make_shared<arrow::MutableBuffer>(
-      reinterpret_cast<uint8_t*>(out_indices), num_nodes);
+      reinterpret_cast<uint8_t*>(out_indices), num_nodes * sizeof(uint64_t));
 
   auto dests_buffer = std::make_shared<arrow::MutableBuffer>(
-      reinterpret_cast<uint8_t*>(out_dests), num_edges);
+      reinterpret_cast<uint8_t*>(out_dests), num_edges * sizeof(Node));
 
-  return katana::GraphTopology{
+  return Topology{
+      .out_indices = std::make_shared<arrow::UInt64Array>(
+          static_cast<int64_t>(num_nodes), indices_buffer),
+      .out_dests = std::make_shared<typename Topology::NodeArray>(
+          static_cast<int64_t>(num_edges), dests_buffer),
+  };
+}
+
+/// DecodeCompressedTopology extracts the topology from a compressed topology
+/// file (see tsuba/CSRTopology.h). The out indices are used in place; the
+/// destinations are decoded in parallel, a block of nodes at a time.
+template <typename Topology>
+katana::Result<Topology>
+DecodeCompressedTopology(const tsuba::CompressedCSRTopologyView& view) {
+  using Node = typename Topology::Node;
+  uint64_t num_nodes = view.num_nodes();
+  uint64_t num_edges = view.num_edges();
+
+  auto dests_result = AllocateValues<Node>(num_edges);
+  if (!dests_result) {
+    return dests_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_result.value();
+  auto* out_dests = reinterpret_cast<Node*>(dests_buffer->mutable_data());
+
+  std::atomic<bool> in_range(true);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, tsuba::CompressedCSRNumBlocks(num_nodes)),
+      [&](uint64_t block) {
+        uint64_t first = block * tsuba::kCompressedCSRBlockNodes;
+        uint64_t first_edge = first > 0 ? view.out_indexes()[first - 1] : 0;
+        if (!view.DecodeBlock(block, out_dests + first_edge)) {
+          in_range = false;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (!in_range) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "compressed topology has destinations that are not nodes");
+  }
+
+  auto indices_buffer = std::make_shared<arrow::MutableBuffer>(
+      reinterpret_cast<uint8_t*>(const_cast<uint64_t*>(view.out_indexes())),
+      num_nodes * sizeof(uint64_t));
+
+  return Topology{
       .out_indices = std::make_shared<arrow::UInt64Array>(
-          indices_buffer->size(), indices_buffer),
+          static_cast<int64_t>(num_nodes), indices_buffer),
+      .out_dests = std::make_shared<typename Topology::NodeArray>(
+          static_cast<int64_t>(num_edges), dests_buffer),
+  };
+}
+
+/// NarrowTopology copies the out-edges of \param wide, which must have fewer
+/// than 2^32 nodes, into a topology with 32-bit node ids. The out indices are
+/// shared.
+katana::Result<katana::GraphTopology>
+NarrowTopology(const katana::WideGraphTopology& wide) {
+  using Node = katana::GraphTopology::Node;
+  KATANA_LOG_DEBUG_ASSERT(wide.num_nodes() <= std::numeric_limits<Node>::max());
+  uint64_t num_edges = wide.num_edges();
+
+  auto dests_result = AllocateValues<Node>(num_edges);
+  if (!dests_result) {
+    return dests_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_result.value();
+  auto* out_dests = reinterpret_cast<Node*>(dests_buffer->mutable_data());
+  const uint64_t* wide_dests = wide.out_dests->raw_values();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { out_dests[e] = static_cast<Node>(wide_dests[e]); },
+      katana::no_stats());
+
+  return katana::GraphTopology{
+      .out_indices = wide.out_indices,
       .out_dests = std::make_shared<arrow::UInt32Array>(
-          dests_buffer->size(), dests_buffer),
+          static_cast<int64_t>(num_edges), dests_buffer),
   };
 }
 
+bool
+NeedsWideNodeIds(uint64_t num_nodes) {
+  return num_nodes > std::numeric_limits<katana::GraphTopology::Node>::max();
+}
+
+/// LoadTopology extracts the topology in \param topology_file_storage into
+/// \param topology, or into \param wide_topology if it has too many nodes
+/// for 32-bit node ids. Files with 64-bit destinations are narrowed when
+/// possible and compressed files are decoded.
 katana::Result<void>
 LoadTopology(
-    katana::GraphTopology* topology,
+    katana::GraphTopology* topology, katana::WideGraphTopology* wide_topology,
     const tsuba::FileView& topology_file_storage) {
-  auto map_result = MapTopology(topology_file_storage);
-  if (!map_result) {
-    return map_result.error();
+  if (topology_file_storage.size() < sizeof(tsuba::CSRTopologyHeader)) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+  const auto* header = topology_file_storage.ptr<tsuba::CSRTopologyHeader>();
+  bool wide = NeedsWideNodeIds(header->num_nodes);
+
+  switch (header->version) {
+  case 1: {
+    auto map_result = MapTopology<katana::GraphTopology>(topology_file_storage);
+    if (!map_result) {
+      return map_result.error();
+    }
+    *topology = std::move(map_result.value());
+    break;
+  }
+  case 2: {
+    auto map_result =
+        MapTopology<katana::WideGraphTopology>(topology_file_storage);
+    if (!map_result) {
+      return map_result.error();
+    }
+    if (wide) {
+      *wide_topology = std::move(map_result.value());
+    } else {
+      auto narrow_result = NarrowTopology(map_result.value());
+      if (!narrow_result) {
+        return narrow_result.error();
+      }
+      *topology = std::move(narrow_result.value());
+    }
+    break;
+  }
+  case tsuba::kCompressedCSRTopologyVersion: {
+    auto view_res = tsuba::CompressedCSRTopologyView::Make(
+        topology_file_storage.ptr<uint8_t>(), topology_file_storage.size());
+    if (!view_res) {
+      return view_res.error();
+    }
+    if (wide) {
+      auto decode_result =
+          DecodeCompressedTopology<katana::WideGraphTopology>(view_res.value());
+      if (!decode_result) {
+        return decode_result.error();
+      }
+      *wide_topology = std::move(decode_result.value());
+    } else {
+      auto decode_result =
+          DecodeCompressedTopology<katana::GraphTopology>(view_res.value());
+      if (!decode_result) {
+        return decode_result.error();
+      }
+      *topology = std::move(decode_result.value());
+    }
+    break;
+  }
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "unknown topology version {}",
+        header->version);
   }
-  *topology = std::move(map_result.value());
 
   return katana::ResultSuccess();
 }
 
+/// WriteTopology writes \param topology as a version 1 topology file, or as
+/// a version 2 file if it has 64-bit node ids
+template <typename Topology>
 katana::Result<std::unique_ptr<tsuba::FileFrame>>
-WriteTopology(const katana::GraphTopology& topology) {
+WriteTopology(const Topology& topology) {
+  using Node = typename Topology::Node;
   auto ff = std::make_unique<tsuba::FileFrame>();
   if (auto res = ff->Init(); !res) {
     return res.error();
@@ -103,7 +259,8 @@ WriteTopology(const katana::GraphTopology& topology) {
   uint64_t num_nodes = topology.num_nodes();
   uint64_t num_edges = topology.num_edges();
 
-  uint64_t data[4] = {1, 0, num_nodes, num_edges};
+  uint64_t version = sizeof(Node) == sizeof(uint32_t) ? 1 : 2;
+  uint64_t data[4] = {version, 0, num_nodes, num_edges};
   arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
   if (!aro_sts.ok()) {
     return tsuba::ArrowToTsuba(aro_sts.code());
@@ -122,15 +279,639 @@ WriteTopology(const katana::GraphTopology& topology) {
 
   if (num_edges) {
     const auto* raw = topology.out_dests->raw_values();
-    static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, uint32_t>);
+    static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, Node>);
     auto buf = std::make_shared<arrow::Buffer>(
-        reinterpret_cast<const uint8_t*>(raw), num_edges * sizeof(uint32_t));
+        reinterpret_cast<const uint8_t*>(raw), num_edges * sizeof(Node));
     aro_sts = ff->Write(buf);
     if (!aro_sts.ok()) {
       return tsuba::ArrowToTsuba(aro_sts.code());
     }
   }
-  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+/// WriteCompressedTopology writes \param topology in the compressed topology
+/// format (see tsuba/CSRTopology.h). Blocks of nodes are sized and then
+/// encoded in parallel.
+template <typename Topology>
+katana::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteCompressedTopology(const Topology& topology) {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error();
+  }
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+  uint64_t num_blocks = tsuba::CompressedCSRNumBlocks(num_nodes);
+
+  auto for_each_block = [&](auto&& fn) {
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_blocks),
+        [&](uint64_t block) {
+          uint64_t first = block * tsuba::kCompressedCSRBlockNodes;
+          uint64_t last =
+              std::min(first + tsuba::kCompressedCSRBlockNodes, num_nodes);
+          fn(block, first, last);
+        },
+        katana::steal(), katana::no_stats());
+  };
+
+  std::vector<uint64_t> block_offsets(num_blocks + 1, 0);
+  for_each_block([&](uint64_t block, uint64_t first, uint64_t last) {
+    uint64_t size = 0;
+    for (uint64_t n = first; n < last; ++n) {
+      uint64_t prev = n;
+      for (auto e : topology.edges(n)) {
+        uint64_t dest = topology.edge_dest(e);
+        size += tsuba::CompressedCSREncodedSize(prev, dest);
+        prev = dest;
+      }
+    }
+    block_offsets[block + 1] = size;
+  });
+  std::partial_sum(
+      block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+
+  katana::LargeArray<uint8_t> stream;
+  stream.allocateInterleaved(block_offsets[num_blocks]);
+  for_each_block([&](uint64_t block, uint64_t first, uint64_t last) {
+    uint8_t* out = stream.data() + block_offsets[block];
+    for (uint64_t n = first; n < last; ++n) {
+      uint64_t prev = n;
+      for (auto e : topology.edges(n)) {
+        uint64_t dest = topology.edge_dest(e);
+        out = tsuba::CompressedCSREncode(prev, dest, out);
+        prev = dest;
+      }
+    }
+  });
+
+  tsuba::CSRTopologyHeader header{
+      .version = tsuba::kCompressedCSRTopologyVersion,
+      .edge_type_size = 0,
+      .num_nodes = num_nodes,
+      .num_edges = num_edges,
+  };
+  arrow::Status aro_sts = ff->Write(&header, sizeof(header));
+  if (aro_sts.ok() && num_nodes) {
+    aro_sts = ff->Write(
+        topology.out_indices->raw_values(), num_nodes * sizeof(uint64_t));
+  }
+  if (aro_sts.ok()) {
+    aro_sts = ff->Write(
+        block_offsets.data(), block_offsets.size() * sizeof(uint64_t));
+  }
+  if (aro_sts.ok() && block_offsets[num_blocks] > 0) {
+    aro_sts = ff->Write(stream.data(), block_offsets[num_blocks]);
+  }
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+constexpr uint64_t
+GetInGraphSize(uint64_t num_nodes, uint64_t num_edges) {
+  /// version, num_nodes, num_edges, reserved
+  constexpr int mandatory_fields = 4;
+
+  return (mandatory_fields + num_nodes + num_edges) * sizeof(uint64_t) +
+         (num_edges * sizeof(uint32_t));
+}
+
+/// MapInTopology takes a file buffer of an in-edge index file and extracts
+/// the in-edge arrays into \param topology.
+///
+/// Format of an in-edge index file:
+///
+///   uint64_t version: 1
+///   uint64_t num_nodes: number of nodes
+///   uint64_t num_edges: number of edges
+///   uint64_t reserved: 0
+///   uint64_t[num_nodes] in_indices: end of the in-edges for a node
+///   uint64_t[num_edges] in_to_out_edges: out-edge id of each in-edge
+///   uint32_t[num_edges] in_sources: sources (node indexes) of each in-edge
+katana::Result<void>
+MapInTopology(
+    const tsuba::FileView& file_view, katana::GraphTopology* topology) {
+  const auto* data = file_view.ptr<uint64_t>();
+  if (file_view.size() < 4 * sizeof(uint64_t)) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  if (data[0] != 1) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  uint64_t num_nodes = data[1];
+  uint64_t num_edges = data[2];
+
+  if (num_nodes != topology->num_nodes() ||
+      num_edges != topology->num_edges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "in-edge index has {} nodes and {} edges but topology has {} and {}",
+        num_nodes, num_edges, topology->num_nodes(), topology->num_edges());
+  }
+
+  uint64_t expected_size = GetInGraphSize(num_nodes, num_edges);
+
+  if (file_view.size() < expected_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "file_view size: {} expected {}",
+        file_view.size(), expected_size);
+  }
+
+  uint64_t* in_indices = const_cast<uint64_t*>(&data[4]);
+  uint64_t* in_to_out_edges = in_indices + num_nodes;
+  auto* in_sources = reinterpret_cast<uint32_t*>(in_to_out_edges + num_edges);
+
+  topology->in_indices = std::make_shared<arrow::UInt64Array>(
+      num_nodes, arrow::MutableBuffer::Wrap(in_indices, num_nodes));
+  topology->in_to_out_edges = std::make_shared<arrow::UInt64Array>(
+      num_edges, arrow::MutableBuffer::Wrap(in_to_out_edges, num_edges));
+  topology->in_sources = std::make_shared<arrow::UInt32Array>(
+      num_edges, arrow::MutableBuffer::Wrap(in_sources, num_edges));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteInTopology(const katana::GraphTopology& topology) {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  if (auto res = ff->Init(); !res) {
+    return res.error();
+  }
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  uint64_t data[4] = {1, num_nodes, num_edges, 0};
+  arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+
+  if (num_nodes) {
+    const auto* raw = topology.in_indices->raw_values();
+    static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, uint64_t>);
+    auto buf = std::make_shared<arrow::Buffer>(
+        reinterpret_cast<const uint8_t*>(raw), num_nodes * sizeof(uint64_t));
+    aro_sts = ff->Write(buf);
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+
+  if (num_edges) {
+    const auto* raw_edges = topology.in_to_out_edges->raw_values();
+    static_assert(std::is_same_v<std::decay_t<decltype(*raw_edges)>, uint64_t>);
+    auto buf = std::make_shared<arrow::Buffer>(
+        reinterpret_cast<const uint8_t*>(raw_edges),
+        num_edges * sizeof(uint64_t));
+    aro_sts = ff->Write(buf);
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+
+    const auto* raw_sources = topology.in_sources->raw_values();
+    static_assert(
+        std::is_same_v<std::decay_t<decltype(*raw_sources)>, uint32_t>);
+    buf = std::make_shared<arrow::Buffer>(
+        reinterpret_cast<const uint8_t*>(raw_sources),
+        num_edges * sizeof(uint32_t));
+    aro_sts = ff->Write(buf);
+    if (!aro_sts.ok()) {
+      return tsuba::ArrowToTsuba(aro_sts.code());
+    }
+  }
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+/// TransposeEdges computes the in-edge arrays of \param topology from its
+/// out-edges into \param in_indices, which has room for the nodes of
+/// topology, and \param in_to_out_edges and \param in_sources, which have
+/// room for its edges. In-edges of a node are ordered by source and, for
+/// parallel edges, by out-edge id, so the result does not depend on thread
+/// timing.
+void
+TransposeEdges(
+    const katana::GraphTopology* topology, uint64_t* in_indices,
+    uint64_t* in_to_out_edges, uint32_t* in_sources) {
+  uint64_t num_nodes = topology->num_nodes();
+  uint64_t num_edges = topology->num_edges();
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_indices[n] = uint64_t{0}; }, katana::no_stats());
+
+  // Count in-degrees
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        __sync_add_and_fetch(&in_indices[topology->edge_dest(e)], 1);
+      },
+      katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      in_indices, in_indices + num_nodes, in_indices);
+
+  katana::LargeArray<uint64_t> in_offset;
+  in_offset.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_offset[n] = n > 0 ? in_indices[n - 1] : 0; },
+      katana::no_stats());
+
+  // Scatter out-edges to their destination's in-edge range
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t src) {
+        for (auto e : topology->edges(src)) {
+          auto dest = topology->edge_dest(e);
+          auto in_e = __sync_fetch_and_add(&(in_offset[dest]), 1);
+          in_to_out_edges[in_e] = e;
+          in_sources[in_e] = src;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // Out-edge ids increase with their source, so sorting the out-edge ids and
+  // the sources of each in-edge range independently keeps them paired
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n > 0 ? in_indices[n - 1] : 0;
+        uint64_t end = in_indices[n];
+        std::sort(in_to_out_edges + begin, in_to_out_edges + end);
+        std::sort(in_sources + begin, in_sources + end);
+      },
+      katana::steal(), katana::no_stats());
+}
+
+/// BuildInTopology fills in the in-edge arrays of \param topology
+katana::Result<void>
+BuildInTopology(katana::GraphTopology* topology) {
+  uint64_t num_nodes = topology->num_nodes();
+  uint64_t num_edges = topology->num_edges();
+
+  auto in_indices_result = AllocateValues<uint64_t>(num_nodes);
+  if (!in_indices_result) {
+    return in_indices_result.error();
+  }
+  auto in_to_out_edges_result = AllocateValues<uint64_t>(num_edges);
+  if (!in_to_out_edges_result) {
+    return in_to_out_edges_result.error();
+  }
+  auto in_sources_result = AllocateValues<uint32_t>(num_edges);
+  if (!in_sources_result) {
+    return in_sources_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> in_indices = in_indices_result.value();
+  std::shared_ptr<arrow::Buffer> in_to_out_edges =
+      in_to_out_edges_result.value();
+  std::shared_ptr<arrow::Buffer> in_sources = in_sources_result.value();
+
+  TransposeEdges(
+      topology, reinterpret_cast<uint64_t*>(in_indices->mutable_data()),
+      reinterpret_cast<uint64_t*>(in_to_out_edges->mutable_data()),
+      reinterpret_cast<uint32_t*>(in_sources->mutable_data()));
+
+  topology->in_indices = std::make_shared<arrow::UInt64Array>(
+      static_cast<int64_t>(num_nodes), in_indices);
+  topology->in_to_out_edges = std::make_shared<arrow::UInt64Array>(
+      static_cast<int64_t>(num_edges), in_to_out_edges);
+  topology->in_sources = std::make_shared<arrow::UInt32Array>(
+      static_cast<int64_t>(num_edges), in_sources);
+  return katana::ResultSuccess();
+}
+
+/// PermuteRows returns a table whose row i is row \param indices[i] of \param
+/// table
+katana::Result<std::shared_ptr<arrow::Table>>
+PermuteRows(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::shared_ptr<arrow::Array>& indices) {
+  auto take_result = arrow::compute::Take(table, indices);
+  if (!take_result.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(take_result.status()), "permuting rows: {}",
+        take_result.status());
+  }
+  return take_result.ValueOrDie().table();
+}
+
+/// PermuteRows returns an array whose element i is element \param indices[i]
+/// of \param array
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+PermuteRows(
+    const std::shared_ptr<arrow::ChunkedArray>& array,
+    const std::shared_ptr<arrow::Array>& indices) {
+  auto take_result = arrow::compute::Take(array, indices);
+  if (!take_result.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(take_result.status()), "permuting rows: {}",
+        take_result.status());
+  }
+  return take_result.ValueOrDie().chunked_array();
+}
+
+/// MakeNodeMapping turns \param order, the old node ids in their new order,
+/// into a mapping from old to new node ids
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+MakeNodeMapping(const std::vector<uint32_t>& order) {
+  uint64_t num_nodes = order.size();
+  auto buffer_result = AllocateValues<uint64_t>(num_nodes);
+  if (!buffer_result) {
+    return buffer_result.error();
+  }
+  auto* old_to_new =
+      reinterpret_cast<uint64_t*>(buffer_result.value()->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t i) { old_to_new[order[i]] = i; }, katana::no_stats());
+  return std::make_shared<arrow::UInt64Array>(
+      static_cast<int64_t>(num_nodes), buffer_result.value());
+}
+
+/// ReverseCuthillMcKeeOrder returns the nodes of \param topology in reverse
+/// Cuthill-McKee order
+std::vector<uint32_t>
+ReverseCuthillMcKeeOrder(const katana::GraphTopology& topology) {
+  uint64_t num_nodes = topology.num_nodes();
+  auto degree = [&](uint32_t n) { return topology.edges(n).size(); };
+  auto by_degree = [&](uint32_t a, uint32_t b) {
+    return std::make_pair(degree(a), a) < std::make_pair(degree(b), b);
+  };
+
+  // Start each component from its lowest degree node
+  std::vector<uint32_t> starts(num_nodes);
+  std::iota(starts.begin(), starts.end(), uint32_t{0});
+  katana::ParallelSTL::sort(starts.begin(), starts.end(), by_degree);
+
+  // The breadth-first search is inherently serial; it visits each edge once
+  std::vector<uint32_t> order;
+  order.reserve(num_nodes);
+  std::vector<bool> visited(num_nodes, false);
+  for (uint32_t start : starts) {
+    if (visited[start]) {
+      continue;
+    }
+    visited[start] = true;
+    order.push_back(start);
+    for (uint64_t head = order.size() - 1; head < order.size(); ++head) {
+      uint32_t node = order[head];
+      uint64_t first_new = order.size();
+      for (auto e : topology.edges(node)) {
+        auto dest = topology.edge_dest(e);
+        if (!visited[dest]) {
+          visited[dest] = true;
+          order.push_back(dest);
+        }
+      }
+      std::sort(order.begin() + first_new, order.end(), by_degree);
+    }
+  }
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+/// BuildReversedGraph creates a graph with the nodes of \param pg in which
+/// the edges of node n are the reverse of the in-edges of n in pg and, if
+/// \param keep_out_edges, also the out-edges of n. In the latter case, the
+/// reverse of a self loop is not added.
+///
+/// The edges of each node are sorted by destination. An out-edge precedes a
+/// reverse edge with the same destination; other ties are broken by the id of
+/// the edge in pg. If \param remove_duplicates, only the first edge from a
+/// node to each destination is kept. The edge properties in \param
+/// edge_property_names are copied from the edge in pg each new edge came
+/// from.
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+BuildReversedGraph(
+    katana::PropertyGraph* pg, bool keep_out_edges, bool remove_duplicates,
+    const std::vector<std::string>& edge_property_names) {
+  if (pg->has_wide_node_ids()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "reversing graphs with wide node ids is not supported");
+  }
+  const katana::GraphTopology& topology = pg->topology();
+  auto reversed = std::make_unique<katana::PropertyGraph>();
+  uint64_t num_nodes = topology.num_nodes();
+  if (num_nodes == 0) {
+    return std::unique_ptr<katana::PropertyGraph>(std::move(reversed));
+  }
+
+  // Reverse edges come from the in-edges of each node. Use the in-edge index
+  // of pg if it has one.
+  katana::LargeArray<uint64_t> in_indices_storage;
+  katana::LargeArray<uint64_t> in_to_out_edges_storage;
+  katana::LargeArray<uint32_t> in_sources_storage;
+  const uint64_t* in_indices = nullptr;
+  const uint64_t* in_to_out_edges = nullptr;
+  const uint32_t* in_sources = nullptr;
+  if (topology.has_in_edges()) {
+    in_indices = topology.in_indices->raw_values();
+    in_to_out_edges = topology.in_to_out_edges->raw_values();
+    in_sources = topology.in_sources->raw_values();
+  } else {
+    in_indices_storage.allocateInterleaved(num_nodes);
+    in_to_out_edges_storage.allocateInterleaved(topology.num_edges());
+    in_sources_storage.allocateInterleaved(topology.num_edges());
+    TransposeEdges(
+        &topology, in_indices_storage.data(), in_to_out_edges_storage.data(),
+        in_sources_storage.data());
+    in_indices = in_indices_storage.data();
+    in_to_out_edges = in_to_out_edges_storage.data();
+    in_sources = in_sources_storage.data();
+  }
+  const uint32_t* out_dests = topology.out_dests->raw_values();
+
+  auto in_range = [&](uint64_t n) {
+    return std::make_pair(n > 0 ? in_indices[n - 1] : 0, in_indices[n]);
+  };
+  auto is_skipped = [&](uint64_t n, uint64_t in_e) {
+    return keep_out_edges && in_sources[in_e] == n;
+  };
+
+  // Upper bound on the number of edges of each node; exact unless duplicates
+  // are removed
+  auto bounds_result = AllocateValues<uint64_t>(num_nodes);
+  if (!bounds_result) {
+    return bounds_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> bounds_buffer = bounds_result.value();
+  auto* bounds = reinterpret_cast<uint64_t*>(bounds_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [in_begin, in_end] = in_range(n);
+        // Self loops are first among in-edges with source n, which are
+        // contiguous
+        auto self_loops = std::equal_range(
+            in_sources + in_begin, in_sources + in_end,
+            static_cast<uint32_t>(n));
+        uint64_t num_skipped =
+            keep_out_edges ? self_loops.second - self_loops.first : 0;
+        bounds[n] = in_end - in_begin - num_skipped +
+                    (keep_out_edges ? topology.edges(n).size() : 0);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(bounds, bounds + num_nodes, bounds);
+  uint64_t max_edges = bounds[num_nodes - 1];
+
+  auto dests_result = AllocateValues<uint32_t>(max_edges);
+  if (!dests_result) {
+    return dests_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> dests_buffer = dests_result.value();
+  auto* dests = reinterpret_cast<uint32_t*>(dests_buffer->mutable_data());
+
+  // edge_map[e] is the edge of pg that edge e came from
+  auto edge_map_result = AllocateValues<uint64_t>(max_edges);
+  if (!edge_map_result) {
+    return edge_map_result.error();
+  }
+  std::shared_ptr<arrow::Buffer> edge_map_buffer = edge_map_result.value();
+  auto* edge_map = reinterpret_cast<uint64_t*>(edge_map_buffer->mutable_data());
+
+  katana::LargeArray<uint64_t> num_written;
+  if (remove_duplicates) {
+    num_written.allocateInterleaved(num_nodes);
+  }
+
+  // Each node writes its own range: out-edges sorted by destination are
+  // staged at the end of the range and merged with the in-edges, which are
+  // already sorted by source. Writes never pass unread out-edges.
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t begin = n > 0 ? bounds[n - 1] : 0;
+        uint64_t* node_map = edge_map + begin;
+        uint32_t* node_dests = dests + begin;
+
+        auto [in_e, in_end] = in_range(n);
+        uint64_t num_out = keep_out_edges ? topology.edges(n).size() : 0;
+        uint64_t* out_first = node_map + (bounds[n] - begin - num_out);
+        std::iota(out_first, out_first + num_out, *topology.edges(n).begin());
+        std::sort(out_first, out_first + num_out, [&](uint64_t a, uint64_t b) {
+          return std::make_pair(out_dests[a], a) <
+                 std::make_pair(out_dests[b], b);
+        });
+
+        uint64_t out_i = 0;
+        uint64_t w = 0;
+        auto emit = [&](uint32_t dest, uint64_t edge) {
+          if (remove_duplicates && w > 0 && node_dests[w - 1] == dest) {
+            return;
+          }
+          node_dests[w] = dest;
+          node_map[w] = edge;
+          ++w;
+        };
+        while (true) {
+          while (in_e < in_end && is_skipped(n, in_e)) {
+            ++in_e;
+          }
+          bool has_out = out_i < num_out;
+          bool has_in = in_e < in_end;
+          if (!has_out && !has_in) {
+            break;
+          }
+          if (has_out &&
+              (!has_in || out_dests[out_first[out_i]] <= in_sources[in_e])) {
+            uint64_t e = out_first[out_i++];
+            emit(out_dests[e], e);
+          } else {
+            emit(in_sources[in_e], in_to_out_edges[in_e]);
+            ++in_e;
+          }
+        }
+        if (remove_duplicates) {
+          num_written[n] = w;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::shared_ptr<arrow::Buffer> indices_buffer = bounds_buffer;
+  uint64_t num_edges = max_edges;
+  if (remove_duplicates) {
+    auto indices_result = AllocateValues<uint64_t>(num_nodes);
+    if (!indices_result) {
+      return indices_result.error();
+    }
+    indices_buffer = indices_result.value();
+    auto* indices = reinterpret_cast<uint64_t*>(indices_buffer->mutable_data());
+    katana::ParallelSTL::partial_sum(
+        num_written.begin(), num_written.end(), indices);
+    num_edges = indices[num_nodes - 1];
+
+    if (num_edges < max_edges) {
+      auto compact_dests_result = AllocateValues<uint32_t>(num_edges);
+      if (!compact_dests_result) {
+        return compact_dests_result.error();
+      }
+      auto compact_map_result = AllocateValues<uint64_t>(num_edges);
+      if (!compact_map_result) {
+        return compact_map_result.error();
+      }
+      auto* compact_dests = reinterpret_cast<uint32_t*>(
+          compact_dests_result.value()->mutable_data());
+      auto* compact_map = reinterpret_cast<uint64_t*>(
+          compact_map_result.value()->mutable_data());
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_nodes),
+          [&](uint64_t n) {
+            uint64_t from = n > 0 ? bounds[n - 1] : 0;
+            uint64_t to = n > 0 ? indices[n - 1] : 0;
+            std::copy_n(dests + from, num_written[n], compact_dests + to);
+            std::copy_n(edge_map + from, num_written[n], compact_map + to);
+          },
+          katana::steal(), katana::no_stats());
+      dests_buffer = compact_dests_result.value();
+      edge_map_buffer = compact_map_result.value();
+    }
+  }
+
+  if (auto r = reversed->SetTopology(katana::GraphTopology{
+          .out_indices = std::make_shared<arrow::UInt64Array>(
+              static_cast<int64_t>(num_nodes), indices_buffer),
+          .out_dests = std::make_shared<arrow::UInt32Array>(
+              static_cast<int64_t>(num_edges), dests_buffer),
+      });
+      !r) {
+    return r.error();
+  }
+
+  if (edge_property_names.empty()) {
+    return std::unique_ptr<katana::PropertyGraph>(std::move(reversed));
+  }
+
+  auto edge_map_array = std::make_shared<arrow::UInt64Array>(
+      static_cast<int64_t>(num_edges), edge_map_buffer);
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (const auto& name : edge_property_names) {
+    if (auto r = pg->EnsureEdgePropertyLoaded(name); !r) {
+      return r.error();
+    }
+    std::shared_ptr<arrow::ChunkedArray> property = pg->GetEdgeProperty(name);
+    auto take_result = arrow::compute::Take(property, edge_map_array);
+    if (!take_result.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(take_result.status()),
+          "copying edge property {}: {}", name, take_result.status());
+    }
+    fields.emplace_back(arrow::field(name, property->type()));
+    columns.emplace_back(take_result.ValueOrDie().chunked_array());
+  }
+  if (auto r = reversed->AddEdgeProperties(
+          arrow::Table::Make(arrow::schema(fields), columns));
+      !r) {
+    return r.error();
+  }
+
+  return std::unique_ptr<katana::PropertyGraph>(std::move(reversed));
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -146,6 +927,14 @@ MakePropertyGraph(
       std::move(rdg_file), std::move(rdg_result.value()));
 }
 
+/// \returns true if properties of \param type are treated as types
+bool
+IsTypeProperty(const arrow::DataType& type) {
+  // a bool or uint8 property is (always) considered a type
+  // TODO(roshan) make this customizable by the user
+  return type.Equals(arrow::boolean()) || type.Equals(arrow::uint8());
+}
+
 /// Assumes all boolean or uint8 properties are types
 katana::Result<katana::LargeArray<katana::PropertyGraph::TypeSetID>>
 GetTypeSetIDsFromProperties(
@@ -170,12 +959,7 @@ GetTypeSetIDsFromProperties(
   const std::shared_ptr<arrow::Schema>& schema = properties->schema();
   KATANA_LOG_DEBUG_ASSERT(schema->num_fields() == properties->num_columns());
   for (int i = 0, n = schema->num_fields(); i < n; i++) {
-    const std::shared_ptr<arrow::Field>& current_field = schema->field(i);
-
-    // a bool or uint8 property is (always) considered a type
-    // TODO(roshan) make this customizable by the user
-    if (current_field->type()->Equals(arrow::boolean()) ||
-        current_field->type()->Equals(arrow::uint8())) {
+    if (IsTypeProperty(*schema->field(i)->type())) {
       type_field_indices.push_back(i);
     }
   }
@@ -237,7 +1021,7 @@ GetTypeSetIDsFromProperties(
           local_type_combinations.emplace(field_indices);
         }
       });
-  for (unsigned t = 0, n = katana::activeThreads; t < n; t++) {
+  for (unsigned t = 0, n = katana::getActiveThreads(); t < n; t++) {
     katana::gstl::Set<katana::gstl::Vector<int>>& remote_type_combinations =
         *type_combinations_pts.getRemote(t);
     for (auto& type_combination : remote_type_combinations) {
@@ -327,6 +1111,203 @@ GetUnknownTypeSetIDs(uint64_t num_rows) {
   return type_set_ids;
 }
 
+/// GroupByTypeSetID fills \param ids with the ids [0, num_rows) grouped by
+/// their TypeSetID in \param type_set_ids and sets group i to
+/// [offsets[i], offsets[i + 1]). It is a parallel stable counting sort, so
+/// ids are in increasing order within each group.
+template <typename Id>
+void
+GroupByTypeSetID(
+    const katana::PropertyGraph::TypeSetID* type_set_ids, uint64_t num_rows,
+    katana::LargeArray<Id>* ids, std::vector<uint64_t>* offsets) {
+  constexpr size_t kNumTypeSetIDs =
+      std::numeric_limits<katana::PropertyGraph::TypeSetID>::max() + 1;
+  uint32_t num_threads = katana::getActiveThreads();
+
+  // counts[t * kNumTypeSetIDs + i] is the number of ids of TypeSetID i in
+  // the block of thread t; it becomes where thread t scatters them
+  std::vector<uint64_t> counts(num_threads * kNumTypeSetIDs, 0);
+  katana::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [begin, end] =
+        katana::block_range(uint64_t{0}, num_rows, tid, nthreads);
+    uint64_t* local = &counts[tid * kNumTypeSetIDs];
+    for (uint64_t row = begin; row < end; ++row) {
+      ++local[type_set_ids[row]];
+    }
+  });
+
+  offsets->assign(kNumTypeSetIDs + 1, 0);
+  uint64_t total = 0;
+  for (size_t i = 0; i < kNumTypeSetIDs; ++i) {
+    (*offsets)[i] = total;
+    for (uint32_t t = 0; t < num_threads; ++t) {
+      uint64_t count = counts[t * kNumTypeSetIDs + i];
+      counts[t * kNumTypeSetIDs + i] = total;
+      total += count;
+    }
+  }
+  (*offsets)[kNumTypeSetIDs] = total;
+
+  ids->allocateInterleaved(num_rows);
+  katana::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [begin, end] =
+        katana::block_range(uint64_t{0}, num_rows, tid, nthreads);
+    uint64_t* local = &counts[tid * kNumTypeSetIDs];
+    for (uint64_t row = begin; row < end; ++row) {
+      (*ids)[local[type_set_ids[row]]++] = row;
+    }
+  });
+}
+
+/// A degree histogram with the buckets of tsuba::GraphStatistics
+using DegreeHistogram = std::array<uint64_t, 65>;
+
+/// MergeHistograms sums the per-thread histograms \param hists, dropping
+/// trailing empty buckets
+std::vector<uint64_t>
+MergeHistograms(katana::PerThreadStorage<DegreeHistogram>* hists) {
+  std::vector<uint64_t> merged(std::tuple_size_v<DegreeHistogram>, 0);
+  for (unsigned t = 0, n = katana::getActiveThreads(); t < n; t++) {
+    const DegreeHistogram& local = *hists->getRemote(t);
+    for (size_t i = 0; i < local.size(); ++i) {
+      merged[i] += local[i];
+    }
+  }
+  while (!merged.empty() && merged.back() == 0) {
+    merged.pop_back();
+  }
+  return merged;
+}
+
+/// ComputeTopologyStatistics summarizes \param topology in two parallel
+/// passes, one over out-edges and one over in-degrees. Type counts are left
+/// empty.
+template <typename Topology>
+tsuba::GraphStatistics
+ComputeTopologyStatistics(const Topology& topology) {
+  using Node = typename Topology::Node;
+  using Edge = typename Topology::Edge;
+
+  uint64_t num_nodes = topology.num_nodes();
+
+  katana::LargeArray<uint64_t> in_degrees;
+  in_degrees.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { in_degrees[n] = uint64_t{0}; }, katana::no_stats());
+
+  katana::PerThreadStorage<DegreeHistogram> out_hists;
+  katana::PerThreadStorage<std::vector<Node>> scratch;
+  katana::GReduceMax<uint64_t> max_out_degree;
+  katana::GAccumulator<uint64_t> num_self_loops;
+  katana::GAccumulator<uint64_t> num_duplicates;
+  katana::GReduceLogicalAnd edges_sorted;
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        uint64_t degree = end - begin;
+        (*out_hists.getLocal())[tsuba::GraphStatistics::DegreeBucket(
+            degree)] += 1;
+        max_out_degree.update(degree);
+
+        bool sorted = true;
+        uint64_t self_loops = 0;
+        for (Edge e = begin; e < end; ++e) {
+          Node dest = topology.edge_dest(e);
+          __sync_add_and_fetch(&in_degrees[dest], 1);
+          if (dest == n) {
+            ++self_loops;
+          }
+          if (e > begin && topology.edge_dest(e - 1) > dest) {
+            sorted = false;
+          }
+        }
+        num_self_loops += self_loops;
+        edges_sorted.update(sorted);
+
+        // Duplicates are adjacent once the destinations are sorted
+        uint64_t duplicates = 0;
+        if (sorted) {
+          for (Edge e = begin + 1; e < end; ++e) {
+            if (topology.edge_dest(e - 1) == topology.edge_dest(e)) {
+              ++duplicates;
+            }
+          }
+        } else {
+          std::vector<Node>& dests = *scratch.getLocal();
+          dests.clear();
+          for (Edge e = begin; e < end; ++e) {
+            dests.emplace_back(topology.edge_dest(e));
+          }
+          std::sort(dests.begin(), dests.end());
+          for (size_t i = 1; i < dests.size(); ++i) {
+            if (dests[i - 1] == dests[i]) {
+              ++duplicates;
+            }
+          }
+        }
+        num_duplicates += duplicates;
+      },
+      katana::steal(), katana::loopname("ComputeStatistics_OutEdges"));
+
+  katana::PerThreadStorage<DegreeHistogram> in_hists;
+  katana::GReduceMax<uint64_t> max_in_degree;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        (*in_hists.getLocal())[tsuba::GraphStatistics::DegreeBucket(
+            in_degrees[n])] += 1;
+        max_in_degree.update(in_degrees[n]);
+      },
+      katana::loopname("ComputeStatistics_InDegrees"));
+
+  tsuba::GraphStatistics stats;
+  stats.num_nodes = num_nodes;
+  stats.num_edges = topology.num_edges();
+  stats.max_out_degree = max_out_degree.reduce();
+  stats.max_in_degree = max_in_degree.reduce();
+  stats.out_degree_histogram = MergeHistograms(&out_hists);
+  stats.in_degree_histogram = MergeHistograms(&in_hists);
+  stats.edges_sorted = edges_sorted.reduce();
+  stats.num_self_loops = num_self_loops.reduce();
+  stats.num_duplicate_edges = num_duplicates.reduce();
+  return stats;
+}
+
+/// CountTypes returns the number of rows with each type name given the
+/// TypeSetID \param type_set_ids of each of \param num_rows rows
+std::map<std::string, uint64_t>
+CountTypes(
+    const katana::PropertyGraph::TypeSetID* type_set_ids, uint64_t num_rows,
+    const katana::PropertyGraph::TypeSetIDToSetOfTypeNamesMap&
+        type_set_id_to_type_names) {
+  using TypeSetIDCounts = std::array<
+      uint64_t,
+      std::numeric_limits<katana::PropertyGraph::TypeSetID>::max() + 1>;
+
+  katana::PerThreadStorage<TypeSetIDCounts> counts;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_rows),
+      [&](uint64_t row) { (*counts.getLocal())[type_set_ids[row]] += 1; },
+      katana::no_stats());
+
+  std::map<std::string, uint64_t> type_counts;
+  for (unsigned t = 0, n = katana::getActiveThreads(); t < n; t++) {
+    const TypeSetIDCounts& local = *counts.getRemote(t);
+    for (size_t id = 0; id < type_set_id_to_type_names.size(); ++id) {
+      if (local[id] == 0) {
+        continue;
+      }
+      for (const std::string& name : type_set_id_to_type_names[id]) {
+        type_counts[name] += local[id];
+      }
+    }
+  }
+  return type_counts;
+}
+
 }  // namespace
 
 katana::PropertyGraph::PropertyGraph() = default;
@@ -387,15 +1368,47 @@ katana::PropertyGraph::Validate() {
 katana::Result<void>
 katana::PropertyGraph::DoWrite(
     tsuba::RDGHandle handle, const std::string& command_line) {
-  if (!rdg_.topology_file_storage().Valid()) {
-    auto result = WriteTopology(topology_);
+  if (!rdg_.statistics()) {
+    ComputeStatistics();
+  } else if (node_type_set_ids() && edge_type_set_ids()) {
+    // Types may have been constructed after the statistics were loaded
+    tsuba::GraphStatistics stats = rdg_.statistics().value();
+    stats.node_type_counts = CountTypes(
+        node_type_set_ids(), num_nodes(), node_type_set_id_to_type_names_);
+    stats.edge_type_counts = CountTypes(
+        edge_type_set_ids(), num_edges(), edge_type_set_id_to_type_names_);
+    rdg_.set_statistics(std::move(stats));
+  }
+
+  const tsuba::FileView& topology_storage = rdg_.topology_file_storage();
+  bool stored_compressed =
+      topology_storage.Valid() &&
+      topology_storage.ptr<tsuba::CSRTopologyHeader>()->version ==
+          tsuba::kCompressedCSRTopologyVersion;
+
+  std::unique_ptr<tsuba::FileFrame> ff;
+  if (!topology_storage.Valid() ||
+      (compress_topology_ && !stored_compressed)) {
+    auto result = VisitTopology([this](const auto& topology) {
+      return compress_topology_ ? WriteCompressedTopology(topology)
+                                : WriteTopology(topology);
+    });
+    if (!result) {
+      return result.error();
+    }
+    ff = std::move(result.value());
+  }
+
+  std::unique_ptr<tsuba::FileFrame> in_ff;
+  if (topology_.has_in_edges() && !rdg_.in_topology_file_storage().Valid()) {
+    auto result = WriteInTopology(topology_);
     if (!result) {
       return result.error();
     }
-    return rdg_.Store(handle, command_line, std::move(result.value()));
+    in_ff = std::move(result.value());
   }
 
-  return rdg_.Store(handle, command_line);
+  return rdg_.Store(handle, command_line, std::move(ff), std::move(in_ff));
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -405,7 +1418,8 @@ katana::PropertyGraph::Make(
       new PropertyGraph(std::move(rdg_file), std::move(rdg)));
 
   auto load_result =
-      LoadTopology(&g->topology_, g->rdg_.topology_file_storage());
+      LoadTopology(
+          &g->topology_, &g->wide_topology_, g->rdg_.topology_file_storage());
   if (!load_result) {
     return load_result.error();
   }
@@ -430,7 +1444,17 @@ katana::PropertyGraph::Make(
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Copy() const {
-  return Copy(node_schema()->field_names(), edge_schema()->field_names());
+  // The copy is loaded from storage, so unloaded properties are copied
+  // without loading them here
+  std::vector<std::string> node_names = GetNodePropertyNames();
+  for (auto& name : GetUnloadedNodePropertyNames()) {
+    node_names.emplace_back(std::move(name));
+  }
+  std::vector<std::string> edge_names = GetEdgePropertyNames();
+  for (auto& name : GetUnloadedEdgePropertyNames()) {
+    edge_names.emplace_back(std::move(name));
+  }
+  return Copy(node_names, edge_names);
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -456,6 +1480,9 @@ katana::PropertyGraph::ConstructTypeSetIDs() {
         ErrorCode::AssertionFailed,
         "ConstructTypeSetIDs() should not called more than once");
   }
+  if (auto res = EnsureTypePropertiesLoaded(); !res) {
+    return res.error();
+  }
 
   static_assert(kUnknownType == 0);
   node_type_set_id_to_type_names_.push_back(
@@ -489,9 +1516,236 @@ katana::PropertyGraph::ConstructTypeSetIDs() {
     edge_type_set_id_ = std::move(edge_types_res.value());
   }
 
+  // Graphs with wide node ids have TypeSetIDs but no type indexes
+  if (!has_wide_node_ids()) {
+    if (auto res = BuildTypeIndexes(); !res) {
+      return res.error();
+    }
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::EnsureTypePropertiesLoaded() const {
+  std::lock_guard<std::mutex> lock(*load_mutex_);
+  // Loading in the order of the unloaded names keeps the type columns in the
+  // order EnsureAllPropertiesLoaded would give them, and so their TypeSetIDs
+  for (const std::string& name : rdg_.unloaded_node_property_names()) {
+    auto type_result = rdg_.UnloadedNodePropertyType(name);
+    if (!type_result) {
+      return type_result.error().WithContext("node property {}", name);
+    }
+    if (!IsTypeProperty(*type_result.value())) {
+      continue;
+    }
+    if (auto res = rdg_.EnsureNodePropertyLoaded(name); !res) {
+      return res.error().WithContext("loading node property {}", name);
+    }
+  }
+  for (const std::string& name : rdg_.unloaded_edge_property_names()) {
+    auto type_result = rdg_.UnloadedEdgePropertyType(name);
+    if (!type_result) {
+      return type_result.error().WithContext("edge property {}", name);
+    }
+    if (!IsTypeProperty(*type_result.value())) {
+      continue;
+    }
+    if (auto res = rdg_.EnsureEdgePropertyLoaded(name); !res) {
+      return res.error().WithContext("loading edge property {}", name);
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::BuildTypeIndexes() {
+  if (has_wide_node_ids()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "type indexes of graphs with wide node ids are not supported");
+  }
+  GroupByTypeSetID(
+      node_type_set_id_.data(), num_nodes(), &nodes_by_type_set_id_,
+      &node_type_set_id_offsets_);
+
+  out_edges_by_type_set_id_ = katana::LargeArray<uint32_t>();
+  has_out_edge_type_index_ = false;
+  auto by_type_set_id = [this](Edge a, Edge b) {
+    return edge_type_set_id_[a] < edge_type_set_id_[b];
+  };
+  using edge_iterator = boost::counting_iterator<Edge>;
+  // The index is only needed if some node has out-edges out of TypeSetID
+  // order, which is never the case when all edges have one TypeSetID
+  katana::GReduceLogicalOr unsorted;
+  katana::GReduceLogicalOr too_wide;
+  katana::do_all(
+      katana::iterate(topology_),
+      [&](Node n) {
+        auto [begin, end] = topology_.edge_range(n);
+        if (end - begin > std::numeric_limits<uint32_t>::max()) {
+          too_wide.update(true);
+        }
+        if (!std::is_sorted(
+                edge_iterator(begin), edge_iterator(end), by_type_set_id)) {
+          unsorted.update(true);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  if (!unsorted.reduce()) {
+    has_out_edge_type_index_ = true;
+    return katana::ResultSuccess();
+  }
+  if (too_wide.reduce()) {
+    KATANA_LOG_WARN(
+        "not indexing out-edges by type: a node has too many out-edges");
+    return katana::ResultSuccess();
+  }
+
+  out_edges_by_type_set_id_.allocateInterleaved(num_edges());
+  uint32_t* offsets = out_edges_by_type_set_id_.data();
+  katana::do_all(
+      katana::iterate(topology_),
+      [&](Node n) {
+        auto [begin, end] = topology_.edge_range(n);
+        std::iota(offsets + begin, offsets + end, uint32_t{0});
+        std::stable_sort(
+            offsets + begin, offsets + end, [&](uint32_t a, uint32_t b) {
+              return by_type_set_id(begin + a, begin + b);
+            });
+      },
+      katana::steal(), katana::no_stats());
+  has_out_edge_type_index_ = true;
+
   return katana::ResultSuccess();
 }
 
+void
+katana::PropertyGraph::ClearTypeIndexes() {
+  nodes_by_type_set_id_ = katana::LargeArray<Node>();
+  node_type_set_id_offsets_.clear();
+  out_edges_by_type_set_id_ = katana::LargeArray<uint32_t>();
+  has_out_edge_type_index_ = false;
+}
+
+katana::PropertyGraph::TypeIndexRange<katana::PropertyGraph::Node>
+katana::PropertyGraph::NodesOfTypeSetID(TypeSetID type_set_id) const {
+  if (node_type_set_id_offsets_.empty()) {
+    return {};
+  }
+  return {
+      nodes_by_type_set_id_.data(),
+      0,
+      node_type_set_id_offsets_[type_set_id],
+      node_type_set_id_offsets_[type_set_id + 1],
+      nullptr,
+      nullptr};
+}
+
+katana::PropertyGraph::TypeIndexRange<katana::PropertyGraph::Node>
+katana::PropertyGraph::NodesOfType(const std::string& name) const {
+  auto it = node_type_name_to_type_set_ids_.find(name);
+  if (it == node_type_name_to_type_set_ids_.end() ||
+      node_type_set_id_offsets_.empty() || it->second.none()) {
+    return {};
+  }
+  // Only look at the groups from the first to the last wanted TypeSetID
+  const SetOfTypeSetIDs& wanted = it->second;
+  size_t first = 0;
+  while (!wanted.test(first)) {
+    ++first;
+  }
+  size_t last = wanted.size() - 1;
+  while (!wanted.test(last)) {
+    --last;
+  }
+  return {
+      nodes_by_type_set_id_.data(),
+      0,
+      node_type_set_id_offsets_[first],
+      node_type_set_id_offsets_[last + 1],
+      node_type_set_id_.data(),
+      &wanted};
+}
+
+uint64_t
+katana::PropertyGraph::NumNodesOfType(const std::string& name) const {
+  auto it = node_type_name_to_type_set_ids_.find(name);
+  if (it == node_type_name_to_type_set_ids_.end() ||
+      node_type_set_id_offsets_.empty()) {
+    return 0;
+  }
+  uint64_t count = 0;
+  for (size_t i = 0; i < it->second.size(); ++i) {
+    if (it->second.test(i)) {
+      count += node_type_set_id_offsets_[i + 1] - node_type_set_id_offsets_[i];
+    }
+  }
+  return count;
+}
+
+katana::PropertyGraph::TypeIndexRange<katana::PropertyGraph::Edge, uint32_t>
+katana::PropertyGraph::OutEdgesOfTypeSetID(
+    Node node, TypeSetID type_set_id) const {
+  if (!has_out_edge_type_index_) {
+    return {};
+  }
+  auto [begin, end] = topology_.edge_range(node);
+  // Without an index, the out-edges are already grouped by TypeSetID
+  const uint32_t* offsets = out_edges_by_type_set_id_.size() == num_edges()
+                                ? out_edges_by_type_set_id_.data()
+                                : nullptr;
+  const TypeSetID* types = edge_type_set_id_.data();
+  auto type_at = [&, begin = begin](uint64_t pos) {
+    return types[offsets ? begin + offsets[pos] : pos];
+  };
+  using pos_iterator = boost::counting_iterator<uint64_t>;
+  uint64_t lo = *std::lower_bound(
+      pos_iterator(begin), pos_iterator(end), type_set_id,
+      [&](uint64_t pos, TypeSetID t) { return type_at(pos) < t; });
+  uint64_t hi = *std::upper_bound(
+      pos_iterator(lo), pos_iterator(end), type_set_id,
+      [&](TypeSetID t, uint64_t pos) { return t < type_at(pos); });
+  return {offsets, begin, lo, hi, nullptr, nullptr};
+}
+
+katana::PropertyGraph::TypeIndexRange<katana::PropertyGraph::Edge, uint32_t>
+katana::PropertyGraph::OutEdgesOfType(
+    Node node, const std::string& name) const {
+  auto it = edge_type_name_to_type_set_ids_.find(name);
+  if (it == edge_type_name_to_type_set_ids_.end() ||
+      !has_out_edge_type_index_) {
+    return {};
+  }
+  auto [begin, end] = topology_.edge_range(node);
+  const uint32_t* offsets = out_edges_by_type_set_id_.size() == num_edges()
+                                ? out_edges_by_type_set_id_.data()
+                                : nullptr;
+  return {
+      offsets, begin, begin, end, edge_type_set_id_.data(), &it->second};
+}
+
+katana::Result<void>
+katana::PropertyGraph::ReorderEdgeTypeSetIDs(const uint64_t* old_edge) {
+  uint64_t num_edges = topology_.num_edges();
+  if (edge_type_set_id_.size() != num_edges) {
+    return katana::ResultSuccess();
+  }
+  katana::LargeArray<TypeSetID> type_set_ids;
+  type_set_ids.allocateInterleaved(num_edges);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) { type_set_ids[e] = edge_type_set_id_[old_edge[e]]; },
+      katana::no_stats());
+  edge_type_set_id_ = std::move(type_set_ids);
+
+  if (has_wide_node_ids() || node_type_set_id_.size() != num_nodes()) {
+    ClearTypeIndexes();
+    return katana::ResultSuccess();
+  }
+  return BuildTypeIndexes();
+}
+
 katana::Result<void>
 katana::PropertyGraph::WriteGraph(
     const std::string& uri, const std::string& command_line) {
@@ -524,7 +1778,12 @@ katana::PropertyGraph::Commit(const std::string& command_line) {
 
 bool
 katana::PropertyGraph::Equals(const PropertyGraph* other) const {
-  if (!topology().Equals(other->topology())) {
+  if (has_wide_node_ids() != other->has_wide_node_ids()) {
+    return false;
+  }
+  if (has_wide_node_ids()
+          ? !wide_topology().Equals(other->wide_topology())
+          : !topology().Equals(other->topology())) {
     return false;
   }
   const auto& node_props = rdg_.node_properties();
@@ -645,93 +1904,471 @@ katana::PropertyGraph::AddNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology_.out_indices->length(), props->num_rows());
   }
-  return rdg_.AddNodeProperties(props);
+  return rdg_.AddNodeProperties(props);
+}
+
+katana::Result<void>
+katana::PropertyGraph::UpsertNodeProperties(
+    const std::shared_ptr<arrow::Table>& props) {
+  if (props->num_columns() == 0) {
+    KATANA_LOG_DEBUG("upsert empty node prop table");
+    return ResultSuccess();
+  }
+  if (topology_.out_indices &&
+      topology_.out_indices->length() != props->num_rows()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} rows found {} instead",
+        topology_.out_indices->length(), props->num_rows());
+  }
+  return rdg_.UpsertNodeProperties(props);
+}
+
+katana::Result<void>
+katana::PropertyGraph::RemoveNodeProperty(int i) {
+  return rdg_.RemoveNodeProperty(i);
+}
+
+katana::Result<void>
+katana::PropertyGraph::RemoveNodeProperty(const std::string& prop_name) {
+  auto col_names = node_properties()->ColumnNames();
+  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
+  if (pos != col_names.cend()) {
+    return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
+  }
+  if (rdg_.HasUnloadedNodeProperty(prop_name)) {
+    return rdg_.RemoveUnloadedNodeProperty(prop_name);
+  }
+  return katana::ErrorCode::PropertyNotFound;
+}
+
+katana::Result<void>
+katana::PropertyGraph::AddEdgeProperties(
+    const std::shared_ptr<arrow::Table>& props) {
+  if (props->num_columns() == 0) {
+    KATANA_LOG_DEBUG("adding empty edge prop table");
+    return ResultSuccess();
+  }
+  if (topology_.out_dests &&
+      topology_.out_dests->length() != props->num_rows()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} rows found {} instead",
+        topology_.out_dests->length(), props->num_rows());
+  }
+  return rdg_.AddEdgeProperties(props);
+}
+
+katana::Result<void>
+katana::PropertyGraph::UpsertEdgeProperties(
+    const std::shared_ptr<arrow::Table>& props) {
+  if (props->num_columns() == 0) {
+    KATANA_LOG_DEBUG("upsert empty edge prop table");
+    return ResultSuccess();
+  }
+  if (topology_.out_dests &&
+      topology_.out_dests->length() != props->num_rows()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "expected {} rows found {} instead",
+        topology_.out_dests->length(), props->num_rows());
+  }
+  return rdg_.UpsertEdgeProperties(props);
+}
+
+katana::Result<void>
+katana::PropertyGraph::RemoveEdgeProperty(int i) {
+  return rdg_.RemoveEdgeProperty(i);
+}
+
+katana::Result<void>
+katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
+  auto col_names = edge_properties()->ColumnNames();
+  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
+  if (pos != col_names.cend()) {
+    return rdg_.RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
+  }
+  if (rdg_.HasUnloadedEdgeProperty(prop_name)) {
+    return rdg_.RemoveUnloadedEdgeProperty(prop_name);
+  }
+  return katana::ErrorCode::PropertyNotFound;
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PropertyGraph::LoadNodeProperty(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(*load_mutex_);
+  if (auto col = rdg_.node_properties()->GetColumnByName(name); col) {
+    return col;
+  }
+  if (!rdg_.HasUnloadedNodeProperty(name)) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no node property {}", name);
+  }
+  if (auto res = rdg_.EnsureNodePropertyLoaded(name); !res) {
+    return res.error().WithContext("loading node property {}", name);
+  }
+  return rdg_.node_properties()->GetColumnByName(name);
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PropertyGraph::LoadEdgeProperty(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(*load_mutex_);
+  if (auto col = rdg_.edge_properties()->GetColumnByName(name); col) {
+    return col;
+  }
+  if (!rdg_.HasUnloadedEdgeProperty(name)) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "no edge property {}", name);
+  }
+  if (auto res = rdg_.EnsureEdgePropertyLoaded(name); !res) {
+    return res.error().WithContext("loading edge property {}", name);
+  }
+  return rdg_.edge_properties()->GetColumnByName(name);
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+katana::PropertyGraph::GetNodeProperty(const std::string& name) const {
+  auto res = LoadNodeProperty(name);
+  if (!res) {
+    if (res.error() != ErrorCode::PropertyNotFound) {
+      KATANA_LOG_ERROR("{}", res.error());
+    }
+    return nullptr;
+  }
+  return res.value();
+}
+
+std::shared_ptr<arrow::ChunkedArray>
+katana::PropertyGraph::GetEdgeProperty(const std::string& name) const {
+  auto res = LoadEdgeProperty(name);
+  if (!res) {
+    if (res.error() != ErrorCode::PropertyNotFound) {
+      KATANA_LOG_ERROR("{}", res.error());
+    }
+    return nullptr;
+  }
+  return res.value();
+}
+
+katana::Result<void>
+katana::PropertyGraph::SetTopology(const katana::GraphTopology& topology) {
+  if (auto res = rdg_.UnbindTopologyFileStorage(); !res) {
+    return res.error();
+  }
+  if (auto res = rdg_.UnbindInTopologyFileStorage(); !res) {
+    return res.error();
+  }
+  topology_ = topology;
+  wide_topology_ = WideGraphTopology{};
+  rdg_.set_statistics(std::nullopt);
+  ClearTypeIndexes();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::SetTopology(const katana::WideGraphTopology& topology) {
+  if (!NeedsWideNodeIds(topology.num_nodes())) {
+    auto narrow_result = NarrowTopology(topology);
+    if (!narrow_result) {
+      return narrow_result.error();
+    }
+    return SetTopology(narrow_result.value());
+  }
+  if (topology.has_in_edges()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "in-edges of topologies with wide node ids are not supported");
+  }
+  if (auto res = SetTopology(GraphTopology{}); !res) {
+    return res.error();
+  }
+  wide_topology_ = topology;
+
+  return katana::ResultSuccess();
+}
+
+void
+katana::PropertyGraph::ComputeStatistics() {
+  tsuba::GraphStatistics stats = VisitTopology(
+      [](const auto& topology) { return ComputeTopologyStatistics(topology); });
+  if (const TypeSetID* ids = node_type_set_ids(); ids) {
+    stats.node_type_counts =
+        CountTypes(ids, num_nodes(), node_type_set_id_to_type_names_);
+  }
+  if (const TypeSetID* ids = edge_type_set_ids(); ids) {
+    stats.edge_type_counts =
+        CountTypes(ids, num_edges(), edge_type_set_id_to_type_names_);
+  }
+  rdg_.set_statistics(std::move(stats));
 }
 
 katana::Result<void>
-katana::PropertyGraph::UpsertNodeProperties(
-    const std::shared_ptr<arrow::Table>& props) {
-  if (props->num_columns() == 0) {
-    KATANA_LOG_DEBUG("upsert empty node prop table");
-    return ResultSuccess();
+katana::PropertyGraph::ConstructInEdges() {
+  if (topology_.has_in_edges()) {
+    return katana::ResultSuccess();
   }
-  if (topology_.out_indices &&
-      topology_.out_indices->length() != props->num_rows()) {
+  if (has_wide_node_ids()) {
     return KATANA_ERROR(
-        ErrorCode::InvalidArgument, "expected {} rows found {} instead",
-        topology_.out_indices->length(), props->num_rows());
+        ErrorCode::NotImplemented,
+        "in-edges of graphs with wide node ids are not supported");
   }
-  return rdg_.UpsertNodeProperties(props);
-}
 
-katana::Result<void>
-katana::PropertyGraph::RemoveNodeProperty(int i) {
-  return rdg_.RemoveNodeProperty(i);
+  if (rdg_.has_in_topology_file()) {
+    if (auto res = rdg_.BindInTopologyFileStorage(); !res) {
+      return res.error();
+    }
+    auto map_result =
+        MapInTopology(rdg_.in_topology_file_storage(), &topology_);
+    if (map_result) {
+      return katana::ResultSuccess();
+    }
+    KATANA_LOG_WARN("ignoring stored in-edge index: {}", map_result.error());
+    if (auto res = rdg_.UnbindInTopologyFileStorage(); !res) {
+      return res.error();
+    }
+  }
+
+  return BuildInTopology(&topology_);
 }
 
 katana::Result<void>
-katana::PropertyGraph::RemoveNodeProperty(const std::string& prop_name) {
-  auto col_names = node_properties()->ColumnNames();
-  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
-  if (pos != col_names.cend()) {
-    return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
-  }
-  return katana::ErrorCode::PropertyNotFound;
+katana::PropertyGraph::DropInEdges() {
+  topology_.in_indices.reset();
+  topology_.in_sources.reset();
+  topology_.in_to_out_edges.reset();
+  return rdg_.UnbindInTopologyFileStorage();
 }
 
 katana::Result<void>
-katana::PropertyGraph::AddEdgeProperties(
-    const std::shared_ptr<arrow::Table>& props) {
-  if (props->num_columns() == 0) {
-    KATANA_LOG_DEBUG("adding empty edge prop table");
-    return ResultSuccess();
+katana::PropertyGraph::RelabelNodes(
+    const std::shared_ptr<arrow::UInt64Array>& old_to_new) {
+  if (has_wide_node_ids()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "relabeling graphs with wide node ids is not supported");
   }
-  if (topology_.out_dests &&
-      topology_.out_dests->length() != props->num_rows()) {
+  uint64_t num_nodes = topology_.num_nodes();
+  uint64_t num_edges = topology_.num_edges();
+
+  if (!old_to_new ||
+      static_cast<uint64_t>(old_to_new->length()) != num_nodes) {
     return KATANA_ERROR(
-        ErrorCode::InvalidArgument, "expected {} rows found {} instead",
-        topology_.out_dests->length(), props->num_rows());
+        ErrorCode::InvalidArgument, "expected a new id for each of {} nodes",
+        num_nodes);
+  }
+  for (const auto& nodes : {master_nodes(), mirror_nodes()}) {
+    for (const auto& host_nodes : nodes) {
+      if (host_nodes && host_nodes->length() > 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "relabeling a partition of a distributed graph is not supported");
+      }
+    }
   }
-  return rdg_.AddEdgeProperties(props);
-}
+  if (num_nodes == 0) {
+    return katana::ResultSuccess();
+  }
+  const uint64_t* mapping = old_to_new->raw_values();
 
-katana::Result<void>
-katana::PropertyGraph::UpsertEdgeProperties(
-    const std::shared_ptr<arrow::Table>& props) {
-  if (props->num_columns() == 0) {
-    KATANA_LOG_DEBUG("upsert empty edge prop table");
-    return ResultSuccess();
+  // Invert the mapping, checking that it is a permutation
+  constexpr uint32_t kUnmapped = std::numeric_limits<uint32_t>::max();
+  auto new_to_old_result = AllocateValues<uint32_t>(num_nodes);
+  if (!new_to_old_result) {
+    return new_to_old_result.error();
   }
-  if (topology_.out_dests &&
-      topology_.out_dests->length() != props->num_rows()) {
+  auto* new_to_old =
+      reinterpret_cast<uint32_t*>(new_to_old_result.value()->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { new_to_old[n] = kUnmapped; }, katana::no_stats());
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (mapping[n] >= num_nodes) {
+          out_of_range.update(true);
+        } else {
+          new_to_old[mapping[n]] = n;
+        }
+      },
+      katana::no_stats());
+  katana::GReduceLogicalOr unmapped;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        if (new_to_old[n] == kUnmapped) {
+          unmapped.update(true);
+        }
+      },
+      katana::no_stats());
+  if (out_of_range.reduce() || unmapped.reduce()) {
     return KATANA_ERROR(
-        ErrorCode::InvalidArgument, "expected {} rows found {} instead",
-        topology_.out_dests->length(), props->num_rows());
+        ErrorCode::InvalidArgument, "node mapping is not a permutation");
   }
-  return rdg_.UpsertEdgeProperties(props);
-}
 
-katana::Result<void>
-katana::PropertyGraph::RemoveEdgeProperty(int i) {
-  return rdg_.RemoveEdgeProperty(i);
-}
+  // Build the relabeled topology; edge_map[e] is the old id of new edge e
+  auto indices_result = AllocateValues<uint64_t>(num_nodes);
+  if (!indices_result) {
+    return indices_result.error();
+  }
+  auto dests_result = AllocateValues<uint32_t>(num_edges);
+  if (!dests_result) {
+    return dests_result.error();
+  }
+  auto edge_map_result = AllocateValues<uint64_t>(num_edges);
+  if (!edge_map_result) {
+    return edge_map_result.error();
+  }
+  auto* indices =
+      reinterpret_cast<uint64_t*>(indices_result.value()->mutable_data());
+  auto* dests =
+      reinterpret_cast<uint32_t*>(dests_result.value()->mutable_data());
+  auto* edge_map =
+      reinterpret_cast<uint64_t*>(edge_map_result.value()->mutable_data());
 
-katana::Result<void>
-katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
-  auto col_names = edge_properties()->ColumnNames();
-  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
-  if (pos != col_names.cend()) {
-    return rdg_.RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { indices[n] = topology_.edges(new_to_old[n]).size(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(indices, indices + num_nodes, indices);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        uint64_t new_e = n > 0 ? indices[n - 1] : 0;
+        for (auto e : topology_.edges(new_to_old[n])) {
+          dests[new_e] = mapping[topology_.edge_dest(e)];
+          edge_map[new_e] = e;
+          ++new_e;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  // Permute everything before changing anything so that failures leave the
+  // graph as it was
+  if (auto res = EnsureAllPropertiesLoaded(); !res) {
+    return res.error();
   }
-  return katana::ErrorCode::PropertyNotFound;
-}
 
-katana::Result<void>
-katana::PropertyGraph::SetTopology(const katana::GraphTopology& topology) {
-  if (auto res = rdg_.UnbindTopologyFileStorage(); !res) {
+  auto new_to_old_array = std::make_shared<arrow::UInt32Array>(
+      static_cast<int64_t>(num_nodes), new_to_old_result.value());
+  auto edge_map_array = std::make_shared<arrow::UInt64Array>(
+      static_cast<int64_t>(num_edges), edge_map_result.value());
+
+  std::shared_ptr<arrow::Table> new_node_properties;
+  if (node_properties()->num_columns() > 0) {
+    auto res = PermuteRows(node_properties(), new_to_old_array);
+    if (!res) {
+      return res.error().WithContext("permuting node properties");
+    }
+    new_node_properties = std::move(res.value());
+  }
+  std::shared_ptr<arrow::Table> new_edge_properties;
+  if (edge_properties()->num_columns() > 0) {
+    auto res = PermuteRows(edge_properties(), edge_map_array);
+    if (!res) {
+      return res.error().WithContext("permuting edge properties");
+    }
+    new_edge_properties = std::move(res.value());
+  }
+
+  std::shared_ptr<arrow::ChunkedArray> new_local_to_user_id;
+  if (local_to_user_id() &&
+      static_cast<uint64_t>(local_to_user_id()->length()) == num_nodes) {
+    auto res = PermuteRows(local_to_user_id(), new_to_old_array);
+    if (!res) {
+      return res.error().WithContext("permuting local to user ids");
+    }
+    new_local_to_user_id = std::move(res.value());
+  }
+  std::shared_ptr<arrow::ChunkedArray> new_local_to_global_id;
+  if (local_to_global_id() &&
+      static_cast<uint64_t>(local_to_global_id()->length()) == num_nodes) {
+    auto res = PermuteRows(local_to_global_id(), new_to_old_array);
+    if (!res) {
+      return res.error().WithContext("permuting local to global ids");
+    }
+    new_local_to_global_id = std::move(res.value());
+  }
+
+  katana::LargeArray<TypeSetID> new_node_type_set_id;
+  if (node_type_set_id_.size() == num_nodes) {
+    new_node_type_set_id.allocateInterleaved(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          new_node_type_set_id[n] = node_type_set_id_[new_to_old[n]];
+        },
+        katana::no_stats());
+  }
+  katana::LargeArray<TypeSetID> new_edge_type_set_id;
+  if (edge_type_set_id_.size() == num_edges) {
+    new_edge_type_set_id.allocateInterleaved(num_edges);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_edges),
+        [&](uint64_t e) {
+          new_edge_type_set_id[e] = edge_type_set_id_[edge_map[e]];
+        },
+        katana::no_stats());
+  }
+
+  // Commit the permuted tables. Upserts replace tables whole, so the old
+  // tables can be put back if a later step fails; the steps after
+  // SetTopology cannot fail.
+  std::shared_ptr<arrow::Table> old_node_properties = node_properties();
+  std::shared_ptr<arrow::Table> old_edge_properties = edge_properties();
+  auto restore_properties = [&](bool node, bool edge) {
+    if (node) {
+      if (auto res = UpsertNodeProperties(old_node_properties); !res) {
+        KATANA_LOG_ERROR("restoring node properties: {}", res.error());
+      }
+    }
+    if (edge) {
+      if (auto res = UpsertEdgeProperties(old_edge_properties); !res) {
+        KATANA_LOG_ERROR("restoring edge properties: {}", res.error());
+      }
+    }
+  };
+  if (new_node_properties) {
+    if (auto res = UpsertNodeProperties(new_node_properties); !res) {
+      return res.error();
+    }
+  }
+  if (new_edge_properties) {
+    if (auto res = UpsertEdgeProperties(new_edge_properties); !res) {
+      restore_properties(new_node_properties != nullptr, false);
+      return res.error();
+    }
+  }
+  if (auto res = SetTopology(katana::GraphTopology{
+          .out_indices = std::make_shared<arrow::UInt64Array>(
+              static_cast<int64_t>(num_nodes), indices_result.value()),
+          .out_dests = std::make_shared<arrow::UInt32Array>(
+              static_cast<int64_t>(num_edges), dests_result.value()),
+      });
+      !res) {
+    restore_properties(
+        new_node_properties != nullptr, new_edge_properties != nullptr);
     return res.error();
   }
-  topology_ = topology;
+
+  if (new_local_to_user_id) {
+    set_local_to_user_id(std::move(new_local_to_user_id));
+  }
+  if (new_local_to_global_id) {
+    set_local_to_global_id(std::move(new_local_to_global_id));
+  }
+  if (new_node_type_set_id.size() == num_nodes) {
+    node_type_set_id_ = std::move(new_node_type_set_id);
+  }
+  if (new_edge_type_set_id.size() == num_edges) {
+    edge_type_set_id_ = std::move(new_edge_type_set_id);
+  }
+  if (node_type_set_id_.size() == num_nodes &&
+      edge_type_set_id_.size() == num_edges) {
+    // Cannot fail: the topology has narrow node ids
+    if (auto res = BuildTypeIndexes(); !res) {
+      return res.error();
+    }
+  }
 
   return katana::ResultSuccess();
 }
@@ -752,6 +2389,16 @@ katana::PropertyGraph::InformPath(const std::string& input_path) {
 
 katana::Result<std::shared_ptr<arrow::UInt64Array>>
 katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
+  if (pg->has_wide_node_ids()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "sorting edges of graphs with wide node ids is not supported");
+  }
+  // Sorting renumbers edges, which invalidates in-edge to out-edge ids
+  if (auto res = pg->DropInEdges(); !res) {
+    return res.error();
+  }
+
   auto view_result_dests =
       katana::ConstructPropertyView<katana::UInt32Property>(
           pg->topology().out_dests.get());
@@ -791,6 +2438,11 @@ katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
       },
       katana::steal());
 
+  // Edges keep their TypeSetIDs, and the type index follows the new order
+  if (auto res = pg->ReorderEdgeTypeSetIDs(permutation_vec_data); !res) {
+    return res.error();
+  }
+
   if (auto r = permutation_vec_builder.Advance(pg->topology().num_edges());
       !r.ok()) {
     return ErrorCode::ArrowError;
@@ -804,10 +2456,59 @@ katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
   }
 }
 
-katana::GraphTopology::Edge
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+katana::SortAllEdgesByDestWithProperties(katana::PropertyGraph* pg) {
+  // Load before changing anything so that failures leave the graph as it was
+  for (const auto& name : pg->GetUnloadedEdgePropertyNames()) {
+    if (auto res = pg->EnsureEdgePropertyLoaded(name); !res) {
+      return res.error();
+    }
+  }
+
+  auto permutation_result = SortAllEdgesByDest(pg);
+  if (!permutation_result) {
+    return permutation_result.error();
+  }
+  std::shared_ptr<arrow::UInt64Array> permutation =
+      std::move(permutation_result.value());
+  if (pg->edge_properties()->num_columns() == 0) {
+    return permutation;
+  }
+
+  // Sorting an already sorted graph usually leaves every edge in place
+  const uint64_t* old_edge = permutation->raw_values();
+  katana::GReduceLogicalOr moved;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, pg->num_edges()),
+      [&](uint64_t e) {
+        if (old_edge[e] != e) {
+          moved.update(true);
+        }
+      },
+      katana::no_stats());
+  if (!moved.reduce()) {
+    return permutation;
+  }
+
+  auto permuted_result = PermuteRows(pg->edge_properties(), permutation);
+  if (!permuted_result) {
+    return permuted_result.error().WithContext("permuting edge properties");
+  }
+  if (auto res = pg->UpsertEdgeProperties(permuted_result.value()); !res) {
+    return res.error();
+  }
+  return permutation;
+}
+
+katana::Result<katana::GraphTopology::Edge>
 katana::FindEdgeSortedByDest(
     const PropertyGraph* graph, GraphTopology::Node node,
     GraphTopology::Node node_to_find) {
+  if (graph->has_wide_node_ids()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "finding edges of graphs with wide node ids is not supported");
+  }
   auto view_result_dests =
       katana::ConstructPropertyView<katana::UInt32Property>(
           graph->topology().out_dests.get());
@@ -826,296 +2527,110 @@ katana::FindEdgeSortedByDest(
       node_to_find,
       [=](edge_iterator e, uint32_t n) { return out_dests_view[*e] < n; });
 
-  return (
-      out_dests_view[*edge_matched] == node_to_find ? *edge_matched
-                                                    : edge_range.second);
+  if (edge_matched == edge_iterator(edge_range.second) ||
+      out_dests_view[*edge_matched] != node_to_find) {
+    return edge_range.second;
+  }
+  return *edge_matched;
 }
 
 katana::Result<void>
 katana::SortNodesByDegree(katana::PropertyGraph* pg) {
-  uint64_t num_nodes = pg->topology().num_nodes();
-  uint64_t num_edges = pg->topology().num_edges();
-
-  using DegreeNodePair = std::pair<uint64_t, uint32_t>;
-  std::vector<DegreeNodePair> dn_pairs(num_nodes);
-  katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](size_t node) {
-    size_t node_degree = pg->edges(node).size();
-    dn_pairs[node] = DegreeNodePair(node_degree, node);
-  });
-
-  // sort by degree (first item)
-  katana::ParallelSTL::sort(
-      dn_pairs.begin(), dn_pairs.end(), std::greater<DegreeNodePair>());
-
-  // create mapping, get degrees out to another vector to get prefix sum
-  std::vector<uint32_t> old_to_new_mapping(num_nodes);
-  katana::LargeArray<uint64_t> new_prefix_sum;
-  new_prefix_sum.allocateBlocked(num_nodes);
-  katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](uint64_t index) {
-    // save degree, which is pair.first
-    new_prefix_sum[index] = dn_pairs[index].first;
-    // save mapping; original index is in .second, map it to current index
-    old_to_new_mapping[dn_pairs[index].second] = index;
-  });
-
-  katana::ParallelSTL::partial_sum(
-      new_prefix_sum.begin(), new_prefix_sum.end(), new_prefix_sum.begin());
-
-  katana::LargeArray<uint32_t> new_out_dest;
-  new_out_dest.allocateBlocked(num_edges);
-
-  auto view_result_indices =
-      ConstructPropertyView<UInt64Property>(pg->topology().out_indices.get());
-  if (!view_result_indices) {
-    return view_result_indices.error();
-  }
-
-  auto out_indices_view = std::move(view_result_indices.value());
-
-  auto view_result_dests =
-      ConstructPropertyView<UInt32Property>(pg->topology().out_dests.get());
-  if (!view_result_dests) {
-    return view_result_dests.error();
+  if (auto res = RelabelNodes(pg, NodeOrdering::kDegree); !res) {
+    return res.error();
   }
-
-  auto out_dests_view = std::move(view_result_dests.value());
-
-  katana::do_all(
-      katana::iterate(uint64_t{0}, num_nodes),
-      [&](uint32_t old_node_id) {
-        uint32_t new_node_id = old_to_new_mapping[old_node_id];
-
-        // get the start location of this reindex'd nodes edges
-        uint64_t new_out_index =
-            (new_node_id == 0) ? 0 : new_prefix_sum[new_node_id - 1];
-
-        // construct the graph, reindexing as it goes along
-        auto node_edge_range = pg->topology().edge_range(old_node_id);
-        for (auto e = node_edge_range.first; e != node_edge_range.second; ++e) {
-          // get destination, reindex
-          uint32_t old_edge_dest = out_dests_view[e];
-          uint32_t new_edge_dest = old_to_new_mapping[old_edge_dest];
-
-          new_out_dest[new_out_index] = new_edge_dest;
-
-          new_out_index++;
-        }
-        // this assert makes sure reindex was correct + makes sure all edges
-        // are accounted for
-        KATANA_LOG_DEBUG_ASSERT(new_out_index == new_prefix_sum[new_node_id]);
-      },
-      katana::steal());
-
-  //Update the underlying PropertyGraph topology
-  katana::do_all(
-      katana::iterate(uint64_t{0}, num_nodes), [&](uint32_t node_id) {
-        out_indices_view[node_id] = new_prefix_sum[node_id];
-      });
-
-  katana::do_all(
-      katana::iterate(uint64_t{0}, num_edges), [&](uint32_t edge_id) {
-        out_dests_view[edge_id] = new_out_dest[edge_id];
-      });
-
   return katana::ResultSuccess();
 }
 
-katana::Result<std::unique_ptr<katana::PropertyGraph>>
-katana::CreateSymmetricGraph(katana::PropertyGraph* pg) {
-  const GraphTopology& topology = pg->topology();
-  auto symmetric = std::make_unique<katana::PropertyGraph>();
-  if (topology.num_nodes() == 0) {
-    return std::unique_ptr<PropertyGraph>(std::move(symmetric));
-  }
-
-  // New symmetric graph topology
-  auto out_indices = std::make_unique<katana::LargeArray<uint64_t>>();
-  auto out_dests = std::make_unique<katana::LargeArray<uint32_t>>();
-
-  out_indices->allocateInterleaved(topology.num_nodes());
-  // Store the out-degree of nodes from original graph
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_nodes()), [&](uint64_t n) {
-        auto edges = topology.edges(n);
-        (*out_indices)[n] = (*edges.end() - *edges.begin());
-      });
-
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_nodes()),
-      [&](uint64_t n) {
-        auto edges = topology.edges(n);
-        // update the out_indices for the symmetric topology
-        for (auto e = edges.begin(); e != edges.end(); ++e) {
-          auto dest = topology.edge_dest(*e);
-          // Do not add reverse edge for self-loops
-          if (n != dest) {
-            __sync_fetch_and_add(&((*out_indices)[dest]), 1);
-          }
-        }
-      },
-      katana::steal());
-
-  // Compute prefix sum
-  for (uint64_t n = 1; n < topology.num_nodes(); ++n) {
-    (*out_indices)[n] += (*out_indices)[n - 1];
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+katana::ComputeNodeOrdering(
+    const katana::PropertyGraph* pg, katana::NodeOrdering ordering) {
+  if (pg->has_wide_node_ids()) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "relabeling graphs with wide node ids is not supported");
   }
+  const GraphTopology& topology = pg->topology();
+  uint64_t num_nodes = topology.num_nodes();
 
-  uint64_t num_nodes_symmetric = topology.num_nodes();
-  uint64_t num_edges_symmetric = (*out_indices)[num_nodes_symmetric - 1];
-
-  katana::LargeArray<uint64_t> out_dests_offset;
-  out_dests_offset.allocateInterleaved(topology.num_nodes());
-  // Temp LargeArray for computing new destination positions
-  out_dests_offset[0] = 0;
-  katana::do_all(
-      katana::iterate(uint64_t{1}, topology.num_nodes()),
-      [&](uint64_t n) { out_dests_offset[n] = (*out_indices)[n - 1]; },
-      katana::no_stats());
-
-  out_dests->allocateInterleaved(num_edges_symmetric);
-  // Update graph topology with the original edges + reverse edges
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_nodes()),
-      [&](uint64_t src) {
-        auto edges = topology.edges(src);
-        // e = start index into edge array for a particular node
-        auto e = edges.begin();
-
-        // get all outgoing edges (excluding self edges) of a particular
-        // node and add reverse edges.
-        while (e < edges.end()) {
-          // destination node
-          auto dest = topology.edge_dest(*e);
-
-          // Add original edge
-          auto e_new_src = __sync_fetch_and_add(&(out_dests_offset[src]), 1);
-          (*out_dests)[e_new_src] = dest;
-
-          // Do not add reverse edge for self-loops
-          if (dest != src) {
-            // Add reverse edge
-            auto e_new_dst = __sync_fetch_and_add(&(out_dests_offset[dest]), 1);
-            (*out_dests)[e_new_dst] = src;
-            // TODO(gill) copy edge data to "new" array
-          }
-          e++;
-        }
-      },
-      katana::no_stats());
-
-  auto numeric_array_out_indices =
-      std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
-          static_cast<int64_t>(num_nodes_symmetric),
-          arrow::MutableBuffer::Wrap(
-              out_indices.release()->data(), num_nodes_symmetric));
-
-  auto numeric_array_out_dests =
-      std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
-          static_cast<int64_t>(num_edges_symmetric),
-          arrow::MutableBuffer::Wrap(
-              out_dests.release()->data(), num_edges_symmetric));
-
-  if (auto r = symmetric->SetTopology(katana::GraphTopology{
-          .out_indices = std::move(numeric_array_out_indices),
-          .out_dests = std::move(numeric_array_out_dests),
-      });
-      !r) {
-    return r.error();
+  switch (ordering) {
+  case NodeOrdering::kDegree: {
+    std::vector<uint32_t> order(num_nodes);
+    std::iota(order.begin(), order.end(), uint32_t{0});
+    katana::ParallelSTL::sort(
+        order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+          uint64_t a_degree = topology.edges(a).size();
+          uint64_t b_degree = topology.edges(b).size();
+          return a_degree > b_degree || (a_degree == b_degree && a < b);
+        });
+    return MakeNodeMapping(order);
+  }
+  case NodeOrdering::kReverseCuthillMcKee:
+    return MakeNodeMapping(ReverseCuthillMcKeeOrder(topology));
+  case NodeOrdering::kHubCluster: {
+    // hubs_through[n] is the number of hubs among nodes [0, n]
+    katana::LargeArray<uint64_t> hubs_through;
+    hubs_through.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          // degree > num_edges / num_nodes without rounding
+          bool is_hub =
+              topology.edges(n).size() * num_nodes > topology.num_edges();
+          hubs_through[n] = is_hub ? 1 : 0;
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        hubs_through.begin(), hubs_through.end(), hubs_through.begin());
+    uint64_t num_hubs = num_nodes > 0 ? hubs_through[num_nodes - 1] : 0;
+
+    std::vector<uint32_t> order(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          uint64_t hubs_before = n > 0 ? hubs_through[n - 1] : 0;
+          bool is_hub = hubs_through[n] != hubs_before;
+          uint64_t new_id =
+              is_hub ? hubs_before : num_hubs + (n - hubs_before);
+          order[new_id] = n;
+        },
+        katana::no_stats());
+    return MakeNodeMapping(order);
+  }
+  default:
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unknown node ordering {}",
+        static_cast<int>(ordering));
   }
-
-  return std::unique_ptr<PropertyGraph>(std::move(symmetric));
 }
 
-katana::Result<std::unique_ptr<katana::PropertyGraph>>
-katana::CreateTransposeGraph(katana::PropertyGraph* pg) {
-  const GraphTopology& topology = pg->topology();
-  auto transpose = std::make_unique<katana::PropertyGraph>();
-  if (topology.num_nodes() == 0) {
-    return std::unique_ptr<PropertyGraph>(std::move(transpose));
+katana::Result<std::shared_ptr<arrow::UInt64Array>>
+katana::RelabelNodes(katana::PropertyGraph* pg, katana::NodeOrdering ordering) {
+  auto old_to_new_result = ComputeNodeOrdering(pg, ordering);
+  if (!old_to_new_result) {
+    return old_to_new_result.error();
   }
-
-  // New transpose graph topology
-  auto out_indices = std::make_unique<katana::LargeArray<uint64_t>>();
-  auto out_dests = std::make_unique<katana::LargeArray<uint32_t>>();
-
-  out_indices->allocateInterleaved(topology.num_nodes());
-
-  // Initialize the new topology indices
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_nodes()),
-      [&](uint64_t n) { (*out_indices)[n] = uint64_t{0}; }, katana::no_stats());
-
-  // Keep a copy of old destinaton ids and compute number of
-  // in-coming edges for the new prefix sum of out_indices.
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_edges()),
-      [&](uint64_t e) {
-        // Counting outgoing edges in the tranpose graph by
-        // counting incoming edges in the original graph
-        auto dest = topology.edge_dest(e);
-        __sync_add_and_fetch(&((*out_indices)[dest]), 1);
-      },
-      katana::no_stats());
-
-  // Prefix sum calculation of the edge index array
-  for (uint64_t n = 1; n < topology.num_nodes(); ++n) {
-    (*out_indices)[n] += (*out_indices)[n - 1];
+  auto old_to_new = std::move(old_to_new_result.value());
+  if (auto res = pg->RelabelNodes(old_to_new); !res) {
+    return res.error();
   }
+  return old_to_new;
+}
 
-  katana::LargeArray<uint64_t> out_dests_offset;
-  out_dests_offset.allocateInterleaved(topology.num_nodes());
-  // Reuse out_indices_tmp for computing new destination positions
-  out_dests_offset[0] = 0;
-  katana::do_all(
-      katana::iterate(uint64_t{1}, topology.num_nodes()),
-      [&](uint64_t n) { out_dests_offset[n] = (*out_indices)[n - 1]; },
-      katana::no_stats());
-
-  out_dests->allocateInterleaved(topology.num_edges());
-  // Update large_array_out_dests_ with the new destination ids
-  // of the transposed graphs
-  katana::do_all(
-      katana::iterate(uint64_t{0}, topology.num_nodes()),
-      [&](uint64_t src) {
-        auto edges = topology.edges(src);
-        // e = start index into edge array for a particular node
-        auto e = edges.begin();
-
-        // get all outgoing edges of a particular
-        // node and reverse the edges.
-        while (e < edges.end()) {
-          // Destination node
-          auto dest = topology.edge_dest(*e);
-          // Location to save edge
-          auto e_new = __sync_fetch_and_add(&(out_dests_offset[dest]), 1);
-          // Save src as destination
-          (*out_dests)[e_new] = src;
-          // TODO (gill) copy edge data to the transposed graph
-          e++;
-        }
-      },
-      katana::no_stats());
-
-  // Set new topology
-  auto numeric_array_out_indices =
-      std::make_shared<arrow::NumericArray<arrow::UInt64Type>>(
-          static_cast<int64_t>(topology.num_nodes()),
-          arrow::MutableBuffer::Wrap(
-              out_indices.release()->data(), topology.num_nodes()));
-
-  auto numeric_array_out_dests =
-      std::make_shared<arrow::NumericArray<arrow::UInt32Type>>(
-          static_cast<int64_t>(topology.num_edges()),
-          arrow::MutableBuffer::Wrap(
-              out_dests.release()->data(), topology.num_edges()));
-
-  if (auto r = transpose->SetTopology(katana::GraphTopology{
-          .out_indices = std::move(numeric_array_out_indices),
-          .out_dests = std::move(numeric_array_out_dests),
-      });
-      !r) {
-    return r.error();
-  }
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::CreateSymmetricGraph(
+    katana::PropertyGraph* pg,
+    const std::vector<std::string>& edge_property_names,
+    bool remove_duplicates) {
+  return BuildReversedGraph(
+      pg, /*keep_out_edges=*/true, remove_duplicates, edge_property_names);
+}
 
-  return std::unique_ptr<PropertyGraph>(std::move(transpose));
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::CreateTransposeGraph(
+    katana::PropertyGraph* pg,
+    const std::vector<std::string>& edge_property_names,
+    bool remove_duplicates) {
+  return BuildReversedGraph(
+      pg, /*keep_out_edges=*/false, remove_duplicates, edge_property_names);
 }
@@ -204,6 +204,11 @@ public:
 
 }  // namespace
 
+std::unique_ptr<katana::TerminationDetection>
+katana::internal::CreateLocalTerminationDetection() {
+  return std::make_unique<LocalTerminationDetection>();
+}
+
 struct katana::SharedMem::Impl {
   struct Dependents {
     LocalTerminationDetection term;
@@ -21,15 +21,22 @@
 
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <sstream>
 
 #include "katana/Env.h"
 #include "katana/Executor_OnEach.h"
+#include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
 #include "tsuba/file.h"
 
 namespace {
@@ -39,6 +46,23 @@ CheckPrintingThreadVals() {
   return katana::GetEnv("PRINT_PER_THREAD_STATS");
 }
 
+katana::StatFormat
+DefaultStatFormat() {
+  std::string format;
+  if (!katana::GetEnv("KATANA_STAT_FORMAT", &format) || format == "text") {
+    return katana::StatFormat::kText;
+  }
+  if (format == "json") {
+    return katana::StatFormat::kJSON;
+  }
+  if (format == "chrome") {
+    return katana::StatFormat::kChromeTrace;
+  }
+  KATANA_LOG_WARN(
+      "unknown KATANA_STAT_FORMAT {}; expected text, json or chrome", format);
+  return katana::StatFormat::kText;
+}
+
 void
 PrintHeader(std::ostream& out, const char* sep) {
   out << "STAT_TYPE" << sep << "REGION" << sep << "CATEGORY" << sep;
@@ -125,8 +149,101 @@ struct StatImpl {
       }
     }
   }
+
+  /// Adds the statistics to the JSON objects of their regions under key
+  void ToJSON(
+      const char* key,
+      std::map<katana::gstl::Str, nlohmann::json>* regions) const {
+    for (auto i = result_.cbegin(), end_i = result_.cend(); i != end_i; ++i) {
+      const auto& s = result_.stat(i);
+      nlohmann::json values = nlohmann::json::array();
+      for (const auto& v : s.values()) {
+        values.emplace_back(v);
+      }
+      (*regions)[result_.region(i)][key][result_.category(i).c_str()] = {
+          {"total_type", katana::StatTotal::str(s.totalTy())},
+          {"total", s.total()},
+          {"values", std::move(values)},
+      };
+    }
+  }
 };
 
+struct TimelineEvent {
+  katana::gstl::Str region;
+  katana::gstl::Str category;
+  unsigned tid;
+  std::chrono::steady_clock::time_point begin;
+  std::chrono::steady_clock::time_point end;
+};
+
+/// Returns the parent of each region on the timeline: the region of the
+/// innermost event on the same thread that contains the first event of the
+/// region, if any
+std::map<katana::gstl::Str, const katana::gstl::Str*>
+RegionParents(const std::vector<const TimelineEvent*>& events) {
+  std::vector<const TimelineEvent*> sorted(events);
+  std::sort(
+      sorted.begin(), sorted.end(),
+      [](const TimelineEvent* a, const TimelineEvent* b) {
+        if (a->tid != b->tid) {
+          return a->tid < b->tid;
+        }
+        if (a->begin != b->begin) {
+          return a->begin < b->begin;
+        }
+        return a->end > b->end;
+      });
+
+  struct First {
+    std::chrono::steady_clock::time_point begin;
+    const katana::gstl::Str* parent;
+  };
+  std::map<katana::gstl::Str, First> first;
+  std::vector<const TimelineEvent*> open;
+  for (const TimelineEvent* e : sorted) {
+    if (!open.empty() && open.back()->tid != e->tid) {
+      open.clear();
+    }
+    while (!open.empty() && open.back()->end < e->end) {
+      open.pop_back();
+    }
+    const katana::gstl::Str* parent = nullptr;
+    for (auto it = open.rbegin(); it != open.rend(); ++it) {
+      if ((*it)->region != e->region) {
+        parent = &(*it)->region;
+        break;
+      }
+    }
+    auto [it, inserted] = first.emplace(e->region, First{e->begin, parent});
+    if (!inserted && e->begin < it->second.begin) {
+      it->second = First{e->begin, parent};
+    }
+    open.emplace_back(e);
+  }
+
+  // Place regions in the order they first started so that a parent is
+  // always placed before its children, which rules out cycles
+  std::vector<std::pair<const katana::gstl::Str*, First>> order;
+  for (const auto& [region, f] : first) {
+    order.emplace_back(&region, f);
+  }
+  std::stable_sort(
+      order.begin(), order.end(), [](const auto& a, const auto& b) {
+        return a.second.begin < b.second.begin;
+      });
+
+  std::map<katana::gstl::Str, const katana::gstl::Str*> parents;
+  for (const auto& [region, f] : order) {
+    if (f.parent && parents.count(*f.parent)) {
+      parents.emplace(*region, &parents.find(*f.parent)->first);
+    } else {
+      parents.emplace(*region, nullptr);
+    }
+  }
+  return parents;
+}
+
 }  // end unnamed namespace
 
 class katana::StatManager::Impl {
@@ -135,8 +252,135 @@ public:
   StatImpl<double> fp_stats_;
   StatImpl<Str> str_stats_;
   std::string outfile_;
+  std::atomic<StatFormat> format_{DefaultStatFormat()};
+  katana::PerThreadStorage<gstl::Vector<TimelineEvent>> timeline_;
+  std::chrono::steady_clock::time_point epoch_{
+      std::chrono::steady_clock::now()};
+
+  bool empty() const {
+    return int_stats_.result_.cbegin() == int_stats_.result_.cend() &&
+           fp_stats_.result_.cbegin() == fp_stats_.result_.cend() &&
+           str_stats_.result_.cbegin() == str_stats_.result_.cend();
+  }
+
+  std::vector<const TimelineEvent*> Timeline() const {
+    std::vector<const TimelineEvent*> events;
+    for (unsigned t = 0; t < timeline_.size(); ++t) {
+      for (const auto& e : *timeline_.getRemote(t)) {
+        events.emplace_back(&e);
+      }
+    }
+    return events;
+  }
+
+  double Micros(std::chrono::steady_clock::time_point t) const {
+    return std::chrono::duration<double, std::micro>(t - epoch_).count();
+  }
+
+  void PrintJSON(std::ostream& out) const;
+  void PrintChromeTrace(std::ostream& out) const;
 };
 
+void
+katana::StatManager::Impl::PrintJSON(std::ostream& out) const {
+  std::vector<const TimelineEvent*> events = Timeline();
+  if (empty() && events.empty()) {
+    return;
+  }
+
+  std::map<gstl::Str, nlohmann::json> regions;
+  int_stats_.ToJSON("stats", &regions);
+  fp_stats_.ToJSON("stats", &regions);
+  str_stats_.ToJSON("params", &regions);
+
+  auto parents = RegionParents(events);
+  std::map<gstl::Str, std::vector<gstl::Str>> children;
+  std::vector<gstl::Str> roots;
+  for (const auto& [region, parent] : parents) {
+    regions[region];
+    if (parent) {
+      children[*parent].emplace_back(region);
+    }
+  }
+  for (const auto& [region, json] : regions) {
+    auto it = parents.find(region);
+    if (it == parents.end() || !it->second) {
+      roots.emplace_back(region);
+    }
+  }
+
+  std::function<nlohmann::json(const gstl::Str&)> make_region =
+      [&](const gstl::Str& region) {
+        nlohmann::json r = std::move(regions[region]);
+        r["name"] = region;
+        nlohmann::json sub = nlohmann::json::array();
+        for (const auto& child : children[region]) {
+          sub.emplace_back(make_region(child));
+        }
+        r["regions"] = std::move(sub);
+        return r;
+      };
+
+  nlohmann::json top = nlohmann::json::array();
+  for (const auto& region : roots) {
+    top.emplace_back(make_region(region));
+  }
+
+  auto res = JsonDump(nlohmann::json{{"regions", std::move(top)}});
+  if (!res) {
+    KATANA_LOG_ERROR("printing stats: {}", res.error());
+    return;
+  }
+  out << res.value() << "\n";
+}
+
+void
+katana::StatManager::Impl::PrintChromeTrace(std::ostream& out) const {
+  std::vector<const TimelineEvent*> events = Timeline();
+  if (events.empty()) {
+    return;
+  }
+
+  int pid = getpid();
+  nlohmann::json trace = nlohmann::json::array();
+  std::vector<bool> named;
+  for (const TimelineEvent* e : events) {
+    if (e->tid >= named.size()) {
+      named.resize(e->tid + 1);
+    }
+    if (!named[e->tid]) {
+      named[e->tid] = true;
+      trace.emplace_back(nlohmann::json{
+          {"name", "thread_name"},
+          {"ph", "M"},
+          {"pid", pid},
+          {"tid", e->tid},
+          {"args", {{"name", fmt::format("thread {}", e->tid)}}},
+      });
+    }
+    trace.emplace_back(nlohmann::json{
+        {"name", e->region},
+        {"cat", e->category},
+        {"ph", "X"},
+        {"ts", Micros(e->begin)},
+        {"dur",
+         std::chrono::duration<double, std::micro>(e->end - e->begin).count()},
+        {"pid", pid},
+        {"tid", e->tid},
+    });
+  }
+
+  auto res = JsonDump(nlohmann::json{
+      {"traceEvents", std::move(trace)},
+      {"displayTimeUnit", "ms"},
+  });
+  if (!res) {
+    KATANA_LOG_ERROR("printing stats: {}", res.error());
+    return;
+  }
+  out << res.value() << "\n";
+}
+
 katana::StatManager::StatManager() { impl_ = std::make_unique<Impl>(); }
 
 katana::StatManager::~StatManager() = default;
@@ -146,6 +390,26 @@ katana::StatManager::SetStatFile(const std::string& outfile) {
   impl_->outfile_ = outfile;
 }
 
+void
+katana::StatManager::SetStatFormat(StatFormat format) {
+  impl_->format_ = format;
+}
+
+bool
+katana::StatManager::IsRecordingTimeline() const {
+  return impl_->format_.load(std::memory_order_relaxed) != StatFormat::kText;
+}
+
+void
+katana::StatManager::AddTimelineEvent(
+    const char* region, const char* category,
+    std::chrono::steady_clock::time_point begin,
+    std::chrono::steady_clock::time_point end) {
+  impl_->timeline_.getLocal()->emplace_back(TimelineEvent{
+      gstl::makeStr(region), gstl::makeStr(category),
+      ThreadPool::getPoolTID(ThreadPool::getTID()), begin, end});
+}
+
 bool
 katana::StatManager::IsPrintingThreadVals() const {
   return CheckPrintingThreadVals();
@@ -249,12 +513,27 @@ katana::StatManager::AddParam(
 
 void
 katana::StatManager::Print() {
+  auto print = [this](std::ostream& out) {
+    switch (impl_->format_.load()) {
+    case StatFormat::kJSON:
+      MergeStats();
+      impl_->PrintJSON(out);
+      break;
+    case StatFormat::kChromeTrace:
+      impl_->PrintChromeTrace(out);
+      break;
+    default:
+      PrintStats(out);
+      break;
+    }
+  };
+
   if (impl_->outfile_.empty()) {
-    return PrintStats(std::cout);
+    return print(std::cout);
   }
   // n.b. Assumes that stats fit in memory
   std::ostringstream out;
-  PrintStats(out);
+  print(out);
 
   std::string stats = out.str();
   if (stats.empty()) {
@@ -280,11 +559,32 @@ katana::internal::sysStatManager() {
   return stat_manager_singleton;
 }
 
+bool
+katana::internal::IsRecordingTimeline() {
+  return stat_manager_singleton &&
+         stat_manager_singleton->IsRecordingTimeline();
+}
+
+void
+katana::internal::ReportTimelineEvent(
+    const char* region, const char* category,
+    std::chrono::steady_clock::time_point begin,
+    std::chrono::steady_clock::time_point end) {
+  if (stat_manager_singleton) {
+    stat_manager_singleton->AddTimelineEvent(region, category, begin, end);
+  }
+}
+
 void
 katana::SetStatFile(const std::string& f) {
   internal::sysStatManager()->SetStatFile(f);
 }
 
+void
+katana::SetStatFormat(StatFormat format) {
+  internal::sysStatManager()->SetStatFormat(format);
+}
+
 void
 katana::PrintStats() {
   internal::sysStatManager()->Print();
@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include "katana/ExecutionContext.h"
 #include "katana/Logging.h"
 #include "katana/TerminationDetection.h"
 
@@ -35,6 +36,9 @@ katana::internal::SetTerminationDetection(katana::TerminationDetection* t) {
 
 katana::TerminationDetection&
 katana::GetTerminationDetection(unsigned active_threads) {
+  if (ExecutionContext* ctx = ExecutionContext::Current()) {
+    return ctx->GetTerminationDetection(active_threads);
+  }
   kTerminationDetection->Init(active_threads);
   return *kTerminationDetection;
 }
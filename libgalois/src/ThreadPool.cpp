@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <numeric>
 
 #include "katana/Env.h"
 #include "katana/HWTopo.h"
@@ -39,14 +40,18 @@ using katana::ThreadPool;
 thread_local ThreadPool::per_signal ThreadPool::my_box;
 
 ThreadPool::ThreadPool()
-    : mi(getHWTopo().machineTopoInfo),
-      reserved(0),
-      masterFastmode(false),
-      running(false) {
-  signals.resize(mi.maxThreads);
+    : reserved(0), masterFastmode(false), numPartitions(0) {
+  const auto& hw = getHWTopo();
+  whole.mi = hw.machineTopoInfo;
+  whole.topo = hw.threadTopoInfo;
+  whole.threads.resize(whole.mi.maxThreads);
+  std::iota(whole.threads.begin(), whole.threads.end(), 0);
+  leased.resize(whole.mi.maxThreads);
+
+  signals.resize(whole.mi.maxThreads);
   initThread(0);
 
-  for (unsigned i = 1; i < mi.maxThreads; ++i) {
+  for (unsigned i = 1; i < whole.mi.maxThreads; ++i) {
     std::thread t(&ThreadPool::threadLoop, this, i);
     threads.emplace_back(std::move(t));
   }
@@ -69,11 +74,15 @@ ThreadPool::~ThreadPool() {
 void
 ThreadPool::destroyCommon() {
   beKind();  // reset fastmode
-  run(mi.maxThreads, []() { throw shutdown_ty(); });
+  KATANA_LOG_VASSERT(
+      numPartitions == 0, "Partitions still in use at thread pool exit");
+  run(whole.mi.maxThreads, []() { throw shutdown_ty(); });
 }
 
 void
 ThreadPool::burnPower(unsigned num) {
+  KATANA_LOG_VASSERT(
+      numPartitions == 0, "Fast mode is not supported with partitions");
   num = std::min(num, getMaxUsableThreads());
 
   // changing number of threads?  just do a reset
@@ -129,9 +138,9 @@ getNth(std::atomic<T*>& headptr, unsigned off) {
 void
 ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
-  my_box.topo = getHWTopo().threadTopoInfo[tid];
+  my_box.topo = whole.topo[tid];
   // Initialize
-  initPTS(mi.maxThreads);
+  initPTS(whole.mi.maxThreads);
 
   if (!GetEnv("KATANA_DO_NOT_BIND_THREADS")) {
     bool bind_main = false;
@@ -161,7 +170,7 @@ ThreadPool::threadLoop(unsigned tid) {
     me.wait(fastmode);
     cascade(fastmode);
     try {
-      work();
+      (me.partition ? me.partition->work : whole.work)();
     } catch (const shutdown_ty&) {
       return;
     } catch (const fastmode_ty& fm) {
@@ -184,15 +193,16 @@ ThreadPool::threadLoop(unsigned tid) {
 void
 ThreadPool::decascade() {
   auto& me = my_box;
+  const Partition& part = view();
   // nothing to wake up
   if (me.wbegin != me.wend) {
     auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
-    auto& c1done = signals[me.wbegin]->done;
+    auto& c1done = signals[part.threads[me.wbegin]]->done;
     while (!c1done) {
       asmPause();
     }
     if (midpoint < me.wend) {
-      auto& c2done = signals[midpoint]->done;
+      auto& c2done = signals[part.threads[midpoint]]->done;
       while (!c2done) {
         asmPause();
       }
@@ -212,29 +222,43 @@ ThreadPool::cascade(bool fastmode) {
   }
 
   auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
+  // children take the ids and topology of their place in the partition
+  const Partition& part = view();
 
-  auto* child1 = signals[me.wbegin];
+  auto* child1 = signals[part.threads[me.wbegin]];
   child1->wbegin = me.wbegin + 1;
   child1->wend = midpoint;
+  child1->topo = part.topo[me.wbegin];
+  child1->partition = me.partition;
   child1->wakeup(fastmode);
 
   if (midpoint < me.wend) {
-    auto* child2 = signals[midpoint];
+    auto* child2 = signals[part.threads[midpoint]];
     child2->wbegin = midpoint + 1;
     child2->wend = me.wend;
+    child2->topo = part.topo[midpoint];
+    child2->partition = me.partition;
     child2->wakeup(fastmode);
   }
 }
 
 void
-ThreadPool::runInternal(unsigned num) {
+ThreadPool::runInternal(unsigned num, std::function<void(void)> work) {
+  // my_box is tid 0
+  auto& me = my_box;
+  Partition& part = me.partition ? *me.partition : whole;
+  // partitions run concurrently with each other but not with the whole pool
+  std::unique_lock<std::shared_mutex> lock(partitionLock, std::defer_lock);
+  if (!me.partition) {
+    lock.lock();
+  }
   // sanitize num
   // seq write to starting should make work safe
-  KATANA_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
-  running = true;
+  KATANA_LOG_VASSERT(
+      !part.running, "Recursive thread pool execution not supported");
+  part.running = true;
+  part.work = std::move(work);
   num = std::min(std::max(1U, num), getMaxUsableThreads());
-  // my_box is tid 0
-  auto& me = my_box;
   me.wbegin = 1;
   me.wend = num;
 
@@ -243,7 +267,7 @@ ThreadPool::runInternal(unsigned num) {
   cascade(masterFastmode);
   // Do master thread work
   try {
-    work();
+    part.work();
   } catch (const shutdown_ty&) {
     return;
   } catch (const fastmode_ty& fm) {
@@ -251,30 +275,164 @@ ThreadPool::runInternal(unsigned num) {
   // wait for children
   decascade();
   // Clean up
-  work = nullptr;
-  running = false;
+  part.work = nullptr;
+  part.running = false;
 }
 
 void
 ThreadPool::runDedicated(std::function<void(void)>& f) {
-  // TODO(ddn): update katana::activeThreads to reflect the dedicated
-  // thread but we don't want to depend on katana symbols and too many
-  // clients access katana::activeThreads directly.
+  // TODO(ddn): update katana::getActiveThreads() to reflect the dedicated
+  // thread but we don't want to depend on katana symbols.
+  std::unique_lock<std::shared_mutex> lock(partitionLock);
   KATANA_LOG_VASSERT(
-      !running, "Can't start dedicated thread during parallel section");
+      !whole.running, "Can't start dedicated thread during parallel section");
   ++reserved;
 
-  KATANA_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
-  work = [&f]() { throw dedicated_ty{f}; };
-  auto* child = signals[mi.maxThreads - reserved];
+  KATANA_LOG_VASSERT(
+      reserved < whole.mi.maxThreads, "Too many dedicated threads");
+  unsigned tid = whole.mi.maxThreads - reserved;
+  {
+    std::lock_guard<std::mutex> lg(leaseLock);
+    KATANA_LOG_VASSERT(!leased[tid], "Dedicated thread is in a partition");
+  }
+  whole.work = [&f]() { throw dedicated_ty{f}; };
+  auto* child = signals[tid];
   child->wbegin = 0;
   child->wend = 0;
+  child->topo = whole.topo[tid];
+  child->partition = nullptr;
   child->done = 0;
   child->wakeup(masterFastmode);
   while (!child->done) {
     asmPause();
   }
-  work = nullptr;
+  whole.work = nullptr;
+}
+
+bool
+ThreadPool::isAvailable(unsigned poolTid) {
+  std::lock_guard<std::mutex> lg(leaseLock);
+  return poolTid != 0 && poolTid < whole.mi.maxThreads - reserved &&
+         !leased[poolTid];
+}
+
+std::unique_ptr<ThreadPool::Partition>
+ThreadPool::makePartition(std::vector<unsigned> threads) {
+  if (threads.empty()) {
+    return nullptr;
+  }
+  std::sort(threads.begin(), threads.end());
+  {
+    std::lock_guard<std::mutex> lg(leaseLock);
+    for (unsigned i = 0; i < threads.size(); ++i) {
+      unsigned t = threads[i];
+      if (t == 0 || t >= whole.mi.maxThreads - reserved || leased[t] ||
+          (i > 0 && threads[i - 1] == t)) {
+        return nullptr;
+      }
+    }
+    for (unsigned t : threads) {
+      leased[t] = true;
+    }
+    ++numPartitions;
+  }
+
+  auto p = std::make_unique<Partition>();
+  p->threads = std::move(threads);
+  unsigned num = p->threads.size();
+
+  // Renumber threads, sockets and leaders densely within the partition
+  std::vector<unsigned> socket_ids;
+  std::vector<unsigned> socket_leaders;
+  std::vector<bool> seen_numa;
+  unsigned num_cores = 0;
+  unsigned num_numa = 0;
+  unsigned max_socket = 0;
+  p->topo.resize(num);
+  for (unsigned i = 0; i < num; ++i) {
+    const ThreadTopoInfo& hw = whole.topo[p->threads[i]];
+    if (hw.socket >= socket_ids.size()) {
+      socket_ids.resize(hw.socket + 1, ~0U);
+    }
+    if (hw.numaNode >= seen_numa.size()) {
+      seen_numa.resize(hw.numaNode + 1);
+    }
+    unsigned& socket = socket_ids[hw.socket];
+    if (socket == ~0U) {
+      socket = socket_leaders.size();
+      socket_leaders.push_back(i);
+    }
+    max_socket = std::max(max_socket, socket);
+
+    ThreadTopoInfo& ti = p->topo[i];
+    ti = hw;
+    ti.tid = i;
+    ti.socket = socket;
+    ti.socketLeader = socket_leaders[socket];
+    ti.cumulativeMaxSocket = max_socket;
+
+    // pool threads below maxCores are on distinct cores (see HWTopoLinux)
+    if (hw.tid < whole.mi.maxCores) {
+      ++num_cores;
+    }
+    if (!seen_numa[hw.numaNode]) {
+      seen_numa[hw.numaNode] = true;
+      ++num_numa;
+    }
+  }
+
+  p->mi.maxThreads = num;
+  p->mi.maxCores = std::max(1U, num_cores);
+  p->mi.maxSockets = socket_leaders.size();
+  p->mi.maxNumaNodes = std::max(1U, num_numa);
+  return p;
+}
+
+void
+ThreadPool::releasePartition(std::unique_ptr<Partition> p) {
+  if (!p) {
+    return;
+  }
+  KATANA_LOG_VASSERT(
+      !p->running && my_box.partition != p.get(),
+      "Releasing a partition in use");
+  std::lock_guard<std::mutex> lg(leaseLock);
+  for (unsigned t : p->threads) {
+    leased[t] = false;
+  }
+  --numPartitions;
+}
+
+void
+ThreadPool::enterPartition(Partition* p) {
+  auto& me = my_box;
+  KATANA_LOG_VASSERT(!me.partition, "Nested partitions are not supported");
+  // Pool threads are busy while the whole pool runs; only the thread that
+  // started the work could enter a partition, and it would deadlock
+  KATANA_LOG_VASSERT(
+      std::find(signals.begin() + 1, signals.end(), &me) == signals.end() &&
+          !(signals[0] == &me && whole.running),
+      "Pool threads cannot enter a partition");
+  KATANA_LOG_VASSERT(
+      !masterFastmode, "Fast mode is not supported with partitions");
+
+  p->entry.lock();
+  partitionLock.lock_shared();
+  me.savedTopo = me.topo;
+  me.topo = p->topo[0];
+  me.partition = p;
+}
+
+void
+ThreadPool::leavePartition() {
+  auto& me = my_box;
+  Partition* p = me.partition;
+  KATANA_LOG_VASSERT(p, "Not in a partition");
+  KATANA_LOG_VASSERT(!p->running, "Leaving a partition during parallel work");
+  me.partition = nullptr;
+  me.topo = me.savedTopo;
+  partitionLock.unlock_shared();
+  p->entry.unlock();
 }
 
 static katana::ThreadPool* TPOOL = nullptr;
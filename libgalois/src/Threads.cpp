@@ -21,6 +21,7 @@
 
 #include <algorithm>
 
+#include "katana/ExecutionContext.h"
 #include "katana/ThreadPool.h"
 namespace katana {
 KATANA_EXPORT unsigned int activeThreads = 1;
@@ -28,6 +29,9 @@ KATANA_EXPORT unsigned int activeThreads = 1;
 
 unsigned int
 katana::setActiveThreads(unsigned int num) noexcept {
+  if (ExecutionContext* ctx = ExecutionContext::Current()) {
+    return ctx->SetActiveThreads(num);
+  }
   num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
   num = std::max(num, 1U);
   katana::activeThreads = num;
@@ -36,5 +40,8 @@ katana::setActiveThreads(unsigned int num) noexcept {
 
 unsigned int
 katana::getActiveThreads() noexcept {
+  if (ExecutionContext* ctx = ExecutionContext::Current()) {
+    return ctx->active_threads();
+  }
   return katana::activeThreads;
 }
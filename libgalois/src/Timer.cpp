@@ -87,6 +87,7 @@ StatTimer::StatTimer(const char* const name, const char* const region) {
   region_ = gstl::makeStr(r);
 
   valid_ = false;
+  timeline_ = false;
 }
 
 StatTimer::~StatTimer() {
@@ -105,12 +106,22 @@ void
 StatTimer::start() {
   TimeAccumulator::start();
   valid_ = true;
+  // Only the timeline needs the start time
+  timeline_ = internal::IsRecordingTimeline();
+  if (timeline_) {
+    begin_ = std::chrono::steady_clock::now();
+  }
 }
 
 void
 StatTimer::stop() {
-  valid_ = false;
   TimeAccumulator::stop();
+  if (valid_ && timeline_) {
+    internal::ReportTimelineEvent(
+        region_.c_str(), name_.c_str(), begin_,
+        std::chrono::steady_clock::now());
+  }
+  valid_ = false;
 }
 
 uint64_t
@@ -33,6 +33,39 @@ katana::analytics::SourcePicker::PickNext() {
   return source;
 }
 
+namespace {
+
+/// IsPowerLawFromHistogram applies the sampling heuristic below to the whole
+/// out-degree histogram of \param stats. Like the samples, it only considers
+/// nodes with edges. The median is interpolated within its bucket.
+bool
+IsPowerLawFromHistogram(const tsuba::GraphStatistics& stats) {
+  const std::vector<uint64_t>& hist = stats.out_degree_histogram;
+  uint64_t num_zero_degree = hist.empty() ? 0 : hist[0];
+  uint64_t num_with_edges = stats.num_nodes - num_zero_degree;
+  if (num_with_edges == 0) {
+    return false;
+  }
+  double average = static_cast<double>(stats.num_edges) / num_with_edges;
+
+  uint64_t median_rank = num_with_edges / 2;
+  uint64_t seen = 0;
+  double median = 0;
+  for (size_t i = 1; i < hist.size(); ++i) {
+    if (seen + hist[i] > median_rank) {
+      double lo = static_cast<double>(uint64_t{1} << (i - 1));
+      double width = lo;
+      median = lo + width * static_cast<double>(median_rank - seen) /
+                        static_cast<double>(hist[i]);
+      break;
+    }
+    seen += hist[i];
+  }
+  return average / 1.3 > median;
+}
+
+}  // namespace
+
 bool
 katana::analytics::IsApproximateDegreeDistributionPowerLaw(
     const PropertyGraph& graph) {
@@ -43,6 +76,11 @@ katana::analytics::IsApproximateDegreeDistributionPowerLaw(
   if (averageDegree < 10) {
     return false;
   }
+  if (const auto& stats = graph.statistics();
+      stats && stats->num_nodes == graph.num_nodes() &&
+      stats->num_edges == graph.num_edges()) {
+    return IsPowerLawFromHistogram(stats.value());
+  }
   katana::StatTimer autoAlgoTimer("IsApproximateDegreeDistributionPowerLaw");
   autoAlgoTimer.start();
   SourcePicker sp(graph);
@@ -19,9 +19,12 @@
 
 #include "katana/analytics/bfs/bfs.h"
 
+#include <climits>
 #include <deque>
 #include <type_traits>
+#include <unordered_set>
 
+#include "katana/DynamicBitset.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
 
@@ -246,6 +249,134 @@ SynchronousAlgo(
   }
 }
 
+/// Direction-optimizing BFS (see BfsPlan::DirectionOptimizing). Top-down steps
+/// push from the frontier along out-edges; bottom-up steps let every unvisited
+/// node look for a parent in the frontier along its in-edges.
+katana::Result<void>
+DirectionOptimizingAlgo(
+    katana::PropertyGraph* pg, Graph* graph, const Graph::Node& source,
+    uint32_t alpha, uint32_t beta) {
+  using Cont = katana::InsertBag<Graph::Node>;
+
+  // In-edges are only needed for bottom-up steps, which high-diameter graphs
+  // may never take, so the in-edge index is constructed on first use.
+  bool have_in_edges = false;
+  const katana::GraphTopology& topology = pg->topology();
+
+  katana::DynamicBitset front_bitset;
+  katana::DynamicBitset next_bitset;
+
+  auto curr = std::make_unique<Cont>();
+  auto next = std::make_unique<Cont>();
+
+  Dist next_level = 0U;
+  graph->GetData<BfsNodeDistance>(source) = 0U;
+  next->push(source);
+
+  const uint64_t num_nodes = graph->num_nodes();
+  int64_t edges_to_check = graph->num_edges();
+  int64_t scout_count = graph->edges(source).size();
+
+  katana::GAccumulator<uint64_t> work_items;
+
+  while (!next->empty()) {
+    std::swap(curr, next);
+    next->clear();
+
+    if (scout_count > edges_to_check / alpha) {
+      if (!have_in_edges) {
+        if (auto res = pg->ConstructInEdges(); !res) {
+          return res.error();
+        }
+        have_in_edges = true;
+        front_bitset.resize(num_nodes);
+        next_bitset.resize(num_nodes);
+      }
+
+      front_bitset.reset();
+      work_items.reset();
+      katana::do_all(
+          katana::iterate(*curr),
+          [&](const Graph::Node& n) {
+            front_bitset.set(n);
+            work_items += 1;
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::loopname("DirectionOptimizing-ToBitset"));
+
+      uint64_t awake_count = work_items.reduce();
+      uint64_t old_awake_count = 0;
+      do {
+        old_awake_count = awake_count;
+        ++next_level;
+        next_bitset.reset();
+        work_items.reset();
+
+        katana::do_all(
+            katana::iterate(*graph),
+            [&](const Graph::Node& dst) {
+              auto& dst_data = graph->GetData<BfsNodeDistance>(dst);
+              if (dst_data != BfsImplementation::kDistanceInfinity) {
+                return;
+              }
+              for (auto e : topology.in_edges(dst)) {
+                if (front_bitset.test(topology.in_edge_source(e))) {
+                  dst_data = next_level;
+                  next_bitset.set(dst);
+                  work_items += 1;
+                  break;
+                }
+              }
+            },
+            katana::steal(), katana::chunk_size<kChunkSize>(),
+            katana::loopname("DirectionOptimizing-Pull"));
+
+        std::swap(front_bitset, next_bitset);
+        awake_count = work_items.reduce();
+      } while (awake_count >= old_awake_count ||
+               awake_count > num_nodes / beta);
+
+      katana::do_all(
+          katana::iterate(*graph),
+          [&](const Graph::Node& n) {
+            if (front_bitset.test(n)) {
+              next->push(n);
+            }
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::loopname("DirectionOptimizing-ToWorklist"));
+      scout_count = 1;
+    } else {
+      ++next_level;
+      edges_to_check -= scout_count;
+      work_items.reset();
+
+      katana::do_all(
+          katana::iterate(*curr),
+          [&](const Graph::Node& src) {
+            for (auto e : graph->edges(src)) {
+              auto dest = graph->GetEdgeDest(e);
+              auto& dest_data = graph->GetData<BfsNodeDistance>(dest);
+
+              if (dest_data == BfsImplementation::kDistanceInfinity &&
+                  __sync_bool_compare_and_swap(
+                      &dest_data, BfsImplementation::kDistanceInfinity,
+                      next_level)) {
+                next->push(*dest);
+                work_items += graph->edges(*dest).size();
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::loopname("DirectionOptimizing-Push"));
+
+      scout_count = work_items.reduce();
+    }
+  }
+
+  return katana::ResultSuccess();
+}
+
 template <bool CONCURRENT>
 void
 RunAlgo(BfsPlan algo, Graph* graph, const Graph::Node& source) {
@@ -274,6 +405,7 @@ RunAlgo(BfsPlan algo, Graph* graph, const Graph::Node& source) {
 
 katana::Result<void>
 BfsImpl(
+    katana::PropertyGraph* pg,
     katana::TypedPropertyGraph<std::tuple<BfsNodeDistance>, std::tuple<>>&
         graph,
     size_t start_node, BfsPlan algo) {
@@ -281,6 +413,12 @@ BfsImpl(
     return katana::ErrorCode::InvalidArgument;
   }
 
+  if (algo.algorithm() == BfsPlan::kDirectionOptimizing &&
+      (algo.alpha() == 0 || algo.beta() == 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha and beta must be positive");
+  }
+
   auto it = graph.begin();
   std::advance(it, start_node);
   Graph::Node source = *it;
@@ -295,13 +433,106 @@ BfsImpl(
   katana::StatTimer execTime("BFS");
   execTime.start();
 
-  RunAlgo<true>(algo, &graph, source);
+  if (algo.algorithm() == BfsPlan::kDirectionOptimizing) {
+    if (auto r = DirectionOptimizingAlgo(
+            pg, &graph, source, algo.alpha(), algo.beta());
+        !r) {
+      return r.error();
+    }
+  } else {
+    RunAlgo<true>(algo, &graph, source);
+  }
 
   execTime.stop();
 
   return katana::ResultSuccess();
 }
 
+/// One bit per source in a batch of a multi-source BFS.
+using SourceMask = uint64_t;
+constexpr size_t kSourcesPerBatch = sizeof(SourceMask) * CHAR_BIT;
+
+/// Multi-source BFS over a batch of at most kSourcesPerBatch sources. Bit i of
+/// a node's masks refers to sources[i], whose levels are written to
+/// distances[i]. Topology is either node id width.
+template <typename Topology>
+void
+MultiSourceBatch(
+    const Topology& topology, const std::vector<uint64_t>& sources,
+    std::vector<katana::PODPropertyView<Dist>>* distances) {
+  KATANA_LOG_DEBUG_ASSERT(sources.size() <= kSourcesPerBatch);
+  KATANA_LOG_DEBUG_ASSERT(sources.size() == distances->size());
+
+  const uint64_t num_nodes = topology.num_nodes();
+
+  katana::LargeArray<SourceMask> seen;
+  katana::LargeArray<SourceMask> visit;
+  katana::LargeArray<SourceMask> visit_next;
+  seen.allocateInterleaved(num_nodes);
+  visit.allocateInterleaved(num_nodes);
+  visit_next.allocateInterleaved(num_nodes);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        seen[n] = 0;
+        visit[n] = 0;
+        visit_next[n] = 0;
+        for (auto& dist : *distances) {
+          dist[n] = BfsImplementation::kDistanceInfinity;
+        }
+      },
+      katana::no_stats());
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    seen[sources[i]] |= SourceMask{1} << i;
+    visit[sources[i]] |= SourceMask{1} << i;
+    (*distances)[i][sources[i]] = 0;
+  }
+
+  katana::GReduceLogicalOr visited_any;
+  Dist level = 0;
+  do {
+    ++level;
+    visited_any.reset();
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t src) {
+          SourceMask src_visit = visit[src];
+          if (!src_visit) {
+            return;
+          }
+          for (auto e : topology.edges(src)) {
+            auto dest = topology.edge_dest(e);
+            SourceMask update = src_visit & ~seen[dest];
+            if (update && (visit_next[dest] & update) != update) {
+              __sync_fetch_and_or(&visit_next[dest], update);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("MultiSource-Push"));
+
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          SourceMask new_visit = visit_next[n] & ~seen[n];
+          visit_next[n] = 0;
+          visit[n] = new_visit;
+          if (!new_visit) {
+            return;
+          }
+          seen[n] |= new_visit;
+          visited_any.update(true);
+          for (SourceMask m = new_visit; m; m &= m - 1) {
+            (*distances)[__builtin_ctzll(m)][n] = level;
+          }
+        },
+        katana::loopname("MultiSource-Update"));
+  } while (visited_any.reduce());
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -319,7 +550,84 @@ katana::analytics::Bfs(
     return pg_result.error();
   }
 
-  return BfsImpl(pg_result.value(), start_node, algo);
+  return BfsImpl(pg, pg_result.value(), start_node, algo);
+}
+
+katana::Result<void>
+katana::analytics::BfsMultiSource(
+    katana::PropertyGraph* pg, const std::vector<uint64_t>& start_nodes,
+    const std::vector<std::string>& output_property_names) {
+  if (start_nodes.size() != output_property_names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} start nodes but {} output properties", start_nodes.size(),
+        output_property_names.size());
+  }
+  std::unordered_set<std::string> unique_names;
+  for (const auto& name : output_property_names) {
+    if (!unique_names.insert(name).second) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "output property {} is given more than once", name);
+    }
+  }
+  for (auto start_node : start_nodes) {
+    if (start_node >= pg->size()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "start node {} does not exist",
+          start_node);
+    }
+  }
+
+  // If any output property cannot be created, remove the ones that were so
+  // that a failed call leaves the graph as it was
+  std::vector<std::string> created;
+  auto remove_created = [&](const katana::ErrorInfo& error) {
+    // Errors while removing would overwrite the thread's error context
+    katana::CopyableErrorInfo saved(error);
+    for (const auto& name : created) {
+      if (auto res = pg->RemoveNodeProperty(name); !res) {
+        KATANA_LOG_WARN("removing output property {}: {}", name, res.error());
+      }
+    }
+    return saved.ToErrorInfo();
+  };
+
+  std::vector<katana::PODPropertyView<Dist>> distances;
+  for (const auto& name : output_property_names) {
+    if (auto result =
+            ConstructNodeProperties<std::tuple<BfsNodeDistance>>(pg, {name});
+        !result) {
+      return remove_created(result.error());
+    }
+    created.emplace_back(name);
+    auto view_result = katana::ConstructPropertyView<BfsNodeDistance>(
+        pg->GetNodeProperty(name)->chunk(0).get());
+    if (!view_result) {
+      return remove_created(view_result.error());
+    }
+    distances.emplace_back(std::move(view_result.value()));
+  }
+
+  katana::StatTimer execTime("BFS-MultiSource");
+  execTime.start();
+
+  for (size_t begin = 0; begin < start_nodes.size();
+       begin += kSourcesPerBatch) {
+    size_t end = std::min(begin + kSourcesPerBatch, start_nodes.size());
+    std::vector<uint64_t> batch_sources(
+        start_nodes.begin() + begin, start_nodes.begin() + end);
+    std::vector<katana::PODPropertyView<Dist>> batch_distances(
+        distances.begin() + begin, distances.begin() + end);
+
+    pg->VisitTopology([&](const auto& topology) {
+      MultiSourceBatch(topology, batch_sources, &batch_distances);
+    });
+  }
+
+  execTime.stop();
+
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -334,8 +334,12 @@ katana::analytics::LocalClusteringCoefficient(
     timer_relabel.stop();
   }
 
+  // Stored statistics can tell us the edges are already sorted
+  bool edges_sorted = plan.edges_sorted() ||
+                      (pg->statistics() && pg->statistics()->edges_sorted);
+
   // If we relabel we must also sort. Relabeling will break the sorting.
-  if (relabel || !plan.edges_sorted()) {
+  if (relabel || !edges_sorted) {
     if (auto r = katana::SortAllEdgesByDest(pg); !r) {
       return r.error();
     }
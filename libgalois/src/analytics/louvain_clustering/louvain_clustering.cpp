@@ -87,6 +87,10 @@ struct LouvainClusteringImplementation
     constant_for_second_term =
         Base::template CalConstantForSecondTerm<EdgeWeightType>(graph);
 
+    // Reused across nodes and rounds to avoid allocating for every node
+    katana::PerThreadStorage<typename Base::NeighborClusters>
+        per_thread_neighbors;
+
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
     while (true) {
@@ -108,21 +112,17 @@ struct LouvainClusteringImplementation
             uint64_t degree =
                 std::distance(graph.edge_begin(n), graph.edge_end(n));
             uint64_t local_target = Base::UNASSIGNED;
-            std::map<uint64_t, uint64_t>
-                cluster_local_map;  // Map each neighbor's cluster to local number:
-                                    // Community --> Index
-            std::vector<EdgeWeightType>
-                counter;  // Number of edges to each unique cluster
             EdgeWeightType self_loop_wt = 0;
 
             if (degree > 0) {
+              // Edge weight to each unique neighboring cluster
+              auto* neighbors = per_thread_neighbors.getLocal();
               Base::template FindNeighboringClusters<EdgeWeightType>(
-                  graph, n, cluster_local_map, counter, self_loop_wt);
+                  graph, n, neighbors, self_loop_wt);
               // Find the max gain in modularity
               local_target = Base::MaxModularityWithoutSwaps(
-                  cluster_local_map, counter, self_loop_wt, c_info,
-                  n_data_degree_wt, n_data_curr_comm_id,
-                  constant_for_second_term);
+                  *neighbors, self_loop_wt, c_info, n_data_degree_wt,
+                  n_data_curr_comm_id, constant_for_second_term);
 
             } else {
               local_target = Base::UNASSIGNED;
@@ -240,6 +240,10 @@ struct LouvainClusteringImplementation
       c_update_subtract[n].size = 0;
     });
 
+    // Reused across nodes and rounds to avoid allocating for every node
+    katana::PerThreadStorage<typename Base::NeighborClusters>
+        per_thread_neighbors;
+
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
 
@@ -260,21 +264,17 @@ struct LouvainClusteringImplementation
               uint64_t degree =
                   std::distance(graph.edge_begin(n), graph.edge_end(n));
 
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map;  // Map each neighbor's cluster to local number:
-                                      // Community --> Index
-              std::vector<EdgeWeightType>
-                  counter;  // Number of edges to each unique cluster
               EdgeWeightType self_loop_wt = 0;
 
               if (degree > 0) {
+                // Edge weight to each unique neighboring cluster
+                auto* neighbors = per_thread_neighbors.getLocal();
                 Base::template FindNeighboringClusters<EdgeWeightType>(
-                    graph, n, cluster_local_map, counter, self_loop_wt);
+                    graph, n, neighbors, self_loop_wt);
                 // Find the max gain in modularity
                 local_target[n] = Base::MaxModularityWithoutSwaps(
-                    cluster_local_map, counter, self_loop_wt, c_info,
-                    n_data_degree_wt, n_data_curr_comm_id,
-                    constant_for_second_term);
+                    *neighbors, self_loop_wt, c_info, n_data_degree_wt,
+                    n_data_curr_comm_id, constant_for_second_term);
 
               } else {
                 local_target[n] = Base::UNASSIGNED;
@@ -0,0 +1,517 @@
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/LargeArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Timer.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/UnionFind.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+template <typename Weight>
+using EdgeWeight = katana::PODProperty<Weight>;
+
+struct EdgeInForest : public katana::PODProperty<uint8_t> {};
+
+using Node = katana::PropertyGraph::Node;
+using Edge = katana::PropertyGraph::Edge;
+
+constexpr Node kNoNode = std::numeric_limits<Node>::max();
+constexpr Edge kNoEdge = std::numeric_limits<Edge>::max();
+
+/// The order in which edges join the forest: by weight, and between equal
+/// weights by the endpoints, so that both directions of an edge compare equal
+/// and every plan picks the same forest.
+template <typename Weight>
+struct EdgeKey {
+  Weight weight;
+  Node lo;
+  Node hi;
+
+  bool operator<(const EdgeKey& o) const {
+    return std::tie(weight, lo, hi) < std::tie(o.weight, o.lo, o.hi);
+  }
+};
+
+template <typename Weight>
+struct KruskalEdge {
+  EdgeKey<Weight> key;
+  Edge edge;
+
+  bool operator<(const KruskalEdge& o) const { return key < o.key; }
+};
+
+struct Component : public katana::UnionFindNode<Component> {
+  /// For a representative during a Boruvka round, the node of the component
+  /// with the lightest edge to another component.
+  std::atomic<Node> lightest{kNoNode};
+
+  Component() : katana::UnionFindNode<Component>(this) {}
+};
+
+template <typename Weight>
+struct MinimumSpanningForestImplementation {
+  using EdgeData = std::tuple<EdgeWeight<Weight>, EdgeInForest>;
+  using Graph = katana::TypedPropertyGraph<std::tuple<>, EdgeData>;
+  using Key = EdgeKey<Weight>;
+
+  Graph* graph_;
+  katana::LargeArray<Component> components_;
+
+  explicit MinimumSpanningForestImplementation(Graph* graph) : graph_(graph) {
+    components_.allocateBlocked(graph_->num_nodes());
+    components_.construct();
+  }
+
+  Key GetKey(Node src, Edge e) const {
+    Node dst = *graph_->GetEdgeDest(e);
+    return Key{
+        graph_->template GetEdgeData<EdgeWeight<Weight>>(e),
+        std::min(src, dst), std::max(src, dst)};
+  }
+
+  /// Adds edge e between src and dst to the forest unless it closes a cycle
+  void Join(Node src, Node dst, Edge e) {
+    if (components_[src].merge(&components_[dst])) {
+      graph_->template GetEdgeData<EdgeInForest>(e) = 1;
+    }
+  }
+
+  void Boruvka() {
+    // lightest_edge[n] is the lightest edge of n to another component in the
+    // current round
+    katana::LargeArray<Edge> lightest_edge;
+    lightest_edge.allocateBlocked(graph_->num_nodes());
+
+    katana::InsertBag<Node> current;
+    katana::InsertBag<Node> next;
+    katana::InsertBag<Node> winners;
+
+    katana::do_all(
+        katana::iterate(*graph_), [&](Node n) { current.push(n); },
+        katana::no_stats());
+
+    while (!current.empty()) {
+      // Every node offers its lightest edge leaving its component to the
+      // representative of the component. A node without such an edge will
+      // never have one again, so it drops out.
+      katana::do_all(
+          katana::iterate(current),
+          [&](Node n) {
+            Component* rep = components_[n].findAndCompress();
+            Edge best = kNoEdge;
+            Key best_key{};
+            for (auto e : graph_->edges(n)) {
+              Node dst = *graph_->GetEdgeDest(e);
+              if (components_[dst].findAndCompress() == rep) {
+                continue;
+              }
+              Key key = GetKey(n, e);
+              if (best == kNoEdge || key < best_key) {
+                best = e;
+                best_key = key;
+              }
+            }
+            lightest_edge[n] = best;
+            if (best == kNoEdge) {
+              return;
+            }
+            next.push(n);
+
+            Node cur = rep->lightest.load(std::memory_order_acquire);
+            while (cur == kNoNode ||
+                   best_key < GetKey(cur, lightest_edge[cur])) {
+              if (rep->lightest.compare_exchange_weak(cur, n)) {
+                break;
+              }
+            }
+          },
+          katana::steal(),
+          katana::loopname("MinimumSpanningForest-Boruvka-Find"));
+
+      katana::do_all(
+          katana::iterate(next),
+          [&](Node n) {
+            Component* rep = components_[n].find();
+            if (rep->lightest.load(std::memory_order_relaxed) == n) {
+              rep->lightest.store(kNoNode, std::memory_order_relaxed);
+              winners.push(n);
+            }
+          },
+          katana::loopname("MinimumSpanningForest-Boruvka-Winners"),
+          katana::no_stats());
+
+      // With ties broken by endpoints, the picked edges only form cycles of
+      // two components that picked the same edge, and merge detects those.
+      katana::do_all(
+          katana::iterate(winners),
+          [&](Node n) {
+            Edge e = lightest_edge[n];
+            Join(n, *graph_->GetEdgeDest(e), e);
+          },
+          katana::loopname("MinimumSpanningForest-Boruvka-Merge"));
+
+      current.clear();
+      current.swap(next);
+      winners.clear();
+    }
+  }
+
+  Key ChoosePivot(KruskalEdge<Weight>* begin, KruskalEdge<Weight>* end) {
+    constexpr size_t kSampleSize = 1024;
+    size_t n = end - begin;
+    size_t stride = std::max<size_t>(n / kSampleSize, 1);
+    std::vector<Key> sample;
+    for (size_t i = 0; i < n; i += stride) {
+      sample.emplace_back(begin[i].key);
+    }
+    auto median = sample.begin() + sample.size() / 2;
+    std::nth_element(sample.begin(), median, sample.end());
+    return *median;
+  }
+
+  void Kruskal(KruskalEdge<Weight>* begin, KruskalEdge<Weight>* end) {
+    katana::ParallelSTL::sort(begin, end);
+    for (auto* it = begin; it != end; ++it) {
+      Join(it->key.lo, it->key.hi, it->edge);
+    }
+  }
+
+  void FilterKruskal(uint64_t kruskal_threshold) {
+    // The graph is symmetric, so only the direction from the lower node id
+    // is needed; self-loops never join the forest. offsets[n] is one past the
+    // last edge kept for nodes [0, n].
+    uint64_t num_nodes = graph_->num_nodes();
+    katana::LargeArray<uint64_t> offsets;
+    offsets.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](Node n) {
+          uint64_t kept = 0;
+          for (auto e : graph_->edges(n)) {
+            if (n < *graph_->GetEdgeDest(e)) {
+              ++kept;
+            }
+          }
+          offsets[n] = kept;
+        },
+        katana::steal(), katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        offsets.begin(), offsets.end(), offsets.begin());
+    uint64_t num_kept = num_nodes > 0 ? offsets[num_nodes - 1] : 0;
+
+    katana::LargeArray<KruskalEdge<Weight>> edges;
+    edges.allocateBlocked(num_kept);
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](Node n) {
+          uint64_t pos = n > 0 ? offsets[n - 1] : 0;
+          for (auto e : graph_->edges(n)) {
+            if (n < *graph_->GetEdgeDest(e)) {
+              edges[pos++] = KruskalEdge<Weight>{GetKey(n, e), e};
+            }
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    FilterKruskal(edges.begin(), edges.end(), kruskal_threshold);
+  }
+
+  void FilterKruskal(
+      KruskalEdge<Weight>* begin, KruskalEdge<Weight>* end,
+      uint64_t kruskal_threshold) {
+    while (static_cast<uint64_t>(end - begin) > kruskal_threshold) {
+      Key pivot = ChoosePivot(begin, end);
+      KruskalEdge<Weight>* mid = katana::ParallelSTL::partition(
+          begin, end, [&](const auto& e) { return !(pivot < e.key); });
+      if (mid == end) {
+        // Too many equal keys to split
+        break;
+      }
+
+      FilterKruskal(begin, mid, kruskal_threshold);
+
+      // Heavier edges whose endpoints are already connected cannot join the
+      // forest
+      end = katana::ParallelSTL::partition(mid, end, [&](const auto& e) {
+        return components_[e.key.lo].find() != components_[e.key.hi].find();
+      });
+      begin = mid;
+    }
+    Kruskal(begin, end);
+  }
+
+  katana::Result<void> operator()(MinimumSpanningForestPlan plan) {
+    katana::do_all(
+        katana::iterate(*graph_),
+        [&](Node n) {
+          for (auto e : graph_->edges(n)) {
+            graph_->template GetEdgeData<EdgeInForest>(e) = 0;
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    katana::StatTimer exec_time("MinimumSpanningForest");
+    exec_time.start();
+
+    switch (plan.algorithm()) {
+    case MinimumSpanningForestPlan::kBoruvka:
+      Boruvka();
+      break;
+    case MinimumSpanningForestPlan::kFilterKruskal:
+      FilterKruskal(plan.kruskal_threshold());
+      break;
+    default:
+      return katana::ErrorCode::InvalidArgument;
+    }
+
+    exec_time.stop();
+
+    return katana::ResultSuccess();
+  }
+};
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestWithWrap(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MinimumSpanningForestPlan plan) {
+  using Impl = MinimumSpanningForestImplementation<Weight>;
+
+  if (auto r = ConstructEdgeProperties<std::tuple<EdgeInForest>>(
+          pg, {output_property_name});
+      !r) {
+    return r.error();
+  }
+
+  auto pg_result = Impl::Graph::Make(
+      pg, {}, {edge_weight_property_name, output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  Impl impl(&graph);
+  return impl(plan);
+}
+
+template <typename Weight>
+katana::Result<void>
+MinimumSpanningForestValidateImpl(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  using Impl = MinimumSpanningForestImplementation<Weight>;
+
+  auto pg_result = Impl::Graph::Make(
+      pg, {}, {edge_weight_property_name, output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  // The weights of all minimum spanning forests are the same, so compare
+  // against sequential Kruskal
+  std::vector<KruskalEdge<Weight>> edges;
+  std::vector<Weight> forest_weights;
+  Impl forest(&graph);
+  for (Node n : graph) {
+    for (auto e : graph.edges(n)) {
+      edges.emplace_back(KruskalEdge<Weight>{forest.GetKey(n, e), e});
+      if (graph.template GetEdgeData<EdgeInForest>(e)) {
+        if (!forest.components_[n].merge(
+                &forest.components_[*graph.GetEdgeDest(e)])) {
+          return KATANA_ERROR(
+              katana::ErrorCode::AssertionFailed,
+              "forest edge {} closes a cycle", e);
+        }
+        forest_weights.emplace_back(
+            graph.template GetEdgeData<EdgeWeight<Weight>>(e));
+      }
+    }
+  }
+
+  std::sort(edges.begin(), edges.end());
+  std::vector<Weight> expected_weights;
+  Impl expected(&graph);
+  for (const auto& e : edges) {
+    if (expected.components_[e.key.lo].merge(
+            &expected.components_[e.key.hi])) {
+      expected_weights.emplace_back(e.key.weight);
+    }
+  }
+
+  if (forest_weights.size() != expected_weights.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "forest has {} edges but a spanning forest has {}",
+        forest_weights.size(), expected_weights.size());
+  }
+  std::sort(forest_weights.begin(), forest_weights.end());
+  if (forest_weights != expected_weights) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "forest is not minimum");
+  }
+
+  return katana::ResultSuccess();
+}
+
+template <typename Weight>
+katana::Result<MinimumSpanningForestStatistics>
+ComputeStatistics(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  using Impl = MinimumSpanningForestImplementation<Weight>;
+
+  auto pg_result = Impl::Graph::Make(
+      pg, {}, {edge_weight_property_name, output_property_name});
+  if (!pg_result) {
+    return pg_result.error();
+  }
+  auto graph = pg_result.value();
+
+  katana::GAccumulator<uint64_t> n_forest_edges;
+  katana::GAccumulator<double> total_weight;
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](Node n) {
+        for (auto e : graph.edges(n)) {
+          if (graph.template GetEdgeData<EdgeInForest>(e)) {
+            n_forest_edges += 1;
+            total_weight += graph.template GetEdgeData<EdgeWeight<Weight>>(e);
+          }
+        }
+      },
+      katana::loopname("Compute Statistics"), katana::no_stats());
+
+  uint64_t edges = n_forest_edges.reduce();
+  return MinimumSpanningForestStatistics{
+      edges, graph.num_nodes() - edges, total_weight.reduce()};
+}
+
+katana::Result<std::shared_ptr<arrow::DataType>>
+GetWeightType(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  auto property = pg->GetEdgeProperty(edge_weight_property_name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "edge property {} not found",
+        edge_weight_property_name);
+  }
+  return property->type();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForest(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name, MinimumSpanningForestPlan plan) {
+  auto type = GetWeightType(pg, edge_weight_property_name);
+  if (!type) {
+    return type.error();
+  }
+  switch (type.value()->id()) {
+  case arrow::UInt32Type::type_id:
+    return MinimumSpanningForestWithWrap<uint32_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return MinimumSpanningForestWithWrap<int32_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return MinimumSpanningForestWithWrap<uint64_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return MinimumSpanningForestWithWrap<int64_t>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::FloatType::type_id:
+    return MinimumSpanningForestWithWrap<float>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return MinimumSpanningForestWithWrap<double>(
+        pg, edge_weight_property_name, output_property_name, plan);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+katana::Result<void>
+katana::analytics::MinimumSpanningForestAssertValid(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  auto type = GetWeightType(pg, edge_weight_property_name);
+  if (!type) {
+    return type.error();
+  }
+  switch (type.value()->id()) {
+  case arrow::UInt32Type::type_id:
+    return MinimumSpanningForestValidateImpl<uint32_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int32Type::type_id:
+    return MinimumSpanningForestValidateImpl<int32_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::UInt64Type::type_id:
+    return MinimumSpanningForestValidateImpl<uint64_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int64Type::type_id:
+    return MinimumSpanningForestValidateImpl<int64_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::FloatType::type_id:
+    return MinimumSpanningForestValidateImpl<float>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::DoubleType::type_id:
+    return MinimumSpanningForestValidateImpl<double>(
+        pg, edge_weight_property_name, output_property_name);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+katana::Result<MinimumSpanningForestStatistics>
+MinimumSpanningForestStatistics::Compute(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  auto type = GetWeightType(pg, edge_weight_property_name);
+  if (!type) {
+    return type.error();
+  }
+  switch (type.value()->id()) {
+  case arrow::UInt32Type::type_id:
+    return ComputeStatistics<uint32_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int32Type::type_id:
+    return ComputeStatistics<int32_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::UInt64Type::type_id:
+    return ComputeStatistics<uint64_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::Int64Type::type_id:
+    return ComputeStatistics<int64_t>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::FloatType::type_id:
+    return ComputeStatistics<float>(
+        pg, edge_weight_property_name, output_property_name);
+  case arrow::DoubleType::type_id:
+    return ComputeStatistics<double>(
+        pg, edge_weight_property_name, output_property_name);
+  default:
+    return katana::ErrorCode::TypeError;
+  }
+}
+
+void
+MinimumSpanningForestStatistics::Print(std::ostream& os) const {
+  os << "Number of forest edges = " << n_forest_edges << std::endl;
+  os << "Number of trees = " << n_trees << std::endl;
+  os << "Total weight = " << total_weight << std::endl;
+}
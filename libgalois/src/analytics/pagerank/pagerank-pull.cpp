@@ -73,6 +73,20 @@ ComputeOutDeg(Graph* graph) {
   katana::StatTimer out_degree_timer("computeOutDegFunc");
   out_degree_timer.start();
 
+  // The (transposed) input's in-degrees are the original graph's out-degrees;
+  // read them off the in-edge index when there is one.
+  const katana::GraphTopology& topology = graph->GetPropertyGraph().topology();
+  if (topology.has_in_edges()) {
+    katana::do_all(
+        katana::iterate(*graph),
+        [&](const GNode& src) {
+          graph->GetData<NodeNout>(src) = topology.in_edges(src).size();
+        },
+        katana::no_stats(), katana::loopname("CopyDeg"));
+    out_degree_timer.stop();
+    return;
+  }
+
   katana::LargeArray<std::atomic<size_t>> vec;
   vec.allocateInterleaved(graph->size());
 
@@ -19,6 +19,9 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <arrow/compute/api.h>
+
+#include "katana/ArrowInterchange.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -27,6 +30,329 @@ const int RandomWalksPlan::kChunkSize = 1;
 
 namespace {
 
+/// AliasTable holds Walker alias tables for the out-edges of every node,
+/// aligned with the edges: for the edge at offset i in the edge range of node
+/// n, the sampler keeps offset i with probability prob[e] and otherwise takes
+/// offset alias[e].
+struct AliasTable {
+  std::shared_ptr<arrow::DoubleArray> prob;
+  std::shared_ptr<arrow::UInt32Array> alias;
+};
+
+std::string
+AliasProbPropertyName(const std::string& edge_weight_property_name) {
+  return edge_weight_property_name + "_alias_prob";
+}
+
+std::string
+AliasIndexPropertyName(const std::string& edge_weight_property_name) {
+  return edge_weight_property_name + "_alias_index";
+}
+
+template <typename T>
+katana::Result<std::shared_ptr<arrow::Buffer>>
+AllocateValues(uint64_t count) {
+  auto res = arrow::AllocateBuffer(count * sizeof(T));
+  if (!res.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(res.status()), "allocating {} values: {}", count,
+        res.status());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(res.ValueOrDie()));
+}
+
+/// Get the edge property \param name as one contiguous array of \param type
+katana::Result<std::shared_ptr<arrow::Array>>
+GetContiguousEdgeProperty(
+    const katana::PropertyGraph* pg, const std::string& name,
+    const std::shared_ptr<arrow::DataType>& type) {
+  auto property = pg->GetEdgeProperty(name);
+  if (!property) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "edge property {} not found",
+        name);
+  }
+  if (!property->type()->Equals(type)) {
+    auto cast_result = arrow::compute::Cast(property, type);
+    if (!cast_result.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(cast_result.status()),
+          "casting edge property {} to {}: {}", name, type->ToString(),
+          cast_result.status());
+    }
+    property = cast_result.ValueOrDie().chunked_array();
+  }
+  if (property->null_count() != 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "edge property {} has nulls",
+        name);
+  }
+  return katana::Unchunk(property);
+}
+
+/// Build the alias tables of all nodes in parallel with Vose's method. Nodes
+/// without positive total weight sample their edges uniformly.
+katana::Result<AliasTable>
+BuildAliasTable(
+    const katana::GraphTopology& topology, const arrow::DoubleArray& weights) {
+  uint64_t num_edges = topology.num_edges();
+  auto prob_result = AllocateValues<double>(num_edges);
+  if (!prob_result) {
+    return prob_result.error();
+  }
+  auto alias_result = AllocateValues<uint32_t>(num_edges);
+  if (!alias_result) {
+    return alias_result.error();
+  }
+  auto* prob = reinterpret_cast<double*>(prob_result.value()->mutable_data());
+  auto* alias =
+      reinterpret_cast<uint32_t*>(alias_result.value()->mutable_data());
+  const double* weight = weights.raw_values();
+
+  katana::GReduceLogicalOr invalid_weight;
+  // Worklists of small and large offsets; reused across nodes
+  katana::PerThreadStorage<std::vector<uint32_t>> per_thread_worklist;
+
+  katana::do_all(
+      katana::iterate(topology),
+      [&](uint32_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        uint64_t degree = end - begin;
+        double total = 0;
+        for (uint64_t e = begin; e < end; ++e) {
+          if (!(weight[e] >= 0)) {
+            invalid_weight.update(true);
+            return;
+          }
+          total += weight[e];
+        }
+        if (!(total > 0)) {
+          std::fill(prob + begin, prob + end, 1.0);
+          std::iota(alias + begin, alias + end, uint32_t{0});
+          return;
+        }
+
+        // Small offsets grow from the front and large ones from the back
+        std::vector<uint32_t>& worklist = *per_thread_worklist.getLocal();
+        worklist.resize(degree);
+        uint64_t num_small = 0;
+        uint64_t large_begin = degree;
+        for (uint64_t i = 0; i < degree; ++i) {
+          prob[begin + i] = weight[begin + i] * degree / total;
+          if (prob[begin + i] < 1.0) {
+            worklist[num_small++] = i;
+          } else {
+            worklist[--large_begin] = i;
+          }
+        }
+        while (num_small > 0 && large_begin < degree) {
+          uint32_t small = worklist[--num_small];
+          uint32_t large = worklist[large_begin];
+          alias[begin + small] = large;
+          prob[begin + large] -= 1.0 - prob[begin + small];
+          if (prob[begin + large] < 1.0) {
+            ++large_begin;
+            worklist[num_small++] = large;
+          }
+        }
+        // Whatever is left is full up to rounding error
+        for (uint64_t i = large_begin; i < degree; ++i) {
+          prob[begin + worklist[i]] = 1.0;
+          alias[begin + worklist[i]] = worklist[i];
+        }
+        for (uint64_t i = 0; i < num_small; ++i) {
+          prob[begin + worklist[i]] = 1.0;
+          alias[begin + worklist[i]] = worklist[i];
+        }
+      },
+      katana::steal(), katana::loopname("BuildAliasTable"),
+      katana::no_stats());
+
+  if (invalid_weight.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge weights must be non-negative numbers");
+  }
+
+  return AliasTable{
+      std::make_shared<arrow::DoubleArray>(
+          static_cast<int64_t>(num_edges), prob_result.value()),
+      std::make_shared<arrow::UInt32Array>(
+          static_cast<int64_t>(num_edges), alias_result.value())};
+}
+
+/// Load the alias tables persisted by RandomWalksBuildAliasTable
+katana::Result<AliasTable>
+LoadAliasTable(
+    const katana::PropertyGraph* pg,
+    const std::string& edge_weight_property_name) {
+  auto prob_result = GetContiguousEdgeProperty(
+      pg, AliasProbPropertyName(edge_weight_property_name), arrow::float64());
+  if (!prob_result) {
+    return prob_result.error();
+  }
+  auto alias_result = GetContiguousEdgeProperty(
+      pg, AliasIndexPropertyName(edge_weight_property_name), arrow::uint32());
+  if (!alias_result) {
+    return alias_result.error();
+  }
+  return AliasTable{
+      std::static_pointer_cast<arrow::DoubleArray>(prob_result.value()),
+      std::static_pointer_cast<arrow::UInt32Array>(alias_result.value())};
+}
+
+/// Get alias tables for \param edge_weight_property_name, using the persisted
+/// ones if there are any
+katana::Result<AliasTable>
+PrepareAliasTable(
+    const katana::PropertyGraph* pg,
+    const std::string& edge_weight_property_name) {
+  if (edge_weight_property_name.empty()) {
+    return AliasTable{};
+  }
+  if (pg->HasEdgeProperty(AliasProbPropertyName(edge_weight_property_name)) &&
+      pg->HasEdgeProperty(AliasIndexPropertyName(edge_weight_property_name))) {
+    return LoadAliasTable(pg, edge_weight_property_name);
+  }
+  auto weights_result = GetContiguousEdgeProperty(
+      pg, edge_weight_property_name, arrow::float64());
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  return BuildAliasTable(
+      pg->topology(),
+      *std::static_pointer_cast<arrow::DoubleArray>(weights_result.value()));
+}
+
+/// Copy the destinations of \param topology, sorted within the edge range of
+/// each node, so that neighbor lookups can search them without reordering the
+/// edges of the graph
+katana::Result<std::shared_ptr<arrow::Buffer>>
+BuildSortedDests(const katana::GraphTopology& topology) {
+  auto dests_result = AllocateValues<uint32_t>(topology.num_edges());
+  if (!dests_result) {
+    return dests_result.error();
+  }
+  auto* sorted_dests =
+      reinterpret_cast<uint32_t*>(dests_result.value()->mutable_data());
+  const uint32_t* dests = topology.out_dests->raw_values();
+
+  katana::do_all(
+      katana::iterate(topology),
+      [&](uint32_t n) {
+        auto [begin, end] = topology.edge_range(n);
+        std::copy(dests + begin, dests + end, sorted_dests + begin);
+        std::sort(sorted_dests + begin, sorted_dests + end);
+      },
+      katana::steal(), katana::loopname("BuildSortedDests"),
+      katana::no_stats());
+
+  return dests_result;
+}
+
+/// NeighborSampler draws out-edges of a node uniformly or, given alias
+/// tables, proportionally to their weight. It works directly on the topology
+/// arrays so that the walk kernels do not allocate or build views.
+class NeighborSampler {
+public:
+  NeighborSampler(
+      const katana::GraphTopology& topology, const uint32_t* sorted_dests,
+      const AliasTable& alias_table)
+      : out_indices_(topology.out_indices->raw_values()),
+        out_dests_(topology.out_dests->raw_values()),
+        sorted_dests_(sorted_dests),
+        prob_(alias_table.prob ? alias_table.prob->raw_values() : nullptr),
+        alias_(alias_table.alias ? alias_table.alias->raw_values() : nullptr) {}
+
+  uint64_t edge_begin(uint32_t n) const {
+    return n > 0 ? out_indices_[n - 1] : 0;
+  }
+
+  uint64_t degree(uint32_t n) const { return out_indices_[n] - edge_begin(n); }
+
+  uint32_t dest(uint64_t e) const { return out_dests_[e]; }
+
+  /// Sample an out-edge of \param n, which must have one, given \param u
+  /// drawn uniformly from [0, 1)
+  uint64_t Sample(uint32_t n, double u) const {
+    uint64_t begin = edge_begin(n);
+    uint64_t degree = out_indices_[n] - begin;
+    double scaled = u * degree;
+    uint64_t offset =
+        std::min(static_cast<uint64_t>(scaled), degree - uint64_t{1});
+    if (prob_ != nullptr && scaled - offset >= prob_[begin + offset]) {
+      offset = alias_[begin + offset];
+    }
+    return begin + offset;
+  }
+
+  /// \returns true if \param dst is an out-neighbor of \param src
+  bool IsNeighbor(uint32_t src, uint32_t dst) const {
+    const uint32_t* end = sorted_dests_ + out_indices_[src];
+    const uint32_t* found =
+        std::lower_bound(sorted_dests_ + edge_begin(src), end, dst);
+    return found != end && *found == dst;
+  }
+
+private:
+  const uint64_t* out_indices_;
+  const uint32_t* out_dests_;
+  const uint32_t* sorted_dests_;
+  const double* prob_;
+  const uint32_t* alias_;
+};
+
+/// WalkBuffer holds walks in one flat array: walk i is the first length(i)
+/// entries of walk(i), which has room for width nodes. Walks of length 0 were
+/// not generated.
+class WalkBuffer {
+public:
+  static katana::Result<WalkBuffer> Make(uint64_t num_walks, uint32_t width) {
+    auto nodes_result = AllocateValues<uint32_t>(num_walks * width);
+    if (!nodes_result) {
+      return nodes_result.error();
+    }
+    auto lengths_result = AllocateValues<uint32_t>(num_walks);
+    if (!lengths_result) {
+      return lengths_result.error();
+    }
+    return WalkBuffer(
+        num_walks, width, std::move(nodes_result.value()),
+        std::move(lengths_result.value()));
+  }
+
+  uint64_t num_walks() const { return num_walks_; }
+  uint32_t width() const { return width_; }
+
+  uint32_t* walk(uint64_t i) {
+    return reinterpret_cast<uint32_t*>(nodes_->mutable_data()) + i * width_;
+  }
+  const uint32_t* walk(uint64_t i) const {
+    return reinterpret_cast<const uint32_t*>(nodes_->data()) + i * width_;
+  }
+
+  uint32_t& length(uint64_t i) {
+    return reinterpret_cast<uint32_t*>(lengths_->mutable_data())[i];
+  }
+  uint32_t length(uint64_t i) const {
+    return reinterpret_cast<const uint32_t*>(lengths_->data())[i];
+  }
+
+private:
+  WalkBuffer(
+      uint64_t num_walks, uint32_t width, std::shared_ptr<arrow::Buffer> nodes,
+      std::shared_ptr<arrow::Buffer> lengths)
+      : num_walks_(num_walks),
+        width_(width),
+        nodes_(std::move(nodes)),
+        lengths_(std::move(lengths)) {}
+
+  uint64_t num_walks_;
+  uint32_t width_;
+  std::shared_ptr<arrow::Buffer> nodes_;
+  std::shared_ptr<arrow::Buffer> lengths_;
+};
+
 struct Node2VecAlgo {
   using NodeData = std::tuple<>;
   using EdgeData = std::tuple<>;
@@ -37,30 +363,10 @@ struct Node2VecAlgo {
   const RandomWalksPlan& plan_;
   Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
 
-  GNode FindSampleNeighbor(
-      const Graph& graph, const GNode& n,
-      const katana::LargeArray<uint64_t>& degree, double prob) {
-    if (degree[n] == 0) {
-      return graph.num_nodes();
-    }
-    double total_wt = degree[n];
-
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto edge = graph.edge_begin(n) + edge_index;
-    return *graph.GetEdgeDest(edge);
-  }
-
   void GraphRandomWalk(
-      const Graph& graph, katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::LargeArray<uint64_t>& degree) {
+      const Graph& graph, const NeighborSampler& sampler, WalkBuffer* walks) {
     katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
 
     double prob_forward = 1.0 / plan_.forward_probability();
     double prob_backward = 1.0 / plan_.backward_probability();
@@ -75,97 +381,81 @@ struct Node2VecAlgo {
     lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
     lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
 
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
-
     katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
+        katana::iterate(uint64_t(0), walks->num_walks()),
         [&](uint64_t idx) {
           GNode n = idx % graph.size();
+          uint32_t* walk = walks->walk(idx);
+          uint32_t& length = walks->length(idx);
 
           //check if n has no neighbor
-          if (degree[n] == 0) {
+          if (sampler.degree(n) == 0) {
+            length = 0;
             return;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
-
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
-
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+          std::mt19937& rng = *generator.getLocal();
 
-          //Assumption: All edges have weight 1
-          Graph::Node nbr = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr < graph.num_nodes());
+          walk[0] = n;
+          walk[1] = sampler.dest(sampler.Sample(n, dist(rng)));
+          length = 2;
 
-          walk.push_back(std::move(nbr));
-
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[current_walk - 1];
-            uint32_t prev = walk[current_walk - 2];
+          for (; length < walks->width(); length++) {
+            uint32_t curr = walk[length - 1];
+            uint32_t prev = walk[length - 2];
 
             //check if n has no neighbor
-            if (degree[curr] == 0) {
+            if (sampler.degree(curr) == 0) {
               break;
             }
             //acceptance-rejection sampling
             while (true) {
               //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              Graph::Node nbr = FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr < graph.num_nodes());
+              GNode nbr = sampler.dest(sampler.Sample(curr, dist(rng)));
 
               //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
+              double y = dist(rng) * upper_bound;
 
               if (y <= lower_bound) {
                 //accept this sample
-                walk.push_back(std::move(nbr));
+                walk[length] = nbr;
                 break;
+              }
+
+              //compute transition probability
+              double alpha;
+
+              //check if nbr is same as the previous node on this walk
+              if (nbr == prev) {
+                alpha = prob_backward;
+              }  //check if nbr is also a neighbor of the previous node on this walk
+              else if (sampler.IsNeighbor(prev, nbr)) {
+                alpha = 1.0;
               } else {
-                //compute transition probability
-                double alpha;
-
-                //check if nbr is same as the previous node on this walk
-                if (nbr == prev) {
-                  alpha = prob_backward;
-                }  //check if nbr is also a neighbor of the previous node on this walk
-                else if (
-                    katana::FindEdgeSortedByDest(graph, prev, nbr) !=
-                    graph.edge_end(prev)) {
-                  alpha = 1.0;
-                } else {
-                  alpha = prob_forward;
-                }
-
-                if (y <= alpha) {
-                  //accept y
-                  walk.push_back(std::move(nbr));
-                  break;
-                }
+                alpha = prob_forward;
+              }
+
+              if (y <= alpha) {
+                //accept y
+                walk[length] = nbr;
+                break;
               }
             }
           }
-
-          walks->push(std::move(walk));
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Node2vec walks"), katana::no_stats());
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
-    }
   }
 
-  void operator()(
-      const Graph& graph, katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::LargeArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+  katana::Result<WalkBuffer> operator()(
+      const Graph& graph, const NeighborSampler& sampler) {
+    auto walks_result = WalkBuffer::Make(
+        graph.size() * plan_.number_of_walks(), plan_.walk_length() + 1);
+    if (!walks_result) {
+      return walks_result.error();
+    }
+    GraphRandomWalk(graph, sampler, &walks_result.value());
+    return walks_result;
   }
 };
 
@@ -194,33 +484,18 @@ struct Edge2VecAlgo {
     }
   }
 
-  std::pair<GNode, EdgeType::ViewType::value_type> FindSampleNeighbor(
-      const Graph& graph, const GNode& n,
-      const katana::LargeArray<uint64_t>& degree, double prob) {
-    if (degree[n] == 0) {
-      return std::make_pair(graph.num_nodes(), 1);
-    }
-    double total_wt = degree[n];
-    prob = prob * total_wt;
-
-    uint32_t edge_index = std::floor(prob);
-    auto edge = graph.edge_begin(n) + edge_index;
-    return std::make_pair(
-        *graph.GetEdgeDest(edge), graph.GetEdgeData<EdgeType>(edge));
+  EdgeType::ViewType::value_type GetEdgeType(const Graph& graph, uint64_t e) {
+    return graph.GetEdgeData<EdgeType>(Graph::edge_iterator(e));
   }
 
+  /// Generate walks \param begin to \param end of \param walks, recording
+  /// the type of the edge taken at each step in \param types, which has
+  /// walks->width() - 1 entries per walk
   void GraphRandomWalk(
-      const Graph& graph, katana::InsertBag<std::vector<uint32_t>>* walks,
-      katana::InsertBag<std::vector<uint32_t>>* types_walks,
-      const katana::LargeArray<uint64_t>& degree) {
+      const Graph& graph, const NeighborSampler& sampler, uint64_t begin,
+      uint64_t end, WalkBuffer* walks, katana::LargeArray<uint32_t>* types) {
     katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
 
     double prob_forward = 1.0 / plan_.forward_probability();
     double prob_backward = 1.0 / plan_.backward_probability();
@@ -230,62 +505,50 @@ struct Edge2VecAlgo {
     upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
     upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
 
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+    uint32_t types_width = walks->width() - 1;
 
     katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
+        katana::iterate(begin, end),
         [&](uint64_t idx) {
           GNode n = idx % graph.size();
+          uint32_t* walk = walks->walk(idx);
+          uint32_t* types_vec = &(*types)[(idx - begin) * types_width];
+          uint32_t& length = walks->length(idx);
+
+          // Incomplete walks are dropped
+          length = 0;
 
           //check if n has no neighbor
-          if (degree[n] == 0) {
+          if (sampler.degree(n) == 0) {
             return;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
-
-          std::vector<uint32_t> walk;
-          std::vector<uint32_t> types_vec;
-
-          walk.push_back(n);
+          std::mt19937& rng = *generator.getLocal();
 
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+          walk[0] = n;
+          uint64_t edge = sampler.Sample(n, dist(rng));
+          walk[1] = sampler.dest(edge);
+          types_vec[0] = GetEdgeType(graph, edge);
 
-          //Assumption: All edges have weight 1
-          auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
-
-          walk.push_back(std::move(nbr_pair.first));
-          types_vec.push_back(nbr_pair.second);
-
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[walk.size() - 1];
+          for (uint32_t current = 2; current < walks->width(); current++) {
+            uint32_t curr = walk[current - 1];
             //check if n has no neighbor
-            if (degree[curr] == 0) {
+            if (sampler.degree(curr) == 0) {
               return;
             }
-            uint32_t prev = walk[walk.size() - 2];
+            uint32_t prev = walk[current - 2];
 
-            uint32_t p1 = types_vec.back();  //last element of types_vec
+            uint32_t p1 = types_vec[current - 2];  //type of the last step
 
             //acceptance-rejection sampling
             while (true) {
               //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr_type_pair =
-                  FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
-
-              Graph::Node nbr = nbr_type_pair.first;
-              EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
+              uint64_t nbr_edge = sampler.Sample(curr, dist(rng));
+              GNode nbr = sampler.dest(nbr_edge);
+              EdgeType::ViewType::value_type p2 = GetEdgeType(graph, nbr_edge);
 
               //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
+              double y = dist(rng) * upper_bound;
 
               //compute transition probability
               double alpha;
@@ -294,9 +557,7 @@ struct Edge2VecAlgo {
               if (nbr == prev) {
                 alpha = prob_backward;
               }  //check if nbr is also a neighbor of the previous node on this walk
-              else if (
-                  katana::FindEdgeSortedByDest(graph, prev, nbr) !=
-                  graph.edge_end(prev)) {
+              else if (sampler.IsNeighbor(prev, nbr)) {
                 alpha = 1.0;
               } else {
                 alpha = prob_forward;
@@ -305,16 +566,15 @@ struct Edge2VecAlgo {
               alpha = alpha * transition_matrix_[p1][p2];
               if (alpha >= y) {
                 //accept y
-                walk.push_back(std::move(nbr));
-                types_vec.push_back(p2);
+                walk[current] = nbr;
+                types_vec[current - 1] = p2;
                 break;
               }
             }  //end while
 
           }  //end for
 
-          (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
+          length = walks->width();
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Edge2vec walks"), katana::no_stats());
@@ -322,24 +582,27 @@ struct Edge2VecAlgo {
 
   //compute the histogram of edge types for each walk
   std::vector<std::vector<uint32_t>> ComputeNumEdgeTypeVectors(
-      const katana::InsertBag<std::vector<uint32_t>>& types_walks) {
+      const WalkBuffer& walks, uint64_t begin, uint64_t end,
+      const katana::LargeArray<uint32_t>& types) {
     std::vector<std::vector<uint32_t>> num_edge_types_walks;
+    uint32_t types_width = walks.width() - 1;
 
     katana::PerThreadStorage<std::vector<std::vector<uint32_t>>>
         per_thread_num_edge_types_walks;
-    katana::do_all(
-        katana::iterate(types_walks),
-        [&](const std::vector<uint32_t>& types_walk) {
-          std::vector<uint32_t> num_edge_types(
-              plan_.number_of_edge_types() + 1, 0);
+    katana::do_all(katana::iterate(begin, end), [&](uint64_t idx) {
+      if (walks.length(idx) == 0) {
+        return;
+      }
+      std::vector<uint32_t> num_edge_types(plan_.number_of_edge_types() + 1, 0);
 
-          for (auto type : types_walk) {
-            num_edge_types[type]++;
-          }
+      const uint32_t* types_walk = &types[(idx - begin) * types_width];
+      for (uint32_t i = 0; i < types_width; i++) {
+        num_edge_types[types_walk[i]]++;
+      }
 
-          per_thread_num_edge_types_walks.getLocal()->emplace_back(
-              std::move(num_edge_types));
-        });
+      per_thread_num_edge_types_walks.getLocal()->emplace_back(
+          std::move(num_edge_types));
+    });
 
     for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
       for (auto num_edge_types :
@@ -436,22 +699,34 @@ struct Edge2VecAlgo {
         });
   }
 
-  void operator()(
-      const Graph& graph, katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::LargeArray<uint64_t>& degree) {
+  katana::Result<WalkBuffer> operator()(
+      const Graph& graph, const NeighborSampler& sampler) {
     uint32_t iterations = plan_.max_iterations();
+    uint64_t walks_per_iteration = graph.size() * plan_.number_of_walks();
+
+    // Every iteration keeps its walks
+    auto walks_result = WalkBuffer::Make(
+        walks_per_iteration * iterations, plan_.walk_length() + 1);
+    if (!walks_result) {
+      return walks_result.error();
+    }
+    WalkBuffer& walks = walks_result.value();
+
+    katana::LargeArray<uint32_t> types;
+    types.allocateBlocked(walks_per_iteration * plan_.walk_length());
 
     Initialize();
 
     for (uint32_t iter = 0; iter < iterations; iter++) {
-      //E step; generate walks
-      katana::InsertBag<std::vector<uint32_t>> types_walks;
+      uint64_t begin = iter * walks_per_iteration;
+      uint64_t end = begin + walks_per_iteration;
 
-      GraphRandomWalk(graph, walks, &types_walks, degree);
+      //E step; generate walks
+      GraphRandomWalk(graph, sampler, begin, end, &walks, &types);
 
       //Update transition matrix
       std::vector<std::vector<uint32_t>> num_edge_types_walks =
-          ComputeNumEdgeTypeVectors(types_walks);
+          ComputeNumEdgeTypeVectors(walks, begin, end, types);
 
       std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks =
           TransformVectors(num_edge_types_walks);
@@ -461,26 +736,25 @@ struct Edge2VecAlgo {
 
       ComputeTransitionMatrix(transformed_num_edge_types_walks, means);
     }
+
+    return walks_result;
   }
 };
 
-template <typename Graph>
-void
-InitializeDegrees(const Graph& graph, katana::LargeArray<uint64_t>* degree) {
-  katana::do_all(katana::iterate(graph), [&](typename Graph::Node n) {
-    // Treat this as O(1) time because subtracting iterators is just pointer
-    // or number subtraction. So don't use steal().
-    (*degree)[n] = graph.edges(n).size();
-  });
-}
-
 }  //namespace
 
 template <typename Algorithm>
-static katana::Result<std::vector<std::vector<uint32_t>>>
-RandomWalksWithWrap(katana::PropertyGraph* pg, RandomWalksPlan plan) {
-  if (auto res = katana::SortAllEdgesByDest(pg); !res) {
-    return res.error();
+static katana::Result<WalkBuffer>
+RandomWalksWithWrap(
+    katana::PropertyGraph* pg, RandomWalksPlan plan,
+    const std::string& edge_weight_property_name) {
+  auto alias_table_result = PrepareAliasTable(pg, edge_weight_property_name);
+  if (!alias_table_result) {
+    return alias_table_result.error();
+  }
+  auto sorted_dests_result = BuildSortedDests(pg->topology());
+  if (!sorted_dests_result) {
+    return sorted_dests_result.error();
   }
 
   // TODO(amp): This is incorrect. For Node2vec this needs to be:
@@ -497,40 +771,156 @@ RandomWalksWithWrap(katana::PropertyGraph* pg, RandomWalksPlan plan) {
   auto graph = pg_result.value();
 
   Algorithm algo(plan);
-
-  katana::LargeArray<uint64_t> degree;
-  degree.allocateBlocked(graph.size());
-  InitializeDegrees<typename Algorithm::Graph>(graph, &degree);
+  NeighborSampler sampler(
+      pg->topology(),
+      reinterpret_cast<const uint32_t*>(sorted_dests_result.value()->data()),
+      alias_table_result.value());
 
   katana::StatTimer execTime("RandomWalks");
   execTime.start();
-  katana::InsertBag<std::vector<uint32_t>> walks;
-  algo(graph, &walks, degree);
-  execTime.stop();
-
+  auto walks_result = algo(graph, sampler);
   execTime.stop();
 
-  degree.destroy();
-  degree.deallocate();
-
-  std::vector<std::vector<uint32_t>> walks_in_vector;
-  walks_in_vector.reserve(plan.number_of_walks());
-  std::move(walks.begin(), walks.end(), std::back_inserter(walks_in_vector));
-  return walks_in_vector;
+  return walks_result;
 }
 
-katana::Result<std::vector<std::vector<uint32_t>>>
-katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+static katana::Result<WalkBuffer>
+RandomWalksImpl(
+    katana::PropertyGraph* pg, RandomWalksPlan plan,
+    const std::string& edge_weight_property_name) {
+  // Walks hold walk_length + 1 nodes and the kernels always take a first step
+  if (plan.walk_length() < 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "walk length must be at least 1");
+  }
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec:
-    return RandomWalksWithWrap<Node2VecAlgo>(pg, plan);
+    return RandomWalksWithWrap<Node2VecAlgo>(
+        pg, plan, edge_weight_property_name);
   case RandomWalksPlan::kEdge2Vec:
-    return RandomWalksWithWrap<Edge2VecAlgo>(pg, plan);
+    return RandomWalksWithWrap<Edge2VecAlgo>(
+        pg, plan, edge_weight_property_name);
   default:
-    return ErrorCode::InvalidArgument;
+    return katana::ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<std::vector<std::vector<uint32_t>>>
+katana::analytics::RandomWalks(
+    PropertyGraph* pg, RandomWalksPlan plan,
+    const std::string& edge_weight_property_name) {
+  auto walks_result = RandomWalksImpl(pg, plan, edge_weight_property_name);
+  if (!walks_result) {
+    return walks_result.error();
+  }
+  const WalkBuffer& walks = walks_result.value();
+
+  std::vector<std::vector<uint32_t>> walks_in_vector;
+  walks_in_vector.reserve(walks.num_walks());
+  for (uint64_t i = 0; i < walks.num_walks(); ++i) {
+    if (walks.length(i) > 0) {
+      walks_in_vector.emplace_back(
+          walks.walk(i), walks.walk(i) + walks.length(i));
+    }
+  }
+  return walks_in_vector;
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+katana::analytics::RandomWalksTable(
+    PropertyGraph* pg, RandomWalksPlan plan,
+    const std::string& edge_weight_property_name) {
+  auto walks_result = RandomWalksImpl(pg, plan, edge_weight_property_name);
+  if (!walks_result) {
+    return walks_result.error();
+  }
+  const WalkBuffer& walks = walks_result.value();
+  uint32_t width = walks.width();
+
+  // Compact the generated walks: row[i] is one past the output row of walk i
+  katana::LargeArray<uint64_t> row;
+  row.allocateBlocked(walks.num_walks());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, walks.num_walks()),
+      [&](uint64_t i) { row[i] = walks.length(i) > 0 ? 1 : 0; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(row.begin(), row.end(), row.begin());
+  uint64_t num_rows = walks.num_walks() > 0 ? row[walks.num_walks() - 1] : 0;
+
+  auto nodes_result = AllocateValues<uint32_t>(num_rows * width);
+  if (!nodes_result) {
+    return nodes_result.error();
+  }
+  auto lengths_result = AllocateValues<uint32_t>(num_rows);
+  if (!lengths_result) {
+    return lengths_result.error();
+  }
+  auto* nodes =
+      reinterpret_cast<uint32_t*>(nodes_result.value()->mutable_data());
+  auto* lengths =
+      reinterpret_cast<uint32_t*>(lengths_result.value()->mutable_data());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, walks.num_walks()),
+      [&](uint64_t i) {
+        uint32_t length = walks.length(i);
+        if (length == 0) {
+          return;
+        }
+        uint32_t* out = nodes + (row[i] - 1) * width;
+        std::copy(walks.walk(i), walks.walk(i) + length, out);
+        std::fill(out + length, out + width, uint32_t{0});
+        lengths[row[i] - 1] = length;
+      },
+      katana::no_stats());
+
+  auto values = std::make_shared<arrow::UInt32Array>(
+      static_cast<int64_t>(num_rows * width), nodes_result.value());
+  auto walk_array_result = arrow::FixedSizeListArray::FromArrays(
+      values, static_cast<int32_t>(width));
+  if (!walk_array_result.ok()) {
+    return KATANA_ERROR(
+        katana::ArrowToKatana(walk_array_result.status()),
+        "building walk array: {}", walk_array_result.status());
+  }
+  auto length_array = std::make_shared<arrow::UInt32Array>(
+      static_cast<int64_t>(num_rows), lengths_result.value());
+
+  auto schema = arrow::schema({
+      arrow::field(
+          "walk", arrow::fixed_size_list(arrow::uint32(), width), false),
+      arrow::field("length", arrow::uint32(), false),
+  });
+  return arrow::Table::Make(
+      schema, {walk_array_result.ValueOrDie(), length_array});
+}
+
+katana::Result<void>
+katana::analytics::RandomWalksBuildAliasTable(
+    PropertyGraph* pg, const std::string& edge_weight_property_name) {
+  auto weights_result = GetContiguousEdgeProperty(
+      pg, edge_weight_property_name, arrow::float64());
+  if (!weights_result) {
+    return weights_result.error();
+  }
+  auto alias_table_result = BuildAliasTable(
+      pg->topology(),
+      *std::static_pointer_cast<arrow::DoubleArray>(weights_result.value()));
+  if (!alias_table_result) {
+    return alias_table_result.error();
+  }
+  AliasTable alias_table = std::move(alias_table_result.value());
+
+  auto schema = arrow::schema({
+      arrow::field(
+          AliasProbPropertyName(edge_weight_property_name), arrow::float64()),
+      arrow::field(
+          AliasIndexPropertyName(edge_weight_property_name), arrow::uint32()),
+  });
+  return pg->UpsertEdgeProperties(
+      arrow::Table::Make(schema, {alias_table.prob, alias_table.alias}));
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::RandomWalksAssertValid([
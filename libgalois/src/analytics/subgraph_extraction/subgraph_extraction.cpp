@@ -54,8 +54,10 @@ SubGraphNodeSet(
         auto last = graph->edges(src).end();
         for (uint32_t m = 0; m < num_nodes; ++m) {
           auto dest = node_set[m];
-          // Binary search on the edges sorted by destination id
-          auto edge_id = katana::FindEdgeSortedByDest(graph, src, dest);
+          // Binary search on the edges sorted by destination id. Sorting
+          // already rejected graphs with wide node ids.
+          auto edge_id =
+              katana::FindEdgeSortedByDest(graph, src, dest).value();
           while (edge_id != *last && *graph->GetEdgeDest(edge_id) == dest) {
             subgraph_edges[n].push_back(m);
             edge_id++;
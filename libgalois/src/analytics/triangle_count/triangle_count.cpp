@@ -300,8 +300,12 @@ katana::analytics::TriangleCount(
     return katana::ErrorCode::AssertionFailed;
   }
 
+  // Stored statistics can tell us the edges are already sorted
+  bool edges_sorted = plan.edges_sorted() ||
+                      (pg->statistics() && pg->statistics()->edges_sorted);
+
   std::unique_ptr<katana::PropertyGraph> mutable_pfg;
-  if (relabel || !plan.edges_sorted()) {
+  if (relabel || !edges_sorted) {
     // Copy the graph so we don't mutate the users graph.
     auto mutable_pfg_result = pg->Copy({}, {});
     if (!mutable_pfg_result) {
@@ -321,7 +325,7 @@ katana::analytics::TriangleCount(
   }
 
   // If we relabel we must also sort. Relabeling will break the sorting.
-  if (relabel || !plan.edges_sorted()) {
+  if (relabel || !edges_sorted) {
     if (auto r = katana::SortAllEdgesByDest(pg); !r) {
       return r.error();
     }
@@ -0,0 +1,69 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <atomic>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+// Every iteration of a stealing do_all runs exactly once, even when a few
+// iterations take much longer than the rest
+template <unsigned ChunkSize, typename Range>
+void
+CheckVisitedOnce(const Range& range, size_t size) {
+  std::vector<std::atomic<int>> visits(size);
+  auto body = [&](size_t i) {
+    if (i % 1000 == 0) {
+      volatile size_t spin = 0;
+      for (size_t j = 0; j < 100000; ++j) {
+        spin = spin + j;
+      }
+    }
+    visits[i].fetch_add(1, std::memory_order_relaxed);
+  };
+  katana::do_all(
+      range, body, katana::steal(), katana::chunk_size<ChunkSize>());
+  for (size_t i = 0; i < size; ++i) {
+    KATANA_LOG_ASSERT(visits[i].load() == 1);
+  }
+}
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+  katana::setActiveThreads(4);
+
+  constexpr size_t kSize = 100000;
+
+  // Random access ranges
+  CheckVisitedOnce<1>(katana::iterate(size_t{0}, kSize), kSize);
+  CheckVisitedOnce<64>(katana::iterate(size_t{0}, kSize), kSize);
+  CheckVisitedOnce<1>(katana::iterate(size_t{0}, size_t{3}), 3);
+
+  // Forward ranges
+  katana::InsertBag<size_t> bag;
+  katana::do_all(katana::iterate(size_t{0}, kSize), [&](size_t i) {
+    bag.push(i);
+  });
+  CheckVisitedOnce<1>(katana::iterate(bag), kSize);
+
+  return 0;
+}
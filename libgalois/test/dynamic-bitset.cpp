@@ -0,0 +1,174 @@
+#include <random>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+using Reference = std::vector<bool>;
+
+Reference
+MakeRandom(size_t n, std::mt19937* gen, double density) {
+  std::bernoulli_distribution dist(density);
+  Reference ref(n);
+  for (size_t i = 0; i < n; ++i) {
+    ref[i] = dist(*gen);
+  }
+  return ref;
+}
+
+void
+Assign(const Reference& ref, katana::DynamicBitset* bitset) {
+  bitset->resize(ref.size());
+  bitset->reset();
+  for (size_t i = 0; i < ref.size(); ++i) {
+    if (ref[i]) {
+      bitset->set(i);
+    }
+  }
+}
+
+size_t
+Count(const Reference& ref) {
+  size_t count = 0;
+  for (bool b : ref) {
+    count += b;
+  }
+  return count;
+}
+
+void
+AssertEqual(const katana::DynamicBitset& bitset, const Reference& ref) {
+  KATANA_LOG_ASSERT(bitset.size() == ref.size());
+  for (size_t i = 0; i < ref.size(); ++i) {
+    KATANA_LOG_VASSERT(bitset.test(i) == ref[i], "bit {} differs", i);
+  }
+  KATANA_LOG_ASSERT(bitset.count() == Count(ref));
+
+  std::vector<uint64_t> offsets = bitset.GetOffsets<uint64_t>();
+  KATANA_LOG_ASSERT(offsets.size() == Count(ref));
+  size_t next = 0;
+  for (size_t i = 0; i < ref.size(); ++i) {
+    if (ref[i]) {
+      KATANA_LOG_ASSERT(offsets[next++] == i);
+    }
+  }
+}
+
+template <typename BitsetOp, typename RefOp>
+void
+CheckBinaryOp(
+    const Reference& a, const Reference& b, const BitsetOp& bitset_op,
+    const RefOp& ref_op) {
+  katana::DynamicBitset x;
+  katana::DynamicBitset y;
+  Assign(a, &x);
+  Assign(b, &y);
+  bitset_op(&x, y);
+
+  Reference expected(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    expected[i] = ref_op(a[i], b[i]);
+  }
+  AssertEqual(x, expected);
+}
+
+void
+TestSize(size_t n, std::mt19937* gen) {
+  Reference a = MakeRandom(n, gen, 0.3);
+  Reference b = MakeRandom(n, gen, 0.6);
+
+  CheckBinaryOp(
+      a, b, [](auto* x, const auto& y) { x->bitwise_or(y); },
+      [](bool l, bool r) { return l || r; });
+  CheckBinaryOp(
+      a, b, [](auto* x, const auto& y) { x->bitwise_and(y); },
+      [](bool l, bool r) { return l && r; });
+  CheckBinaryOp(
+      a, b, [](auto* x, const auto& y) { x->bitwise_xor(y); },
+      [](bool l, bool r) { return l != r; });
+  CheckBinaryOp(
+      a, b, [](auto* x, const auto& y) { x->bitwise_andnot(y); },
+      [](bool l, bool r) { return l && !r; });
+  CheckBinaryOp(
+      a, b, [](auto* x, const auto&) { x->bitwise_not(); },
+      [](bool l, bool) { return !l; });
+
+  katana::DynamicBitset x;
+  katana::DynamicBitset y;
+  Assign(a, &x);
+  Assign(b, &y);
+
+  Reference both(n);
+  Reference either(n);
+  for (size_t i = 0; i < n; ++i) {
+    both[i] = a[i] && b[i];
+    either[i] = a[i] || b[i];
+  }
+  KATANA_LOG_ASSERT(x.and_count(y) == Count(both));
+
+  x.or_and_clear(&y);
+  AssertEqual(x, either);
+  AssertEqual(y, Reference(n));
+}
+
+void
+TestNonatomic() {
+  constexpr size_t kSize = 10000;
+  katana::DynamicBitset bitset;
+  bitset.resize(kSize);
+
+  // each thread owns whole words, so no two threads write the same word
+  katana::on_each([&](unsigned tid, unsigned nthreads) {
+    for (size_t word = tid; word * 64 < kSize; word += nthreads) {
+      for (size_t i = word * 64; i < std::min(kSize, word * 64 + 64); ++i) {
+        if (i % 3 == 0) {
+          KATANA_LOG_ASSERT(!bitset.set_nonatomic(i));
+          KATANA_LOG_ASSERT(bitset.set_nonatomic(i));
+        }
+      }
+    }
+  });
+
+  Reference ref(kSize);
+  for (size_t i = 0; i < kSize; i += 3) {
+    ref[i] = true;
+  }
+  AssertEqual(bitset, ref);
+
+  KATANA_LOG_ASSERT(bitset.reset_nonatomic(0));
+  KATANA_LOG_ASSERT(!bitset.reset_nonatomic(0));
+  KATANA_LOG_ASSERT(!bitset.test(0));
+}
+
+void
+TestShrink() {
+  katana::DynamicBitset bitset;
+  bitset.resize(100);
+  bitset.set(90);
+  bitset.resize(80);
+  KATANA_LOG_ASSERT(bitset.count() == 0);
+  KATANA_LOG_ASSERT(bitset.GetOffsets<uint32_t>().empty());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  std::mt19937 gen(0);
+  // sizes around word boundaries and large enough to run in parallel
+  for (size_t n : {size_t{1}, size_t{63}, size_t{64}, size_t{65}, size_t{1000},
+                   (size_t{1} << 20) + 37}) {
+    TestSize(n, &gen);
+  }
+
+  TestNonatomic();
+  TestShrink();
+
+  return 0;
+}
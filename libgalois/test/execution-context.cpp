@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "katana/ExecutionContext.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+// Runs a few kinds of loops in the scope of ctx and checks that they only
+// see the threads of ctx
+void
+RunJob(katana::ExecutionContext* ctx, unsigned rounds) {
+  katana::ExecutionContext::Scope scope(*ctx);
+  KATANA_LOG_ASSERT(katana::ExecutionContext::Current() == ctx);
+
+  unsigned num = ctx->num_threads();
+  KATANA_LOG_ASSERT(katana::setActiveThreads(1000) == num);
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == num);
+  KATANA_LOG_ASSERT(katana::GetThreadPool().getMaxThreads() == num);
+
+  constexpr size_t kSize = 10000;
+  for (unsigned r = 0; r < rounds; ++r) {
+    std::atomic<bool> bad_tid{false};
+    katana::GAccumulator<size_t> sum;
+    katana::do_all(
+        katana::iterate(size_t{0}, kSize),
+        [&](size_t i) {
+          if (katana::ThreadPool::getTID() >= num ||
+              katana::ExecutionContext::Current() != ctx) {
+            bad_tid = true;
+          }
+          sum += i;
+        },
+        katana::steal());
+    KATANA_LOG_ASSERT(!bad_tid);
+    KATANA_LOG_ASSERT(sum.reduce() == kSize * (kSize - 1) / 2);
+
+    katana::GAccumulator<size_t> visited;
+    katana::for_each(
+        katana::iterate({kSize}), [&](size_t i, auto& wl_ctx) {
+          if (i > 0) {
+            wl_ctx.push(i - 1);
+          }
+          visited += 1;
+        });
+    KATANA_LOG_ASSERT(visited.reduce() == kSize + 1);
+
+    katana::PerThreadStorage<unsigned> seen;
+    katana::on_each([&](unsigned tid, unsigned total) {
+      KATANA_LOG_ASSERT(total == num);
+      KATANA_LOG_ASSERT(tid == katana::ThreadPool::getTID());
+      *seen.getLocal() = tid + 1;
+    });
+    for (unsigned t = 0; t < num; ++t) {
+      KATANA_LOG_ASSERT(*seen.getRemote(t) == t + 1);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+  auto& tp = katana::GetThreadPool();
+
+  // Thread 0 of the pool is never part of a context
+  unsigned available = tp.getMaxThreads() - 1;
+  if (available < 2) {
+    std::cout << "skipping: not enough threads for two contexts\n";
+    return 0;
+  }
+
+  KATANA_LOG_ASSERT(!katana::ExecutionContext::Make(0));
+  KATANA_LOG_ASSERT(!katana::ExecutionContext::Make(available + 1));
+
+  auto a_res = katana::ExecutionContext::Make(available / 2);
+  KATANA_LOG_ASSERT(a_res);
+  auto b_res = katana::ExecutionContext::Make(available - available / 2);
+  KATANA_LOG_ASSERT(b_res);
+  std::unique_ptr<katana::ExecutionContext> a = std::move(a_res.value());
+  std::unique_ptr<katana::ExecutionContext> b = std::move(b_res.value());
+
+  std::vector<unsigned> all = a->pool_threads();
+  all.insert(all.end(), b->pool_threads().begin(), b->pool_threads().end());
+  std::sort(all.begin(), all.end());
+  KATANA_LOG_ASSERT(std::adjacent_find(all.begin(), all.end()) == all.end());
+  KATANA_LOG_ASSERT(all.front() != 0);
+  KATANA_LOG_ASSERT(!katana::ExecutionContext::Make(1));
+
+  // Jobs in different contexts run at the same time
+  std::thread ta(RunJob, a.get(), 20);
+  std::thread tb(RunJob, b.get(), 20);
+  ta.join();
+  tb.join();
+
+  // Per-thread storage made outside of a context is shared with contexts
+  katana::GAccumulator<size_t> outside;
+  {
+    katana::ExecutionContext::Scope scope(*a);
+    katana::do_all(katana::iterate(size_t{0}, size_t{100}), [&](size_t) {
+      outside += 1;
+    });
+  }
+  KATANA_LOG_ASSERT(katana::ExecutionContext::Current() == nullptr);
+  KATANA_LOG_ASSERT(outside.reduce() == 100);
+
+  a.reset();
+  b.reset();
+
+  // Loops outside of contexts use the whole pool again
+  katana::setActiveThreads(tp.getMaxThreads());
+  katana::PerThreadStorage<unsigned> seen;
+  katana::on_each([&](unsigned tid, unsigned) { *seen.getLocal() = 1; });
+  for (unsigned t = 0; t < tp.getMaxThreads(); ++t) {
+    KATANA_LOG_ASSERT(*seen.getRemote(t) == 1);
+  }
+
+  auto numa_res = katana::ExecutionContext::MakeForNumaNode(0);
+  KATANA_LOG_ASSERT(numa_res);
+  KATANA_LOG_ASSERT(!katana::ExecutionContext::MakeForNumaNode(~0U));
+  RunJob(numa_res.value().get(), 1);
+
+  return 0;
+}
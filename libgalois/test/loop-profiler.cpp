@@ -0,0 +1,124 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/LoopProfiler.h"
+#include "katana/Uri.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* kTimeStats[] = {"BusyTime", "StealTime", "IdleTime"};
+
+void
+RunLoops() {
+  katana::GAccumulator<uint64_t> sum;
+
+  katana::SetLoopProfiling(true);
+  katana::do_all(
+      katana::iterate(0, 100000), [&](int i) { sum += i; }, katana::steal(),
+      katana::loopname("ProfiledDoAll"));
+  katana::for_each(
+      katana::iterate({1000}),
+      [&](int i, auto& ctx) {
+        if (i > 0) {
+          ctx.push(i - 1);
+        }
+        sum += 1;
+      },
+      katana::loopname("ProfiledForEach"));
+  katana::on_each(
+      [&](unsigned, unsigned) { sum += 1; },
+      katana::loopname("ProfiledOnEach"));
+
+  katana::SetLoopProfiling(false);
+  katana::do_all(
+      katana::iterate(0, 1000), [&](int i) { sum += i; },
+      katana::loopname("Unprofiled"));
+
+  KATANA_LOG_ASSERT(sum.reduce() > 0);
+}
+
+const nlohmann::json*
+FindRegion(const nlohmann::json& regions, const std::string& name) {
+  for (const auto& r : regions) {
+    if (r["name"] == name) {
+      return &r;
+    }
+  }
+  return nullptr;
+}
+
+std::string
+PrintToFile(const std::string& path) {
+  katana::SetStatFile(path);
+  katana::SetStatFormat(katana::StatFormat::kJSON);
+  katana::PrintStats();
+
+  std::ifstream in(path);
+  return std::string(
+      std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void
+CheckStats(const std::string& path, bool have_counters) {
+  nlohmann::json stats = nlohmann::json::parse(PrintToFile(path));
+  const nlohmann::json& regions = stats["regions"];
+
+  for (const char* loop :
+       {"ProfiledDoAll", "ProfiledForEach", "ProfiledOnEach"}) {
+    const nlohmann::json* region = FindRegion(regions, loop);
+    KATANA_LOG_VASSERT(region, "no statistics for {}", loop);
+    const nlohmann::json& loop_stats = region->at("stats");
+    for (const char* name : kTimeStats) {
+      KATANA_LOG_VASSERT(loop_stats.contains(name), "{} has no {}", loop, name);
+      KATANA_LOG_ASSERT(loop_stats[name]["total_type"] == "TSUM");
+      KATANA_LOG_ASSERT(!loop_stats[name]["values"].empty());
+    }
+    // Without perf_event_open there are no counters, but the times are
+    // still reported
+    if (!have_counters) {
+      for (size_t i = 0; i < katana::internal::kNumHWCounters; ++i) {
+        KATANA_LOG_ASSERT(
+            !loop_stats.contains(katana::internal::HWCounterName(i)));
+      }
+    }
+  }
+
+  const nlohmann::json* unprofiled = FindRegion(regions, "Unprofiled");
+  if (unprofiled && unprofiled->contains("stats")) {
+    for (const char* name : kTimeStats) {
+      KATANA_LOG_ASSERT(!unprofiled->at("stats").contains(name));
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/loop-profiler");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string path(uri_res.value().path());
+
+  katana::internal::HWCounterValues counters;
+  bool have_counters = katana::internal::ReadHWCounters(&counters);
+
+  RunLoops();
+  CheckStats(path, have_counters);
+
+  katana::SetStatFormat(katana::StatFormat::kText);
+  katana::SetStatFile("");
+  fs::remove(path);
+
+  return 0;
+}
@@ -19,7 +19,15 @@
 
 #include "katana/Mem.h"
 
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <vector>
+
 #include "katana/Galois.h"
+#include "katana/PageAlloc.h"
 #include "katana/gIO.h"
 
 using namespace katana;
@@ -33,6 +41,10 @@ struct element {
 
 int
 main() {
+  // Several regions of 2 MB pages fit in the test below; one region of a
+  // 1 GB page would not be unmapped
+  KATANA_LOG_ASSERT(setenv("KATANA_USE_1GB_PAGES", "0", 1) == 0);
+
   katana::SharedMemSys Katana_runtime;
   unsigned baseAllocSize = SystemHeap::AllocSize;
 
@@ -70,5 +82,41 @@ main() {
     KATANA_LOG_ASSERT(allocated);
   }
 
+  // Concurrently allocated pages are distinct and zeroed, including ones
+  // that were freed and handed out again
+  std::vector<char*> pages(16);
+  for (unsigned round = 0; round < 2; ++round) {
+    katana::do_all(katana::iterate(size_t{0}, pages.size()), [&](size_t i) {
+      pages[i] = static_cast<char*>(katana::allocPages(1, round == 0));
+      KATANA_LOG_ASSERT(pages[i]);
+      KATANA_LOG_ASSERT(pages[i][0] == 0);
+      KATANA_LOG_ASSERT(pages[i][katana::allocSize() - 1] == 0);
+      pages[i][0] = 1;
+      pages[i][katana::allocSize() - 1] = 1;
+    });
+    std::vector<char*> sorted(pages);
+    std::sort(sorted.begin(), sorted.end());
+    KATANA_LOG_ASSERT(
+        std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+    katana::do_all(katana::iterate(size_t{0}, pages.size()), [&](size_t i) {
+      katana::freePages(pages[i], 1);
+    });
+  }
+
+  // Enough pages from one thread for several arena regions. Once they are
+  // all freed, the regions that are not being filled are unmapped.
+  std::vector<char*> many(256);
+  for (char*& page : many) {
+    page = static_cast<char*>(katana::allocPages(1, false));
+    KATANA_LOG_ASSERT(page);
+  }
+  for (char* page : many) {
+    katana::freePages(page, 1);
+  }
+  bool unmapped = std::any_of(many.begin(), many.end(), [](char* page) {
+    return msync(page, katana::allocSize(), MS_ASYNC) != 0 && errno == ENOMEM;
+  });
+  KATANA_LOG_ASSERT(unmapped);
+
   return 0;
 }
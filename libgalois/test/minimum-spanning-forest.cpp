@@ -0,0 +1,211 @@
+#include <arrow/api.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <tuple>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/minimum_spanning_forest/minimum_spanning_forest.h"
+
+namespace {
+
+using katana::analytics::MinimumSpanningForest;
+using katana::analytics::MinimumSpanningForestAssertValid;
+using katana::analytics::MinimumSpanningForestPlan;
+using katana::analytics::MinimumSpanningForestStatistics;
+
+/// Source, destination and weight
+template <typename W>
+using WeightedEdge = std::tuple<uint32_t, uint32_t, W>;
+
+/// MakeSymmetricGraph makes a graph with both directions of each of \param
+/// edges and their weights in the edge property "weight"
+template <typename W>
+std::unique_ptr<katana::PropertyGraph>
+MakeSymmetricGraph(
+    size_t num_nodes, const std::vector<WeightedEdge<W>>& edges) {
+  std::vector<std::vector<std::pair<uint32_t, W>>> adjacency(num_nodes);
+  for (const auto& [src, dest, weight] : edges) {
+    adjacency[src].emplace_back(dest, weight);
+    adjacency[dest].emplace_back(src, weight);
+  }
+
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  std::vector<W> weights;
+  for (const auto& neighbors : adjacency) {
+    for (const auto& [dest, weight] : neighbors) {
+      dests.push_back(dest);
+      weights.push_back(weight);
+    }
+    indices.push_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("weight", arrow::CTypeTraits<W>::type_singleton())}),
+      {katana::BuildArray(weights)});
+  if (auto r = g->AddEdgeProperties(table); !r) {
+    KATANA_LOG_FATAL("could not add edge weights: {}", r.error());
+  }
+
+  return g;
+}
+
+/// ReferenceWeight is the total weight of a minimum spanning forest of
+/// \param edges computed by sequential Kruskal
+template <typename W>
+double
+ReferenceWeight(
+    size_t num_nodes, std::vector<WeightedEdge<W>> edges,
+    uint64_t* num_forest_edges) {
+  std::sort(edges.begin(), edges.end(), [](const auto& a, const auto& b) {
+    return std::get<2>(a) < std::get<2>(b);
+  });
+  std::vector<uint32_t> parent(num_nodes);
+  std::iota(parent.begin(), parent.end(), uint32_t{0});
+  auto find = [&](uint32_t n) {
+    while (parent[n] != n) {
+      n = parent[n] = parent[parent[n]];
+    }
+    return n;
+  };
+
+  double total = 0;
+  *num_forest_edges = 0;
+  for (const auto& [src, dest, weight] : edges) {
+    uint32_t a = find(src);
+    uint32_t b = find(dest);
+    if (a != b) {
+      parent[a] = b;
+      total += weight;
+      ++*num_forest_edges;
+    }
+  }
+  return total;
+}
+
+const std::vector<MinimumSpanningForestPlan> kPlans = {
+    MinimumSpanningForestPlan::Boruvka(),
+    // A small threshold so that filter-Kruskal partitions and filters
+    MinimumSpanningForestPlan::FilterKruskal(4),
+    MinimumSpanningForestPlan::FilterKruskal(),
+};
+
+template <typename W>
+void
+CheckForest(
+    katana::PropertyGraph* g, const std::string& output_name,
+    uint64_t expected_forest_edges, uint64_t expected_trees,
+    double expected_weight) {
+  auto valid_result =
+      MinimumSpanningForestAssertValid(g, "weight", output_name);
+  KATANA_LOG_VASSERT(valid_result, "invalid forest: {}", valid_result.error());
+
+  auto stats_result =
+      MinimumSpanningForestStatistics::Compute(g, "weight", output_name);
+  KATANA_LOG_VASSERT(
+      stats_result, "could not compute statistics: {}", stats_result.error());
+  auto stats = stats_result.value();
+  KATANA_LOG_VASSERT(
+      stats.n_forest_edges == expected_forest_edges, "{} != {}",
+      stats.n_forest_edges, expected_forest_edges);
+  KATANA_LOG_VASSERT(
+      stats.n_trees == expected_trees, "{} != {}", stats.n_trees,
+      expected_trees);
+  KATANA_LOG_VASSERT(
+      std::abs(stats.total_weight - expected_weight) <=
+          1e-9 * std::max(1.0, std::abs(expected_weight)),
+      "{} != {}", stats.total_weight, expected_weight);
+}
+
+void
+TestSmall() {
+  // A triangle with a tail and a separate edge, plus an isolated node (7)
+  std::vector<WeightedEdge<int64_t>> edges{
+      {0, 1, 1}, {1, 2, 2}, {0, 2, 3}, {2, 3, -4},
+      {3, 4, 5}, {2, 4, 5}, {5, 6, 0},
+  };
+  auto g = MakeSymmetricGraph<int64_t>(8, edges);
+
+  for (size_t i = 0; i < kPlans.size(); ++i) {
+    std::string output_name = "forest-" + std::to_string(i);
+    auto r = MinimumSpanningForest(g.get(), "weight", output_name, kPlans[i]);
+    KATANA_LOG_VASSERT(r, "could not compute forest: {}", r.error());
+    CheckForest<int64_t>(g.get(), output_name, 5, 3, 1 + 2 - 4 + 5 + 0);
+  }
+}
+
+template <typename W>
+void
+TestRandom(size_t num_nodes, size_t num_edges, W max_weight) {
+  std::mt19937 gen(num_nodes);
+  std::uniform_int_distribution<uint32_t> node_dist(0, num_nodes - 1);
+  std::vector<WeightedEdge<W>> edges;
+  for (size_t i = 0; i < num_edges; ++i) {
+    W weight;
+    if constexpr (std::is_floating_point_v<W>) {
+      weight = std::uniform_real_distribution<W>(0, max_weight)(gen);
+    } else {
+      // Few distinct weights, so there are many ties
+      weight = std::uniform_int_distribution<W>(0, max_weight)(gen);
+    }
+    edges.emplace_back(node_dist(gen), node_dist(gen), weight);
+  }
+  auto g = MakeSymmetricGraph<W>(num_nodes, edges);
+
+  uint64_t expected_forest_edges = 0;
+  double expected_weight =
+      ReferenceWeight(num_nodes, edges, &expected_forest_edges);
+
+  for (size_t i = 0; i < kPlans.size(); ++i) {
+    std::string output_name = "forest-" + std::to_string(i);
+    auto r = MinimumSpanningForest(g.get(), "weight", output_name, kPlans[i]);
+    KATANA_LOG_VASSERT(r, "could not compute forest: {}", r.error());
+    CheckForest<W>(
+        g.get(), output_name, expected_forest_edges,
+        num_nodes - expected_forest_edges, expected_weight);
+  }
+}
+
+void
+TestErrors() {
+  std::vector<WeightedEdge<int64_t>> edges{{0, 1, 1}};
+  auto g = MakeSymmetricGraph<int64_t>(2, edges);
+
+  auto missing = MinimumSpanningForest(g.get(), "no-such-weight", "forest");
+  KATANA_LOG_ASSERT(!missing);
+  KATANA_LOG_ASSERT(missing.error() == katana::ErrorCode::PropertyNotFound);
+
+  KATANA_LOG_ASSERT(MinimumSpanningForest(g.get(), "weight", "forest"));
+  // The output property must not already exist
+  KATANA_LOG_ASSERT(!MinimumSpanningForest(g.get(), "weight", "forest"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestSmall();
+  TestRandom<int32_t>(1000, 5000, 10);
+  TestRandom<uint64_t>(5000, 20000, 1000000);
+  TestRandom<double>(5000, 4000, 50.0);
+  TestErrors();
+
+  return 0;
+}
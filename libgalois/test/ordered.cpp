@@ -0,0 +1,102 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr size_t kNumCells = 16;
+constexpr uint32_t kNumTasks = 1000;
+
+struct Cell : public katana::Lockable {
+  uint32_t last{0};
+  uint32_t count{0};
+  bool out_of_order{false};
+};
+
+struct Task {
+  uint32_t priority;
+  uint32_t cell;
+};
+
+struct TaskLess {
+  bool operator()(const Task& a, const Task& b) const {
+    return a.priority < b.priority;
+  }
+};
+
+/// Each task touches one cell. Tasks on the same cell conflict and must run in
+/// priority order. If with_push is true, some tasks create a later task on the
+/// next cell, which makes the loop an unstable source algorithm: a new task
+/// can come before a task that is already pending on that cell.
+template <typename RunLoop>
+void
+TestOrdered(bool with_push, RunLoop run_loop) {
+  std::vector<Cell> cells(kNumCells);
+  std::vector<Task> tasks;
+  for (uint32_t i = 0; i < kNumTasks; ++i) {
+    // Initial tasks in reverse to check that the executor orders them
+    uint32_t p = kNumTasks - i;
+    tasks.emplace_back(Task{p, p % kNumCells});
+  }
+  std::atomic<uint32_t> initial_done{0};
+
+  auto nh_func = [&](const Task& t) {
+    katana::acquire(&cells[t.cell], katana::MethodFlag::WRITE);
+  };
+
+  auto op_func = [&](const Task& t, katana::UserContext<Task>& ctx) {
+    Cell& cell = cells[t.cell];
+    if (t.priority < cell.last) {
+      cell.out_of_order = true;
+    }
+    cell.last = t.priority;
+    cell.count += 1;
+    if (t.priority <= kNumTasks) {
+      initial_done += 1;
+      if (with_push && t.priority % 3 == 0) {
+        ctx.push(Task{t.priority + kNumTasks, (t.cell + 1) % kNumCells});
+      }
+    }
+  };
+
+  // Only initial tasks create new tasks, so once they are all done no earlier
+  // task can appear.
+  auto stability_test = [&](const Task& t) {
+    return t.priority <= kNumTasks || initial_done == kNumTasks;
+  };
+
+  run_loop(tasks, nh_func, op_func, stability_test);
+
+  uint32_t total = 0;
+  for (const Cell& cell : cells) {
+    KATANA_LOG_ASSERT(!cell.out_of_order);
+    total += cell.count;
+  }
+  uint32_t expected = kNumTasks + (with_push ? kNumTasks / 3 : 0);
+  KATANA_LOG_VASSERT(total == expected, "{} != {}", total, expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+  katana::setActiveThreads(4);
+
+  TestOrdered(false, [](auto& tasks, auto& nh_func, auto& op_func, auto&) {
+    katana::for_each_ordered(
+        tasks.begin(), tasks.end(), TaskLess(), nh_func, op_func,
+        "ordered-stable");
+  });
+
+  TestOrdered(
+      true, [](auto& tasks, auto& nh_func, auto& op_func, auto& stability_test) {
+        katana::for_each_ordered(
+            tasks.begin(), tasks.end(), TaskLess(), nh_func, op_func,
+            stability_test, "ordered-unstable");
+      });
+
+  return 0;
+}
@@ -1,11 +1,22 @@
+#include <sys/mman.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
+#include "katana/Galois.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/TypedPropertyGraph.h"
 #include "katana/Uri.h"
+#include "tsuba/CSRTopology.h"
 
 namespace {
 
@@ -242,6 +253,486 @@ TestTopologyAccess() {
   }
   KATANA_LOG_ASSERT(n_nodes == 10);
 }
+
+void
+TestLazyLoad() {
+  constexpr size_t test_length = 10;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  for (const std::string& name : {"n0", "n1", "n2"}) {
+    KATANA_LOG_ASSERT(
+        g->AddNodeProperties(MakeProps<int32_t>(name, test_length)));
+  }
+  for (const std::string& name : {"e0", "e1"}) {
+    KATANA_LOG_ASSERT(
+        g->AddEdgeProperties(MakeProps<int64_t>(name, test_length)));
+  }
+  g->MarkAllPropertiesPersistent();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  std::vector<std::string> node_props{"n1"};
+  tsuba::RDGLoadOptions opts;
+  opts.node_properties = &node_props;
+  opts.lazy_load_properties = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  KATANA_LOG_ASSERT(make_result);
+  std::unique_ptr<katana::PropertyGraph> lazy = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(lazy->GetNodePropertyNum() == 1);
+  KATANA_LOG_ASSERT(lazy->GetEdgePropertyNum() == 0);
+  KATANA_LOG_ASSERT(lazy->GetUnloadedNodePropertyNames().size() == 2);
+  KATANA_LOG_ASSERT(lazy->GetUnloadedEdgePropertyNames().size() == 2);
+  KATANA_LOG_ASSERT(lazy->HasNodeProperty("n2"));
+  KATANA_LOG_ASSERT(!lazy->HasNodeProperty("n3"));
+  KATANA_LOG_ASSERT(lazy->GetNodeProperty("n3") == nullptr);
+  auto missing = lazy->LoadNodeProperty("n3");
+  KATANA_LOG_ASSERT(!missing);
+  KATANA_LOG_ASSERT(missing.error() == katana::ErrorCode::PropertyNotFound);
+
+  // First access loads the property
+  auto e1 = lazy->GetEdgeProperty("e1");
+  KATANA_LOG_ASSERT(e1 && e1->Equals(g->GetEdgeProperty("e1")));
+  KATANA_LOG_ASSERT(lazy->GetEdgePropertyNum() == 1);
+
+  KATANA_LOG_ASSERT(lazy->EnsureNodePropertyLoaded("n2"));
+  KATANA_LOG_ASSERT(lazy->GetNodePropertyNum() == 2);
+  KATANA_LOG_ASSERT(
+      lazy->GetNodeProperty("n2")->Equals(g->GetNodeProperty("n2")));
+
+  KATANA_LOG_ASSERT(lazy->UnloadNodeProperty("n1"));
+  KATANA_LOG_ASSERT(lazy->GetNodePropertyNum() == 1);
+  KATANA_LOG_ASSERT(lazy->HasNodeProperty("n1"));
+
+  // Concurrent first accesses load the property once
+  int64_t e0_length = g->GetEdgeProperty("e0")->length();
+  katana::do_all(katana::iterate(0, 64), [&](int) {
+    auto e0 = lazy->GetEdgeProperty("e0");
+    KATANA_LOG_ASSERT(e0 && e0->length() == e0_length);
+  });
+  KATANA_LOG_ASSERT(lazy->GetEdgePropertyNum() == 2);
+
+  // Copies include unloaded properties
+  auto copy_result = lazy->Copy();
+  KATANA_LOG_ASSERT(copy_result);
+  KATANA_LOG_ASSERT(copy_result.value()->GetNodePropertyNum() == 3);
+  KATANA_LOG_ASSERT(copy_result.value()->GetEdgePropertyNum() == 2);
+
+  // Unloaded properties are kept when the graph is committed
+  KATANA_LOG_ASSERT(lazy->Commit(command_line));
+  auto reload_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(reload_result);
+  std::unique_ptr<katana::PropertyGraph> reloaded =
+      std::move(reload_result.value());
+  KATANA_LOG_ASSERT(reloaded->GetNodePropertyNum() == 3);
+  KATANA_LOG_ASSERT(reloaded->GetEdgePropertyNum() == 2);
+  for (const std::string& name : {"n0", "n1", "n2"}) {
+    KATANA_LOG_ASSERT(
+        reloaded->GetNodeProperty(name)->Equals(g->GetNodeProperty(name)));
+  }
+}
+
+void
+TestLazyTypeSetIDs() {
+  std::vector<uint64_t> indices{1, 2, 2, 3};
+  std::vector<uint32_t> dests{1, 2, 0};
+  std::vector<int32_t> age{30, 40, 50, 60};
+  std::vector<uint8_t> is_person{1, 0, 1, 1};
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("age", arrow::int32()),
+           arrow::field("Person", arrow::uint8())}),
+      {katana::BuildArray(age), katana::BuildArray(is_person)})));
+  g->MarkAllPropertiesPersistent();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  std::vector<std::string> no_props;
+  tsuba::RDGLoadOptions opts;
+  opts.node_properties = &no_props;
+  opts.edge_properties = &no_props;
+  opts.lazy_load_properties = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(make_result);
+  std::unique_ptr<katana::PropertyGraph> lazy = std::move(make_result.value());
+
+  // Only the type property is loaded to find the types
+  KATANA_LOG_ASSERT(lazy->ConstructTypeSetIDs());
+  KATANA_LOG_ASSERT(lazy->GetNodePropertyNames().size() == 1);
+  KATANA_LOG_ASSERT(lazy->GetNodePropertyNames()[0] == "Person");
+  KATANA_LOG_ASSERT(
+      lazy->GetUnloadedNodePropertyNames() == std::vector<std::string>{"age"});
+
+  KATANA_LOG_ASSERT(g->ConstructTypeSetIDs());
+  for (uint32_t n = 0; n < indices.size(); ++n) {
+    KATANA_LOG_ASSERT(lazy->GetNodeTypeSetID(n) == g->GetNodeTypeSetID(n));
+  }
+}
+
+void
+TestStatistics() {
+  // 0 -> {1, 1, 0}, 1 -> {2}, 2 -> {}, 3 -> {0, 3}
+  std::vector<uint64_t> indices{3, 4, 4, 6};
+  std::vector<uint32_t> dests{1, 1, 0, 2, 0, 3};
+  std::vector<uint8_t> is_person{1, 0, 1, 1};
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("Person", arrow::uint8())}),
+      {katana::BuildArray(is_person)})));
+  KATANA_LOG_ASSERT(g->ConstructTypeSetIDs());
+  g->MarkAllPropertiesPersistent();
+  KATANA_LOG_ASSERT(!g->statistics());
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(make_result);
+  const auto& stats = make_result.value()->statistics();
+  KATANA_LOG_ASSERT(stats);
+
+  KATANA_LOG_VASSERT(
+      stats->num_nodes == 4 && stats->num_edges == 6, "{} {}",
+      stats->num_nodes, stats->num_edges);
+  KATANA_LOG_ASSERT(stats->max_out_degree == 3);
+  KATANA_LOG_ASSERT(stats->max_in_degree == 2);
+  // degrees 3, 1, 0, 2 and in-degrees 2, 2, 1, 1
+  KATANA_LOG_ASSERT(
+      (stats->out_degree_histogram == std::vector<uint64_t>{1, 1, 2}));
+  KATANA_LOG_ASSERT(
+      (stats->in_degree_histogram == std::vector<uint64_t>{0, 2, 2}));
+  KATANA_LOG_ASSERT(!stats->edges_sorted);
+  KATANA_LOG_ASSERT(stats->num_self_loops == 2);
+  KATANA_LOG_ASSERT(stats->num_duplicate_edges == 1);
+  KATANA_LOG_ASSERT(stats->node_type_counts.at("Person") == 3);
+  KATANA_LOG_ASSERT(stats->edge_type_counts.empty());
+
+  // Replacing the topology discards the statistics
+  KATANA_LOG_ASSERT(g->SetTopology(make_result.value()->topology()));
+  KATANA_LOG_ASSERT(!g->statistics());
+  g->ComputeStatistics();
+  KATANA_LOG_ASSERT(g->statistics()->num_duplicate_edges == 1);
+}
+
+void
+TestCompressedTopology() {
+  // Enough nodes for several index blocks, with unsorted neighbors, empty
+  // nodes and destinations far from their source
+  constexpr uint32_t kNumNodes = 300;
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    for (uint32_t i = 0; i < n % 7; ++i) {
+      dests.emplace_back((n * 131 + i * 97) % kNumNodes);
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  g->set_compress_topology(true);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+
+  std::vector<char> topology_file;
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().rfind("topology", 0) == 0) {
+      std::ifstream in(entry.path().string(), std::ios::binary);
+      topology_file.assign(
+          std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(make_result);
+  KATANA_LOG_ASSERT(make_result.value()->topology().Equals(g->topology()));
+
+  // Neighbors can also be read without decoding the whole file
+  auto view_res = tsuba::CompressedCSRTopologyView::Make(
+      topology_file.data(), topology_file.size());
+  KATANA_LOG_ASSERT(view_res);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    auto e = *g->topology().edges(n).begin();
+    for (uint64_t dest : view_res.value().neighbors(n)) {
+      KATANA_LOG_VASSERT(
+          dest == g->topology().edge_dest(e), "node {} edge {}", n, e);
+      ++e;
+    }
+    KATANA_LOG_ASSERT(e == *g->topology().edges(n).end());
+  }
+
+  // Truncated or corrupt files are rejected rather than read out of bounds
+  for (uint64_t size :
+       {sizeof(tsuba::CSRTopologyHeader), topology_file.size() / 2,
+        topology_file.size() - 1}) {
+    KATANA_LOG_ASSERT(
+        !tsuba::CompressedCSRTopologyView::Make(topology_file.data(), size));
+  }
+  std::vector<char> corrupt = topology_file;
+  // The last destination no longer ends inside the stream
+  corrupt.back() = static_cast<char>(corrupt.back() | 0x80);
+  KATANA_LOG_ASSERT(
+      !tsuba::CompressedCSRTopologyView::Make(corrupt.data(), corrupt.size()));
+  corrupt = topology_file;
+  auto* header = reinterpret_cast<tsuba::CSRTopologyHeader*>(corrupt.data());
+  header->num_nodes = std::numeric_limits<uint64_t>::max() / 4;
+  KATANA_LOG_ASSERT(
+      !tsuba::CompressedCSRTopologyView::Make(corrupt.data(), corrupt.size()));
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeInEdgesGraph() {
+  // Every node has in-edges from several sources, given out of order
+  constexpr uint32_t kNumNodes = 50;
+  std::vector<uint64_t> indices;
+  std::vector<uint32_t> dests;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    for (uint32_t i = 0; i < 4; ++i) {
+      dests.emplace_back((n * 7 + (3 - i) * 11) % kNumNodes);
+    }
+    indices.emplace_back(dests.size());
+  }
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+  return g;
+}
+
+std::string
+FindInTopologyFile(const std::string& rdg_dir) {
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().rfind("in_topology", 0) == 0) {
+      return entry.path().string();
+    }
+  }
+  return "";
+}
+
+void
+AssertSameInEdges(
+    const katana::GraphTopology& a, const katana::GraphTopology& b) {
+  KATANA_LOG_ASSERT(a.has_in_edges() && b.has_in_edges());
+  KATANA_LOG_ASSERT(a.in_indices->Equals(*b.in_indices));
+  KATANA_LOG_ASSERT(a.in_sources->Equals(*b.in_sources));
+  KATANA_LOG_ASSERT(a.in_to_out_edges->Equals(*b.in_to_out_edges));
+}
+
+void
+TestInEdgesRoundTrip() {
+  auto g = MakeInEdgesGraph();
+  KATANA_LOG_ASSERT(g->ConstructInEdges());
+  const katana::GraphTopology& topology = g->topology();
+  uint64_t num_nodes = topology.num_nodes();
+  uint64_t num_edges = topology.num_edges();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  if (auto res = g->Write(rdg_dir, command_line); !res) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+  std::string in_file = FindInTopologyFile(rdg_dir);
+  KATANA_LOG_ASSERT(!in_file.empty());
+
+  // A reloaded graph gets the stored index back
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(make_result);
+  auto loaded = std::move(make_result.value());
+  KATANA_LOG_ASSERT(!loaded->topology().has_in_edges());
+  KATANA_LOG_ASSERT(loaded->ConstructInEdges());
+  AssertSameInEdges(loaded->topology(), topology);
+  loaded.reset();
+
+  // Swap the first two in-edges of node 0 in storage. A built index orders
+  // them by source, so only a loaded index keeps the swap.
+  KATANA_LOG_ASSERT(topology.in_indices->Value(0) >= 2);
+  KATANA_LOG_ASSERT(
+      topology.in_sources->Value(0) != topology.in_sources->Value(1));
+  {
+    std::fstream f(in_file, std::ios::in | std::ios::out | std::ios::binary);
+    uint64_t to_out[2] = {
+        topology.in_to_out_edges->Value(1), topology.in_to_out_edges->Value(0)};
+    uint32_t sources[2] = {
+        topology.in_sources->Value(1), topology.in_sources->Value(0)};
+    f.seekp((4 + num_nodes) * sizeof(uint64_t));
+    f.write(reinterpret_cast<const char*>(to_out), sizeof(to_out));
+    f.seekp((4 + num_nodes + num_edges) * sizeof(uint64_t));
+    f.write(reinterpret_cast<const char*>(sources), sizeof(sources));
+    KATANA_LOG_ASSERT(f.good());
+  }
+  make_result = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(make_result);
+  loaded = std::move(make_result.value());
+  KATANA_LOG_ASSERT(loaded->ConstructInEdges());
+  const katana::GraphTopology& swapped = loaded->topology();
+  for (int i = 0; i < 2; ++i) {
+    KATANA_LOG_ASSERT(
+        swapped.in_sources->Value(i) == topology.in_sources->Value(1 - i));
+    KATANA_LOG_ASSERT(
+        swapped.in_to_out_edges->Value(i) ==
+        topology.in_to_out_edges->Value(1 - i));
+  }
+  loaded.reset();
+
+  // Sorting the edges drops the index, also from the next write
+  auto resorted_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(resorted_result);
+  auto resorted = std::move(resorted_result.value());
+  KATANA_LOG_ASSERT(resorted->ConstructInEdges());
+  KATANA_LOG_ASSERT(katana::SortAllEdgesByDest(resorted.get()));
+  KATANA_LOG_ASSERT(!resorted->topology().has_in_edges());
+
+  auto uri2_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri2_res);
+  std::string rdg_dir2(uri2_res.value().path());  // path() because local
+  if (auto res = resorted->Write(rdg_dir2, command_line); !res) {
+    fs::remove_all(rdg_dir2);
+    KATANA_LOG_FATAL("writing result: {}", res.error());
+  }
+  bool has_in_file = !FindInTopologyFile(rdg_dir2).empty();
+  fs::remove_all(rdg_dir2);
+  KATANA_LOG_ASSERT(!has_in_file);
+}
+
+void
+TestWideTopology() {
+  // Topologies with 64-bit node ids that fit in 32 bits are narrowed
+  std::vector<uint64_t> indices{2, 3, 3};
+  std::vector<uint64_t> wide_dests{1, 2, 0};
+  std::vector<uint32_t> dests{1, 2, 0};
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::WideGraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(wide_dests)),
+  }));
+  KATANA_LOG_ASSERT(!g->has_wide_node_ids());
+  KATANA_LOG_ASSERT(g->num_nodes() == 3 && g->num_edges() == 3);
+  KATANA_LOG_ASSERT(g->topology().Equals(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  }));
+
+  size_t visited = 0;
+  g->VisitTopology([&](const auto& topology) {
+    for (auto n : topology) {
+      visited += topology.edges(n).size();
+    }
+  });
+  KATANA_LOG_ASSERT(visited == 3);
+}
+
+void
+AssertNotImplemented(const katana::ErrorInfo& error) {
+  KATANA_LOG_VASSERT(
+      error == katana::ErrorCode::NotImplemented, "unexpected error: {}",
+      error);
+}
+
+void
+TestWideNodeIdsRejected() {
+  // 2^32 + 1 nodes and no edges. The out indices are all zero, so they can
+  // come from an anonymous mapping that is never touched.
+  uint64_t num_nodes = (uint64_t{1} << 32) + 1;
+  size_t size = num_nodes * sizeof(uint64_t);
+  void* indices = mmap(
+      nullptr, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+      -1, 0);
+  if (indices == MAP_FAILED) {
+    KATANA_LOG_WARN("skipping wide node id test: mmap: {}", strerror(errno));
+    return;
+  }
+
+  std::vector<uint64_t> no_dests;
+  auto g = std::make_unique<katana::PropertyGraph>();
+  KATANA_LOG_ASSERT(g->SetTopology(katana::WideGraphTopology{
+      .out_indices = std::make_shared<arrow::UInt64Array>(
+          num_nodes, std::make_shared<arrow::Buffer>(
+                         static_cast<const uint8_t*>(indices), size)),
+      .out_dests = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(no_dests)),
+  }));
+  KATANA_LOG_ASSERT(g->has_wide_node_ids());
+  KATANA_LOG_ASSERT(g->num_nodes() == num_nodes && g->num_edges() == 0);
+
+  using Graph = katana::TypedPropertyGraph<std::tuple<>, std::tuple<>>;
+  AssertNotImplemented(Graph::Make(g.get(), {}, {}).error());
+  AssertNotImplemented(katana::CreateSymmetricGraph(g.get()).error());
+  AssertNotImplemented(katana::CreateTransposeGraph(g.get()).error());
+  AssertNotImplemented(katana::SortAllEdgesByDest(g.get()).error());
+  AssertNotImplemented(katana::FindEdgeSortedByDest(g.get(), 0, 1).error());
+  AssertNotImplemented(
+      katana::RelabelNodes(g.get(), katana::NodeOrdering::kDegree).error());
+  AssertNotImplemented(g->ConstructInEdges().error());
+
+  g.reset();
+  munmap(indices, size);
+}
+
 }  // namespace
 
 int
@@ -260,6 +751,13 @@ main(int argc, char** argv) {
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
+  TestLazyLoad();
+  TestLazyTypeSetIDs();
+  TestStatistics();
+  TestCompressedTopology();
+  TestInEdgesRoundTrip();
+  TestWideTopology();
+  TestWideNodeIdsRejected();
 
   return 0;
 }
@@ -2,9 +2,12 @@
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
 
+#include <numeric>
+
 #include "TestTypedPropertyGraph.h"
 #include "katana/Logging.h"
 #include "katana/Properties.h"
+#include "katana/SharedMemSys.h"
 
 using DataType = int64_t;
 
@@ -126,12 +129,352 @@ TestError1(size_t num_nodes, size_t line_width) {
       "Should return PropertyNotFound when node property doesn't exist.");
 }
 
+/// Test that the in-edge index is the reverse of the out-edges
+void
+TestInEdges(size_t num_nodes, size_t line_width) {
+  RandomPolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, &policy);
+
+  auto r = g->ConstructInEdges();
+  KATANA_LOG_VASSERT(r, "could not construct in-edges: {}", r.error());
+
+  const katana::GraphTopology& topology = g->topology();
+  KATANA_LOG_ASSERT(topology.has_in_edges());
+
+  size_t num_in_edges = 0;
+  for (auto n : topology.nodes(0, num_nodes)) {
+    katana::GraphTopology::Node prev_src = 0;
+    for (auto e : topology.in_edges(n)) {
+      auto src = topology.in_edge_source(e);
+      auto out_e = topology.in_edge_to_out_edge(e);
+      auto [begin, end] = topology.edge_range(src);
+
+      KATANA_LOG_VASSERT(
+          begin <= out_e && out_e < end, "{} is not an out-edge of {}", out_e,
+          src);
+      KATANA_LOG_VASSERT(
+          topology.edge_dest(out_e) == n, "{} != {}",
+          topology.edge_dest(out_e), n);
+      KATANA_LOG_VASSERT(prev_src <= src, "{} > {}", prev_src, src);
+
+      prev_src = src;
+      ++num_in_edges;
+    }
+  }
+  KATANA_LOG_VASSERT(
+      num_in_edges == topology.num_edges(), "{} != {}", num_in_edges,
+      topology.num_edges());
+}
+
+/// AddEdgeIds adds an edge property "id" whose value is the edge id
+void
+AddEdgeIds(katana::PropertyGraph* g) {
+  std::vector<int64_t> ids(g->topology().num_edges());
+  std::iota(ids.begin(), ids.end(), int64_t{0});
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("id", arrow::int64())}),
+      {katana::BuildArray(ids)});
+  auto r = g->AddEdgeProperties(table);
+  KATANA_LOG_VASSERT(r, "could not add edge ids: {}", r.error());
+}
+
+/// CheckReversed checks that every edge of \param reversed is an edge of
+/// \param g, given by its "id" property, reversed or, if \param
+/// allow_forward, not, and that edges of each node are sorted by destination.
+/// Returns the number of edges.
+size_t
+CheckReversed(
+    const katana::PropertyGraph& g, const katana::PropertyGraph& reversed,
+    bool allow_forward) {
+  const katana::GraphTopology& topology = g.topology();
+  const katana::GraphTopology& rev_topology = reversed.topology();
+  KATANA_LOG_ASSERT(rev_topology.num_nodes() == topology.num_nodes());
+
+  auto ids = std::static_pointer_cast<arrow::Int64Array>(
+      reversed.GetEdgeProperty("id")->chunk(0));
+  KATANA_LOG_ASSERT(
+      static_cast<size_t>(ids->length()) == rev_topology.num_edges());
+
+  for (auto n : rev_topology.nodes(0, rev_topology.num_nodes())) {
+    katana::GraphTopology::Node prev_dest = 0;
+    for (auto e : rev_topology.edges(n)) {
+      auto dest = rev_topology.edge_dest(e);
+      KATANA_LOG_VASSERT(prev_dest <= dest, "{} > {}", prev_dest, dest);
+      prev_dest = dest;
+
+      uint64_t orig = ids->Value(e);
+      auto [begin, end] = topology.edge_range(dest);
+      bool is_reverse = begin <= orig && orig < end &&
+                        topology.edge_dest(orig) == n;
+      auto [n_begin, n_end] = topology.edge_range(n);
+      bool is_forward = n_begin <= orig && orig < n_end &&
+                        topology.edge_dest(orig) == dest;
+      KATANA_LOG_VASSERT(
+          is_reverse || (allow_forward && is_forward),
+          "edge {} -> {} does not match original edge {}", n, dest, orig);
+    }
+  }
+  return rev_topology.num_edges();
+}
+
+void
+TestReversedGraphs(size_t num_nodes, size_t line_width) {
+  RandomPolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, &policy);
+  AddEdgeIds(g.get());
+
+  const katana::GraphTopology& topology = g->topology();
+  size_t num_self_loops = 0;
+  for (auto n : topology.nodes(0, num_nodes)) {
+    for (auto e : topology.edges(n)) {
+      num_self_loops += topology.edge_dest(e) == n;
+    }
+  }
+
+  auto transpose_result = katana::CreateTransposeGraph(g.get(), {"id"});
+  KATANA_LOG_VASSERT(
+      transpose_result, "could not transpose: {}", transpose_result.error());
+  size_t num_transpose_edges =
+      CheckReversed(*g, *transpose_result.value(), false);
+  KATANA_LOG_VASSERT(
+      num_transpose_edges == topology.num_edges(), "{} != {}",
+      num_transpose_edges, topology.num_edges());
+
+  auto symmetric_result = katana::CreateSymmetricGraph(g.get(), {"id"});
+  KATANA_LOG_VASSERT(
+      symmetric_result, "could not symmetrize: {}", symmetric_result.error());
+  size_t num_symmetric_edges =
+      CheckReversed(*g, *symmetric_result.value(), true);
+  size_t expected = 2 * topology.num_edges() - num_self_loops;
+  KATANA_LOG_VASSERT(
+      num_symmetric_edges == expected, "{} != {}", num_symmetric_edges,
+      expected);
+
+  auto dedup_result = katana::CreateSymmetricGraph(g.get(), {"id"}, true);
+  KATANA_LOG_VASSERT(
+      dedup_result, "could not symmetrize: {}", dedup_result.error());
+  CheckReversed(*g, *dedup_result.value(), true);
+  const katana::GraphTopology& dedup = dedup_result.value()->topology();
+  for (auto n : dedup.nodes(0, num_nodes)) {
+    auto [begin, end] = dedup.edge_range(n);
+    for (auto e = begin + 1; e < end; ++e) {
+      KATANA_LOG_VASSERT(
+          dedup.edge_dest(e - 1) != dedup.edge_dest(e),
+          "duplicate edge {} -> {}", n, dedup.edge_dest(e));
+    }
+  }
+  // Every original edge is still present in both directions
+  for (auto n : topology.nodes(0, num_nodes)) {
+    for (auto e : topology.edges(n)) {
+      auto dest = topology.edge_dest(e);
+      KATANA_LOG_ASSERT(
+          katana::FindEdgeSortedByDest(dedup_result.value().get(), n, dest)
+              .value() != dedup.edge_range(n).second);
+      KATANA_LOG_ASSERT(
+          katana::FindEdgeSortedByDest(dedup_result.value().get(), dest, n)
+              .value() != dedup.edge_range(dest).second);
+    }
+  }
+}
+
+/// SkewedPolicy gives node i (i % max_width) random neighbors
+class SkewedPolicy : public Policy {
+  size_t max_width_{};
+
+public:
+  SkewedPolicy(size_t max_width) : max_width_(max_width) {}
+
+  std::vector<uint32_t> GenerateNeighbors(
+      size_t node_id, size_t num_nodes) override {
+    return RandomPolicy{node_id % max_width_}.GenerateNeighbors(
+        node_id, num_nodes);
+  }
+};
+
+void
+TestRelabelNodes(
+    size_t num_nodes, size_t max_width, katana::NodeOrdering ordering) {
+  SkewedPolicy policy{max_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, &policy);
+  AddEdgeIds(g.get());
+  auto copy_result = g->Copy();
+  KATANA_LOG_VASSERT(copy_result, "could not copy: {}", copy_result.error());
+  std::unique_ptr<katana::PropertyGraph> original =
+      std::move(copy_result.value());
+  std::vector<int64_t> node_ids(num_nodes);
+  std::iota(node_ids.begin(), node_ids.end(), int64_t{0});
+  auto add_result = g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("id", arrow::int64())}),
+      {katana::BuildArray(node_ids)}));
+  KATANA_LOG_VASSERT(add_result, "could not add ids: {}", add_result.error());
+
+  auto relabel_result = katana::RelabelNodes(g.get(), ordering);
+  KATANA_LOG_VASSERT(
+      relabel_result, "could not relabel: {}", relabel_result.error());
+  auto old_to_new = relabel_result.value();
+
+  const katana::GraphTopology& topology = original->topology();
+  const katana::GraphTopology& relabeled = g->topology();
+  KATANA_LOG_ASSERT(relabeled.num_edges() == topology.num_edges());
+
+  auto old_node_ids = std::static_pointer_cast<arrow::Int64Array>(
+      g->GetNodeProperty("id")->chunk(0));
+  auto old_edge_ids = std::static_pointer_cast<arrow::Int64Array>(
+      g->GetEdgeProperty("id")->chunk(0));
+  for (auto n : relabeled.nodes(0, num_nodes)) {
+    uint64_t old_n = old_node_ids->Value(n);
+    KATANA_LOG_VASSERT(
+        old_to_new->Value(old_n) == n, "{} != {}", old_to_new->Value(old_n),
+        n);
+    KATANA_LOG_ASSERT(
+        relabeled.edges(n).size() == topology.edges(old_n).size());
+    for (auto e : relabeled.edges(n)) {
+      uint64_t old_e = old_edge_ids->Value(e);
+      auto [begin, end] = topology.edge_range(old_n);
+      KATANA_LOG_VASSERT(
+          begin <= old_e && old_e < end, "{} is not an edge of {}", old_e,
+          old_n);
+      KATANA_LOG_ASSERT(
+          old_to_new->Value(topology.edge_dest(old_e)) ==
+          relabeled.edge_dest(e));
+    }
+  }
+}
+
+/// CheckTypeIndexRange checks that \param range has exactly the ids in
+/// [begin, end) for which \param has_type is true
+template <typename Range, typename Pred>
+void
+CheckTypeIndexRange(
+    const Range& range, uint64_t begin, uint64_t end, Pred has_type) {
+  std::vector<uint64_t> found(range.begin(), range.end());
+  std::sort(found.begin(), found.end());
+  std::vector<uint64_t> expected;
+  for (uint64_t i = begin; i < end; ++i) {
+    if (has_type(i)) {
+      expected.emplace_back(i);
+    }
+  }
+  KATANA_LOG_VASSERT(
+      found == expected, "found {} ids but expected {}", found.size(),
+      expected.size());
+}
+
+void
+TestTypeIndexes(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, &policy);
+
+  auto is_a = [](uint64_t n) { return n % 3 == 0; };
+  auto is_b = [](uint64_t n) { return n % 2 == 0; };
+  auto is_e = [](uint64_t e) { return e % 5 == 0; };
+  std::vector<uint8_t> a(num_nodes);
+  std::vector<uint8_t> b(num_nodes);
+  for (size_t n = 0; n < num_nodes; ++n) {
+    a[n] = is_a(n);
+    b[n] = is_b(n);
+  }
+  std::vector<uint8_t> e(g->num_edges());
+  for (size_t i = 0; i < e.size(); ++i) {
+    e[i] = is_e(i);
+  }
+  KATANA_LOG_ASSERT(g->AddNodeProperties(arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("A", arrow::uint8()),
+           arrow::field("B", arrow::uint8())}),
+      {katana::BuildArray(a), katana::BuildArray(b)})));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("E", arrow::uint8())}),
+      {katana::BuildArray(e)})));
+  KATANA_LOG_ASSERT(g->ConstructTypeSetIDs());
+
+  CheckTypeIndexRange(g->NodesOfType("A"), 0, num_nodes, is_a);
+  CheckTypeIndexRange(g->NodesOfType("B"), 0, num_nodes, is_b);
+  KATANA_LOG_ASSERT(g->NodesOfType("C").empty());
+  KATANA_LOG_ASSERT(g->NumNodesOfType("A") == (num_nodes + 2) / 3);
+
+  // Nodes with both types have their own TypeSetID
+  auto both = g->GetNodeTypeSetID(0);
+  auto nodes = g->NodesOfTypeSetID(both);
+  KATANA_LOG_ASSERT(std::is_sorted(nodes.begin(), nodes.end()));
+  CheckTypeIndexRange(nodes, 0, num_nodes, [&](uint64_t n) {
+    return is_a(n) && is_b(n);
+  });
+
+  for (auto n : *g) {
+    auto [begin, end] = g->topology().edge_range(n);
+    CheckTypeIndexRange(g->OutEdgesOfType(n, "E"), begin, end, is_e);
+    CheckTypeIndexRange(
+        g->OutEdgesOfTypeSetID(n, katana::PropertyGraph::kUnknownType), begin,
+        end, [&](uint64_t e) { return !is_e(e); });
+  }
+
+  // Relabeling keeps the indexes in sync with the types
+  auto relabel_result =
+      katana::RelabelNodes(g.get(), katana::NodeOrdering::kDegree);
+  KATANA_LOG_ASSERT(relabel_result);
+  for (auto n : g->NodesOfType("A")) {
+    KATANA_LOG_ASSERT(g->NodeTypeNameToTypeSetIDs("A").test(
+        g->GetNodeTypeSetID(n)));
+  }
+  KATANA_LOG_ASSERT(g->NumNodesOfType("A") == (num_nodes + 2) / 3);
+
+  // So does sorting edges in place, which moves TypeSetIDs with the edges
+  auto sort_result = katana::SortAllEdgesByDestWithProperties(g.get());
+  KATANA_LOG_ASSERT(sort_result);
+  auto e_type_set_ids = g->EdgeTypeNameToTypeSetIDs("E");
+  for (auto n : *g) {
+    auto [begin, end] = g->topology().edge_range(n);
+    CheckTypeIndexRange(g->OutEdgesOfType(n, "E"), begin, end, [&](auto e) {
+      return e_type_set_ids.test(g->GetEdgeTypeSetID(e));
+    });
+  }
+}
+
+void
+TestTypeIndexesOneType(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, &policy);
+  std::vector<uint8_t> e(g->num_edges(), 1);
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("E", arrow::uint8())}),
+      {katana::BuildArray(e)})));
+  KATANA_LOG_ASSERT(g->ConstructTypeSetIDs());
+
+  // Every out-edge has type E, with or without a stored index
+  for (auto n : *g) {
+    auto [begin, end] = g->topology().edge_range(n);
+    CheckTypeIndexRange(
+        g->OutEdgesOfType(n, "E"), begin, end, [](uint64_t) { return true; });
+    KATANA_LOG_ASSERT(
+        g->OutEdgesOfTypeSetID(n, katana::PropertyGraph::kUnknownType)
+            .empty());
+  }
+}
+
 int
 main() {
+  katana::SharedMemSys sys;
+
   TestIterate1(10, 3);
   TestIterate3(10, 3);
   TestIterate4(10, 3);
   TestError1(10, 3);
+  TestInEdges(100, 5);
+  TestReversedGraphs(100, 5);
+  TestRelabelNodes(100, 8, katana::NodeOrdering::kDegree);
+  TestRelabelNodes(100, 8, katana::NodeOrdering::kReverseCuthillMcKee);
+  TestRelabelNodes(100, 8, katana::NodeOrdering::kHubCluster);
+  TestTypeIndexes(100, 5);
+  TestTypeIndexesOneType(100, 5);
 
   return 0;
 }
@@ -0,0 +1,139 @@
+#include <arrow/api.h>
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+namespace {
+
+using katana::analytics::RandomWalks;
+using katana::analytics::RandomWalksBuildAliasTable;
+using katana::analytics::RandomWalksPlan;
+
+constexpr uint32_t kNumberOfWalks = 20000;
+
+/// The weights of the edges of node 0, by destination
+const std::map<uint32_t, double> kWeights{{1, 1.0}, {2, 3.0}, {3, 6.0}};
+
+/// The destinations of the star graph, in edge order
+const std::vector<uint32_t> kDests{3, 1, 2, 0, 0, 0};
+
+/// MakeStarGraph makes a symmetric star around node 0 whose edges are not
+/// sorted by destination, with the edge properties "type" (all 0) and
+/// "weight"
+std::unique_ptr<katana::PropertyGraph>
+MakeStarGraph() {
+  std::vector<uint64_t> indices{3, 4, 5, 6};
+  std::vector<uint32_t> dests(kDests);
+  std::vector<double> weights{
+      kWeights.at(3), kWeights.at(1), kWeights.at(2), 1.0, 1.0, 1.0};
+  std::vector<uint32_t> types(dests.size(), 0);
+
+  auto g = std::make_unique<katana::PropertyGraph>();
+  auto set_result = g->SetTopology(katana::GraphTopology{
+      .out_indices = std::static_pointer_cast<arrow::UInt64Array>(
+          katana::BuildArray(indices)),
+      .out_dests = std::static_pointer_cast<arrow::UInt32Array>(
+          katana::BuildArray(dests)),
+  });
+  KATANA_LOG_ASSERT(set_result);
+
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("type", arrow::uint32()),
+           arrow::field("weight", arrow::float64())}),
+      {katana::BuildArray(types), katana::BuildArray(weights)});
+  if (auto r = g->AddEdgeProperties(table); !r) {
+    KATANA_LOG_FATAL("could not add edge properties: {}", r.error());
+  }
+
+  return g;
+}
+
+/// Check that the first steps of walks from node 0 follow kWeights and that
+/// the edges and their weights are left as they were
+void
+CheckWalks(katana::PropertyGraph* g, const RandomWalksPlan& plan) {
+  auto walks_result = RandomWalks(g, plan, "weight");
+  KATANA_LOG_VASSERT(walks_result, "random walks: {}", walks_result.error());
+
+  std::map<uint32_t, uint64_t> counts;
+  uint64_t total = 0;
+  for (const auto& walk : walks_result.value()) {
+    if (walk.size() < 2 || walk[0] != 0) {
+      continue;
+    }
+    ++counts[walk[1]];
+    ++total;
+  }
+  KATANA_LOG_ASSERT(total > 0);
+
+  double weight_sum = 0;
+  for (const auto& [dest, weight] : kWeights) {
+    weight_sum += weight;
+  }
+  for (const auto& [dest, weight] : kWeights) {
+    double expected = weight / weight_sum;
+    double actual = static_cast<double>(counts[dest]) / total;
+    KATANA_LOG_VASSERT(
+        std::abs(actual - expected) < 0.02, "dest {}: {} != {}", dest, actual,
+        expected);
+  }
+
+  auto weight_array = std::static_pointer_cast<arrow::DoubleArray>(
+      g->GetEdgeProperty("weight")->chunk(0));
+  const auto& topology = g->topology();
+  for (uint64_t e = 0; e < kDests.size(); ++e) {
+    KATANA_LOG_VASSERT(
+        topology.out_dests->Value(e) == kDests[e], "edge {} moved to {}", e,
+        topology.out_dests->Value(e));
+  }
+  for (uint64_t e = 0; e < topology.out_indices->Value(0); ++e) {
+    uint32_t dest = topology.out_dests->Value(e);
+    KATANA_LOG_VASSERT(
+        weight_array->Value(e) == kWeights.at(dest),
+        "edge {} to {} has weight {}", e, dest, weight_array->Value(e));
+  }
+}
+
+void
+TestWeighted(const RandomWalksPlan& plan) {
+  auto g = MakeStarGraph();
+
+  // Repeated calls see the same graph
+  CheckWalks(g.get(), plan);
+  CheckWalks(g.get(), plan);
+
+  // The persisted alias tables must agree with the edges
+  auto h = MakeStarGraph();
+  auto build_result = RandomWalksBuildAliasTable(h.get(), "weight");
+  KATANA_LOG_VASSERT(
+      build_result, "building alias table: {}", build_result.error());
+  CheckWalks(h.get(), plan);
+}
+
+void
+TestZeroWalkLength() {
+  auto g = MakeStarGraph();
+  auto walks_result = RandomWalks(g.get(), RandomWalksPlan::Node2Vec(0));
+  KATANA_LOG_ASSERT(!walks_result);
+  KATANA_LOG_ASSERT(walks_result.error() == katana::ErrorCode::InvalidArgument);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestWeighted(RandomWalksPlan::Node2Vec(1, kNumberOfWalks));
+  TestWeighted(RandomWalksPlan::Edge2Vec(1, kNumberOfWalks, 1.0, 1.0, 1, 1));
+  TestZeroWalkLength();
+
+  return 0;
+}
@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <numeric>
@@ -124,6 +125,94 @@ do_count_if() {
   return 0;
 }
 
+int
+do_partition() {
+  unsigned M = katana::GetThreadPool().getMaxThreads();
+  std::cout << "partition:\n";
+
+  while (M) {
+    katana::setActiveThreads(M);  // katana::LL::getMaxThreads());
+    std::cout << "Using " << M << " threads\n";
+
+    std::vector<unsigned> V(vectorSize);
+    std::generate(V.begin(), V.end(), RandomNumber);
+    std::vector<unsigned> C = V;
+
+    katana::Timer t;
+    t.start();
+    auto mid = katana::ParallelSTL::partition(V.begin(), V.end(), IsOddS());
+    t.stop();
+
+    katana::Timer t2;
+    t2.start();
+    std::partition(C.begin(), C.end(), IsOddS());
+    t2.stop();
+
+    bool partitioned = std::all_of(V.begin(), mid, IsOddS()) &&
+                       std::none_of(mid, V.end(), IsOddS());
+    std::sort(V.begin(), V.end());
+    std::sort(C.begin(), C.end());
+    bool eq = std::equal(C.begin(), C.end(), V.begin());
+
+    std::cout << "Galois: " << t.get() << " STL: " << t2.get()
+              << " Partitioned: " << partitioned << " Equal: " << eq << "\n";
+    if (!partitioned || !eq) {
+      return 1;
+    }
+    M >>= 1;
+  }
+
+  return 0;
+}
+
+/// Replay, in one thread, an interleaving of two threads in parallel
+/// partition: thread A takes the first and last blocks, thread B takes the
+/// two middle blocks, completes both at once and records nothing, then A
+/// completes its high block but not its low one.
+int
+do_partition_interleaving() {
+  std::cout << "partition interleaving:\n";
+
+  using Iterator = std::vector<unsigned>::iterator;
+  using Helper = katana::ParallelSTL::partition_helper<Iterator, IsOddS>;
+  constexpr size_t kBlockSize = 1024;
+
+  // Odd elements belong low. A's low block has one even element at its
+  // start. B's blocks each have one misplaced element, at the last position
+  // B looks at, so a single swap completes both.
+  std::vector<unsigned> V(4 * kBlockSize);
+  std::fill(V.begin(), V.begin() + 2 * kBlockSize, 1);
+  std::fill(V.begin() + 2 * kBlockSize, V.end(), 2);
+  V[0] = 0;
+  V[2 * kBlockSize - 1] = 0;
+  V[2 * kBlockSize] = 1;
+
+  Helper::partition_helper_state s(V.begin(), V.end(), IsOddS());
+  auto a_low = s.takeLow();
+  auto a_high = s.takeHigh();
+  auto b_low = s.takeLow();
+  auto b_high = s.takeHigh();
+  auto b_parts = katana::ParallelSTL::dual_partition(
+      b_low.first, b_low.second, b_high.first, b_high.second, IsOddS());
+  if (b_parts.first != b_low.second || b_parts.second != b_high.first) {
+    std::cout << "B did not complete both blocks\n";
+    return 1;
+  }
+  s.update({b_low.second, b_low.second}, {b_high.first, b_high.first});
+
+  auto a_parts = katana::ParallelSTL::dual_partition(
+      a_low.first, a_low.second, a_high.first, a_high.second, IsOddS());
+  s.update({a_parts.first, a_low.second}, {a_high.first, a_parts.second});
+
+  auto mid = s.finish();
+  bool partitioned = mid == V.begin() + (2 * kBlockSize - 1) &&
+                     std::all_of(V.begin(), mid, IsOddS()) &&
+                     std::none_of(mid, V.end(), IsOddS());
+  std::cout << "Partitioned: " << partitioned << "\n";
+
+  return partitioned ? 0 : 1;
+}
+
 template <typename T>
 struct mymax {
   T operator()(const T& x, const T& y) const { return std::max(x, y); }
@@ -175,6 +264,8 @@ main(int argc, char** argv) {
   int ret = 0;
   //  ret |= do_sort();
   //  ret |= do_count_if();
+  ret |= do_partition();
+  ret |= do_partition_interleaving();
   ret |= do_accumulate();
   return ret;
 }
@@ -0,0 +1,115 @@
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Uri.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string
+PrintToFile(const std::string& path, katana::StatFormat format) {
+  katana::SetStatFile(path);
+  katana::SetStatFormat(format);
+  katana::PrintStats();
+
+  std::ifstream in(path);
+  return std::string(
+      std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+const nlohmann::json*
+FindRegion(const nlohmann::json& regions, const std::string& name) {
+  for (const auto& r : regions) {
+    if (r["name"] == name) {
+      return &r;
+    }
+  }
+  return nullptr;
+}
+
+void
+RunRegions() {
+  katana::StatTimer outer("Time", "Outer");
+  outer.start();
+  katana::do_all(
+      katana::iterate(0, 1000), [](int) {}, katana::loopname("Inner"));
+  katana::ReportStatSum("Inner", "Work", 1);
+  outer.stop();
+
+  katana::ReportParam("Params", "Name", "value");
+}
+
+void
+TestJSON(const std::string& path) {
+  std::string out = PrintToFile(path, katana::StatFormat::kJSON);
+  nlohmann::json stats = nlohmann::json::parse(out);
+  const nlohmann::json& regions = stats["regions"];
+
+  const nlohmann::json* outer = FindRegion(regions, "Outer");
+  KATANA_LOG_ASSERT(outer);
+  const nlohmann::json* inner = FindRegion((*outer)["regions"], "Inner");
+  KATANA_LOG_ASSERT(inner);
+  KATANA_LOG_ASSERT(!FindRegion(regions, "Inner"));
+
+  const nlohmann::json& work = (*inner)["stats"]["Work"];
+  KATANA_LOG_ASSERT(work["total_type"] == "TSUM");
+  KATANA_LOG_ASSERT(work["total"] == 1);
+  KATANA_LOG_ASSERT(work["values"].size() == 1);
+
+  const nlohmann::json* params = FindRegion(regions, "Params");
+  KATANA_LOG_ASSERT(params);
+  KATANA_LOG_ASSERT((*params)["params"]["Name"]["total"] == "value");
+}
+
+void
+TestChromeTrace(const std::string& path) {
+  std::string out = PrintToFile(path, katana::StatFormat::kChromeTrace);
+  nlohmann::json trace = nlohmann::json::parse(out);
+
+  size_t outer = 0;
+  size_t inner = 0;
+  for (const auto& e : trace["traceEvents"]) {
+    if (e["ph"] != "X") {
+      continue;
+    }
+    KATANA_LOG_ASSERT(e["dur"] >= 0);
+    if (e["name"] == "Outer") {
+      ++outer;
+    } else if (e["name"] == "Inner" && e["cat"] == "Loop") {
+      ++inner;
+    }
+  }
+  KATANA_LOG_ASSERT(outer == 1);
+  KATANA_LOG_ASSERT(inner == katana::getActiveThreads());
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+  katana::setActiveThreads(4);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/stat-format");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string path(uri_res.value().path());
+
+  katana::SetStatFormat(katana::StatFormat::kJSON);
+  RunRegions();
+
+  TestJSON(path);
+  TestChromeTrace(path);
+
+  katana::SetStatFormat(katana::StatFormat::kText);
+  katana::SetStatFile("");
+  fs::remove(path);
+
+  return 0;
+}
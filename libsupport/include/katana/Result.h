@@ -217,6 +217,10 @@ public:
 
   const std::error_code& error_code() const { return error_code_; }
 
+  /// Make an ErrorInfo with the same error code and message on the error
+  /// stack of the calling thread, e.g., to return a stored error
+  ErrorInfo ToErrorInfo() const;
+
   friend std::ostream& operator<<(
       std::ostream& out, const CopyableErrorInfo& ei) {
     return ei.Write(out);
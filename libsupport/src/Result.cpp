@@ -156,6 +156,14 @@ katana::CopyableErrorInfo::Write(std::ostream& out) const {
   return out;
 }
 
+katana::ErrorInfo
+katana::CopyableErrorInfo::ToErrorInfo() const {
+  if (message_.empty()) {
+    return ErrorInfo(error_code_);
+  }
+  return ErrorInfo(error_code_, message_);
+}
+
 katana::Result<void>
 katana::ResultSuccess() {
   return BOOST_OUTCOME_V2_NAMESPACE::success();
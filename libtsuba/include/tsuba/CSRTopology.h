@@ -1,9 +1,13 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_CSRTOPOLOGY_H_
 #define KATANA_LIBTSUBA_TSUBA_CSRTOPOLOGY_H_
 
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
 
 #include "katana/BitMath.h"
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
 
 namespace tsuba {
 
@@ -26,6 +30,8 @@ struct CSRTopologyPrefix {
   uint64_t out_indexes[];  // NOLINT needed for layout
 };
 
+/// Size of an uncompressed CSR file; compressed files record the size of
+/// their destination stream in the file itself
 constexpr uint64_t
 CSRTopologyFileSize(const CSRTopologyHeader& header) {
   uint64_t edge_size =
@@ -35,6 +41,301 @@ CSRTopologyFileSize(const CSRTopologyHeader& header) {
          (header.num_edges * header.edge_type_size);
 }
 
+/// Compressed CSR files share the header (with version
+/// kCompressedCSRTopologyVersion) and the out index array of CSR files, so
+/// readers of the prefix work unchanged, but replace the destination array
+/// with a byte stream:
+///
+///   uint64_t[num_blocks + 1] block_offsets: offset in the stream of the
+///     edges of the first node of each block of kCompressedCSRBlockNodes
+///     nodes; the last entry is the size of the stream
+///   uint8_t[] stream: destinations of all edges in edge order
+///
+/// Each destination is stored as the difference from the previous
+/// destination of the same node (from the node itself for its first edge),
+/// zigzag encoded and written as a varint (7 bits per byte, high bit set on
+/// all but the last byte). Sorted neighbors compress best but edge order is
+/// kept as is, since edge ids index edge properties.
+///
+/// The format only reduces storage and I/O. PropertyGraph decodes it into a
+/// flat CSR when a graph is loaded, so a loaded graph takes as much memory as
+/// an uncompressed one.
+constexpr uint64_t kCompressedCSRTopologyVersion = 3;
+
+/// Number of nodes per entry of the block index of a compressed CSR file
+constexpr uint64_t kCompressedCSRBlockNodes = 64;
+
+constexpr uint64_t
+CompressedCSRNumBlocks(uint64_t num_nodes) {
+  return (num_nodes + kCompressedCSRBlockNodes - 1) / kCompressedCSRBlockNodes;
+}
+
+/// Number of bytes needed to encode a destination \param dest following
+/// \param prev
+constexpr uint64_t
+CompressedCSREncodedSize(uint64_t prev, uint64_t dest) {
+  auto delta = static_cast<int64_t>(dest - prev);
+  uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^
+                    static_cast<uint64_t>(delta >> 63);
+  uint64_t size = 1;
+  while (zigzag >= 0x80) {
+    zigzag >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+/// Encode a destination \param dest following \param prev at \param out
+/// \returns one past the last byte written
+inline uint8_t*
+CompressedCSREncode(uint64_t prev, uint64_t dest, uint8_t* out) {
+  auto delta = static_cast<int64_t>(dest - prev);
+  uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^
+                    static_cast<uint64_t>(delta >> 63);
+  while (zigzag >= 0x80) {
+    *out++ = static_cast<uint8_t>(zigzag | 0x80);
+    zigzag >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(zigzag);
+  return out;
+}
+
+/// Decode the destination at \param in following \param prev into \param
+/// dest
+/// \returns one past the last byte read
+inline const uint8_t*
+CompressedCSRDecode(const uint8_t* in, uint64_t prev, uint64_t* dest) {
+  uint64_t zigzag = *in & 0x7f;
+  for (uint32_t shift = 7; *in++ & 0x80; shift += 7) {
+    zigzag |= static_cast<uint64_t>(*in & 0x7f) << shift;
+  }
+  auto delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(
+                                                       zigzag & 1);
+  *dest = prev + static_cast<uint64_t>(delta);
+  return in;
+}
+
+/// A read-only view of a compressed CSR file in memory. Neighbors of a node
+/// are decoded on the fly: the block index bounds a lookup to skipping the
+/// edges of at most kCompressedCSRBlockNodes - 1 nodes.
+class CompressedCSRTopologyView {
+public:
+  /// Iterates over the destinations of the out-edges of one node
+  class NeighborIterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = uint64_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const uint64_t*;
+    using reference = const uint64_t&;
+
+    NeighborIterator() = default;
+    NeighborIterator(const uint8_t* pos, uint64_t prev, uint64_t remaining)
+        : pos_(pos), dest_(prev), remaining_(remaining) {
+      if (remaining_ > 0) {
+        pos_ = CompressedCSRDecode(pos_, dest_, &dest_);
+      }
+    }
+
+    reference operator*() const { return dest_; }
+
+    NeighborIterator& operator++() {
+      if (--remaining_ > 0) {
+        pos_ = CompressedCSRDecode(pos_, dest_, &dest_);
+      }
+      return *this;
+    }
+
+    NeighborIterator operator++(int) {
+      NeighborIterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const NeighborIterator& other) const {
+      return remaining_ == other.remaining_;
+    }
+    bool operator!=(const NeighborIterator& other) const {
+      return !(*this == other);
+    }
+
+  private:
+    const uint8_t* pos_{nullptr};
+    uint64_t dest_{0};
+    uint64_t remaining_{0};
+  };
+
+  struct NeighborRange {
+    NeighborIterator first;
+    NeighborIterator last;
+
+    NeighborIterator begin() const { return first; }
+    NeighborIterator end() const { return last; }
+  };
+
+  /// Check that \param data of \param size bytes holds a compressed CSR
+  /// file and make a view of it. \param data must outlive the view.
+  ///
+  /// The out indexes, the block index and the framing of the stream are
+  /// checked against size, so later reads stay in bounds; this reads the
+  /// whole stream once. Decoded destinations are not range checked here (see
+  /// DecodeBlock).
+  static katana::Result<CompressedCSRTopologyView> Make(
+      const void* data, uint64_t size) {
+    const auto* header = static_cast<const CSRTopologyHeader*>(data);
+    if (size < sizeof(*header) ||
+        header->version != kCompressedCSRTopologyVersion) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "not a compressed topology");
+    }
+    // Compare counts rather than sizes so that corrupt counts cannot
+    // overflow
+    uint64_t num_nodes = header->num_nodes;
+    uint64_t num_words = (size - sizeof(*header)) / sizeof(uint64_t);
+    if (num_nodes >= num_words ||
+        CompressedCSRNumBlocks(num_nodes) + 1 > num_words - num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "topology size: {} too small for {} nodes", size, num_nodes);
+    }
+    uint64_t num_blocks = CompressedCSRNumBlocks(num_nodes);
+    uint64_t stream_start =
+        sizeof(*header) + (num_nodes + num_blocks + 1) * sizeof(uint64_t);
+    CompressedCSRTopologyView view(data);
+    uint64_t stream_size = view.block_offsets_[num_blocks];
+    if (stream_size > size - stream_start) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "topology size: {} expected {}", size,
+          stream_start + stream_size);
+    }
+
+    uint64_t prev_index = 0;
+    for (uint64_t n = 0; n < num_nodes; ++n) {
+      if (view.out_indexes_[n] < prev_index) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "out indexes decrease at node {}", n);
+      }
+      prev_index = view.out_indexes_[n];
+    }
+    if (prev_index != header->num_edges) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "out indexes do not match the number of edges");
+    }
+
+    // Each block must hold exactly its edges: one byte without the high bit
+    // ends each destination, and the last byte of a block ends one
+    if (view.block_offsets_[0] != 0) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "stream does not start at offset 0");
+    }
+    for (uint64_t block = 0; block < num_blocks; ++block) {
+      uint64_t begin = view.block_offsets_[block];
+      uint64_t end = view.block_offsets_[block + 1];
+      if (end < begin) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "block offsets decrease at block {}",
+            block);
+      }
+      uint64_t first = block * kCompressedCSRBlockNodes;
+      uint64_t last = std::min(first + kCompressedCSRBlockNodes, num_nodes);
+      uint64_t num_block_edges = view.EdgeBegin(last) - view.EdgeBegin(first);
+      uint64_t num_ends = 0;
+      uint64_t run = 0;
+      for (uint64_t i = begin; i < end; ++i) {
+        if (view.stream_[i] & 0x80) {
+          if (++run >= kMaxEncodedSize) {
+            return KATANA_ERROR(
+                ErrorCode::InvalidArgument,
+                "destination longer than {} bytes in block {}",
+                kMaxEncodedSize, block);
+          }
+        } else {
+          run = 0;
+          ++num_ends;
+        }
+      }
+      if (num_ends != num_block_edges || run != 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "block {} encodes {} destinations but has {} edges", block,
+            num_ends, num_block_edges);
+      }
+    }
+    return view;
+  }
+
+  uint64_t num_nodes() const { return header_->num_nodes; }
+  uint64_t num_edges() const { return header_->num_edges; }
+
+  /// out_indexes()[n] is one past the last out-edge of node n
+  const uint64_t* out_indexes() const { return out_indexes_; }
+
+  /// \returns the destinations of the out-edges of \param node in edge order
+  NeighborRange neighbors(uint64_t node) const {
+    uint64_t degree = EdgeBegin(node + 1) - EdgeBegin(node);
+    return NeighborRange{
+        NeighborIterator(Seek(node), node, degree),
+        NeighborIterator(nullptr, 0, 0)};
+  }
+
+  /// Decode the destinations of the out-edges of the nodes in block \param
+  /// block into \param out, which must have room for them
+  /// \returns false if a destination is not a node of the graph
+  template <typename Dest>
+  bool DecodeBlock(uint64_t block, Dest* out) const {
+    uint64_t first = block * kCompressedCSRBlockNodes;
+    uint64_t last = std::min(first + kCompressedCSRBlockNodes, num_nodes());
+    const uint8_t* pos = stream_ + block_offsets_[block];
+    bool in_range = true;
+    for (uint64_t node = first, e = EdgeBegin(first); node < last; ++node) {
+      uint64_t dest = node;
+      for (uint64_t end = out_indexes_[node]; e < end; ++e) {
+        pos = CompressedCSRDecode(pos, dest, &dest);
+        in_range &= dest < num_nodes();
+        *out++ = static_cast<Dest>(dest);
+      }
+    }
+    return in_range;
+  }
+
+private:
+  /// A zigzag encoded uint64_t takes at most 10 bytes
+  static constexpr uint64_t kMaxEncodedSize = 10;
+
+  explicit CompressedCSRTopologyView(const void* data)
+      : header_(static_cast<const CSRTopologyHeader*>(data)),
+        out_indexes_(reinterpret_cast<const uint64_t*>(header_ + 1)),
+        block_offsets_(out_indexes_ + header_->num_nodes),
+        stream_(reinterpret_cast<const uint8_t*>(
+            block_offsets_ + CompressedCSRNumBlocks(header_->num_nodes) + 1)) {
+  }
+
+  uint64_t EdgeBegin(uint64_t node) const {
+    return node > 0 ? out_indexes_[node - 1] : 0;
+  }
+
+  /// \returns the position in the stream of the first edge of \param node
+  const uint8_t* Seek(uint64_t node) const {
+    uint64_t block_first = node - node % kCompressedCSRBlockNodes;
+    const uint8_t* pos =
+        stream_ + block_offsets_[node / kCompressedCSRBlockNodes];
+    // Every encoded destination ends with a byte without the high bit
+    for (uint64_t skip = EdgeBegin(node) - EdgeBegin(block_first); skip > 0;
+         ++pos) {
+      if ((*pos & 0x80) == 0) {
+        --skip;
+      }
+    }
+    return pos;
+  }
+
+  const CSRTopologyHeader* header_;
+  const uint64_t* out_indexes_;
+  const uint64_t* block_offsets_;
+  const uint8_t* stream_;
+};
+
 }  // namespace tsuba
 
 #endif
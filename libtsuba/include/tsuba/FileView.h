@@ -28,6 +28,9 @@ class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
   int64_t mem_start_{0};
   std::string filename_;
   bool valid_{false};
+  /// True if map_start_ maps the file itself rather than a buffer filled from
+  /// storage
+  bool zero_copy_{false};
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
 
@@ -44,6 +47,7 @@ public:
         mem_start_(other.mem_start_),
         filename_(std::move(other.filename_)),
         valid_(other.valid_),
+        zero_copy_(other.zero_copy_),
         filling_(std::move(other.filling_)),
         fetches_(std::move(other.fetches_)) {
     other.valid_ = false;
@@ -61,6 +65,7 @@ public:
       mem_start_ = other.mem_start_;
       filename_ = std::move(other.filename_);
       valid_ = other.valid_;
+      zero_copy_ = other.zero_copy_;
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
@@ -81,6 +86,12 @@ public:
   /// Calls to Read will handle asynchronous
   /// reads internally, but if you intend to use ptr(), you should pass
   /// resolve=true.
+  ///
+  /// Files on the local file system are mapped directly (copy-on-write) so
+  /// that the whole file is available without copying and processes share
+  /// page cache pages; begin, end and resolve then only decide which pages
+  /// the kernel reads ahead. Set KATANA_LOCAL_FILE_MMAP=0 to read local files
+  /// into private memory instead.
   katana::Result<void> Bind(
       std::string_view filename, uint64_t begin, uint64_t end, bool resolve);
   katana::Result<void> Bind(
@@ -95,6 +106,9 @@ public:
 
   bool Valid() const { return valid_; }
 
+  /// Does this view map the file directly, without a copy
+  bool zero_copy() const { return zero_copy_; }
+
   katana::Result<void> Unbind();
 
   /// Be very careful with this function. It is the caller's responsibility to
@@ -144,6 +158,9 @@ public:
   ///// End arrow::io::RandomAccessFile methods ///////
 
 private:
+  // Map local file path of the given size at map_start_
+  katana::Result<void> MapLocalFile(const std::string& path, uint64_t size);
+
   // Given the size of some region, how many pages does it take up?
   uint64_t page_number(uint64_t size);
 
@@ -0,0 +1,51 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_GRAPHSTATISTICS_H_
+#define KATANA_LIBTSUBA_TSUBA_GRAPHSTATISTICS_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace tsuba {
+
+/// Summary of the topology and types of a partition. It is computed when a
+/// graph is stored and kept in the part header so that readers can plan
+/// without a pass over the graph.
+struct GraphStatistics {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  uint64_t max_out_degree{0};
+  uint64_t max_in_degree{0};
+  /// Degree histograms with logarithmic buckets: bucket 0 counts nodes of
+  /// degree 0 and bucket i > 0 counts nodes with degree in [2^(i-1), 2^i).
+  /// Trailing empty buckets are omitted.
+  std::vector<uint64_t> out_degree_histogram;
+  std::vector<uint64_t> in_degree_histogram;
+  /// True if the out-edges of every node are ordered by destination
+  bool edges_sorted{false};
+  uint64_t num_self_loops{0};
+  /// Number of edges that have the same source and destination as an
+  /// earlier edge
+  uint64_t num_duplicate_edges{0};
+  /// Number of nodes (edges) of each type. Empty if types were not
+  /// constructed when the statistics were computed.
+  std::map<std::string, uint64_t> node_type_counts;
+  std::map<std::string, uint64_t> edge_type_counts;
+
+  double average_degree() const {
+    return num_nodes == 0 ? 0.0 : static_cast<double>(num_edges) / num_nodes;
+  }
+
+  static uint32_t DegreeBucket(uint64_t degree) {
+    uint32_t bucket = 0;
+    while (degree != 0) {
+      degree >>= 1;
+      ++bucket;
+    }
+    return bucket;
+  }
+};
+
+}  // namespace tsuba
+
+#endif
@@ -29,9 +29,14 @@ public:
     bool make_cannonical{true};
 
     /// if provided, slice the resulting table so that it only contains
-    /// Slice.length rows starting from Slice.offset
+    /// Slice.length rows starting from Slice.offset. Only the row groups that
+    /// overlap the slice are fetched and decoded.
     std::optional<Slice> slice{std::nullopt};
 
+    /// if true (default) decode row groups, or the columns of a single row
+    /// group, in parallel
+    bool use_threads{true};
+
     static ReadOpts Defaults() { return ReadOpts{}; }
   };
 
@@ -47,8 +52,8 @@ public:
   katana::Result<std::shared_ptr<arrow::Table>> ReadTable(
       const katana::Uri& uri);
 
-  /// read part of a table from storage
-  /// n.b. support for the `slice` read option is missing here
+  /// read part of a table from storage; only the chosen columns are fetched
+  /// and decoded
   ///   \param uri an identifier for a parquet file
   ///   \param column_bitmap must have the same length as the number of columns
   ///      in the table in the parquet file. The loaded table will only contain
@@ -57,7 +62,6 @@ public:
       const katana::Uri& uri, const std::vector<int32_t>& column_bitmap);
 
   /// read a column part of a table from storage
-  /// n.b. support for the `slice` read option is missing here
   ///   \param uri an identifier for a parquet file
   ///   \param column_idx must be a valid column index for the table in that
   ///      file
@@ -72,22 +76,30 @@ public:
   ///   \param uri an identifier for a parquet file
   katana::Result<int64_t> NumRows(const katana::Uri& uri);
 
+  /// Get the schema of the table stored in a parquet file, as ReadTable
+  /// would return it, without reading the table
+  ///   \param uri an identifier for a parquet file
+  katana::Result<std::shared_ptr<arrow::Schema>> GetSchema(
+      const katana::Uri& uri);
+
 private:
-  ParquetReader(std::optional<Slice> slice, bool make_cannonical)
-      : slice_(slice), make_cannonical_{make_cannonical} {}
+  ParquetReader(
+      std::optional<Slice> slice, bool make_cannonical, bool use_threads)
+      : slice_(slice),
+        make_cannonical_{make_cannonical},
+        use_threads_{use_threads} {}
 
-  katana::Result<std::shared_ptr<arrow::Table>> ReadFromUriSliced(
-      const katana::Uri& uri);
+  /// read the columns at \param column_indexes (all columns if nullptr) of
+  /// the rows in slice_ (all rows if there is no slice)
+  katana::Result<std::shared_ptr<arrow::Table>> DoRead(
+      const katana::Uri& uri, const std::vector<int32_t>* column_indexes);
 
   katana::Result<std::shared_ptr<arrow::Table>> FixTable(
       std::shared_ptr<arrow::Table>&& _table);
 
-  katana::Result<std::shared_ptr<arrow::Table>> DoFilteredTableRead(
-      parquet::arrow::FileReader* reader, const arrow::Schema& schema,
-      const std::vector<int32_t>& filter);
-
   std::optional<Slice> slice_;
   bool make_cannonical_;
+  bool use_threads_;
 };
 
 }  // namespace tsuba
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include <arrow/api.h>
@@ -15,6 +16,7 @@
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/FileView.h"
+#include "tsuba/GraphStatistics.h"
 #include "tsuba/PartitionMetadata.h"
 #include "tsuba/RDGLineage.h"
 #include "tsuba/ReadGroup.h"
@@ -38,6 +40,11 @@ struct KATANA_EXPORT RDGLoadOptions {
   /// List of edge properties that should be loaded
   /// nullptr means all edge properties will be loaded
   const std::vector<std::string>* edge_properties{nullptr};
+  /// If true, properties that are not in the lists above are not dropped but
+  /// registered as unloaded; they are fetched from storage on demand (see
+  /// RDG::EnsureNodePropertyLoaded). A nullptr list then means no properties
+  /// are loaded eagerly.
+  bool lazy_load_properties{false};
 };
 
 class KATANA_EXPORT RDG {
@@ -57,11 +64,13 @@ public:
   bool Equals(const RDG& other) const;
 
   /// Store this RDG at \param handle; if \param ff is not null, it is persisted
-  /// as the topology for this RDG. Add \param command_line to metadata to aid
-  /// in tracking lineage
+  /// as the topology for this RDG. If \param in_ff is not null, it is persisted
+  /// as the in-edge index for this RDG. Add \param command_line to metadata to
+  /// aid in tracking lineage
   katana::Result<void> Store(
       RDGHandle handle, const std::string& command_line,
-      std::unique_ptr<FileFrame> ff = nullptr);
+      std::unique_ptr<FileFrame> ff = nullptr,
+      std::unique_ptr<FileFrame> in_ff = nullptr);
 
   katana::Result<void> AddNodeProperties(
       const std::shared_ptr<arrow::Table>& props);
@@ -78,6 +87,35 @@ public:
   katana::Result<void> RemoveNodeProperty(uint32_t i);
   katana::Result<void> RemoveEdgeProperty(uint32_t i);
 
+  /// Make sure node property \param name is in memory, loading it from
+  /// storage if it is unloaded. Loaded properties are appended to
+  /// node_properties(). Returns PropertyNotFound if there is no such property.
+  katana::Result<void> EnsureNodePropertyLoaded(const std::string& name);
+  katana::Result<void> EnsureEdgePropertyLoaded(const std::string& name);
+  /// Load all unloaded node and edge properties
+  katana::Result<void> EnsureAllPropertiesLoaded();
+
+  /// Release the memory of node property \param name. The property remains
+  /// part of this RDG and can be loaded again. Only properties whose current
+  /// value is in storage can be unloaded.
+  katana::Result<void> UnloadNodeProperty(const std::string& name);
+  katana::Result<void> UnloadEdgeProperty(const std::string& name);
+
+  /// Remove unloaded node property \param name from this RDG without loading
+  /// it
+  katana::Result<void> RemoveUnloadedNodeProperty(const std::string& name);
+  katana::Result<void> RemoveUnloadedEdgeProperty(const std::string& name);
+
+  bool HasUnloadedNodeProperty(const std::string& name) const;
+  bool HasUnloadedEdgeProperty(const std::string& name) const;
+
+  /// The type of unloaded node property \param name, read from storage
+  /// without loading the property
+  katana::Result<std::shared_ptr<arrow::DataType>> UnloadedNodePropertyType(
+      const std::string& name) const;
+  katana::Result<std::shared_ptr<arrow::DataType>> UnloadedEdgePropertyType(
+      const std::string& name) const;
+
   void MarkAllPropertiesPersistent();
 
   katana::Result<void> MarkNodePropertiesPersistent(
@@ -93,6 +131,14 @@ public:
 
   katana::Result<void> UnbindTopologyFileStorage();
 
+  /// Map the in-edge index of this RDG into memory. The index is optional and
+  /// is not loaded by Make; callers should check has_in_topology_file first.
+  katana::Result<void> BindInTopologyFileStorage();
+
+  /// Forget the in-edge index of this RDG, e.g., because the topology it was
+  /// derived from has changed
+  katana::Result<void> UnbindInTopologyFileStorage();
+
   /// Inform this RDG that it's topology is in storage at this location
   /// without loading it into memory. \param new_top must exist and be in
   /// the correct directory for this RDG
@@ -116,12 +162,18 @@ public:
   uint32_t partition_id() const { return partition_id_; }
   void set_partition_id(uint32_t partition_id) { partition_id_ = partition_id; }
 
-  /// The node properties
+  /// The node properties that are in memory
   const std::shared_ptr<arrow::Table>& node_properties() const;
 
-  /// The edge properties
+  /// The edge properties that are in memory
   const std::shared_ptr<arrow::Table>& edge_properties() const;
 
+  /// Names of the node properties that are in storage but not in memory
+  std::vector<std::string> unloaded_node_property_names() const;
+
+  /// Names of the edge properties that are in storage but not in memory
+  std::vector<std::string> unloaded_edge_property_names() const;
+
   const std::vector<std::shared_ptr<arrow::ChunkedArray>>& master_nodes()
       const {
     return master_nodes_;
@@ -173,8 +225,18 @@ public:
   const PartitionMetadata& part_metadata() const;
   void set_part_metadata(const PartitionMetadata& metadata);
 
+  /// Statistics of the topology, if they were stored with this RDG or set
+  /// since it was loaded. They are written by the next Store.
+  const std::optional<GraphStatistics>& statistics() const;
+  void set_statistics(std::optional<GraphStatistics> statistics);
+
   const FileView& topology_file_storage() const;
 
+  /// Does this RDG have an in-edge index, either in storage or in memory
+  bool has_in_topology_file() const;
+
+  const FileView& in_topology_file_storage() const;
+
 private:
   RDG(std::unique_ptr<RDGCore>&& core);
 
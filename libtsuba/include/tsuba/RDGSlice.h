@@ -30,6 +30,8 @@ public:
   struct SliceArg {
     std::pair<uint64_t, uint64_t> node_range;
     std::pair<uint64_t, uint64_t> edge_range;
+    /// Byte range of the topology file to map; only uncompressed (version 1
+    /// and 2) topology files can be sliced
     uint64_t topo_off;
     uint64_t topo_size;
   };
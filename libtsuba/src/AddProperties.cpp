@@ -73,6 +73,33 @@ tsuba::LoadPropertySlice(
   }
 }
 
+katana::Result<std::shared_ptr<arrow::DataType>>
+tsuba::LoadPropertyType(
+    const std::string& expected_name, const katana::Uri& file_path) {
+  try {
+    auto reader_res = tsuba::ParquetReader::Make();
+    if (!reader_res) {
+      return reader_res.error().WithContext("reading property type");
+    }
+    auto schema_res = reader_res.value()->GetSchema(file_path);
+    if (!schema_res) {
+      return schema_res.error().WithContext("reading property type");
+    }
+    std::shared_ptr<arrow::Schema> schema = std::move(schema_res.value());
+    if (schema->num_fields() != 1 ||
+        schema->field(0)->name() != expected_name) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::InvalidArgument,
+          "expected only field {} found {} instead", expected_name,
+          schema->ToString());
+    }
+    return schema->field(0)->type();
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+  }
+}
+
 katana::Result<void>
 tsuba::AddProperties(
     const katana::Uri& uri,
@@ -17,6 +17,11 @@ KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadPropertySlice(
     const std::string& expected_name, const katana::Uri& file_path,
     int64_t offset, int64_t length);
 
+/// Read the type of the property stored at \param file_path without loading
+/// it
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::DataType>>
+LoadPropertyType(const std::string& expected_name, const katana::Uri& file_path);
+
 KATANA_EXPORT katana::Result<void> AddProperties(
     const katana::Uri& uri,
     const std::vector<tsuba::PropStorageInfo>& properties, ReadGroup* grp,
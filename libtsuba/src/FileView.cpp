@@ -1,12 +1,19 @@
 #include "tsuba/FileView.h"
 
+#include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
 #include <cassert>
+#include <cerrno>
 #include <cstdio>
+#include <optional>
 #include <string>
+#include <system_error>
 
+#include "GlobalState.h"
+#include "LocalStorage.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "tsuba/Errors.h"
@@ -30,6 +37,29 @@
  * somehow and also tell users to not modify our files?
  */
 
+namespace {
+
+// Direct mappings start on a huge page boundary so that the kernel can back
+// them with huge pages where the file system supports it
+constexpr uint64_t kHugePageSize = UINT64_C(2) << 20; /* 2M */
+
+/// Return the local path of filename if it should be mapped directly
+std::optional<std::string>
+ZeroCopyPath(const std::string& filename) {
+  bool use_mmap = true;
+  katana::GetEnv("KATANA_LOCAL_FILE_MMAP", &use_mmap);
+  if (!use_mmap) {
+    return std::nullopt;
+  }
+  auto* local = dynamic_cast<tsuba::LocalStorage*>(tsuba::FS(filename));
+  if (local == nullptr) {
+    return std::nullopt;
+  }
+  return local->LocalPath(filename);
+}
+
+}  // namespace
+
 namespace tsuba {
 
 FileView::~FileView() {
@@ -52,10 +82,65 @@ FileView::Unbind() {
       }
     }
     valid_ = false;
+    zero_copy_ = false;
   }
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+FileView::MapLocalFile(const std::string& path, uint64_t size) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", path);
+  }
+
+  // Reserve enough address space to align the start of the mapping
+  uint64_t reserve_size = size + kHugePageSize;
+  void* reserve = mmap(
+      nullptr, reserve_size, PROT_NONE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (reserve == MAP_FAILED) {
+    close(fd);
+    return KATANA_ERROR(katana::ResultErrno(), "reserving contiguous range");
+  }
+  auto* reserve_start = static_cast<uint8_t*>(reserve);
+  auto* reserve_end = reserve_start + reserve_size;
+  auto* start = reinterpret_cast<uint8_t*>(
+      (reinterpret_cast<uintptr_t>(reserve) + kHugePageSize - 1) &
+      ~(kHugePageSize - 1));
+
+  // Private and writable so that callers that modify the data in place (e.g.,
+  // sorting edges) get a copy of only the pages they touch
+  void* tmp = mmap(
+      start, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+  int map_errno = errno;
+  close(fd);
+  if (tmp == MAP_FAILED) {
+    munmap(reserve, reserve_size);
+    return KATANA_ERROR(
+        std::error_code(map_errno, std::system_category()), "mapping {}",
+        path);
+  }
+
+  // Release the parts of the reservation around the mapping
+  uint64_t page_size = sysconf(_SC_PAGESIZE);
+  uint8_t* map_end = start + (size + page_size - 1) / page_size * page_size;
+  if (start > reserve_start) {
+    munmap(reserve_start, start - reserve_start);
+  }
+  if (reserve_end > map_end) {
+    munmap(map_end, reserve_end - map_end);
+  }
+
+  if (size >= kHugePageSize) {
+    // Only a hint; fails on kernels without huge page support for files
+    madvise(start, size, MADV_HUGEPAGE);
+  }
+
+  map_start_ = start;
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 FileView::Bind(
     std::string_view filename, uint64_t begin, uint64_t end, bool resolve) {
@@ -71,6 +156,27 @@ FileView::Bind(
         "begin is larger than end or the size of the file");
   }
 
+  if (auto path = ZeroCopyPath(filename_); path && buf.size > 0) {
+    if (auto res = Unbind(); !res) {
+      return res.error().WithContext("resetting for new content");
+    }
+    if (auto res = MapLocalFile(path.value(), buf.size); !res) {
+      return res.error();
+    }
+    page_shift_ = 20; /* 1M */
+    zero_copy_ = true;
+    mem_start_ = 0;
+    file_size_ = buf.size;
+    filling_.clear();
+    fetches_ = std::make_unique<std::vector<FillingRange>>();
+    if (auto res = Fill(begin, in_end, resolve); !res) {
+      return res.error().WithContext("reading content");
+    }
+    cursor_ = 0;
+    valid_ = true;
+    return katana::ResultSuccess();
+  }
+
   // SCB 2020-07-23: Given that page_shift_ is treated as a compile-time
   // constant, it seems silly to have it be a member of this class. But I can
   // imagine one day wanting to set it dynamically based on file type, file
@@ -117,6 +223,16 @@ FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   if (!fetches_) {
     return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
   }
+  if (zero_copy_) {
+    // The whole file is already mapped; pages are read from the page cache
+    // on first access. Start reading the range if it will be needed soon.
+    if (resolve && in_end != in_begin) {
+      uint64_t page_size = sysconf(_SC_PAGESIZE);
+      uint64_t off = in_begin / page_size * page_size;
+      madvise(map_start_ + off, in_end - off, MADV_WILLNEED);
+    }
+    return katana::ResultSuccess();
+  }
   // Gracefully handle the fill zero case here to simplify Bind
   if (in_end != in_begin) {
     if (auto opt =
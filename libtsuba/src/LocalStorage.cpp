@@ -7,13 +7,16 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <cerrno>
 #include <fstream>
 #include <iterator>
+#include <memory>
 #include <system_error>
 
 #include <boost/filesystem.hpp>
 
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "katana/Uri.h"
@@ -22,6 +25,143 @@
 
 namespace fs = boost::filesystem;
 
+namespace {
+
+/// Requests larger than this are split into chunks transferred in parallel
+constexpr uint64_t kIOChunkSize = UINT64_C(8) << 20; /* 8M */
+constexpr int kDefaultMaxIOThreads = 16;
+constexpr int kDefaultQueueDepthPerThread = 4;
+
+class FileDescriptor {
+public:
+  explicit FileDescriptor(int fd) : fd_(fd) {}
+  FileDescriptor(const FileDescriptor& no_copy) = delete;
+  FileDescriptor& operator=(const FileDescriptor& no_copy) = delete;
+  ~FileDescriptor() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  int fd() const { return fd_; }
+
+private:
+  int fd_;
+};
+
+/// Collects the results of the chunks of one request and completes the
+/// request when the last chunk finishes
+class SplitRequest {
+public:
+  SplitRequest(
+      std::shared_ptr<FileDescriptor> file, std::string path, bool is_read,
+      uint64_t size, uint64_t num_chunks)
+      : file_(std::move(file)),
+        path_(std::move(path)),
+        is_read_(is_read),
+        size_(size),
+        remaining_(num_chunks) {}
+
+  int fd() const { return file_->fd(); }
+
+  std::future<katana::Result<void>> GetFuture() {
+    return promise_.get_future();
+  }
+
+  void FinishChunk(const katana::Result<uint64_t>& res) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (res) {
+      transferred_ += res.value();
+    } else if (result_) {
+      result_ = res.error();
+    }
+    if (--remaining_ > 0) {
+      return;
+    }
+    file_.reset();
+    promise_.set_value(Finalize());
+  }
+
+private:
+  katana::Result<void> Finalize() {
+    if (!result_) {
+      return result_.error().WithContext(
+          "{} {}", is_read_ ? "reading" : "writing", path_);
+    }
+    // if the difference in what was read from what we wanted is less than a
+    // block it's because the file size isn't well aligned so don't complain.
+    if (is_read_ && size_ - transferred_ > tsuba::kBlockSize) {
+      return KATANA_ERROR(
+          tsuba::ErrorCode::LocalStorageError,
+          "short read: {}: expected {} bytes got {}", path_, size_,
+          transferred_);
+    }
+    return katana::ResultSuccess();
+  }
+
+  std::shared_ptr<FileDescriptor> file_;
+  std::string path_;
+  bool is_read_;
+  uint64_t size_;
+  uint64_t remaining_;
+  uint64_t transferred_{0};
+  katana::Result<void> result_{katana::ResultSuccess()};
+  std::mutex mutex_;
+  std::promise<katana::Result<void>> promise_;
+};
+
+/// Read up to size bytes at offset; stops early at end of file
+katana::Result<uint64_t>
+PRead(int fd, uint8_t* data, uint64_t size, uint64_t offset) {
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t ret = pread(fd, data + done, size - done, offset + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "pread");
+    }
+    if (ret == 0) {
+      break;
+    }
+    done += ret;
+  }
+  return done;
+}
+
+katana::Result<uint64_t>
+PWrite(int fd, const uint8_t* data, uint64_t size, uint64_t offset) {
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t ret = pwrite(fd, data + done, size - done, offset + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "pwrite");
+    }
+    done += ret;
+  }
+  return done;
+}
+
+std::future<katana::Result<void>>
+MakeReadyFuture(katana::Result<void> res) {
+  std::promise<katana::Result<void>> promise;
+  promise.set_value(std::move(res));
+  return promise.get_future();
+}
+
+uint64_t
+NumChunks(uint64_t size) {
+  return std::max<uint64_t>(1, (size + kIOChunkSize - 1) / kIOChunkSize);
+}
+
+}  // namespace
+
+tsuba::LocalStorage::~LocalStorage() { StopWorkers(); }
+
 void
 tsuba::LocalStorage::CleanUri(std::string* uri) {
   if (uri->find(uri_scheme()) != 0) {
@@ -31,30 +171,149 @@ tsuba::LocalStorage::CleanUri(std::string* uri) {
 }
 
 katana::Result<void>
-tsuba::LocalStorage::WriteFile(
-    std::string uri, const uint8_t* data, uint64_t size) {
-  CleanUri(&uri);
-  fs::path m_path{uri};
+tsuba::LocalStorage::Init() {
+  KATANA_LOG_DEBUG_ASSERT(workers_.empty());
+
+  int num_threads = std::min<int>(
+      std::thread::hardware_concurrency(), kDefaultMaxIOThreads);
+  katana::GetEnv("KATANA_LOCAL_IO_THREADS", &num_threads);
+  num_threads = std::max(num_threads, 0);
+
+  int queue_depth = kDefaultQueueDepthPerThread * num_threads;
+  katana::GetEnv("KATANA_LOCAL_IO_QUEUE_DEPTH", &queue_depth);
+  max_queue_depth_ = std::max(queue_depth, 1);
+
+  stopping_ = false;
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this]() { WorkerLoop(); });
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::LocalStorage::Fini() {
+  StopWorkers();
+  return katana::ResultSuccess();
+}
+
+void
+tsuba::LocalStorage::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  not_empty_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+void
+tsuba::LocalStorage::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+      // Drain the queue before stopping so that no request is left pending
+      if (queue_.empty()) {
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    not_full_.notify_one();
+    task();
+  }
+}
+
+void
+tsuba::LocalStorage::Submit(std::function<void()> task) {
+  if (workers_.empty()) {
+    task();
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this]() { return queue_.size() < max_queue_depth_; });
+    queue_.emplace_back(std::move(task));
+  }
+  not_empty_.notify_one();
+}
+
+std::future<katana::Result<void>>
+tsuba::LocalStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  std::string path = uri;
+  CleanUri(&path);
+  fs::path m_path{path};
   fs::path dir = m_path.parent_path();
   if (!dir.empty()) {
     if (boost::system::error_code err; !fs::create_directories(dir, err)) {
       if (err) {
-        return KATANA_ERROR(
+        return MakeReadyFuture(KATANA_ERROR(
             std::error_code(err.value(), err.category()),
-            "creating parent directories");
+            "creating parent directories"));
       }
     }
   }
 
-  std::ofstream ofile(uri);
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "opening file");
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
+    return MakeReadyFuture(KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening file: {}: {}", path,
+        katana::ResultErrno().message()));
   }
-  ofile.write(reinterpret_cast<const char*>(data), size); /* NOLINT */
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "writing file");
+  auto file = std::make_shared<FileDescriptor>(fd);
+  if (ftruncate(fd, size) != 0) {
+    return MakeReadyFuture(KATANA_ERROR(
+        ErrorCode::LocalStorageError, "sizing file: {}: {}", path,
+        katana::ResultErrno().message()));
   }
-  return katana::ResultSuccess();
+
+  uint64_t num_chunks = NumChunks(size);
+  auto request = std::make_shared<SplitRequest>(
+      std::move(file), path, false, size, num_chunks);
+  auto future = request->GetFuture();
+  for (uint64_t i = 0; i < num_chunks; ++i) {
+    uint64_t offset = i * kIOChunkSize;
+    uint64_t len = std::min(kIOChunkSize, size - offset);
+    Submit([request, data, offset, len]() {
+      request->FinishChunk(PWrite(request->fd(), data + offset, len, offset));
+    });
+  }
+  return future;
+}
+
+std::future<katana::Result<void>>
+tsuba::LocalStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  std::string path = uri;
+  CleanUri(&path);
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return MakeReadyFuture(KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening file: {}: {}", path,
+        katana::ResultErrno().message()));
+  }
+  auto file = std::make_shared<FileDescriptor>(fd);
+
+  uint64_t num_chunks = NumChunks(size);
+  auto request = std::make_shared<SplitRequest>(
+      std::move(file), path, true, size, num_chunks);
+  auto future = request->GetFuture();
+  for (uint64_t i = 0; i < num_chunks; ++i) {
+    uint64_t offset = i * kIOChunkSize;
+    uint64_t len = std::min(kIOChunkSize, size - offset);
+    Submit([request, result_buf, start, offset, len]() {
+      request->FinishChunk(
+          PRead(request->fd(), result_buf + offset, len, start + offset));
+    });
+  }
+  return future;
 }
 
 katana::Result<void>
@@ -83,30 +342,6 @@ tsuba::LocalStorage::RemoteCopyFile(
   return katana::ResultSuccess();
 }
 
-katana::Result<void>
-tsuba::LocalStorage::ReadFile(
-    std::string uri, uint64_t start, uint64_t size, uint8_t* data) {
-  CleanUri(&uri);
-  std::ifstream ifile(uri);
-
-  ifile.seekg(start);
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to seek");
-  }
-
-  ifile.read(reinterpret_cast<char*>(data), size); /* NOLINT */
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to read");
-  }
-
-  // if the difference in what was read from what we wanted is less  than a
-  // block it's because the file size isn't well aligned so don't complain.
-  if (size - ifile.gcount() > kBlockSize) {
-    return ErrorCode::LocalStorageError;
-  }
-  return katana::ResultSuccess();
-}
-
 katana::Result<void>
 tsuba::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
   std::string filename = uri;
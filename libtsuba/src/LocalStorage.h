@@ -3,46 +3,76 @@
 
 #include <sys/mman.h>
 
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <future>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "katana/Result.h"
 #include "tsuba/FileStorage.h"
 
 namespace tsuba {
 
-/// Store byte arrays to the local file system; Provided as a convenience for
-/// testing only (un-optimized)
+/// Store byte arrays to the local file system
+///
+/// Reads and writes are done with pread/pwrite by a bounded pool of I/O
+/// threads so that asynchronous requests overlap with each other and with the
+/// caller. Large requests are split into chunks that are transferred in
+/// parallel. Submitting work blocks while the queue is full, which bounds the
+/// number of outstanding chunks. The number of threads is set by
+/// KATANA_LOCAL_IO_THREADS (0 means do all I/O synchronously in the caller)
+/// and the maximum number of queued chunks by KATANA_LOCAL_IO_QUEUE_DEPTH.
 class LocalStorage : public FileStorage {
   void CleanUri(std::string* uri);
-  katana::Result<void> WriteFile(
-      std::string, const uint8_t* data, uint64_t size);
-  katana::Result<void> ReadFile(
-      std::string uri, uint64_t start, uint64_t size, uint8_t* data);
   katana::Result<void> RemoteCopyFile(
       std::string source_uri, std::string dest_uri, uint64_t begin,
       uint64_t size);
 
+  /// Run task on an I/O thread, or in the caller if there are no I/O threads;
+  /// blocks while the queue is full
+  void Submit(std::function<void()> task);
+  void WorkerLoop();
+  void StopWorkers();
+
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> queue_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  size_t max_queue_depth_{0};
+  bool stopping_{false};
+
 public:
   LocalStorage() : FileStorage("file://") {}
+  ~LocalStorage() override;
 
-  katana::Result<void> Init() override { return katana::ResultSuccess(); }
-  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
   katana::Result<void> Stat(const std::string& uri, StatBuf* size) override;
 
   uint32_t Priority() const override { return 1; }
 
+  /// The path in the local file system of \param uri
+  std::string LocalPath(const std::string& uri) {
+    std::string path = uri;
+    CleanUri(&path);
+    return path;
+  }
+
   katana::Result<void> GetMultiSync(
       const std::string& uri, uint64_t start, uint64_t size,
       uint8_t* result_buf) override {
-    return ReadFile(uri, start, size, result_buf);
+    return GetAsync(uri, start, size, result_buf).get();
   }
 
   katana::Result<void> PutMultiSync(
       const std::string& uri, const uint8_t* data, uint64_t size) override {
-    return WriteFile(uri, data, size);
+    return PutAsync(uri, data, size).get();
   }
 
   katana::Result<void> RemoteCopy(
@@ -51,28 +81,13 @@ public:
     return RemoteCopyFile(source_uri, dest_uri, begin, size);
   }
 
-  // get on future can potentially block (bulk synchronous parallel)
+  // get on future can potentially block (bulk synchronous parallel); data
+  // must remain valid until the future is ready
   std::future<katana::Result<void>> PutAsync(
-      const std::string& uri, const uint8_t* data, uint64_t size) override {
-    // No need for AsyncPut to local storage right now
-    if (auto write_res = WriteFile(uri, data, size); !write_res) {
-      return std::async(
-          [=]() -> katana::Result<void> { return write_res.error(); });
-    }
-    return std::async(
-        []() -> katana::Result<void> { return katana::ResultSuccess(); });
-  }
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
   std::future<katana::Result<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    // I suppose there is no need for AsyncGet to local storage either
-    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
-      return std::async(
-          [=]() -> katana::Result<void> { return read_res.error(); });
-    }
-    return std::async(
-        []() -> katana::Result<void> { return katana::ResultSuccess(); });
-  }
+      uint8_t* result_buf) override;
   std::future<katana::Result<void>> ListAsync(
       const std::string& uri, std::vector<std::string>* list,
       std::vector<uint64_t>* size) override;
@@ -1,11 +1,21 @@
 #include "tsuba/ParquetReader.h"
 
-#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
 #include <memory>
-#include <unordered_map>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <utility>
 
 #include <arrow/chunked_array.h>
+#include <arrow/table.h>
 #include <arrow/type.h>
+#include <parquet/arrow/schema.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
 
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
@@ -95,19 +105,200 @@ MakeFileReader(
   return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
 }
 
+/// LeafColumns appends the indexes of the parquet columns that store
+/// \param field to \param leaves
+void
+LeafColumns(
+    const parquet::arrow::SchemaField& field, std::vector<int>* leaves) {
+  if (field.is_leaf()) {
+    leaves->emplace_back(field.column_index);
+    return;
+  }
+  for (const auto& child : field.children) {
+    LeafColumns(child, leaves);
+  }
+}
+
+/// Column chunks that are closer than this in the file are fetched with a
+/// single request
+constexpr int64_t kCoalesceGap = 1 << 20;
+
+/// ColumnChunkRanges returns the sorted, coalesced byte ranges [begin, end)
+/// of the chunks of \param leaves in \param row_groups
+std::vector<std::pair<int64_t, int64_t>>
+ColumnChunkRanges(
+    const parquet::FileMetaData& md, const std::vector<int>& row_groups,
+    const std::vector<int>& leaves) {
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  for (int rg : row_groups) {
+    auto rg_md = md.RowGroup(rg);
+    for (int leaf : leaves) {
+      auto col_md = rg_md->ColumnChunk(leaf);
+      int64_t begin = col_md->data_page_offset();
+      if (col_md->has_dictionary_page() &&
+          col_md->dictionary_page_offset() > 0 &&
+          col_md->dictionary_page_offset() < begin) {
+        begin = col_md->dictionary_page_offset();
+      }
+      ranges.emplace_back(begin, begin + col_md->total_compressed_size());
+    }
+  }
+  std::sort(ranges.begin(), ranges.end());
+
+  std::vector<std::pair<int64_t, int64_t>> coalesced;
+  for (const auto& range : ranges) {
+    if (!coalesced.empty() &&
+        range.first <= coalesced.back().second + kCoalesceGap) {
+      coalesced.back().second = std::max(coalesced.back().second, range.second);
+    } else {
+      coalesced.emplace_back(range);
+    }
+  }
+  return coalesced;
+}
+
+Result<std::shared_ptr<arrow::Table>>
+ReadRowGroupBatch(
+    parquet::arrow::FileReader* reader, const std::vector<int>& row_groups,
+    const std::vector<int>& leaves) {
+  std::shared_ptr<arrow::Table> out;
+  auto status = reader->ReadRowGroups(row_groups, leaves, &out);
+  if (!status.ok()) {
+    return KATANA_ERROR(ErrorCode::ArrowError, "arrow error: {}", status);
+  }
+  return out;
+}
+
+/// Threads decoding row groups for all readers in the process, in addition
+/// to the threads that called them. Readers are often used concurrently, one
+/// per property, so this keeps them from starting a thread per core each.
+std::atomic<int64_t> extra_decode_threads{0};
+
+/// DecodeThreadReservation holds up to a requested number of the extra decode
+/// threads until it is destroyed
+class DecodeThreadReservation {
+public:
+  explicit DecodeThreadReservation(int64_t wanted) {
+    int64_t limit =
+        std::max<int64_t>(std::thread::hardware_concurrency(), 1) - 1;
+    int64_t current = extra_decode_threads.load();
+    while (true) {
+      int64_t n = std::min(wanted, limit - current);
+      if (n <= 0) {
+        return;
+      }
+      if (extra_decode_threads.compare_exchange_weak(current, current + n)) {
+        num_ = n;
+        return;
+      }
+    }
+  }
+  ~DecodeThreadReservation() { extra_decode_threads -= num_; }
+  DecodeThreadReservation(const DecodeThreadReservation&) = delete;
+  DecodeThreadReservation& operator=(const DecodeThreadReservation&) = delete;
+
+  int64_t size() const { return num_; }
+
+private:
+  int64_t num_{0};
+};
+
+/// ReadRowGroupBatchWithNewReader is ReadRowGroupBatch with its own reader
+/// over \param fv and \param md, so that it can run concurrently with other
+/// batches
+Result<std::shared_ptr<arrow::Table>>
+ReadRowGroupBatchWithNewReader(
+    const std::shared_ptr<tsuba::FileView>& fv,
+    const std::shared_ptr<parquet::FileMetaData>& md,
+    const std::vector<int>& row_groups, const std::vector<int>& leaves) {
+  std::unique_ptr<parquet::arrow::FileReader> batch_reader;
+  try {
+    auto status = parquet::arrow::FileReader::Make(
+        arrow::default_memory_pool(),
+        parquet::ParquetFileReader::Open(
+            fv, parquet::default_reader_properties(), md),
+        &batch_reader);
+    if (!status.ok()) {
+      return KATANA_ERROR(ErrorCode::ArrowError, "arrow error: {}", status);
+    }
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "opening parquet reader: {}", exp.what());
+  }
+  return ReadRowGroupBatch(batch_reader.get(), row_groups, leaves);
+}
+
+/// ReadRowGroups decodes \param leaves of \param row_groups. Contiguous
+/// batches of row groups are decoded concurrently, one by the calling thread
+/// and the others by as many extra threads as are free process-wide, each
+/// with its own reader over the same file and metadata. A single batch is
+/// decoded by \param reader with a task per column.
+Result<std::shared_ptr<arrow::Table>>
+ReadRowGroups(
+    parquet::arrow::FileReader* reader,
+    const std::shared_ptr<tsuba::FileView>& fv,
+    const std::vector<int>& row_groups, const std::vector<int>& leaves,
+    bool use_threads) {
+  std::optional<DecodeThreadReservation> reservation;
+  if (use_threads && row_groups.size() > 1) {
+    reservation.emplace(static_cast<int64_t>(row_groups.size()) - 1);
+  }
+  size_t num_batches = 1 + (reservation ? reservation->size() : 0);
+  if (num_batches <= 1) {
+    reader->set_use_threads(use_threads);
+    return ReadRowGroupBatch(reader, row_groups, leaves);
+  }
+
+  std::shared_ptr<parquet::FileMetaData> md =
+      reader->parquet_reader()->metadata();
+  std::vector<std::vector<int>> batches;
+  for (size_t i = 0; i < num_batches; ++i) {
+    batches.emplace_back(
+        row_groups.begin() + row_groups.size() * i / num_batches,
+        row_groups.begin() + row_groups.size() * (i + 1) / num_batches);
+  }
+  std::vector<std::future<Result<std::shared_ptr<arrow::Table>>>> futures;
+  for (size_t i = 1; i < num_batches; ++i) {
+    futures.emplace_back(std::async(
+        std::launch::async, ReadRowGroupBatchWithNewReader, fv, md,
+        std::cref(batches[i]), std::cref(leaves)));
+  }
+
+  reader->set_use_threads(false);
+  std::vector<Result<std::shared_ptr<arrow::Table>>> results;
+  results.emplace_back(ReadRowGroupBatch(reader, batches[0], leaves));
+  for (auto& future : futures) {
+    results.emplace_back(future.get());
+  }
+
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  for (auto& res : results) {
+    if (!res) {
+      return res.error();
+    }
+    tables.emplace_back(std::move(res.value()));
+  }
+
+  auto concat_res = arrow::ConcatenateTables(tables);
+  if (!concat_res.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "arrow error: {}", concat_res.status());
+  }
+  return concat_res.ValueOrDie();
+}
+
 }  // namespace
 
 Result<std::unique_ptr<tsuba::ParquetReader>>
 tsuba::ParquetReader::Make(ReadOpts opts) {
   return std::unique_ptr<ParquetReader>(
-      new ParquetReader(opts.slice, opts.make_cannonical));
+      new ParquetReader(opts.slice, opts.make_cannonical, opts.use_threads));
 }
 
-// Internal use only, invoke iff slice_ has a value
 Result<std::shared_ptr<arrow::Table>>
-tsuba::ParquetReader::ReadFromUriSliced(const katana::Uri& uri) {
-  auto slice = slice_.value();
-  if (slice.offset < 0 || slice.length < 0) {
+tsuba::ParquetReader::DoRead(
+    const katana::Uri& uri, const std::vector<int32_t>* column_indexes) {
+  if (slice_ && (slice_->offset < 0 || slice_->length < 0)) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument,
         "slice offset and length must be non-negative");
@@ -120,146 +311,111 @@ tsuba::ParquetReader::ReadFromUriSliced(const katana::Uri& uri) {
   }
   std::unique_ptr<parquet::arrow::FileReader> reader(
       std::move(reader_res.value()));
+  std::shared_ptr<parquet::FileMetaData> md =
+      reader->parquet_reader()->metadata();
+  const auto& schema_fields = reader->manifest().schema_fields;
+  auto num_fields = static_cast<int32_t>(schema_fields.size());
+
+  // Columns to decode, in file order and without repeats
+  std::vector<int32_t> fields;
+  if (column_indexes != nullptr) {
+    for (int32_t idx : *column_indexes) {
+      if (idx < 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "column indexes must be positive");
+      }
+      if (idx >= num_fields) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "column index {} should be less than the number of columns {}",
+            idx, num_fields);
+      }
+    }
+    fields = *column_indexes;
+    std::sort(fields.begin(), fields.end());
+    fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+  } else {
+    fields.resize(num_fields);
+    std::iota(fields.begin(), fields.end(), 0);
+  }
+  std::vector<int> leaves;
+  for (int32_t idx : fields) {
+    LeafColumns(schema_fields[idx], &leaves);
+  }
 
+  // Row groups that overlap the slice
   std::vector<int> row_groups;
-  int rg_count = reader->num_row_groups();
   int64_t row_offset = 0;
   int64_t cumulative_rows = 0;
-  int64_t file_offset = 0;
-  int64_t cumulative_bytes = 0;
-  int64_t last_row = slice.offset + slice.length;
-  for (int i = 0; cumulative_rows < last_row && i < rg_count; ++i) {
-    auto rg_md = reader->parquet_reader()->metadata()->RowGroup(i);
-    int64_t new_rows = rg_md->num_rows();
-    int64_t new_bytes = rg_md->total_byte_size();
-    if (slice.offset < cumulative_rows + new_rows) {
+  for (int i = 0, rg_count = md->num_row_groups(); i < rg_count; ++i) {
+    int64_t new_rows = md->RowGroup(i)->num_rows();
+    if (slice_) {
+      if (cumulative_rows >= slice_->offset + slice_->length) {
+        break;
+      }
+      if (slice_->offset >= cumulative_rows + new_rows) {
+        cumulative_rows += new_rows;
+        continue;
+      }
       if (row_groups.empty()) {
-        row_offset = slice.offset - cumulative_rows;
-        file_offset = cumulative_bytes;
+        row_offset = slice_->offset - cumulative_rows;
       }
-      row_groups.push_back(i);
     }
+    row_groups.emplace_back(i);
     cumulative_rows += new_rows;
-    cumulative_bytes += new_bytes;
   }
 
-  if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
-    return res.error();
+  // Start fetching everything that will be decoded so that storage latency
+  // overlaps with decoding
+  for (const auto& [begin, end] : ColumnChunkRanges(*md, row_groups, leaves)) {
+    if (auto res = fv->Fill(begin, end, false); !res) {
+      return res.error();
+    }
   }
 
-  std::shared_ptr<arrow::Table> out;
-  auto read_result = reader->ReadRowGroups(row_groups, &out);
-  if (!read_result.ok()) {
-    return KATANA_ERROR(ErrorCode::ArrowError, "arrow error: {}", read_result);
+  auto table_res =
+      ReadRowGroups(reader.get(), fv, row_groups, leaves, use_threads_);
+  if (!table_res) {
+    return table_res.error();
   }
+  std::shared_ptr<arrow::Table> table(std::move(table_res.value()));
 
-  out = out->Slice(row_offset, slice.length);
-
-  return FixTable(std::move(out));
-}
-
-Result<std::shared_ptr<arrow::Table>>
-tsuba::ParquetReader::ReadTable(const katana::Uri& uri) {
   if (slice_) {
-    // logic for a sliced read is different enough not to bother trying
-    // to DRY these out
-    return ReadFromUriSliced(uri);
+    table = table->Slice(row_offset, slice_->length);
   }
 
-  auto reader_res =
-      MakeFileReader(uri, 0, std::numeric_limits<uint64_t>::max());
-  if (!reader_res) {
-    return reader_res.error();
+  if (column_indexes != nullptr) {
+    // table holds fields in file order; arrange them as requested
+    std::vector<std::shared_ptr<arrow::Field>> out_fields;
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> out_columns;
+    for (int32_t idx : *column_indexes) {
+      auto pos = std::lower_bound(fields.begin(), fields.end(), idx) -
+                 fields.begin();
+      out_fields.emplace_back(table->field(pos));
+      out_columns.emplace_back(table->column(pos));
+    }
+    table = arrow::Table::Make(
+        arrow::schema(out_fields), out_columns, table->num_rows());
   }
-  std::unique_ptr<parquet::arrow::FileReader> reader(
-      std::move(reader_res.value()));
 
-  std::shared_ptr<arrow::Table> out;
-  auto read_result = reader->ReadTable(&out);
-  if (!read_result.ok()) {
-    return KATANA_ERROR(ErrorCode::ArrowError, "arrow error: {}", read_result);
-  }
-  return FixTable(std::move(out));
+  return FixTable(std::move(table));
 }
 
 Result<std::shared_ptr<arrow::Table>>
-tsuba::ParquetReader::DoFilteredTableRead(
-    parquet::arrow::FileReader* reader, const arrow::Schema& schema,
-    const std::vector<int32_t>& indexes) {
-  if (slice_) {
-    // TODO(thunt) implement this
-    return KATANA_ERROR(
-        ErrorCode::NotImplemented,
-        "sorry! missing support for sliced read when choosing columns");
-  }
-
-  std::vector<std::shared_ptr<arrow::Field>> fields;
-  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
-  std::unordered_map<int32_t, std::shared_ptr<arrow::ChunkedArray>> read_arrays;
-  for (int32_t idx : indexes) {
-    if (idx < 0) {
-      return KATANA_ERROR(
-          ErrorCode::InvalidArgument, "column indexes must be positive");
-    }
-    if (idx >= schema.num_fields()) {
-      return KATANA_ERROR(
-          ErrorCode::InvalidArgument,
-          "column index {} should be less than the number of columns {}", idx,
-          schema.num_fields());
-    }
-    std::shared_ptr<arrow::ChunkedArray> column;
-    if (auto arr_it = read_arrays.find(idx); arr_it != read_arrays.end()) {
-      column = arr_it->second;
-    } else {
-      auto status = reader->ReadColumn(idx, &column);
-      if (!status.ok()) {
-        return KATANA_ERROR(
-            ErrorCode::ArrowError, "reading column {}: {}", idx, status);
-      }
-      read_arrays.emplace(idx, column);
-    }
-    fields.emplace_back(schema.field(idx));
-    columns.emplace_back(std::move(column));
-  }
-  return FixTable(arrow::Table::Make(arrow::schema(fields), columns));
+tsuba::ParquetReader::ReadTable(const katana::Uri& uri) {
+  return DoRead(uri, nullptr);
 }
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadColumn(const katana::Uri& uri, int32_t column_idx) {
-  auto reader_res = MakeFileReader(uri, 0, 0);
-  if (!reader_res) {
-    return reader_res.error();
-  }
-  std::unique_ptr<parquet::arrow::FileReader> reader(
-      std::move(reader_res.value()));
-
-  std::shared_ptr<arrow::Schema> schema;
-  auto status = reader->GetSchema(&schema);
-  if (!status.ok()) {
-    return KATANA_ERROR(ErrorCode::ArrowError, "reading schema: {}", status);
-  }
-
-  return DoFilteredTableRead(
-      reader.get(), *schema, std::vector<int32_t>{column_idx});
+  std::vector<int32_t> column_indexes{column_idx};
+  return DoRead(uri, &column_indexes);
 }
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadTable(
     const katana::Uri& uri, const std::vector<int32_t>& column_indexes) {
-  auto reader_res = MakeFileReader(uri, 0, 0);
-  if (!reader_res) {
-    return reader_res.error();
-  }
-  std::unique_ptr<parquet::arrow::FileReader> reader(
-      std::move(reader_res.value()));
-
-  std::shared_ptr<arrow::Schema> schema;
-  auto status = reader->GetSchema(&schema);
-  if (!status.ok()) {
-    return KATANA_ERROR(ErrorCode::ArrowError, "reading schema: {}", status);
-  }
-
-  return DoFilteredTableRead(reader.get(), *schema, column_indexes);
+  return DoRead(uri, &column_indexes);
 }
 
 Result<int32_t>
@@ -285,6 +441,35 @@ tsuba::ParquetReader::NumRows(const katana::Uri& uri) {
   return reader->parquet_reader()->metadata()->num_rows();
 }
 
+Result<std::shared_ptr<arrow::Schema>>
+tsuba::ParquetReader::GetSchema(const katana::Uri& uri) {
+  auto reader_res = MakeFileReader(uri, 0, 0);
+  if (!reader_res) {
+    return reader_res.error();
+  }
+  std::unique_ptr<parquet::arrow::FileReader> reader(
+      std::move(reader_res.value()));
+
+  std::shared_ptr<arrow::Schema> schema;
+  if (auto status = reader->GetSchema(&schema); !status.ok()) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "reading schema of {}: {}", uri, status);
+  }
+  if (!make_cannonical_) {
+    return schema;
+  }
+  // Match the types of the columns that FixTable converts
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (const auto& field : schema->fields()) {
+    if (field->type()->id() == arrow::Type::type::STRING) {
+      fields.emplace_back(field->WithType(arrow::large_utf8()));
+    } else {
+      fields.emplace_back(field);
+    }
+  }
+  return arrow::schema(fields, schema->metadata());
+}
+
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::FixTable(std::shared_ptr<arrow::Table>&& _table) {
   std::shared_ptr<arrow::Table> table(std::move(_table));
@@ -3,7 +3,9 @@
 #include <cassert>
 #include <exception>
 #include <fstream>
+#include <iomanip>
 #include <memory>
+#include <optional>
 #include <regex>
 #include <unordered_set>
 
@@ -356,6 +358,21 @@ tsuba::RDG::DoStore(
     core_->part_header().set_topology_path(t_path.BaseName());
   }
 
+  if (core_->part_header().in_topology_path().empty() &&
+      core_->in_topology_file_storage().Valid()) {
+    // In-edge index is mapped from another RDG; copy it here
+    katana::Uri t_path = handle.impl_->rdg_meta().dir().RandFile("in_topology");
+
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+
+    // depends on `in_topology_file_storage_` outliving writes
+    write_group->StartStore(
+        t_path.string(), core_->in_topology_file_storage().ptr<uint8_t>(),
+        core_->in_topology_file_storage().size());
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    core_->part_header().set_in_topology_path(t_path.BaseName());
+  }
+
   auto node_write_result = WriteProperties(
       *core_->node_properties(), core_->part_header().node_prop_info_list(),
       handle.impl_->rdg_meta().dir(), write_group.get());
@@ -509,9 +526,17 @@ tsuba::RDG::Make(const RDGMeta& meta, const RDGLoadOptions& opts) {
 
   RDG rdg(std::make_unique<RDGCore>(std::move(part_header_res.value())));
 
-  if (auto res = rdg.core_->part_header().PrunePropsTo(
-          opts.node_properties, opts.edge_properties);
-      !res) {
+  if (opts.lazy_load_properties) {
+    std::vector<std::string> none;
+    if (auto res = rdg.core_->part_header().UnloadPropsNotIn(
+            opts.node_properties ? opts.node_properties : &none,
+            opts.edge_properties ? opts.edge_properties : &none);
+        !res) {
+      return res.error();
+    }
+  } else if (auto res = rdg.core_->part_header().PrunePropsTo(
+                 opts.node_properties, opts.edge_properties);
+             !res) {
     return res.error();
   }
 
@@ -549,7 +574,7 @@ tsuba::RDG::Make(RDGHandle handle, const RDGLoadOptions& opts) {
 katana::Result<void>
 tsuba::RDG::Store(
     RDGHandle handle, const std::string& command_line,
-    std::unique_ptr<FileFrame> ff) {
+    std::unique_ptr<FileFrame> ff, std::unique_ptr<FileFrame> in_ff) {
   if (!handle.impl_->AllowsWrite()) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "handle does not allow write");
@@ -563,6 +588,17 @@ tsuba::RDG::Store(
       handle.impl_->rdg_meta().policy_id(), tsuba::Comm()->Num,
       core_->part_header().metadata().policy_id_);
   if (handle.impl_->rdg_meta().dir() != rdg_dir_) {
+    // Make sure a stored in-edge index is in memory so that it can be copied
+    // to the new location
+    if (!in_ff && has_in_topology_file()) {
+      if (auto res = BindInTopologyFileStorage(); !res) {
+        return res.error();
+      }
+    }
+    // Likewise for unloaded properties
+    if (auto res = EnsureAllPropertiesLoaded(); !res) {
+      return res.error();
+    }
     core_->part_header().UnbindFromStorage();
   }
 
@@ -583,11 +619,35 @@ tsuba::RDG::Store(
     core_->part_header().set_topology_path(t_path.BaseName());
   }
 
-  return DoStore(handle, command_line, std::move(desc));
+  if (in_ff) {
+    katana::Uri t_path = handle.impl_->rdg_meta().dir().RandFile("in_topology");
+
+    in_ff->Bind(t_path.string());
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    desc->StartStore(std::move(in_ff));
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    core_->part_header().set_in_topology_path(t_path.BaseName());
+  }
+
+  if (auto res = DoStore(handle, command_line, std::move(desc)); !res) {
+    return res.error();
+  }
+
+  // Stored paths are now relative to the new location; later loads of
+  // unloaded properties must read from there
+  rdg_dir_ = handle.impl_->rdg_meta().dir();
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
 tsuba::RDG::AddNodeProperties(const std::shared_ptr<arrow::Table>& props) {
+  for (const std::string& name : props->ColumnNames()) {
+    if (HasUnloadedNodeProperty(name)) {
+      return KATANA_ERROR(
+          ErrorCode::Exists, "node property {} exists but is not loaded",
+          std::quoted(name));
+    }
+  }
   if (auto res = core_->AddNodeProperties(props); !res) {
     return res.error();
   }
@@ -603,6 +663,13 @@ tsuba::RDG::AddNodeProperties(const std::shared_ptr<arrow::Table>& props) {
 
 katana::Result<void>
 tsuba::RDG::AddEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
+  for (const std::string& name : props->ColumnNames()) {
+    if (HasUnloadedEdgeProperty(name)) {
+      return KATANA_ERROR(
+          ErrorCode::Exists, "edge property {} exists but is not loaded",
+          std::quoted(name));
+    }
+  }
   if (auto res = core_->AddEdgeProperties(props); !res) {
     return res.error();
   }
@@ -623,6 +690,10 @@ tsuba::RDG::UpsertNodeProperties(const std::shared_ptr<arrow::Table>& props) {
   }
 
   AddNodePropStorageInfo(core_.get(), props);
+  // New values replace any unloaded ones
+  for (const std::string& name : props->ColumnNames()) {
+    core_->part_header().TakeUnloadedNodeProp(name);
+  }
 
   KATANA_LOG_DEBUG_ASSERT(
       static_cast<size_t>(core_->node_properties()->num_columns()) ==
@@ -638,6 +709,10 @@ tsuba::RDG::UpsertEdgeProperties(const std::shared_ptr<arrow::Table>& props) {
   }
 
   AddEdgePropStorageInfo(core_.get(), props);
+  // New values replace any unloaded ones
+  for (const std::string& name : props->ColumnNames()) {
+    core_->part_header().TakeUnloadedEdgeProp(name);
+  }
 
   KATANA_LOG_DEBUG_ASSERT(
       static_cast<size_t>(core_->edge_properties()->num_columns()) ==
@@ -656,6 +731,189 @@ tsuba::RDG::RemoveEdgeProperty(uint32_t i) {
   return core_->RemoveEdgeProperty(i);
 }
 
+katana::Result<void>
+tsuba::RDG::EnsureNodePropertyLoaded(const std::string& name) {
+  if (core_->node_properties()->GetColumnByName(name)) {
+    return katana::ResultSuccess();
+  }
+  std::optional<PropStorageInfo> pmd =
+      core_->part_header().TakeUnloadedNodeProp(name);
+  if (!pmd) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "node property {} not found",
+        std::quoted(name));
+  }
+
+  auto res = AddProperties(
+      rdg_dir_, {*pmd}, nullptr,
+      [rdg = this](const std::shared_ptr<arrow::Table>& props) {
+        return rdg->core_->AddNodeProperties(props);
+      });
+  if (!res) {
+    core_->part_header().AddUnloadedNodeProp(std::move(pmd.value()));
+    return res.error().WithContext("loading node property");
+  }
+  // Keeps the stored path, so the property is not rewritten on store
+  core_->part_header().AddNodePropStorageInfo(std::move(pmd.value()));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDG::EnsureEdgePropertyLoaded(const std::string& name) {
+  if (core_->edge_properties()->GetColumnByName(name)) {
+    return katana::ResultSuccess();
+  }
+  std::optional<PropStorageInfo> pmd =
+      core_->part_header().TakeUnloadedEdgeProp(name);
+  if (!pmd) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "edge property {} not found",
+        std::quoted(name));
+  }
+
+  auto res = AddProperties(
+      rdg_dir_, {*pmd}, nullptr,
+      [rdg = this](const std::shared_ptr<arrow::Table>& props) {
+        return rdg->core_->AddEdgeProperties(props);
+      });
+  if (!res) {
+    core_->part_header().AddUnloadedEdgeProp(std::move(pmd.value()));
+    return res.error().WithContext("loading edge property");
+  }
+  // Keeps the stored path, so the property is not rewritten on store
+  core_->part_header().AddEdgePropStorageInfo(std::move(pmd.value()));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDG::UnloadNodeProperty(const std::string& name) {
+  int i = core_->node_properties()->schema()->GetFieldIndex(name);
+  if (i < 0) {
+    if (HasUnloadedNodeProperty(name)) {
+      return katana::ResultSuccess();
+    }
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "node property {} not found",
+        std::quoted(name));
+  }
+  PropStorageInfo pmd = core_->part_header().node_prop_info_list()[i];
+  if (pmd.path.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "node property {} has not been stored and cannot be unloaded",
+        std::quoted(name));
+  }
+  if (auto res = core_->RemoveNodeProperty(i); !res) {
+    return res.error();
+  }
+  core_->part_header().AddUnloadedNodeProp(std::move(pmd));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDG::UnloadEdgeProperty(const std::string& name) {
+  int i = core_->edge_properties()->schema()->GetFieldIndex(name);
+  if (i < 0) {
+    if (HasUnloadedEdgeProperty(name)) {
+      return katana::ResultSuccess();
+    }
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "edge property {} not found",
+        std::quoted(name));
+  }
+  PropStorageInfo pmd = core_->part_header().edge_prop_info_list()[i];
+  if (pmd.path.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "edge property {} has not been stored and cannot be unloaded",
+        std::quoted(name));
+  }
+  if (auto res = core_->RemoveEdgeProperty(i); !res) {
+    return res.error();
+  }
+  core_->part_header().AddUnloadedEdgeProp(std::move(pmd));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDG::RemoveUnloadedNodeProperty(const std::string& name) {
+  if (!core_->part_header().TakeUnloadedNodeProp(name)) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "unloaded node property {} not found",
+        std::quoted(name));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::RDG::RemoveUnloadedEdgeProperty(const std::string& name) {
+  if (!core_->part_header().TakeUnloadedEdgeProp(name)) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "unloaded edge property {} not found",
+        std::quoted(name));
+  }
+  return katana::ResultSuccess();
+}
+
+bool
+tsuba::RDG::HasUnloadedNodeProperty(const std::string& name) const {
+  const auto& list = core_->part_header().unloaded_node_prop_info_list();
+  return std::any_of(list.begin(), list.end(), [&](const auto& pmd) {
+    return pmd.name == name;
+  });
+}
+
+bool
+tsuba::RDG::HasUnloadedEdgeProperty(const std::string& name) const {
+  const auto& list = core_->part_header().unloaded_edge_prop_info_list();
+  return std::any_of(list.begin(), list.end(), [&](const auto& pmd) {
+    return pmd.name == name;
+  });
+}
+
+katana::Result<std::shared_ptr<arrow::DataType>>
+tsuba::RDG::UnloadedNodePropertyType(const std::string& name) const {
+  const auto& list = core_->part_header().unloaded_node_prop_info_list();
+  auto it = std::find_if(list.begin(), list.end(), [&](const auto& pmd) {
+    return pmd.name == name;
+  });
+  if (it == list.end()) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "unloaded node property {} not found",
+        std::quoted(name));
+  }
+  return LoadPropertyType(name, rdg_dir_.Join(it->path));
+}
+
+katana::Result<std::shared_ptr<arrow::DataType>>
+tsuba::RDG::UnloadedEdgePropertyType(const std::string& name) const {
+  const auto& list = core_->part_header().unloaded_edge_prop_info_list();
+  auto it = std::find_if(list.begin(), list.end(), [&](const auto& pmd) {
+    return pmd.name == name;
+  });
+  if (it == list.end()) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "unloaded edge property {} not found",
+        std::quoted(name));
+  }
+  return LoadPropertyType(name, rdg_dir_.Join(it->path));
+}
+
+katana::Result<void>
+tsuba::RDG::EnsureAllPropertiesLoaded() {
+  for (const std::string& name : unloaded_node_property_names()) {
+    if (auto res = EnsureNodePropertyLoaded(name); !res) {
+      return res.error();
+    }
+  }
+  for (const std::string& name : unloaded_edge_property_names()) {
+    if (auto res = EnsureEdgePropertyLoaded(name); !res) {
+      return res.error();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 void
 tsuba::RDG::MarkAllPropertiesPersistent() {
   core_->part_header().MarkAllPropertiesPersistent();
@@ -683,6 +941,16 @@ tsuba::RDG::set_part_metadata(const tsuba::PartitionMetadata& metadata) {
   core_->part_header().set_metadata(metadata);
 }
 
+const std::optional<tsuba::GraphStatistics>&
+tsuba::RDG::statistics() const {
+  return core_->part_header().statistics();
+}
+
+void
+tsuba::RDG::set_statistics(std::optional<tsuba::GraphStatistics> statistics) {
+  core_->part_header().set_statistics(std::move(statistics));
+}
+
 const std::shared_ptr<arrow::Table>&
 tsuba::RDG::node_properties() const {
   return core_->node_properties();
@@ -693,6 +961,24 @@ tsuba::RDG::edge_properties() const {
   return core_->edge_properties();
 }
 
+std::vector<std::string>
+tsuba::RDG::unloaded_node_property_names() const {
+  std::vector<std::string> names;
+  for (const auto& pmd : core_->part_header().unloaded_node_prop_info_list()) {
+    names.emplace_back(pmd.name);
+  }
+  return names;
+}
+
+std::vector<std::string>
+tsuba::RDG::unloaded_edge_property_names() const {
+  std::vector<std::string> names;
+  for (const auto& pmd : core_->part_header().unloaded_edge_prop_info_list()) {
+    names.emplace_back(pmd.name);
+  }
+  return names;
+}
+
 const tsuba::FileView&
 tsuba::RDG::topology_file_storage() const {
   return core_->topology_file_storage();
@@ -703,6 +989,35 @@ tsuba::RDG::UnbindTopologyFileStorage() {
   return core_->topology_file_storage().Unbind();
 }
 
+bool
+tsuba::RDG::has_in_topology_file() const {
+  return !core_->part_header().in_topology_path().empty() ||
+         core_->in_topology_file_storage().Valid();
+}
+
+const tsuba::FileView&
+tsuba::RDG::in_topology_file_storage() const {
+  return core_->in_topology_file_storage();
+}
+
+katana::Result<void>
+tsuba::RDG::BindInTopologyFileStorage() {
+  if (core_->in_topology_file_storage().Valid()) {
+    return katana::ResultSuccess();
+  }
+  if (core_->part_header().in_topology_path().empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "no in-edge index in RDG");
+  }
+  katana::Uri t_path = rdg_dir_.Join(core_->part_header().in_topology_path());
+  return core_->in_topology_file_storage().Bind(t_path.string(), true);
+}
+
+katana::Result<void>
+tsuba::RDG::UnbindInTopologyFileStorage() {
+  core_->part_header().set_in_topology_path("");
+  return core_->in_topology_file_storage().Unbind();
+}
+
 katana::Result<void>
 tsuba::RDG::SetTopologyFile(const katana::Uri& new_top) {
   katana::Uri dir = new_top.DirName();
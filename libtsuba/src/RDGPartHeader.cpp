@@ -27,6 +27,8 @@ const char* kNodePropertyKey = "kg.v1.node_property";
 const char* kEdgePropertyKey = "kg.v1.edge_property";
 const char* kPartPropertyFilesKey = "kg.v1.part_property_files";
 const char* kPartProperyMetaKey = "kg.v1.part_property_meta";
+const char* kInTopologyPathKey = "kg.v1.in_topology.path";
+const char* kStatisticsKey = "kg.v1.statistics";
 //
 //constexpr std::string_view  mirror_nodes_prop_name = "mirror_nodes";
 //constexpr std::string_view  master_nodes_prop_name = "master_nodes";
@@ -282,6 +284,43 @@ RDGPartHeader::PrunePropsTo(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+RDGPartHeader::UnloadPropsNotIn(
+    const std::vector<std::string>* node_props,
+    const std::vector<std::string>* edge_props) {
+  auto not_in = [](const std::vector<PropStorageInfo>& list,
+                   const std::vector<std::string>* names) {
+    std::vector<PropStorageInfo> ret;
+    if (names == nullptr) {
+      return ret;
+    }
+    std::unordered_set<std::string> keep(names->begin(), names->end());
+    for (const PropStorageInfo& pmd : list) {
+      if (keep.count(pmd.name) == 0) {
+        ret.emplace_back(pmd);
+      }
+    }
+    return ret;
+  };
+
+  std::vector<PropStorageInfo> node_unloaded =
+      not_in(node_prop_info_list_, node_props);
+  std::vector<PropStorageInfo> edge_unloaded =
+      not_in(edge_prop_info_list_, edge_props);
+
+  if (auto res = PrunePropsTo(node_props, edge_props); !res) {
+    return res.error();
+  }
+
+  for (PropStorageInfo& pmd : node_unloaded) {
+    AddUnloadedNodeProp(std::move(pmd));
+  }
+  for (PropStorageInfo& pmd : edge_unloaded) {
+    AddUnloadedEdgeProp(std::move(pmd));
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 RDGPartHeader::Validate() const {
   for (const auto& md : node_prop_info_list_) {
@@ -306,6 +345,11 @@ RDGPartHeader::Validate() const {
         ErrorCode::InvalidArgument,
         "topology_path doesn't contain a slash (/): {}", topology_path_);
   }
+  if (in_topology_path_.find('/') != std::string::npos) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "in_topology_path contains a slash (/): {}", in_topology_path_);
+  }
   return katana::ResultSuccess();
 }
 
@@ -362,6 +406,9 @@ RDGPartHeader::MarkEdgePropertiesPersistent(
 
 void
 RDGPartHeader::UnbindFromStorage() {
+  // Unloaded properties only exist in storage; load them first
+  KATANA_LOG_DEBUG_ASSERT(unloaded_node_prop_info_list_.empty());
+  KATANA_LOG_DEBUG_ASSERT(unloaded_edge_prop_info_list_.empty());
   for (PropStorageInfo& prop : node_prop_info_list_) {
     prop.path = "";
   }
@@ -372,6 +419,7 @@ RDGPartHeader::UnbindFromStorage() {
     prop.path = "";
   }
   topology_path_ = "";
+  in_topology_path_ = "";
 }
 
 }  // namespace tsuba
@@ -389,13 +437,30 @@ tsuba::to_json(json& j, const std::vector<tsuba::PropStorageInfo>& vec_pmd) {
 
 void
 tsuba::to_json(json& j, const tsuba::RDGPartHeader& header) {
+  std::vector<tsuba::PropStorageInfo> node_props =
+      header.node_prop_info_list_;
+  node_props.insert(
+      node_props.end(), header.unloaded_node_prop_info_list_.begin(),
+      header.unloaded_node_prop_info_list_.end());
+  std::vector<tsuba::PropStorageInfo> edge_props =
+      header.edge_prop_info_list_;
+  edge_props.insert(
+      edge_props.end(), header.unloaded_edge_prop_info_list_.begin(),
+      header.unloaded_edge_prop_info_list_.end());
+
   j = json{
       {kTopologyPathKey, header.topology_path_},
-      {kNodePropertyKey, header.node_prop_info_list_},
-      {kEdgePropertyKey, header.edge_prop_info_list_},
+      {kNodePropertyKey, node_props},
+      {kEdgePropertyKey, edge_props},
       {kPartPropertyFilesKey, header.part_prop_info_list_},
       {kPartProperyMetaKey, header.metadata_},
   };
+  if (!header.in_topology_path_.empty()) {
+    j[kInTopologyPathKey] = header.in_topology_path_;
+  }
+  if (header.statistics_) {
+    j[kStatisticsKey] = header.statistics_.value();
+  }
 }
 
 void
@@ -405,6 +470,14 @@ tsuba::from_json(const json& j, tsuba::RDGPartHeader& header) {
   j.at(kEdgePropertyKey).get_to(header.edge_prop_info_list_);
   j.at(kPartPropertyFilesKey).get_to(header.part_prop_info_list_);
   j.at(kPartProperyMetaKey).get_to(header.metadata_);
+  // optional; older RDGs do not have an in-edge index
+  if (auto it = j.find(kInTopologyPathKey); it != j.end()) {
+    it->get_to(header.in_topology_path_);
+  }
+  // optional; older RDGs do not have statistics
+  if (auto it = j.find(kStatisticsKey); it != j.end()) {
+    header.statistics_ = it->get<tsuba::GraphStatistics>();
+  }
 }
 
 void
@@ -451,6 +524,37 @@ tsuba::from_json(const json& j, tsuba::PartitionMetadata& pmd) {
   }
 }
 
+void
+tsuba::to_json(json& j, const tsuba::GraphStatistics& stats) {
+  j = json{
+      {"num_nodes", stats.num_nodes},
+      {"num_edges", stats.num_edges},
+      {"max_out_degree", stats.max_out_degree},
+      {"max_in_degree", stats.max_in_degree},
+      {"out_degree_histogram", stats.out_degree_histogram},
+      {"in_degree_histogram", stats.in_degree_histogram},
+      {"edges_sorted", stats.edges_sorted},
+      {"num_self_loops", stats.num_self_loops},
+      {"num_duplicate_edges", stats.num_duplicate_edges},
+      {"node_type_counts", stats.node_type_counts},
+      {"edge_type_counts", stats.edge_type_counts}};
+}
+
+void
+tsuba::from_json(const json& j, tsuba::GraphStatistics& stats) {
+  j.at("num_nodes").get_to(stats.num_nodes);
+  j.at("num_edges").get_to(stats.num_edges);
+  j.at("max_out_degree").get_to(stats.max_out_degree);
+  j.at("max_in_degree").get_to(stats.max_in_degree);
+  j.at("out_degree_histogram").get_to(stats.out_degree_histogram);
+  j.at("in_degree_histogram").get_to(stats.in_degree_histogram);
+  j.at("edges_sorted").get_to(stats.edges_sorted);
+  j.at("num_self_loops").get_to(stats.num_self_loops);
+  j.at("num_duplicate_edges").get_to(stats.num_duplicate_edges);
+  j.at("node_type_counts").get_to(stats.node_type_counts);
+  j.at("edge_type_counts").get_to(stats.edge_type_counts);
+}
+
 void
 tsuba::from_json(const nlohmann::json& j, tsuba::PropStorageInfo& propmd) {
   j.at(0).get_to(propmd.name);
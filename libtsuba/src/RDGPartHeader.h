@@ -1,7 +1,9 @@
 #ifndef KATANA_LIBTSUBA_RDGPARTHEADER_H_
 #define KATANA_LIBTSUBA_RDGPARTHEADER_H_
 
+#include <algorithm>
 #include <cassert>
+#include <optional>
 #include <vector>
 
 #include <arrow/api.h>
@@ -9,6 +11,7 @@
 #include "katana/JSON.h"
 #include "katana/Result.h"
 #include "katana/Uri.h"
+#include "tsuba/GraphStatistics.h"
 #include "tsuba/PartitionMetadata.h"
 #include "tsuba/WriteGroup.h"
 #include "tsuba/tsuba.h"
@@ -31,6 +34,12 @@ public:
       const std::vector<std::string>* node_props,
       const std::vector<std::string>* edge_props);
 
+  /// Like PrunePropsTo but properties that are not in the lists are kept as
+  /// unloaded properties: they remain part of the RDG and can be loaded later
+  katana::Result<void> UnloadPropsNotIn(
+      const std::vector<std::string>* node_props,
+      const std::vector<std::string>* edge_props);
+
   katana::Result<void> Write(RDGHandle handle, WriteGroup* writes) const;
 
   void UnbindFromStorage();
@@ -63,6 +72,34 @@ public:
     }
   }
 
+  //
+  // Unloaded properties are in storage but not in memory. They are not part
+  // of the property info lists above (which match the columns of the
+  // property tables) but are written with them.
+  //
+
+  void AddUnloadedNodeProp(PropStorageInfo&& pmd) {
+    KATANA_LOG_DEBUG_ASSERT(!pmd.path.empty());
+    pmd.persist = true;
+    unloaded_node_prop_info_list_.emplace_back(std::move(pmd));
+  }
+
+  void AddUnloadedEdgeProp(PropStorageInfo&& pmd) {
+    KATANA_LOG_DEBUG_ASSERT(!pmd.path.empty());
+    pmd.persist = true;
+    unloaded_edge_prop_info_list_.emplace_back(std::move(pmd));
+  }
+
+  /// Remove the unloaded node property called name and return it, if any
+  std::optional<PropStorageInfo> TakeUnloadedNodeProp(const std::string& name) {
+    return TakeProp(&unloaded_node_prop_info_list_, name);
+  }
+
+  /// Remove the unloaded edge property called name and return it, if any
+  std::optional<PropStorageInfo> TakeUnloadedEdgeProp(const std::string& name) {
+    return TakeProp(&unloaded_edge_prop_info_list_, name);
+  }
+
   void RemoveNodeProperty(uint32_t i) {
     auto& p = node_prop_info_list_;
     KATANA_LOG_DEBUG_ASSERT(i < p.size());
@@ -94,6 +131,12 @@ public:
   const std::string& topology_path() const { return topology_path_; }
   void set_topology_path(std::string path) { topology_path_ = std::move(path); }
 
+  /// Path of the optional in-edge (CSC) index; empty if there is none
+  const std::string& in_topology_path() const { return in_topology_path_; }
+  void set_in_topology_path(std::string path) {
+    in_topology_path_ = std::move(path);
+  }
+
   const std::vector<PropStorageInfo>& node_prop_info_list() const {
     return node_prop_info_list_;
   }
@@ -110,6 +153,14 @@ public:
     edge_prop_info_list_ = std::move(edge_prop_info_list);
   }
 
+  const std::vector<PropStorageInfo>& unloaded_node_prop_info_list() const {
+    return unloaded_node_prop_info_list_;
+  }
+
+  const std::vector<PropStorageInfo>& unloaded_edge_prop_info_list() const {
+    return unloaded_edge_prop_info_list_;
+  }
+
   const std::vector<PropStorageInfo>& part_prop_info_list() const {
     return part_prop_info_list_;
   }
@@ -120,6 +171,15 @@ public:
   const PartitionMetadata& metadata() const { return metadata_; }
   void set_metadata(const PartitionMetadata& metadata) { metadata_ = metadata; }
 
+  /// Statistics of the stored topology; nullopt for RDGs written before
+  /// statistics were recorded
+  const std::optional<GraphStatistics>& statistics() const {
+    return statistics_;
+  }
+  void set_statistics(std::optional<GraphStatistics> statistics) {
+    statistics_ = std::move(statistics);
+  }
+
   friend void to_json(nlohmann::json& j, const RDGPartHeader& header);
   friend void from_json(const nlohmann::json& j, RDGPartHeader& header);
 
@@ -129,14 +189,32 @@ private:
   static katana::Result<RDGPartHeader> MakeParquet(
       const katana::Uri& partition_path);
 
+  static std::optional<PropStorageInfo> TakeProp(
+      std::vector<PropStorageInfo>* list, const std::string& name) {
+    auto it = std::find_if(
+        list->begin(), list->end(),
+        [&](const PropStorageInfo& pmd) { return pmd.name == name; });
+    if (it == list->end()) {
+      return std::nullopt;
+    }
+    PropStorageInfo pmd = std::move(*it);
+    list->erase(it);
+    return pmd;
+  }
+
   std::vector<PropStorageInfo> part_prop_info_list_;
   std::vector<PropStorageInfo> node_prop_info_list_;
   std::vector<PropStorageInfo> edge_prop_info_list_;
+  std::vector<PropStorageInfo> unloaded_node_prop_info_list_;
+  std::vector<PropStorageInfo> unloaded_edge_prop_info_list_;
 
   /// Metadata filled in by CuSP, or from storage (meta partition file)
   PartitionMetadata metadata_;
 
+  std::optional<GraphStatistics> statistics_;
+
   std::string topology_path_;
+  std::string in_topology_path_;
 };
 
 void to_json(nlohmann::json& j, const RDGPartHeader& header);
@@ -151,6 +229,9 @@ void from_json(const nlohmann::json& j, PartitionMetadata& propmd);
 void to_json(
     nlohmann::json& j, const std::vector<tsuba::PropStorageInfo>& vec_pmd);
 
+void to_json(nlohmann::json& j, const GraphStatistics& stats);
+void from_json(const nlohmann::json& j, GraphStatistics& stats);
+
 }  // namespace tsuba
 
 #endif
@@ -4,7 +4,9 @@
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
 #include "katana/Logging.h"
+#include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
+#include "tsuba/file.h"
 
 katana::Result<void>
 tsuba::RDGSlice::DoMake(
@@ -12,6 +14,20 @@ tsuba::RDGSlice::DoMake(
   ReadGroup grp;
   katana::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
 
+  // Slice offsets index the destination array of uncompressed files; the
+  // varint stream of compressed files has no fixed offset per edge
+  CSRTopologyHeader header;
+  if (auto res = FileGet(t_path.string(), &header); !res) {
+    return res.error().WithContext("reading topology header");
+  }
+  if (header.version == kCompressedCSRTopologyVersion) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "slicing compressed topology {} is not supported; rewrite the graph "
+        "without PropertyGraph::set_compress_topology",
+        t_path);
+  }
+
   if (auto res = core_->topology_file_storage().Bind(
           t_path.string(), slice.topo_off, slice.topo_off + slice.topo_size,
           true);
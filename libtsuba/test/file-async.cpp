@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <future>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Uri.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+// Large enough that local storage splits requests into several chunks
+constexpr uint64_t kFileSize = (UINT64_C(20) << 20) + 12345;
+constexpr size_t kNumReaders = 8;
+
+std::vector<uint8_t>
+MakeData(uint64_t size) {
+  std::vector<uint8_t> data(size);
+  for (uint64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>((i * 31) ^ (i >> 8));
+  }
+  return data;
+}
+
+void
+TestRoundTrip(const std::string& dir) {
+  std::string file = katana::Uri::JoinPath(dir, "data");
+  std::vector<uint8_t> data = MakeData(kFileSize);
+
+  auto store_res = tsuba::FileStoreAsync(file, data.data(), data.size()).get();
+  KATANA_LOG_ASSERT(store_res);
+
+  tsuba::StatBuf stat;
+  KATANA_LOG_ASSERT(tsuba::FileStat(file, &stat));
+  KATANA_LOG_ASSERT(stat.size == kFileSize);
+
+  // Issue overlapping reads of different slices before waiting on any
+  uint64_t slice = kFileSize / kNumReaders;
+  std::vector<std::vector<uint8_t>> bufs(kNumReaders);
+  std::vector<std::future<katana::Result<void>>> futures;
+  for (size_t i = 0; i < kNumReaders; ++i) {
+    uint64_t begin = i * slice;
+    uint64_t size = (i + 1 == kNumReaders) ? kFileSize - begin : slice;
+    bufs[i].resize(size);
+    futures.emplace_back(
+        tsuba::FileGetAsync(file, bufs[i].data(), begin, size));
+  }
+  for (size_t i = 0; i < kNumReaders; ++i) {
+    auto res = futures[i].get();
+    KATANA_LOG_VASSERT(res, "reader {}: {}", i, res.error());
+    KATANA_LOG_ASSERT(std::equal(
+        bufs[i].begin(), bufs[i].end(), data.begin() + i * slice));
+  }
+
+  std::vector<uint8_t> all(kFileSize);
+  KATANA_LOG_ASSERT(tsuba::FileGet(file, all.data(), 0, kFileSize));
+  KATANA_LOG_ASSERT(all == data);
+
+  // Reading well past the end of the file is an error
+  std::vector<uint8_t> past_end(kFileSize + 2 * tsuba::kBlockSize);
+  KATANA_LOG_ASSERT(!tsuba::FileGet(file, past_end.data(), 0, past_end.size()));
+}
+
+void
+TestMissingFile(const std::string& dir) {
+  std::string file = katana::Uri::JoinPath(dir, "does-not-exist");
+  uint8_t buf[16];
+  KATANA_LOG_ASSERT(!tsuba::FileGetAsync(file, buf, 0, sizeof(buf)).get());
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/file-async");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());  // path() because local
+
+  TestRoundTrip(dir);
+  TestMissingFile(dir);
+
+  fs::remove_all(dir);
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
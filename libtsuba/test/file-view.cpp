@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/Uri.h"
+#include "tsuba/FileView.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+// Several 1M pages and not a multiple of the page size
+constexpr uint64_t kFileSize = (UINT64_C(5) << 20) + 4321;
+constexpr uint64_t kHugePageSize = UINT64_C(2) << 20;
+
+std::vector<uint8_t>
+MakeData(uint64_t size) {
+  std::vector<uint8_t> data(size);
+  for (uint64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>((i * 17) ^ (i >> 12));
+  }
+  return data;
+}
+
+void
+CheckRead(tsuba::FileView* fv, const std::vector<uint8_t>& data) {
+  constexpr int64_t kOffset = (INT64_C(3) << 20) - 7;
+  KATANA_LOG_ASSERT(fv->Seek(kOffset).ok());
+  std::vector<uint8_t> buf(1 << 20);
+  auto read_res = fv->Read(buf.size(), buf.data());
+  KATANA_LOG_ASSERT(read_res.ok());
+  KATANA_LOG_ASSERT(read_res.ValueOrDie() == static_cast<int64_t>(buf.size()));
+  KATANA_LOG_ASSERT(
+      std::equal(buf.begin(), buf.end(), data.begin() + kOffset));
+
+  // Reads past the end are cut short
+  KATANA_LOG_ASSERT(fv->Seek(kFileSize - 10).ok());
+  auto tail_res = fv->Read(100);
+  KATANA_LOG_ASSERT(tail_res.ok());
+  KATANA_LOG_ASSERT(tail_res.ValueOrDie()->size() == 10);
+}
+
+void
+TestMapped(const std::string& file, const std::vector<uint8_t>& data) {
+  tsuba::FileView fv;
+  // Bind only part of the file; a direct mapping still covers all of it
+  auto bind_res = fv.Bind(file, 0, 4096, true);
+  KATANA_LOG_VASSERT(bind_res, "binding: {}", bind_res.error());
+  KATANA_LOG_ASSERT(fv.zero_copy());
+  KATANA_LOG_ASSERT(fv.size() == kFileSize);
+  KATANA_LOG_ASSERT(
+      reinterpret_cast<uintptr_t>(fv.ptr<uint8_t>()) % kHugePageSize == 0);
+  KATANA_LOG_ASSERT(fv.valid_ptr<uint8_t>() == fv.ptr<uint8_t>());
+  KATANA_LOG_ASSERT(std::equal(data.begin(), data.end(), fv.begin()));
+
+  CheckRead(&fv, data);
+
+  // The mapping is copy-on-write: writes do not reach the file
+  auto* mem = const_cast<uint8_t*>(fv.ptr<uint8_t>());  // NOLINT
+  mem[0] = ~data[0];
+  mem[kFileSize - 1] = ~data[kFileSize - 1];
+  std::vector<uint8_t> on_disk(kFileSize);
+  KATANA_LOG_ASSERT(tsuba::FileGet(file, on_disk.data(), 0, kFileSize));
+  KATANA_LOG_ASSERT(on_disk == data);
+
+  // Moving transfers the mapping and unbinding releases it
+  tsuba::FileView moved(std::move(fv));
+  KATANA_LOG_ASSERT(!fv.Valid());
+  KATANA_LOG_ASSERT(moved.Valid() && moved.zero_copy());
+  KATANA_LOG_ASSERT(moved.ptr<uint8_t>()[0] == static_cast<uint8_t>(~data[0]));
+  KATANA_LOG_ASSERT(moved.Unbind());
+  KATANA_LOG_ASSERT(!moved.Valid() && !moved.zero_copy());
+
+  // Rebinding reads the file again
+  KATANA_LOG_ASSERT(moved.Bind(file, true));
+  KATANA_LOG_ASSERT(moved.ptr<uint8_t>()[0] == data[0]);
+}
+
+void
+TestCopied(const std::string& file, const std::vector<uint8_t>& data) {
+  KATANA_LOG_ASSERT(setenv("KATANA_LOCAL_FILE_MMAP", "0", 1) == 0);
+
+  tsuba::FileView fv;
+  KATANA_LOG_ASSERT(fv.Bind(file, true));
+  KATANA_LOG_ASSERT(!fv.zero_copy());
+  KATANA_LOG_ASSERT(fv.size() == kFileSize);
+  KATANA_LOG_ASSERT(std::equal(data.begin(), data.end(), fv.begin()));
+  CheckRead(&fv, data);
+
+  KATANA_LOG_ASSERT(unsetenv("KATANA_LOCAL_FILE_MMAP") == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/file-view");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string dir(uri_res.value().path());  // path() because local
+  fs::create_directories(dir);
+
+  std::string file = katana::Uri::JoinPath(dir, "data");
+  std::vector<uint8_t> data = MakeData(kFileSize);
+  KATANA_LOG_ASSERT(tsuba::FileStore(file, data.data(), data.size()));
+
+  TestMapped(file, data);
+  TestCopied(file, data);
+
+  fs::remove_all(dir);
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -0,0 +1,198 @@
+#include <fstream>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <boost/filesystem.hpp>
+#include <parquet/arrow/writer.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
+
+#include "katana/Logging.h"
+#include "katana/Uri.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+constexpr int64_t kNumRows = 1000;
+constexpr int64_t kRowGroupSize = 100;
+
+/// Column "a" holds i, "b" holds i / 2.0 and "c" holds 3 * i for row i
+std::shared_ptr<arrow::Table>
+MakeTable() {
+  arrow::Int64Builder a;
+  arrow::DoubleBuilder b;
+  arrow::Int32Builder c;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    KATANA_LOG_ASSERT(a.Append(i).ok());
+    KATANA_LOG_ASSERT(b.Append(i / 2.0).ok());
+    KATANA_LOG_ASSERT(c.Append(static_cast<int32_t>(3 * i)).ok());
+  }
+  std::shared_ptr<arrow::Array> a_array;
+  std::shared_ptr<arrow::Array> b_array;
+  std::shared_ptr<arrow::Array> c_array;
+  KATANA_LOG_ASSERT(a.Finish(&a_array).ok());
+  KATANA_LOG_ASSERT(b.Finish(&b_array).ok());
+  KATANA_LOG_ASSERT(c.Finish(&c_array).ok());
+  return arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("a", arrow::int64()),
+           arrow::field("b", arrow::float64()),
+           arrow::field("c", arrow::int32())}),
+      {a_array, b_array, c_array});
+}
+
+/// Write MakeTable to \param path in row groups of kRowGroupSize rows
+void
+WriteTable(const std::string& path) {
+  auto out_res = arrow::io::FileOutputStream::Open(path);
+  KATANA_LOG_ASSERT(out_res.ok());
+  auto out = out_res.ValueOrDie();
+  KATANA_LOG_ASSERT(parquet::arrow::WriteTable(
+                        *MakeTable(), arrow::default_memory_pool(), out,
+                        kRowGroupSize)
+                        .ok());
+  KATANA_LOG_ASSERT(out->Close().ok());
+}
+
+std::unique_ptr<tsuba::ParquetReader>
+MakeReader(int64_t offset, int64_t length, bool use_threads) {
+  tsuba::ParquetReader::ReadOpts opts;
+  opts.slice = tsuba::ParquetReader::Slice{.offset = offset, .length = length};
+  opts.use_threads = use_threads;
+  auto reader_res = tsuba::ParquetReader::Make(opts);
+  KATANA_LOG_ASSERT(reader_res);
+  return std::move(reader_res.value());
+}
+
+/// Check that \param column holds \param scale times the row numbers from
+/// \param offset
+template <typename ArrayType>
+void
+CheckColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& column, int64_t offset,
+    double scale) {
+  int64_t row = offset;
+  for (const auto& chunk : column->chunks()) {
+    auto array = std::static_pointer_cast<ArrayType>(chunk);
+    for (int64_t i = 0; i < array->length(); ++i, ++row) {
+      KATANA_LOG_VASSERT(
+          array->Value(i) == static_cast<typename ArrayType::value_type>(
+                                 scale * static_cast<double>(row)),
+          "row {}: {}", row, array->Value(i));
+    }
+  }
+}
+
+void
+TestSliceWithColumns(const katana::Uri& uri, bool use_threads) {
+  // The slice starts and ends in the middle of row groups
+  constexpr int64_t kOffset = 250;
+  constexpr int64_t kLength = 420;
+  auto reader = MakeReader(kOffset, kLength, use_threads);
+
+  // Columns come back in the order asked for
+  auto table_res = reader->ReadTable(uri, std::vector<int32_t>{2, 0});
+  KATANA_LOG_VASSERT(table_res, "reading slice: {}", table_res.error());
+  auto table = table_res.value();
+  KATANA_LOG_ASSERT(table->num_rows() == kLength);
+  KATANA_LOG_ASSERT(table->num_columns() == 2);
+  KATANA_LOG_ASSERT(table->field(0)->name() == "c");
+  KATANA_LOG_ASSERT(table->field(1)->name() == "a");
+  CheckColumn<arrow::Int32Array>(table->column(0), kOffset, 3);
+  CheckColumn<arrow::Int64Array>(table->column(1), kOffset, 1);
+
+  auto column_res = reader->ReadColumn(uri, 1);
+  KATANA_LOG_VASSERT(column_res, "reading column: {}", column_res.error());
+  KATANA_LOG_ASSERT(column_res.value()->num_rows() == kLength);
+  CheckColumn<arrow::DoubleArray>(
+      column_res.value()->column(0), kOffset, 0.5);
+
+  // A slice past the end is cut short
+  auto tail_res = MakeReader(kNumRows - 10, 100, use_threads)->ReadTable(uri);
+  KATANA_LOG_ASSERT(tail_res);
+  KATANA_LOG_ASSERT(tail_res.value()->num_rows() == 10);
+}
+
+/// Overwrite the column chunks of the first row group of \param path with
+/// garbage, so that only reads that skip it can succeed
+void
+CorruptFirstRowGroup(const std::string& path) {
+  auto file_reader = parquet::ParquetFileReader::OpenFile(path);
+  auto rg_md = file_reader->metadata()->RowGroup(0);
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  for (int i = 0; i < rg_md->num_columns(); ++i) {
+    auto col_md = rg_md->ColumnChunk(i);
+    int64_t begin = col_md->data_page_offset();
+    if (col_md->has_dictionary_page() &&
+        col_md->dictionary_page_offset() > 0 &&
+        col_md->dictionary_page_offset() < begin) {
+      begin = col_md->dictionary_page_offset();
+    }
+    ranges.emplace_back(begin, col_md->total_compressed_size());
+  }
+  file_reader->Close();
+
+  std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+  for (const auto& [begin, size] : ranges) {
+    std::vector<char> garbage(size, '\xff');
+    f.seekp(begin);
+    f.write(garbage.data(), size);
+  }
+  KATANA_LOG_ASSERT(f.good());
+}
+
+void
+TestRowGroupPruning(const katana::Uri& uri, bool use_threads) {
+  // Only the first row group is unreadable, so slices that do not touch it
+  // must not read it
+  auto pruned_res = MakeReader(500, 200, use_threads)->ReadTable(uri);
+  KATANA_LOG_VASSERT(pruned_res, "reading slice: {}", pruned_res.error());
+  KATANA_LOG_ASSERT(pruned_res.value()->num_rows() == 200);
+  CheckColumn<arrow::Int64Array>(pruned_res.value()->column(0), 500, 1);
+
+  auto boundary_res = MakeReader(kRowGroupSize, 1, use_threads)
+                          ->ReadTable(uri, std::vector<int32_t>{0});
+  KATANA_LOG_ASSERT(boundary_res);
+  CheckColumn<arrow::Int64Array>(
+      boundary_res.value()->column(0), kRowGroupSize, 1);
+
+  KATANA_LOG_ASSERT(!MakeReader(50, 100, use_threads)->ReadTable(uri));
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  auto dir_res = katana::Uri::MakeRand("/tmp/parquet-reader");
+  KATANA_LOG_ASSERT(dir_res);
+  std::string dir(dir_res.value().path());  // path() because local
+  fs::create_directories(dir);
+  std::string path = katana::Uri::JoinPath(dir, "table.parquet");
+  WriteTable(path);
+  auto uri_res = katana::Uri::Make(path);
+  KATANA_LOG_ASSERT(uri_res);
+
+  for (bool use_threads : {false, true}) {
+    TestSliceWithColumns(uri_res.value(), use_threads);
+  }
+  CorruptFirstRowGroup(path);
+  for (bool use_threads : {false, true}) {
+    TestRowGroupPruning(uri_res.value(), use_threads);
+  }
+
+  fs::remove_all(dir);
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
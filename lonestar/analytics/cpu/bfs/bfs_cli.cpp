@@ -17,7 +17,9 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <iostream>
+#include <unordered_set>
 
 #include <katana/analytics/bfs/bfs.h>
 
@@ -62,6 +64,13 @@ static cll::opt<bool> persistAllDistances(
         "distances for the last source are persisted (default value false)"),
     cll::init(false));
 
+static cll::opt<bool> multiSource(
+    "multiSource",
+    cll::desc("Flag to indicate whether to compute the distances from all "
+              "sources together in batches instead of one source at a time; "
+              "-algo is ignored if set (default value false)"),
+    cll::init(false));
+
 static cll::opt<BfsPlan::Algorithm> algo(
     "algo", cll::desc("Choose an algorithm (default value SyncTile):"),
     cll::values(
@@ -69,9 +78,23 @@ static cll::opt<BfsPlan::Algorithm> algo(
             BfsPlan::kAsynchronousTile, "AsyncTile", "Asynchronous tiled"),
         clEnumValN(BfsPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(BfsPlan::kSynchronousTile, "SyncTile", "Synchronous tiled"),
-        clEnumValN(BfsPlan::kSynchronous, "Sync", "Synchronous")),
+        clEnumValN(BfsPlan::kSynchronous, "Sync", "Synchronous"),
+        clEnumValN(
+            BfsPlan::kDirectionOptimizing, "DirectionOpt",
+            "Direction-optimizing")),
     cll::init(BfsPlan::kSynchronousTile));
 
+static cll::opt<uint32_t> alpha(
+    "alpha",
+    cll::desc("alpha value to change direction in direction-optimization "
+              "(default value 15)"),
+    cll::init(BfsPlan::kDefaultAlpha));
+static cll::opt<uint32_t> beta(
+    "beta",
+    cll::desc("beta value to change direction in direction-optimization "
+              "(default value 18)"),
+    cll::init(BfsPlan::kDefaultBeta));
+
 std::string
 AlgorithmName(BfsPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -83,6 +106,8 @@ AlgorithmName(BfsPlan::Algorithm algorithm) {
     return "SyncTile";
   case BfsPlan::kSynchronous:
     return "Sync";
+  case BfsPlan::kDirectionOptimizing:
+    return "DirectionOpt";
   default:
     return "Unknown";
   }
@@ -103,7 +128,9 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
 
-  std::cout << "Running " << AlgorithmName(algo) << "\n";
+  std::cout << "Running "
+            << (multiSource ? std::string("MultiSource") : AlgorithmName(algo))
+            << "\n";
 
   if (reportNode >= pg->topology().num_nodes()) {
     KATANA_LOG_FATAL("failed to set report: {}", reportNode);
@@ -111,20 +138,31 @@ main(int argc, char** argv) {
 
   katana::reportPageAlloc("MeminfoPre");
 
-  std::vector<uint32_t> startNodes;
+  std::vector<uint64_t> startNodes;
   if (!startNodesFile.getValue().empty()) {
     std::ifstream file(startNodesFile);
     if (!file.good()) {
       KATANA_LOG_FATAL("failed to open file: {}", startNodesFile);
     }
     startNodes.insert(
-        startNodes.end(), std::istream_iterator<uint32_t>{file},
-        std::istream_iterator<uint32_t>{});
+        startNodes.end(), std::istream_iterator<uint64_t>{file},
+        std::istream_iterator<uint64_t>{});
   } else {
     std::istringstream str(startNodesString);
     startNodes.insert(
-        startNodes.end(), std::istream_iterator<uint32_t>{str},
-        std::istream_iterator<uint32_t>{});
+        startNodes.end(), std::istream_iterator<uint64_t>{str},
+        std::istream_iterator<uint64_t>{});
+  }
+  // Each source gets an output property named after it, so running a
+  // source twice would overwrite its own result
+  std::unordered_set<uint64_t> seen;
+  auto last = std::remove_if(
+      startNodes.begin(), startNodes.end(),
+      [&](uint64_t n) { return !seen.insert(n).second; });
+  if (last != startNodes.end()) {
+    KATANA_LOG_WARN(
+        "ignoring {} repeated start nodes", startNodes.end() - last);
+    startNodes.erase(last, startNodes.end());
   }
   uint32_t num_sources = startNodes.size();
   std::cout << "Running BFS for " << num_sources << " sources\n";
@@ -143,16 +181,34 @@ main(int argc, char** argv) {
   case BfsPlan::kSynchronousTile:
     plan = BfsPlan::SynchronousTile();
     break;
+  case BfsPlan::kDirectionOptimizing:
+    plan = BfsPlan::DirectionOptimizing(alpha, beta);
+    break;
   }
 
   for (auto startNode : startNodes) {
-    if (startNode >= pg->topology().num_nodes()) {
+    if (startNode >= pg->num_nodes()) {
       KATANA_LOG_FATAL("failed to set source: {}", startNode);
     }
+  }
 
+  if (multiSource) {
+    std::vector<std::string> node_distance_props;
+    for (auto startNode : startNodes) {
+      node_distance_props.emplace_back("level-" + std::to_string(startNode));
+    }
+    if (auto r = BfsMultiSource(pg.get(), startNodes, node_distance_props);
+        !r) {
+      KATANA_LOG_FATAL("Failed to run multi-source bfs {}", r.error());
+    }
+  }
+
+  for (auto startNode : startNodes) {
     std::string node_distance_prop = "level-" + std::to_string(startNode);
-    if (auto r = Bfs(pg.get(), startNode, node_distance_prop, plan); !r) {
-      KATANA_LOG_FATAL("Failed to run bfs {}", r.error());
+    if (!multiSource) {
+      if (auto r = Bfs(pg.get(), startNode, node_distance_prop, plan); !r) {
+        KATANA_LOG_FATAL("Failed to run bfs {}", r.error());
+      }
     }
 
     katana::reportPageAlloc("MeminfoPost");
@@ -69,6 +69,21 @@ static cll::opt<uint32_t> numberOfEdgeTypes(
     "numberOfEdgeTypes", cll::desc("Number of edge types (only for Edge2Vec)"),
     cll::init(1));
 
+static cll::opt<bool> weighted(
+    "weighted",
+    cll::desc(
+        "Sample neighbors proportionally to the edge property given by "
+        "-edgeWeightPropertyName"),
+    cll::init(false));
+
+static cll::opt<std::string> edgeWeightPropertyName(
+    "edgeWeightPropertyName",
+    cll::desc(
+        "Edge weight property for -weighted (Default: -edgePropertyName; "
+        "Edge2Vec reads edge types from -edgePropertyName, so it needs a "
+        "separate weight property)"),
+    cll::init(""));
+
 std::string
 AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -111,8 +126,34 @@ main(int argc, char** argv) {
   }
 
   std::cout << "Reading from file: " << inputFile << "\n";
-  std::unique_ptr<katana::PropertyGraph> pg =
-      MakeFileGraph(inputFile, edge_property_name);
+  // Edge2Vec reads the edge type from the first loaded edge property, so
+  // load the weights after it
+  std::vector<std::string> edge_properties;
+  if (!edge_property_name.empty()) {
+    edge_properties.emplace_back(edge_property_name);
+  }
+  std::string edge_weight_property_name;
+  if (weighted) {
+    edge_weight_property_name = edgeWeightPropertyName.empty()
+                                    ? edge_property_name
+                                    : edgeWeightPropertyName;
+    if (edge_weight_property_name.empty()) {
+      KATANA_LOG_FATAL(
+          "-weighted requires -edgeWeightPropertyName or -edgePropertyName");
+    }
+    if (edge_weight_property_name != edge_property_name) {
+      edge_properties.emplace_back(edge_weight_property_name);
+    }
+  }
+  std::vector<std::string> node_properties;
+  tsuba::RDGLoadOptions opts;
+  opts.node_properties = &node_properties;
+  opts.edge_properties = &edge_properties;
+  auto pg_result = katana::PropertyGraph::Make(inputFile, opts);
+  if (!pg_result) {
+    KATANA_LOG_FATAL("cannot make graph: {}", pg_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_result.value());
 
   std::cout << "Read " << pg->topology().num_nodes() << " nodes, "
             << pg->topology().num_edges() << " edges\n";
@@ -136,7 +177,14 @@ main(int argc, char** argv) {
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
-  auto walks_result = RandomWalks(pg.get(), plan);
+  if (weighted && algo == RandomWalksPlan::kEdge2Vec &&
+      edge_weight_property_name == edge_property_name) {
+    KATANA_LOG_FATAL(
+        "-weighted Edge2Vec needs -edgeWeightPropertyName different from the "
+        "edge type property -edgePropertyName");
+  }
+
+  auto walks_result = RandomWalks(pg.get(), plan, edge_weight_property_name);
   if (!walks_result) {
     KATANA_LOG_FATAL("Failed to run RandomWalks: {}", walks_result.error());
   }
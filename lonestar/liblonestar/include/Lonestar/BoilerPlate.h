@@ -34,6 +34,7 @@ using katana::analytics::ConstructNodeProperties;
 extern llvm::cl::opt<bool> skipVerify;
 extern llvm::cl::opt<int> numThreads;
 extern llvm::cl::opt<std::string> statFile;
+extern llvm::cl::opt<katana::StatFormat> statFormat;
 extern llvm::cl::opt<bool> symmetricGraph;
 extern llvm::cl::opt<std::string> edge_property_name;
 //! Where to write output if output is set
@@ -34,6 +34,17 @@ llvm::cl::opt<std::string> statFile(
     "statFile",
     llvm::cl::desc("ouput file to print stats to (default value empty)"),
     llvm::cl::init(""));
+llvm::cl::opt<katana::StatFormat> statFormat(
+    "statFormat",
+    llvm::cl::desc(
+        "format of the stats (default value text or KATANA_STAT_FORMAT)"),
+    llvm::cl::values(
+        clEnumValN(katana::StatFormat::kText, "text", "comma separated lines"),
+        clEnumValN(
+            katana::StatFormat::kJSON, "json", "JSON with thread values"),
+        clEnumValN(
+            katana::StatFormat::kChromeTrace, "chrome",
+            "Chrome trace events with a timeline of timers and loops")));
 
 //! Flag that forces user to be aware that they should be passing in a
 //! symmetric graph.
@@ -82,6 +93,9 @@ LonestarStart(
   numThreads = katana::setActiveThreads(numThreads);
 
   katana::SetStatFile(statFile);
+  if (statFormat.getNumOccurrences()) {
+    katana::SetStatFormat(statFormat);
+  }
 
   LonestarPrintVersion(llvm::outs());
   llvm::outs() << "Copyright (C) " << katana::getCopyrightYear()
@@ -1,12 +1,24 @@
-from pyarrow.lib cimport pyarrow_unwrap_table, pyarrow_wrap_chunked_array, pyarrow_wrap_schema, to_shared
+from pyarrow.lib cimport (
+    CArray,
+    CUInt32Array,
+    CUInt64Array,
+    pyarrow_unwrap_table,
+    pyarrow_wrap_array,
+    pyarrow_wrap_chunked_array,
+    pyarrow_wrap_schema,
+    to_shared,
+)
 
 from .cpp.libgalois.graphs cimport Graph as CGraph
 from .cpp.libsupport.result cimport Result, handle_result_void, raise_error_code
 
+import numpy as np
+import pyarrow
+
 from .numba_support._pyarrow_wrappers import unchunked
 
 from libc.stdint cimport uint32_t
-from libcpp.memory cimport shared_ptr, unique_ptr
+from libcpp.memory cimport shared_ptr, static_pointer_cast, unique_ptr
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 
@@ -59,8 +71,12 @@ cdef class PropertyGraphBase:
     cdef GraphTopology topology(PropertyGraph self):
         return self.underlying_property_graph().topology()
 
+    def _check_narrow_node_ids(self):
+        if self.underlying_property_graph().has_wide_node_ids():
+            raise NotImplementedError("graphs with more than 2^32 - 1 nodes are not supported")
+
     cpdef uint64_t num_nodes(PropertyGraph self):
-        return self.topology().num_nodes()
+        return self.underlying_property_graph().num_nodes()
 
     def __eq__(self, PropertyGraph other):
         return self.underlying_property_graph().Equals(other.underlying_property_graph())
@@ -81,7 +97,7 @@ cdef class PropertyGraphBase:
 
         Can be called from numba compiled code.
         """
-        return self.topology().num_edges()
+        return self.underlying_property_graph().num_edges()
 
     def node_schema(self):
         """
@@ -142,6 +158,7 @@ cdef class PropertyGraphBase:
         cdef uint64_t prev
         if n > self.num_nodes():
             raise IndexError(n)
+        self._check_narrow_node_ids()
         if n == 0:
             prev = 0
         else:
@@ -158,6 +175,121 @@ cdef class PropertyGraphBase:
             raise IndexError(e)
         return self.topology().out_dests.get().Value(e)
 
+    def out_indices(self):
+        """
+        Return the `pyarrow` array of the edge index of each node: the outgoing edges of node `n` are the edges from
+        `out_indices()[n-1]` (or 0 for node 0) up to but not including `out_indices()[n]`.
+
+        The array shares memory with the graph, so `to_numpy()` on it is zero-copy. It is invalidated by changes to
+        the topology of the graph. Graphs with more than 2^32 - 1 nodes are not supported.
+        """
+        self._check_narrow_node_ids()
+        return pyarrow_wrap_array(static_pointer_cast[CArray, CUInt64Array](self.topology().out_indices))
+
+    def out_dests(self):
+        """
+        Return the `pyarrow` array of the destination node of each edge.
+
+        The array shares memory with the graph, so `to_numpy()` on it is zero-copy. It is invalidated by changes to
+        the topology of the graph. Graphs with more than 2^32 - 1 nodes are not supported.
+        """
+        self._check_narrow_node_ids()
+        return pyarrow_wrap_array(static_pointer_cast[CArray, CUInt32Array](self.topology().out_dests))
+
+    def _type_set_ids(self, uint64_t address, uint64_t length):
+        if address == 0:
+            return None
+        # The buffer keeps self alive for as long as the returned array is used
+        return np.frombuffer(pyarrow.foreign_buffer(address, length, base=self), dtype=np.uint8)
+
+    def node_type_set_ids(self):
+        """
+        Return a read-only `numpy` array of the type set ID of each node, or None if the graph has no node types.
+        The array shares memory with the graph and is invalidated by changes to its topology or types.
+        """
+        return self._type_set_ids(<uint64_t>self.underlying_property_graph().node_type_set_ids(), self.num_nodes())
+
+    def edge_type_set_ids(self):
+        """
+        Return a read-only `numpy` array of the type set ID of each edge, or None if the graph has no edge types.
+        The array shares memory with the graph and is invalidated by changes to its topology or types.
+        """
+        return self._type_set_ids(<uint64_t>self.underlying_property_graph().edge_type_set_ids(), self.num_edges())
+
+    def construct_type_set_ids(self):
+        """
+        Compute the type set ID of each node and edge from the bool and uint8 properties, which are treated as types.
+        Must be called at most once, before `node_type_set_ids()` or `edge_type_set_ids()` return arrays.
+        """
+        with nogil:
+            handle_result_void(self.underlying_property_graph().ConstructTypeSetIDs())
+
+    def _edge_bounds(self, nodes):
+        indices = self.out_indices().to_numpy()
+        if nodes is None:
+            ends = indices
+            begins = np.concatenate(([0], indices[:-1])).astype(np.uint64)
+        else:
+            nodes = np.asarray(nodes, dtype=np.uint64)
+            if nodes.size > 0 and nodes.max() >= self.num_nodes():
+                raise IndexError(nodes.max())
+            ends = indices[nodes]
+            begins = np.where(nodes > 0, indices[np.maximum(nodes, 1) - 1], 0).astype(np.uint64)
+        return begins, ends
+
+    def degrees(self, nodes=None):
+        """
+        Return a `numpy` array of the out-degree of each node in `nodes`, or of every node if `nodes` is None.
+        """
+        begins, ends = self._edge_bounds(nodes)
+        return ends - begins
+
+    def neighbors(self, nodes):
+        """
+        Return the outgoing neighbors of a batch of nodes in CSR form, as a pair of `numpy` arrays `(offsets, dests)`:
+        the neighbors of `nodes[i]` are `dests[offsets[i]:offsets[i+1]]`.
+        """
+        begins, ends = self._edge_bounds(nodes)
+        lengths = ends - begins
+        offsets = np.zeros(len(lengths) + 1, dtype=np.uint64)
+        np.cumsum(lengths, out=offsets[1:])
+        # Edge i of the output is edge i - offsets[j] + begins[j] of the graph for the node j it belongs to
+        edge_ids = np.arange(offsets[-1], dtype=np.int64) + np.repeat(
+            begins.astype(np.int64) - offsets[:-1].astype(np.int64), lengths.astype(np.int64)
+        )
+        return offsets, self.out_dests().to_numpy()[edge_ids]
+
+    def to_scipy_sparse(self, edge_property=None):
+        """
+        Return the adjacency matrix of this graph as a `scipy.sparse.csr_matrix`.
+
+        The column indices share memory with the graph as long as the graph has fewer than 2^31 nodes and edges
+        (otherwise scipy requires 64-bit indices, which are copied). The row pointers are a copy of `out_indices()`
+        with a leading 0.
+
+        :param edge_property: The name or index of a numeric edge property to use as the values of the matrix (shared
+            with the graph if it is not chunked). If None (default), all values are 1 as int64.
+        """
+        import scipy.sparse
+
+        num_nodes = self.num_nodes()
+        num_edges = self.num_edges()
+        dests = self.out_dests().to_numpy()
+        if num_nodes < 2 ** 31 and num_edges < 2 ** 31:
+            index_dtype = np.int32
+            # The destinations are below 2^31, so reinterpreting them is exact
+            indices = dests.view(np.int32)
+        else:
+            index_dtype = np.int64
+            indices = dests.astype(np.int64)
+        indptr = np.zeros(num_nodes + 1, dtype=index_dtype)
+        indptr[1:] = self.out_indices().to_numpy()
+        if edge_property is None:
+            data = np.ones(num_edges, dtype=np.int64)
+        else:
+            data = self.get_edge_property(edge_property).to_numpy()
+        return scipy.sparse.csr_matrix((data, indices, indptr), shape=(num_nodes, num_nodes), copy=False)
+
     def get_node_property(self, prop):
         """
         Return a `pyarrow` array or chunked array storing the data for node property `prop`.
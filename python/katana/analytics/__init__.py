@@ -42,6 +42,8 @@ Algorithms
 
 .. automodule:: katana.analytics._k_truss
 
+.. automodule:: katana.analytics._minimum_spanning_forest
+
 .. automodule:: katana.analytics._pagerank
 
 .. automodule:: katana.analytics._sssp
@@ -59,7 +61,7 @@ from katana.analytics._betweenness_centrality import (
     BetweennessCentralityStatistics,
     betweenness_centrality,
 )
-from katana.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid
+from katana.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid, bfs_multi_source
 from katana.analytics._connected_components import (
     ConnectedComponentsPlan,
     ConnectedComponentsStatistics,
@@ -82,6 +84,12 @@ from katana.analytics._louvain_clustering import (
     louvain_clustering,
     louvain_clustering_assert_valid,
 )
+from katana.analytics._minimum_spanning_forest import (
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
+)
 from katana.analytics._pagerank import PagerankPlan, PagerankStatistics, pagerank, pagerank_assert_valid
 from katana.analytics._sssp import SsspPlan, SsspStatistics, sssp, sssp_assert_valid
 from katana.analytics._subgraph_extraction import SubGraphExtractionPlan, subgraph_extraction
@@ -11,6 +11,8 @@ Breadth-first Search
 
 .. autofunction:: katana.analytics.bfs
 
+.. autofunction:: katana.analytics.bfs_multi_source
+
 .. autoclass:: katana.analytics.BfsStatistics
     :members:
     :undoc-members:
@@ -21,6 +23,7 @@ Breadth-first Search
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
 from katana._property_graph cimport PropertyGraph
 from katana.analytics.plan cimport Plan, _Plan
@@ -38,9 +41,12 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
             kAsynchronous "katana::analytics::BfsPlan::kAsynchronous"
             kSynchronousTile "katana::analytics::BfsPlan::kSynchronousTile"
             kSynchronous "katana::analytics::BfsPlan::kSynchronous"
+            kDirectionOptimizing "katana::analytics::BfsPlan::kDirectionOptimizing"
 
         _BfsPlan.Algorithm algorithm() const
         ptrdiff_t edge_tile_size() const
+        uint32_t alpha() const
+        uint32_t beta() const
 
         @staticmethod
         _BfsPlan AsynchronousTile(ptrdiff_t edge_tile_size)
@@ -54,13 +60,22 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
         @staticmethod
         _BfsPlan Synchronous()
 
+        @staticmethod
+        _BfsPlan DirectionOptimizing(uint32_t alpha, uint32_t beta)
+
     ptrdiff_t kDefaultEdgeTileSize "katana::analytics::BfsPlan::kDefaultEdgeTileSize"
+    uint32_t kDefaultAlpha "katana::analytics::BfsPlan::kDefaultAlpha"
+    uint32_t kDefaultBeta "katana::analytics::BfsPlan::kDefaultBeta"
 
     Result[void] Bfs(_PropertyGraph * pg,
                      size_t start_node,
                      string output_property_name,
                      _BfsPlan algo)
 
+    Result[void] BfsMultiSource(_PropertyGraph * pg,
+                                const vector[uint64_t]& start_nodes,
+                                const vector[string]& output_property_names)
+
     Result[void] BfsAssertValid(_PropertyGraph* pg,
                                 string property_name);
 
@@ -90,11 +105,16 @@ class _BfsAlgorithm(Enum):
 
         Bulk-synchronous tiled
 
+    .. py:attribute:: DirectionOptimizing
+
+        Bulk-synchronous, switching between top-down and bottom-up steps
+
     """
     Asynchronous = _BfsPlan.Algorithm.kAsynchronous
     AsynchronousTile = _BfsPlan.Algorithm.kAsynchronousTile
     Synchronous = _BfsPlan.Algorithm.kSynchronous
     SynchronousTile = _BfsPlan.Algorithm.kSynchronousTile
+    DirectionOptimizing = _BfsPlan.Algorithm.kDirectionOptimizing
 
 
 cdef class BfsPlan(Plan):
@@ -129,6 +149,22 @@ cdef class BfsPlan(Plan):
         """
         return self.underlying_.edge_tile_size()
 
+    @property
+    def alpha(self) -> int:
+        """
+        The direction-optimizing algorithm switches to bottom-up steps once the frontier's out-edges exceed 1/alpha of
+        the unexplored edges.
+        """
+        return self.underlying_.alpha()
+
+    @property
+    def beta(self) -> int:
+        """
+        The direction-optimizing algorithm switches back to top-down steps once the frontier shrinks below 1/beta of
+        the nodes.
+        """
+        return self.underlying_.beta()
+
     @staticmethod
     def asynchronous_tile(edge_tile_size=kDefaultEdgeTileSize):
         return BfsPlan.make(_BfsPlan.AsynchronousTile(edge_tile_size))
@@ -145,6 +181,10 @@ cdef class BfsPlan(Plan):
     def synchronous():
         return BfsPlan.make(_BfsPlan.Synchronous())
 
+    @staticmethod
+    def direction_optimizing(uint32_t alpha=kDefaultAlpha, uint32_t beta=kDefaultBeta):
+        return BfsPlan.make(_BfsPlan.DirectionOptimizing(alpha, beta))
+
 
 def bfs(PropertyGraph pg, size_t start_node, str output_property_name, BfsPlan plan = BfsPlan()):
     """
@@ -165,6 +205,25 @@ def bfs(PropertyGraph pg, size_t start_node, str output_property_name, BfsPlan p
     with nogil:
         handle_result_void(Bfs(pg.underlying_property_graph(), start_node, output_property_name_cstr, plan.underlying_))
 
+def bfs_multi_source(PropertyGraph pg, start_nodes, output_property_names):
+    """
+    Compute the Breadth-First Search levels on `pg` from each node in `start_nodes`. Sources are traversed together
+    in batches, sharing each pass over the edges, which is much faster than calling :py:func:`bfs` for each source.
+    The levels from ``start_nodes[i]`` are written to the property ``output_property_names[i]``.
+
+    :type pg: PropertyGraph
+    :param pg: The graph to analyze.
+    :type start_nodes: list[Node ID]
+    :param start_nodes: The source nodes.
+    :type output_property_names: list[str]
+    :param output_property_names: The output properties to write path lengths into, one per source. These properties
+        must not already exist.
+    """
+    cdef vector[uint64_t] start_nodes_vec = [<uint64_t>n for n in start_nodes]
+    cdef vector[string] output_property_names_vec = [bytes(name, "utf-8") for name in output_property_names]
+    with nogil:
+        handle_result_void(BfsMultiSource(pg.underlying_property_graph(), start_nodes_vec, output_property_names_vec))
+
 def bfs_assert_valid(PropertyGraph pg, str property_name):
     """
     Raise an exception if the BFS results in `pg` appear to be incorrect. This is not an
@@ -24,13 +24,19 @@ cdef shared_ptr[CUInt64Array] handle_result_shared_cuint64array(Result[shared_pt
             raise_error_code(res.error())
     return res.value()
 
+cdef uint64_t handle_result_uint64(Result[uint64_t] res) nogil except? 0:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
 
 # "Algorithms" from PropertyGraph
 
 cdef extern from "katana/PropertyGraph.h" namespace "katana" nogil:
     Result[shared_ptr[CUInt64Array]] SortAllEdgesByDest(_PropertyGraph* pg);
 
-    uint64_t FindEdgeSortedByDest(const _PropertyGraph* graph, uint32_t node, uint32_t node_to_find);
+    Result[uint64_t] FindEdgeSortedByDest(const _PropertyGraph* graph, uint32_t node, uint32_t node_to_find);
 
     Result[void] SortNodesByDegree(_PropertyGraph* pg);
 
@@ -59,7 +65,7 @@ def find_edge_sorted_by_dest(PropertyGraph pg, uint32_t node, uint32_t node_to_f
     :see: :func:`sort_all_edges_by_dest`
     """
     with nogil:
-        res = FindEdgeSortedByDest(pg.underlying_property_graph(), node, node_to_find)
+        res = handle_result_uint64(FindEdgeSortedByDest(pg.underlying_property_graph(), node, node_to_find))
     if res == pg.edges(node)[-1] + 1:
         return None
     return res
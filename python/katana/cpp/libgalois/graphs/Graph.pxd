@@ -1,4 +1,4 @@
-from libc.stdint cimport uint32_t, uint64_t
+from libc.stdint cimport uint8_t, uint32_t, uint64_t
 from libcpp.memory cimport shared_ptr, unique_ptr
 from libcpp.string cimport string
 from libcpp.vector cimport vector
@@ -130,6 +130,13 @@ cdef extern from "katana/Graph.h" namespace "katana" nogil:
         Result[void] Commit(string command_line)
 
         GraphTopology& topology()
+        bint has_wide_node_ids()
+        uint64_t num_nodes()
+        uint64_t num_edges()
+
+        Result[void] ConstructTypeSetIDs()
+        const uint8_t* node_type_set_ids()
+        const uint8_t* edge_type_set_ids()
 
         shared_ptr[CSchema] node_schema()
         shared_ptr[CSchema] edge_schema()
@@ -3,10 +3,11 @@ import pytest
 from pyarrow import Schema, table
 from pytest import approx, raises
 
-from katana import GaloisError
+from katana import GaloisError, TsubaError
 from katana.analytics import (
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
+    BfsPlan,
     BfsStatistics,
     ConnectedComponentsStatistics,
     IndependentSetPlan,
@@ -16,12 +17,15 @@ from katana.analytics import (
     KCoreStatistics,
     KTrussStatistics,
     LouvainClusteringStatistics,
+    MinimumSpanningForestPlan,
+    MinimumSpanningForestStatistics,
     PagerankStatistics,
     SsspStatistics,
     TriangleCountPlan,
     betweenness_centrality,
     bfs,
     bfs_assert_valid,
+    bfs_multi_source,
     connected_components,
     connected_components_assert_valid,
     find_edge_sorted_by_dest,
@@ -36,6 +40,8 @@ from katana.analytics import (
     local_clustering_coefficient,
     louvain_clustering,
     louvain_clustering_assert_valid,
+    minimum_spanning_forest,
+    minimum_spanning_forest_assert_valid,
     pagerank,
     pagerank_assert_valid,
     sort_all_edges_by_dest,
@@ -124,6 +130,49 @@ def test_bfs(property_graph: PropertyGraph):
     verify_bfs(property_graph, start_node, new_property_id)
 
 
+def test_bfs_multi_source(property_graph: PropertyGraph):
+    start_nodes = [0, 1, 2]
+    property_names = ["Level0", "Level1", "Level2"]
+
+    bfs_multi_source(property_graph, start_nodes, property_names)
+
+    for start_node, property_name in zip(start_nodes, property_names):
+        assert property_graph.get_node_property(property_name)[start_node].as_py() == 0
+        bfs_assert_valid(property_graph, property_name)
+
+        bfs(property_graph, start_node, "Expected")
+        assert property_graph.get_node_property(property_name).equals(property_graph.get_node_property("Expected"))
+        property_graph.remove_node_property("Expected")
+
+
+def test_bfs_multi_source_fail(property_graph: PropertyGraph):
+    num_properties = len(property_graph.node_schema())
+
+    # The repeated name fails after the first two properties were created
+    with raises(TsubaError):
+        bfs_multi_source(property_graph, [0, 1, 2], ["Level0", "Level1", "Level0"])
+
+    assert len(property_graph.node_schema()) == num_properties
+    for property_name in ["Level0", "Level1"]:
+        with raises(KeyError):
+            property_graph.get_node_property(property_name)
+
+
+def test_bfs_direction_optimizing(property_graph: PropertyGraph):
+    property_name = "NewProp"
+    start_node = 0
+
+    bfs(property_graph, start_node, property_name, BfsPlan.direction_optimizing())
+
+    assert property_graph.get_node_property(property_name)[start_node].as_py() == 0
+
+    bfs_assert_valid(property_graph, property_name)
+
+    stats = BfsStatistics(property_graph, property_name)
+
+    assert stats.max_distance == 7
+
+
 def test_sssp(property_graph: PropertyGraph):
     property_name = "NewProp"
     weight_name = "workFrom"
@@ -350,6 +399,29 @@ def test_louvain_clustering():
     # assert stats.largest_cluster_size == 297
 
 
+def test_minimum_spanning_forest():
+    property_graph = PropertyGraph(get_input("propertygraphs/rmat10_symmetric"))
+
+    minimum_spanning_forest(property_graph, "value", "output")
+
+    minimum_spanning_forest_assert_valid(property_graph, "value", "output")
+
+    stats = MinimumSpanningForestStatistics(property_graph, "value", "output")
+
+    # One tree per connected component
+    assert stats.n_trees == 69
+    assert stats.n_forest_edges == 955
+
+    minimum_spanning_forest(property_graph, "value", "output2", MinimumSpanningForestPlan.filter_kruskal())
+
+    minimum_spanning_forest_assert_valid(property_graph, "value", "output2")
+
+    stats2 = MinimumSpanningForestStatistics(property_graph, "value", "output2")
+
+    assert stats2.n_forest_edges == stats.n_forest_edges
+    assert stats2.total_weight == approx(stats.total_weight)
+
+
 def test_local_clustering_coefficient():
     property_graph = PropertyGraph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
 
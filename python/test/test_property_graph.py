@@ -69,6 +69,77 @@ def test_nodes_count_edges(property_graph):
     assert property_graph.num_edges() == total
 
 
+def test_topology_arrays(property_graph):
+    out_indices = property_graph.out_indices().to_numpy()
+    out_dests = property_graph.out_dests().to_numpy()
+    assert len(out_indices) == property_graph.num_nodes()
+    assert len(out_dests) == property_graph.num_edges()
+    assert list(out_dests[out_indices[9] : out_indices[10]]) == [2011, 1422, 1409, 4798, 9483]
+
+
+def expected_type_set_ids(schema, get_property, num_rows):
+    # Each bool or uint8 property is a type. Single types are numbered first in
+    # schema order, then combinations of types in sorted order; 0 is no type.
+    type_columns = [i for i, field in enumerate(schema) if field.type in (pyarrow.bool_(), pyarrow.uint8())]
+    rows = [()] * num_rows
+    for i in type_columns:
+        is_type = np.asarray(get_property(i).to_numpy(zero_copy_only=False), dtype=bool)
+        for row in np.flatnonzero(is_type):
+            rows[row] = rows[row] + (i,)
+    ids = {(i,): n + 1 for n, i in enumerate(type_columns)}
+    for combination in sorted({r for r in rows if len(r) > 1}):
+        ids[combination] = len(ids) + 1
+    ids[()] = 0
+    return np.array([ids[r] for r in rows], dtype=np.uint8)
+
+
+def test_type_set_ids(property_graph):
+    assert property_graph.node_type_set_ids() is None
+    assert property_graph.edge_type_set_ids() is None
+
+    property_graph.construct_type_set_ids()
+
+    node_type_set_ids = property_graph.node_type_set_ids()
+    assert node_type_set_ids.dtype == np.uint8
+    assert not node_type_set_ids.flags.writeable
+    expected_nodes = expected_type_set_ids(
+        property_graph.node_schema(), property_graph.get_node_property, property_graph.num_nodes()
+    )
+    assert expected_nodes.max() > 0
+    assert np.array_equal(node_type_set_ids, expected_nodes)
+
+    edge_type_set_ids = property_graph.edge_type_set_ids()
+    expected_edges = expected_type_set_ids(
+        property_graph.edge_schema(), property_graph.get_edge_property, property_graph.num_edges()
+    )
+    assert expected_edges.max() > 0
+    assert np.array_equal(edge_type_set_ids, expected_edges)
+
+
+def test_degrees(property_graph):
+    degrees = property_graph.degrees()
+    assert len(degrees) == property_graph.num_nodes()
+    assert degrees.sum() == property_graph.num_edges()
+    assert list(property_graph.degrees([10, 0])) == [len(property_graph.edges(10)), len(property_graph.edges(0))]
+
+
+def test_neighbors(property_graph):
+    nodes = [10, 0, 10]
+    offsets, dests = property_graph.neighbors(nodes)
+    assert len(offsets) == len(nodes) + 1
+    for i, n in enumerate(nodes):
+        expected = [property_graph.get_edge_dest(e) for e in property_graph.edges(n)]
+        assert list(dests[offsets[i] : offsets[i + 1]]) == expected
+
+
+def test_to_scipy_sparse(property_graph):
+    pytest.importorskip("scipy.sparse")
+    matrix = property_graph.to_scipy_sparse()
+    assert matrix.shape == (property_graph.num_nodes(), property_graph.num_nodes())
+    assert matrix.nnz == property_graph.num_edges()
+    assert list(matrix.indices[matrix.indptr[10] : matrix.indptr[11]]) == [2011, 1422, 1409, 4798, 9483]
+
+
 def test_get_node_property_exception(property_graph):
     with pytest.raises(KeyError):
         property_graph.get_node_property("_mispelled")
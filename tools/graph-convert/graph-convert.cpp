@@ -2875,6 +2875,12 @@ struct Gr2Kg : public Conversion {
       return res.error();
     }
 
+    if (header.version == tsuba::kCompressedCSRTopologyVersion) {
+      KATANA_LOG_ERROR(
+          "{} has a compressed topology; out of core conversion expects GR v1",
+          in_file_name);
+      return katana::ErrorCode::NotImplemented;
+    }
     if (header.version != 1) {
       KATANA_LOG_ERROR("Out of core not possible, katana expects GR v1");
       return katana::ErrorCode::NotImplemented;
@@ -5,6 +5,7 @@
 #include "Transforms.h"
 #include "katana/ErrorCode.h"
 #include "katana/Galois.h"
+#include "katana/GraphCSV.h"
 #include "katana/GraphML.h"
 #include "katana/GraphMLSchema.h"
 #include "katana/Logging.h"
@@ -36,7 +37,11 @@ cll::opt<katana::SourceType> type(
             "source file is of type GraphML"),
         clEnumValN(
             katana::SourceType::kKatana, "katana",
-            "source file is of type Katana")),
+            "source file is of type Katana"),
+        clEnumValN(
+            katana::SourceType::kCsv, "csv",
+            "source is a node file and an edge file (--edges) in the CSV "
+            "format of neo4j-admin import")),
     cll::init(katana::SourceType::kGraphml));
 cll::opt<katana::SourceDatabase> database(
     cll::desc("Database the data is from:"),
@@ -48,6 +53,8 @@ cll::opt<katana::SourceDatabase> database(
             katana::SourceDatabase::kMongodb, "mongodb", "source is mongodb"),
         clEnumValN(katana::SourceDatabase::kMysql, "mysql", "source is mysql")),
     cll::init(katana::SourceDatabase::kNone));
+cll::opt<std::string> edges_filename(
+    "edges", cll::desc("Edge file of a csv input"), cll::init(""));
 cll::opt<int> chunk_size(
     "chunk-size",
     cll::desc("Chunk size for in memory arrow representation during "
@@ -134,6 +141,22 @@ ConvertKatana(const std::string& rdg_file) {
   return katana::PropertyGraph(std::move(*graph));
 }
 
+void
+ConvertCSVInput() {
+  if (edges_filename.empty()) {
+    KATANA_LOG_FATAL("csv input needs an edge file (--edges)");
+  }
+  auto components_result = katana::ConvertCSV(input_filename, edges_filename);
+  if (!components_result) {
+    KATANA_LOG_FATAL("Error converting graph: {}", components_result.error());
+  }
+  if (auto r = katana::WritePropertyGraph(
+          components_result.value(), output_directory);
+      !r) {
+    KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
+  }
+}
+
 void
 ParseWild() {
   switch (type) {
@@ -157,6 +180,9 @@ ParseWild() {
       KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
     }
     return;
+  case katana::SourceType::kCsv:
+    ConvertCSVInput();
+    return;
   default:
     KATANA_LOG_ERROR("Unsupported input type {}", type);
   }
@@ -178,6 +204,9 @@ ParseNeo4j() {
     }
     return;
   }
+  case katana::SourceType::kCsv:
+    ConvertCSVInput();
+    return;
   default:
     KATANA_LOG_ERROR("Unsupported input type {}", type);
   }
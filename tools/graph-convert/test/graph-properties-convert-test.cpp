@@ -4,6 +4,7 @@
 #include <llvm/Support/CommandLine.h>
 
 #include "katana/Galois.h"
+#include "katana/GraphCSV.h"
 #include "katana/GraphML.h"
 #include "katana/Logging.h"
 #include "katana/config.h"
@@ -13,7 +14,7 @@
 #endif
 
 namespace {
-enum ConvertTest { kMovies, kTypes, kChunks, kMongodb };
+enum ConvertTest { kMovies, kMoviesCSV, kTypes, kChunks, kMongodb };
 }
 
 namespace cll = llvm::cl;
@@ -36,6 +37,9 @@ static cll::opt<ConvertTest> test_type(
         clEnumValN(
             ConvertTest::kMovies, "movies",
             "source file is a test for generic conversion"),
+        clEnumValN(
+            ConvertTest::kMoviesCSV, "movies-csv",
+            "source files are a test for csv conversion"),
         clEnumValN(ConvertTest::kChunks, "chunks", "this is a test for chunks"),
         clEnumValN(
             ConvertTest::kMongodb, "mongo", "this is a test for mongodb")),
@@ -43,6 +47,13 @@ static cll::opt<ConvertTest> test_type(
 static cll::opt<int> chunk_size(
     "chunkSize", cll::desc("Chunk size for in memory arrow representation"),
     cll::init(25000));
+static cll::opt<std::string> edges_filename(
+    "edges", cll::desc("Edge file of a csv input; the input file is the node "
+                       "file"),
+    cll::init(""));
+static cll::opt<int> num_csv_chunks(
+    "csvChunks", cll::desc("Number of byte ranges csv files are split into"),
+    cll::init(0));
 
 namespace {
 
@@ -338,6 +349,169 @@ VerifyMovieSet(const katana::GraphComponents& graph) {
   KATANA_LOG_ASSERT(dests->ToString() == dests_expected);
 }
 
+std::shared_ptr<arrow::Array>
+CombinedColumn(
+    const std::shared_ptr<arrow::Table>& table, const std::string& name) {
+  auto column = table->GetColumnByName(name);
+  KATANA_LOG_ASSERT(column);
+  auto res = arrow::Concatenate(column->chunks());
+  KATANA_LOG_ASSERT(res.ok());
+  return res.ValueOrDie();
+}
+
+std::string
+ColumnString(
+    const std::shared_ptr<arrow::Table>& table, const std::string& name) {
+  return CombinedColumn(table, name)->ToString();
+}
+
+void
+VerifyMovieCSVSet(const katana::GraphComponents& graph) {
+  KATANA_LOG_ASSERT(graph.nodes.properties->num_columns() == 5);
+  KATANA_LOG_ASSERT(graph.nodes.labels->num_columns() == 2);
+  KATANA_LOG_ASSERT(graph.edges.properties->num_columns() == 2);
+  KATANA_LOG_ASSERT(graph.edges.labels->num_columns() == 5);
+
+  // n9 only appears in the edge file
+  KATANA_LOG_ASSERT(graph.nodes.properties->num_rows() == 9);
+  KATANA_LOG_ASSERT(graph.nodes.labels->num_rows() == 9);
+  KATANA_LOG_ASSERT(graph.edges.properties->num_rows() == 9);
+  KATANA_LOG_ASSERT(graph.edges.labels->num_rows() == 9);
+
+  // test node properties
+  KATANA_LOG_ASSERT(
+      graph.nodes.properties->GetColumnByName("born")->type()->id() ==
+      arrow::Type::INT64);
+  std::string names_expected = std::string(
+      "[\n\
+  null,\n\
+  \"Keanu Reeves\",\n\
+  \"Carrie-Anne Moss\",\n\
+  \"Laurence Fishburne\",\n\
+  \"Hugo Weaving\",\n\
+  \"Lilly Wachowski\",\n\
+  \"Lana Wachowski\",\n\
+  \"Silver, Joel\",\n\
+  null\n\
+]");
+  KATANA_LOG_ASSERT(
+      ColumnString(graph.nodes.properties, "name") == names_expected);
+
+  auto taglines = safe_cast<arrow::StringArray>(
+      CombinedColumn(graph.nodes.properties, "tagline"));
+  KATANA_LOG_ASSERT(taglines->GetString(0) == "Welcome to the \"Real\" World");
+  KATANA_LOG_ASSERT(taglines->null_count() == 8);
+
+  std::string borns_expected = std::string(
+      "[\n\
+  null,\n\
+  1964,\n\
+  1967,\n\
+  1961,\n\
+  1960,\n\
+  1967,\n\
+  1965,\n\
+  1952,\n\
+  null\n\
+]");
+  KATANA_LOG_ASSERT(
+      ColumnString(graph.nodes.properties, "born") == borns_expected);
+
+  // test node labels
+  std::string persons_expected = std::string(
+      "[\n\
+  false,\n\
+  true,\n\
+  true,\n\
+  true,\n\
+  true,\n\
+  true,\n\
+  true,\n\
+  true,\n\
+  false\n\
+]");
+  KATANA_LOG_ASSERT(
+      ColumnString(graph.nodes.labels, "Person") == persons_expected);
+
+  // test edge properties, which are in CSR order: the edges of n3 keep their
+  // order in the file
+  std::string roles_expected = std::string(
+      "[\n\
+  \"Neo\",\n\
+  \"Trinity\",\n\
+  null,\n\
+  \"Morpheus\",\n\
+  \"Agent Smith\",\n\
+  null,\n\
+  null,\n\
+  null,\n\
+  null\n\
+]");
+  KATANA_LOG_ASSERT(
+      ColumnString(graph.edges.properties, "roles") == roles_expected);
+
+  // test edge types
+  std::string actors_expected = std::string(
+      "[\n\
+  true,\n\
+  true,\n\
+  false,\n\
+  true,\n\
+  true,\n\
+  false,\n\
+  false,\n\
+  false,\n\
+  false\n\
+]");
+  KATANA_LOG_ASSERT(
+      ColumnString(graph.edges.labels, "ACTED_IN") == actors_expected);
+
+  std::string knows_expected = std::string(
+      "[\n\
+  false,\n\
+  false,\n\
+  false,\n\
+  false,\n\
+  false,\n\
+  false,\n\
+  false,\n\
+  false,\n\
+  true\n\
+]");
+  KATANA_LOG_ASSERT(
+      ColumnString(graph.edges.labels, "KNOWS") == knows_expected);
+
+  // test topology
+  std::string indices_expected = std::string(
+      "[\n\
+  0,\n\
+  1,\n\
+  2,\n\
+  4,\n\
+  5,\n\
+  6,\n\
+  7,\n\
+  8,\n\
+  9\n\
+]");
+  KATANA_LOG_ASSERT(
+      graph.topology->out_indices->ToString() == indices_expected);
+
+  std::string dests_expected = std::string(
+      "[\n\
+  0,\n\
+  0,\n\
+  7,\n\
+  0,\n\
+  0,\n\
+  0,\n\
+  0,\n\
+  0,\n\
+  7\n\
+]");
+  KATANA_LOG_ASSERT(graph.topology->out_dests->ToString() == dests_expected);
+}
+
 void
 VerifyTypesSet(katana::GraphComponents graph) {
   KATANA_LOG_ASSERT(graph.nodes.properties->num_columns() == 5);
@@ -1272,7 +1446,18 @@ main(int argc, char** argv) {
 
   switch (fileType) {
   case katana::SourceDatabase::kNeo4j:
-    if (auto r = katana::ConvertGraphML(input_filename, chunk_size, true); !r) {
+    if (!edges_filename.empty()) {
+      katana::CSVImportOptions opts;
+      opts.num_chunks = num_csv_chunks;
+      if (auto r = katana::ConvertCSV(input_filename, edges_filename, opts);
+          !r) {
+        KATANA_LOG_FATAL(": {}", r.error());
+      } else {
+        graph = std::move(r.value());
+      }
+    } else if (auto r =
+                   katana::ConvertGraphML(input_filename, chunk_size, true);
+               !r) {
       KATANA_LOG_FATAL(": {}", r.error());
     } else {
       graph = std::move(r.value());
@@ -1291,6 +1476,9 @@ main(int argc, char** argv) {
   case ConvertTest::kMovies:
     VerifyMovieSet(graph);
     break;
+  case ConvertTest::kMoviesCSV:
+    VerifyMovieCSVSet(graph);
+    break;
   case ConvertTest::kTypes:
     VerifyTypesSet(graph);
     break;